@@ -0,0 +1,272 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Codec benchmarks
+//
+//   bench [--repeat n] [--size bytes] [--filter name] [--silesia dir] [--csv file] [--json file] [--stats]
+//
+// --stats prints what the decoders see in each corpus (see decoder_stats.hpp).
+// --filter runs only the benchmarks whose "library:benchmark/corpus" name contains the string.
+//
+// Built with -DANDYZIP_BENCH_COMPARE=ON, zlib, libdeflate and brotli run the same
+// benchmarks where they are installed (see compare.hpp).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "compare.hpp"
+
+#include <andyzip/bit_writer.hpp>
+#include <andyzip/brotli_decoder.hpp>
+#include <andyzip/brotli_encoder.hpp>
+#include <andyzip/checksum.hpp>
+#include <andyzip/deflate_decoder.hpp>
+#include <andyzip/deflate_encoder.hpp>
+#include <andyzip/filters.hpp>
+#include <andyzip/huffman_table.hpp>
+#include <andyzip/parallel_deflate_decoder.hpp>
+
+#include <thread>
+
+using namespace andyzip_bench;
+
+namespace {
+  template <class Decoder>
+  void bench_deflate_decode(runner &r, const char *name, const corpus &c, const std::vector<uint8_t> &packed) {
+    Decoder dec;
+    std::vector<uint8_t> out(c.data.size());
+    // four bytes of slack for the trusted decoder.
+    std::vector<uint8_t> src(packed);
+    src.resize(packed.size() + 4);
+    r.run(name, c, (double)c.data.size() / packed.size(), [&]() {
+      if (!dec.decode(out.data(), out.data() + out.size(), src.data(), src.data() + packed.size())) {
+        fprintf(stderr, "%s: decode failed\n", name);
+        exit(1);
+      }
+    });
+  }
+
+  template <class Decoder>
+  void bench_brotli_decode(runner &r, const char *name, const corpus &c, const std::vector<uint8_t> &packed) {
+    Decoder dec;
+    andyzip::brotli_decoder_state s;
+    std::vector<char> out(c.data.size());
+    std::vector<uint8_t> src(packed);
+    src.resize(packed.size() + 4);
+    r.run(name, c, (double)c.data.size() / packed.size(), [&]() {
+      s.reset();
+      s.src = (const char*)src.data();
+      s.bitptr = 0;
+      s.bitptr_max = (std::uint32_t)(packed.size() * 8);
+      s.dest = out.data();
+      s.dest_max = out.data() + out.size();
+      dec.decode(s);
+      if (s.error != andyzip::brotli_decoder_state::error_code::ok || s.dest != s.dest_max) {
+        fprintf(stderr, "%s: decode failed\n", name);
+        exit(1);
+      }
+    });
+  }
+
+  // parallel_deflate_decoder at 1, 2, 4 and all hardware threads, with chunks small
+  // enough for the default corpus size to be split up.
+  void bench_parallel_deflate_decode(runner &r, const corpus &c, const std::vector<uint8_t> &packed) {
+    std::vector<uint8_t> out;
+    out.reserve(c.data.size());
+    std::vector<unsigned> thread_counts = {1, 2, 4};
+    if (std::thread::hardware_concurrency() > 4) thread_counts.push_back(std::thread::hardware_concurrency());
+    for (unsigned threads : thread_counts) {
+      andyzip::parallel_deflate_decoder dec(threads, std::max(packed.size() / (threads * 2), (size_t)andyzip::parallel_deflate_decoder::min_chunk_size));
+      std::string name = "deflate_decode_parallel/" + std::to_string(threads);
+      r.run(name, c, (double)c.data.size() / packed.size(), [&]() {
+        out.clear();
+        if (!dec.decode_append(out, packed.data(), packed.data() + packed.size()) || out.size() != c.data.size()) {
+          fprintf(stderr, "%s: decode failed\n", name.c_str());
+          exit(1);
+        }
+      });
+    }
+  }
+
+  void print_deflate_stats(const corpus &c, const std::vector<uint8_t> &packed) {
+    andyzip::basic_deflate_decoder<andyzip::with_stats<andyzip::checked_input>> dec;
+    std::vector<uint8_t> out(c.data.size());
+    dec.decode(out.data(), out.data() + out.size(), packed.data(), packed.data() + packed.size());
+    printf("\ndeflate_decode/%s stats:\n", c.name.c_str());
+    dec.stats().print(stdout);
+    printf("\n");
+  }
+
+  void print_brotli_stats(const corpus &c, const std::vector<uint8_t> &packed) {
+    andyzip::basic_brotli_decoder<andyzip::with_stats<andyzip::checked_input>> dec;
+    andyzip::brotli_decoder_state s;
+    std::vector<char> out(c.data.size());
+    s.src = (const char*)packed.data();
+    s.bitptr_max = (std::uint32_t)(packed.size() * 8);
+    s.dest = out.data();
+    s.dest_max = out.data() + out.size();
+    dec.decode(s);
+    printf("\nbrotli_decode/%s stats:\n", c.name.c_str());
+    s.stats.print(stdout);
+    printf("\n");
+  }
+
+  void bench_deflate(runner &r, const corpus &c, bool stats) {
+    std::vector<uint8_t> packed(andyzip::deflate_encoder::max_encoded_size(c.data.size()));
+    std::vector<uint8_t> level6;
+    for (int level : {1, 6, 9}) {
+      andyzip::deflate_encoder enc(level);
+      uint8_t *end = enc.encode(packed.data(), packed.data() + packed.size(), c.data.data(), c.data.data() + c.data.size());
+      std::string name = "deflate_encode/" + std::to_string(level);
+      r.run(name, c, (double)c.data.size() / (end - packed.data()), [&]() {
+        enc.encode(packed.data(), packed.data() + packed.size(), c.data.data(), c.data.data() + c.data.size());
+      });
+      if (level == 6) level6.assign(packed.data(), end);
+    }
+    bench_deflate_decode<andyzip::deflate_decoder>(r, "deflate_decode", c, level6);
+    bench_deflate_decode<andyzip::trusted_deflate_decoder>(r, "deflate_decode_trusted", c, level6);
+    bench_parallel_deflate_decode(r, c, level6);
+    compare_deflate(r, c, level6);
+    if (stats) print_deflate_stats(c, level6);
+  }
+
+  void bench_brotli(runner &r, const corpus &c, bool stats) {
+    std::vector<uint8_t> packed(andyzip::brotli_encoder::max_encoded_size(c.data.size()));
+    std::vector<uint8_t> quality5;
+    for (int quality : {1, 5, 9, 11}) {
+      andyzip::brotli_encoder enc(quality);
+      uint8_t *end = enc.encode(packed.data(), packed.data() + packed.size(), c.data.data(), c.data.data() + c.data.size());
+      std::string name = "brotli_encode/" + std::to_string(quality);
+      r.run(name, c, (double)c.data.size() / (end - packed.data()), [&]() {
+        enc.encode(packed.data(), packed.data() + packed.size(), c.data.data(), c.data.data() + c.data.size());
+      });
+      if (quality == 5) quality5.assign(packed.data(), end);
+    }
+    bench_brotli_decode<andyzip::brotli_decoder>(r, "brotli_decode", c, quality5);
+    bench_brotli_decode<andyzip::trusted_brotli_decoder>(r, "brotli_decode_trusted", c, quality5);
+    compare_brotli(r, c, quality5);
+    if (stats) print_brotli_stats(c, quality5);
+  }
+
+  // Huffman code the bytes of the corpus with huffman_table and decode them again.
+  void bench_huffman(runner &r, const corpus &c) {
+    uint32_t counts[256] = {0};
+    for (auto b : c.data) counts[b]++;
+    uint8_t lengths[256];
+    uint16_t codes[256];
+    andyzip::huffman_code_lengths(lengths, counts, 256, 15);
+    if (std::count_if(lengths, lengths + 256, [](uint8_t l) { return l != 0; }) < 3) return;
+    andyzip::huffman_codes(codes, lengths, 256);
+    andyzip::bit_writer w;
+    for (auto b : c.data) w.write(lengths[b], codes[b]);
+    std::vector<uint8_t> packed(w.data(), w.data() + w.byte_size());
+    packed.resize(packed.size() + 8);
+
+    std::vector<uint8_t> out(c.data);
+    r.run("huffman_decode", c, (double)c.data.size() / w.byte_size(), [&]() {
+      andyzip::huffman_table<256> table;
+      table.init(lengths, nullptr, 256);
+      size_t bitptr = 0;
+      for (auto &b : out) {
+        uint32_t word;
+        memcpy(&word, packed.data() + (bitptr >> 3), 4);
+        auto code = table.decode((word >> (bitptr & 7)) & 0xffff);
+        bitptr += code.first;
+        b = (uint8_t)code.second;
+      }
+    });
+    if (out != c.data) {
+      fprintf(stderr, "huffman_decode: mismatch\n");
+      exit(1);
+    }
+  }
+
+  void bench_suffix_array(runner &r, const corpus &c) {
+    r.run("suffix_array", c, 0, [&]() {
+      andyzip::suffix_array<uint8_t, uint32_t> sa(c.data.data(), c.data.data() + c.data.size());
+    });
+  }
+
+  // The stride delta filter at the stride choose_stride() picks, or 4 if it picks none.
+  void bench_filters(runner &r, const corpus &c) {
+    unsigned stride = andyzip::choose_stride(c.data.data(), c.data.data() + c.data.size());
+    if (!stride) stride = 4;
+    std::vector<uint8_t> filtered(c.data.size());
+    std::vector<uint8_t> out(c.data);
+    std::string suffix = "/" + std::to_string(stride);
+    r.run("stride_delta_forward" + suffix, c, 0, [&]() {
+      andyzip::stride_delta_forward(filtered.data(), c.data.data(), c.data.size(), stride);
+    });
+    andyzip::stride_delta_forward(filtered.data(), c.data.data(), c.data.size(), stride);
+    r.run("stride_delta_inverse" + suffix, c, 0, [&]() {
+      andyzip::stride_delta_inverse(out.data(), filtered.data(), filtered.size(), stride);
+    });
+    if (out != c.data) {
+      fprintf(stderr, "stride_delta_inverse: mismatch\n");
+      exit(1);
+    }
+  }
+
+  void bench_checksums(runner &r, const corpus &c) {
+    static volatile uint32_t sink;
+    r.run("crc32", c, 0, [&]() { sink = andyzip::crc32(0, c.data.data(), c.data.size()); });
+    r.run("adler32", c, 0, [&]() { sink = andyzip::adler32(1, c.data.data(), c.data.size()); });
+    (void)sink;
+  }
+}
+
+int main(int argc, const char **argv) {
+  runner r;
+  size_t size = 1 << 20;
+  std::string silesia;
+  std::string csv;
+  std::string json;
+  bool stats = false;
+  for (int i = 1; i != argc; ++i) {
+    std::string arg = argv[i];
+    if (i + 1 != argc && arg == "--repeat") {
+      r.repeat = atoi(argv[++i]);
+    } else if (i + 1 != argc && arg == "--size") {
+      size = (size_t)atoll(argv[++i]);
+    } else if (i + 1 != argc && arg == "--filter") {
+      r.filter = argv[++i];
+    } else if (i + 1 != argc && arg == "--silesia") {
+      silesia = argv[++i];
+    } else if (i + 1 != argc && arg == "--csv") {
+      csv = argv[++i];
+    } else if (i + 1 != argc && arg == "--json") {
+      json = argv[++i];
+    } else if (arg == "--stats") {
+      stats = true;
+    } else {
+      fprintf(stderr, "Usage: bench [--repeat n] [--size bytes] [--filter name] [--silesia dir] [--csv file] [--json file] [--stats]\n");
+      fprintf(stderr, "compared with:%s\n", *compared_libraries() ? compared_libraries() : " none");
+      return 1;
+    }
+  }
+
+  std::vector<corpus> corpora = synthetic_corpora(size);
+  if (!silesia.empty() && !add_silesia(corpora, silesia)) {
+    fprintf(stderr, "no Silesia files in %s\n", silesia.c_str());
+    return 1;
+  }
+
+  for (auto &c : corpora) {
+    bench_deflate(r, c, stats);
+    bench_brotli(r, c, stats);
+    bench_huffman(r, c);
+    bench_suffix_array(r, c);
+    bench_filters(r, c);
+    bench_checksums(r, c);
+  }
+
+  if (!csv.empty() && !write_csv(r.results(), csv)) {
+    fprintf(stderr, "could not write %s\n", csv.c_str());
+    return 1;
+  }
+  if (!json.empty() && !write_json(r.results(), json)) {
+    fprintf(stderr, "could not write %s\n", json.c_str());
+    return 1;
+  }
+}
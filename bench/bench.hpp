@@ -0,0 +1,322 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// A small benchmark harness in the style of Google Benchmark.
+//
+// Each benchmark runs over a set of corpora: reproducible synthetic ones (text, json,
+// binary, random, repetitive) and optionally the Silesia corpus. A benchmark is timed
+// "repeat" times and reported as MB/s of uncompressed data for the minimum and median
+// times, cycles per byte (x86 only) and compression ratio where there is one.
+//
+// Results can also be written as CSV or JSON for plotting or comparing runs.
+//
+
+#ifndef ANDYZIP_BENCH_HPP_
+#define ANDYZIP_BENCH_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+#endif
+
+namespace andyzip_bench {
+  struct corpus {
+    std::string name;
+    std::vector<uint8_t> data;
+  };
+
+  struct result {
+    std::string library;      // "andyzip" or the library compared against
+    std::string benchmark;
+    std::string corpus;
+    size_t bytes;
+    double best_mb_per_s;     // from the minimum time
+    double median_mb_per_s;
+    double cycles_per_byte;   // minimum, 0 if there is no cycle counter
+    double ratio;             // uncompressed / compressed or 0
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  //
+  // Synthetic corpora. std::mt19937 is specified exactly by the standard, so these are
+  // the same everywhere. Distributions are not, so they are done by hand.
+  //
+
+  class corpus_builder {
+  public:
+    corpus_builder(uint32_t seed) : rng_(seed) {
+      static const char *syllables[] = {
+        "a", "al", "an", "ar", "be", "ca", "co", "de", "di", "el", "en", "er", "es", "for", "ga", "in",
+        "is", "it", "la", "le", "li", "ma", "me", "mo", "na", "ne", "no", "on", "or", "pa", "per", "pro",
+        "ra", "re", "ri", "ro", "sa", "se", "si", "st", "ta", "te", "th", "ti", "to", "tu", "un", "ve",
+      };
+      for (int i = 0; i != 2000; ++i) {
+        std::string word;
+        int n = 1 + next(3) + (next(4) == 0);
+        for (int j = 0; j != n; ++j) word += syllables[next(sizeof(syllables)/sizeof(syllables[0]))];
+        words_.push_back(word);
+      }
+      // Zipf's law: word i is used in proportion to 1/(i+1).
+      double total = 0;
+      for (size_t i = 0; i != words_.size(); ++i) {
+        total += 1.0 / (i + 1);
+        zipf_.push_back(total);
+      }
+      for (auto &z : zipf_) z /= total;
+    }
+
+    std::vector<uint8_t> text(size_t size) {
+      std::string out;
+      size_t line = 0;
+      bool capital = true;
+      while (out.size() < size) {
+        std::string w = word();
+        if (capital) w[0] = (char)(w[0] - 'a' + 'A');
+        capital = false;
+        out += w;
+        line += w.size();
+        unsigned r = next(100);
+        if (r < 8) { out += '.'; capital = true; }
+        else if (r < 14) out += ',';
+        if (line > 70) { out += '\n'; line = 0; }
+        else { out += ' '; ++line; }
+      }
+      return bytes(out, size);
+    }
+
+    std::vector<uint8_t> json(size_t size) {
+      std::string out = "[\n";
+      for (unsigned id = 1; out.size() < size; ++id) {
+        char number[64];
+        out += "  {\"id\": " + std::to_string(id);
+        out += ", \"name\": \"" + word() + " " + word() + "\"";
+        out += ", \"email\": \"" + word() + "@" + word() + ".com\"";
+        snprintf(number, sizeof(number), "%u.%02u", next(1000), next(100));
+        out += ", \"score\": "; out += number;
+        out += ", \"tags\": [";
+        for (unsigned t = 0, n = next(4); t != n; ++t) out += (t ? ", \"" : "\"") + word() + "\"";
+        out += "], \"active\": "; out += next(3) ? "true" : "false";
+        out += "},\n";
+      }
+      return bytes(out, size);
+    }
+
+    // Records of sensor-like data: an increasing id, slowly changing values and a few flags.
+    std::vector<uint8_t> binary(size_t size) {
+      std::vector<uint8_t> out;
+      int32_t x = 0, y = 0, z = 0;
+      float value = 100.0f;
+      for (uint32_t id = 0; out.size() < size; ++id) {
+        x += (int)next(33) - 16;
+        y += (int)next(9) - 4;
+        z += (int)next(3) - 1;
+        value += ((int)next(201) - 100) * 0.01f;
+        put(out, id, 4);
+        put(out, (uint32_t)x, 2);
+        put(out, (uint32_t)y, 2);
+        put(out, (uint32_t)z, 2);
+        uint32_t bits;
+        memcpy(&bits, &value, 4);
+        put(out, bits, 4);
+        put(out, next(8) ? 1 : next(4), 1);
+        put(out, 0, 1);
+      }
+      out.resize(size);
+      return out;
+    }
+
+    std::vector<uint8_t> random(size_t size) {
+      std::vector<uint8_t> out(size);
+      for (auto &c : out) c = (uint8_t)rng_();
+      return out;
+    }
+
+    // A 1k block copied over and over with a one byte change in each copy.
+    std::vector<uint8_t> repetitive(size_t size) {
+      std::vector<uint8_t> block = text(1024);
+      std::vector<uint8_t> out;
+      while (out.size() < size) {
+        block[next(1024)] = (uint8_t)('a' + next(26));
+        out.insert(out.end(), block.begin(), block.end());
+      }
+      out.resize(size);
+      return out;
+    }
+
+  private:
+    unsigned next(unsigned n) {
+      return (unsigned)(rng_() % n);
+    }
+
+    const std::string &word() {
+      double r = (rng_() & 0xffffff) / (double)0x1000000;
+      return words_[std::lower_bound(zipf_.begin(), zipf_.end() - 1, r) - zipf_.begin()];
+    }
+
+    static std::vector<uint8_t> bytes(const std::string &s, size_t size) {
+      return std::vector<uint8_t>(s.begin(), s.begin() + std::min(size, s.size()));
+    }
+
+    static void put(std::vector<uint8_t> &out, uint32_t value, int bytes) {
+      for (int i = 0; i != bytes; ++i) out.push_back((uint8_t)(value >> (i * 8)));
+    }
+
+    std::mt19937 rng_;
+    std::vector<std::string> words_;
+    std::vector<double> zipf_;
+  };
+
+  inline std::vector<corpus> synthetic_corpora(size_t size, uint32_t seed = 1) {
+    corpus_builder b(seed);
+    std::vector<corpus> result;
+    result.push_back(corpus{"text", b.text(size)});
+    result.push_back(corpus{"json", b.json(size)});
+    result.push_back(corpus{"binary", b.binary(size)});
+    result.push_back(corpus{"random", b.random(size)});
+    result.push_back(corpus{"repetitive", b.repetitive(size)});
+    return result;
+  }
+
+  // Add the files of the Silesia corpus (http://sun.aei.polsl.pl/~sdeor/index.php?page=silesia)
+  // found in dir. Returns the number of files found.
+  inline int add_silesia(std::vector<corpus> &corpora, const std::string &dir) {
+    static const char *names[] = {
+      "dickens", "mozilla", "mr", "nci", "ooffice", "osdb", "reymont", "samba", "sao", "webster", "x-ray", "xml",
+    };
+    int found = 0;
+    for (auto name : names) {
+      std::ifstream is(dir + "/" + name, std::ios::binary);
+      if (!is) continue;
+      corpora.push_back(corpus{name, std::vector<uint8_t>((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>())});
+      ++found;
+    }
+    return found;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  //
+  // Timing
+  //
+
+  inline uint64_t cycles() {
+    #if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+    #else
+      return 0;
+    #endif
+  }
+
+  class runner {
+  public:
+    int repeat = 5;
+    std::string filter;
+
+    // Run fn() repeat times on corpus c and record the result. fn processes all
+    // of c.data. ratio is the compression ratio, if there is one.
+    template <class Fn>
+    void run(const std::string &benchmark, const corpus &c, double ratio, Fn fn) {
+      run("andyzip", benchmark, c, ratio, fn);
+    }
+
+    template <class Fn>
+    void run(const std::string &library, const std::string &benchmark, const corpus &c, double ratio, Fn fn) {
+      std::string full_name = library + ":" + benchmark + "/" + c.name;
+      if (!filter.empty() && full_name.find(filter) == std::string::npos) return;
+
+      std::vector<double> seconds;
+      std::vector<double> cycle_counts;
+      for (int i = 0; i != std::max(1, repeat); ++i) {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t start_cycles = cycles();
+        fn();
+        uint64_t end_cycles = cycles();
+        auto end = std::chrono::steady_clock::now();
+        seconds.push_back(std::chrono::duration<double>(end - start).count());
+        cycle_counts.push_back((double)(end_cycles - start_cycles));
+      }
+      std::sort(seconds.begin(), seconds.end());
+      std::sort(cycle_counts.begin(), cycle_counts.end());
+
+      double mb = c.data.size() / 1000000.0;
+      result r;
+      r.library = library;
+      r.benchmark = benchmark;
+      r.corpus = c.name;
+      r.bytes = c.data.size();
+      r.best_mb_per_s = mb / std::max(seconds[0], 1e-9);
+      r.median_mb_per_s = mb / std::max(seconds[seconds.size() / 2], 1e-9);
+      r.cycles_per_byte = c.data.empty() ? 0 : cycle_counts[0] / c.data.size();
+      r.ratio = ratio;
+      print(r);
+      results_.push_back(r);
+    }
+
+    const std::vector<result> &results() const { return results_; }
+
+  private:
+    void print(const result &r) {
+      if (results_.empty()) {
+        printf("%-10s %-24s %-12s %10s %10s %10s %10s %8s\n", "library", "benchmark", "corpus", "bytes", "best MB/s", "med MB/s", "cycles/B", "ratio");
+      }
+      printf("%-10s %-24s %-12s %10zu %10.1f %10.1f %10.2f", r.library.c_str(), r.benchmark.c_str(), r.corpus.c_str(), r.bytes, r.best_mb_per_s, r.median_mb_per_s, r.cycles_per_byte);
+      if (r.ratio) printf(" %8.3f\n", r.ratio); else printf(" %8s\n", "-");
+      fflush(stdout);
+    }
+
+    std::vector<result> results_;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////////
+  //
+  // Output files
+  //
+
+  inline bool write_csv(const std::vector<result> &results, const std::string &filename) {
+    FILE *fp = fopen(filename.c_str(), "w");
+    if (!fp) return false;
+    fprintf(fp, "library,benchmark,corpus,bytes,best_mb_per_s,median_mb_per_s,cycles_per_byte,ratio\n");
+    for (auto &r : results) {
+      fprintf(fp, "%s,%s,%s,%zu,%.3f,%.3f,%.4f,%.4f\n", r.library.c_str(), r.benchmark.c_str(), r.corpus.c_str(), r.bytes, r.best_mb_per_s, r.median_mb_per_s, r.cycles_per_byte, r.ratio);
+    }
+    return fclose(fp) == 0;
+  }
+
+  inline std::string json_string(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+      if (c == '"' || c == '\\') out += '\\';
+      if ((unsigned char)c < 0x20) continue;
+      out += c;
+    }
+    return out + "\"";
+  }
+
+  inline bool write_json(const std::vector<result> &results, const std::string &filename) {
+    FILE *fp = fopen(filename.c_str(), "w");
+    if (!fp) return false;
+    fprintf(fp, "{\n  \"benchmarks\": [");
+    for (size_t i = 0; i != results.size(); ++i) {
+      auto &r = results[i];
+      fprintf(fp, "%s\n    {\"library\": %s, \"benchmark\": %s, \"corpus\": %s, \"bytes\": %zu, ", i ? "," : "", json_string(r.library).c_str(), json_string(r.benchmark).c_str(), json_string(r.corpus).c_str(), r.bytes);
+      fprintf(fp, "\"best_mb_per_s\": %.3f, \"median_mb_per_s\": %.3f, \"cycles_per_byte\": %.4f, \"ratio\": %.4f}", r.best_mb_per_s, r.median_mb_per_s, r.cycles_per_byte, r.ratio);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+    return fclose(fp) == 0;
+  }
+}
+
+#endif
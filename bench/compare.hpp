@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// The same benchmarks with the reference libraries, for comparison.
+//
+// Configure with -DANDYZIP_BENCH_COMPARE=ON to link whichever of zlib, libdeflate
+// and brotli are installed. Each library found defines ANDYZIP_BENCH_ZLIB,
+// ANDYZIP_BENCH_LIBDEFLATE or ANDYZIP_BENCH_BROTLI; the others are left out.
+//
+// Decoders are given the same compressed data as andyzip's decoders.
+//
+
+#ifndef ANDYZIP_BENCH_COMPARE_HPP_
+#define ANDYZIP_BENCH_COMPARE_HPP_
+
+#include "bench.hpp"
+
+#ifdef ANDYZIP_BENCH_ZLIB
+  #include <zlib.h>
+#endif
+
+#ifdef ANDYZIP_BENCH_LIBDEFLATE
+  #include <libdeflate.h>
+#endif
+
+#ifdef ANDYZIP_BENCH_BROTLI
+  #include <brotli/decode.h>
+  #include <brotli/encode.h>
+#endif
+
+namespace andyzip_bench {
+  inline void fail(const char *library, const char *benchmark) {
+    fprintf(stderr, "%s %s failed\n", library, benchmark);
+    exit(1);
+  }
+
+  // Libraries compared against, for the usage message.
+  inline const char *compared_libraries() {
+    return ""
+    #ifdef ANDYZIP_BENCH_ZLIB
+      " zlib"
+    #endif
+    #ifdef ANDYZIP_BENCH_LIBDEFLATE
+      " libdeflate"
+    #endif
+    #ifdef ANDYZIP_BENCH_BROTLI
+      " brotli"
+    #endif
+    ;
+  }
+
+  // packed is the raw deflate stream that deflate_decoder was timed on.
+  inline void compare_deflate(runner &r, const corpus &c, const std::vector<uint8_t> &packed) {
+    const uint8_t *src = c.data.data();
+    size_t size = c.data.size();
+    double ratio = (double)size / packed.size();
+    std::vector<uint8_t> out(size);
+    std::vector<uint8_t> buffer(size + size / 8 + 1024);
+    (void)r; (void)src; (void)ratio;
+
+    #ifdef ANDYZIP_BENCH_ZLIB
+      for (int level : {1, 6, 9}) {
+        z_stream z = {};
+        deflateInit2(&z, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        size_t packed_size = 0;
+        auto encode = [&]() {
+          deflateReset(&z);
+          z.next_in = (Bytef*)src;
+          z.avail_in = (uInt)size;
+          z.next_out = buffer.data();
+          z.avail_out = (uInt)buffer.size();
+          if (deflate(&z, Z_FINISH) != Z_STREAM_END) fail("zlib", "deflate");
+          packed_size = z.total_out;
+        };
+        encode();
+        r.run("zlib", "deflate_encode/" + std::to_string(level), c, (double)size / packed_size, encode);
+        deflateEnd(&z);
+      }
+      {
+        z_stream z = {};
+        inflateInit2(&z, -15);
+        r.run("zlib", "deflate_decode", c, ratio, [&]() {
+          inflateReset(&z);
+          z.next_in = (Bytef*)packed.data();
+          z.avail_in = (uInt)packed.size();
+          z.next_out = out.data();
+          z.avail_out = (uInt)out.size();
+          if (inflate(&z, Z_FINISH) != Z_STREAM_END || z.total_out != size) fail("zlib", "inflate");
+        });
+        inflateEnd(&z);
+      }
+    #endif
+
+    #ifdef ANDYZIP_BENCH_LIBDEFLATE
+      for (int level : {1, 6, 9, 12}) {
+        libdeflate_compressor *comp = libdeflate_alloc_compressor(level);
+        size_t packed_size = 0;
+        auto encode = [&]() {
+          packed_size = libdeflate_deflate_compress(comp, src, size, buffer.data(), buffer.size());
+          if (!packed_size) fail("libdeflate", "compress");
+        };
+        encode();
+        r.run("libdeflate", "deflate_encode/" + std::to_string(level), c, (double)size / packed_size, encode);
+        libdeflate_free_compressor(comp);
+      }
+      {
+        libdeflate_decompressor *dec = libdeflate_alloc_decompressor();
+        r.run("libdeflate", "deflate_decode", c, ratio, [&]() {
+          size_t actual = 0;
+          if (libdeflate_deflate_decompress(dec, packed.data(), packed.size(), out.data(), out.size(), &actual) != LIBDEFLATE_SUCCESS || actual != size) {
+            fail("libdeflate", "decompress");
+          }
+        });
+        libdeflate_free_decompressor(dec);
+      }
+    #endif
+  }
+
+  // packed is the brotli stream that brotli_decoder was timed on.
+  inline void compare_brotli(runner &r, const corpus &c, const std::vector<uint8_t> &packed) {
+    #ifdef ANDYZIP_BENCH_BROTLI
+      const uint8_t *src = c.data.data();
+      size_t size = c.data.size();
+      std::vector<uint8_t> out(size);
+      std::vector<uint8_t> buffer(BrotliEncoderMaxCompressedSize(size) + 1024);
+
+      for (int quality : {1, 5, 9, 11}) {
+        size_t packed_size = 0;
+        auto encode = [&]() {
+          packed_size = buffer.size();
+          if (!BrotliEncoderCompress(quality, 22, BROTLI_MODE_GENERIC, size, src, &packed_size, buffer.data())) fail("brotli", "compress");
+        };
+        encode();
+        r.run("brotli", "brotli_encode/" + std::to_string(quality), c, (double)size / packed_size, encode);
+      }
+      r.run("brotli", "brotli_decode", c, (double)size / packed.size(), [&]() {
+        size_t actual = out.size();
+        if (BrotliDecoderDecompress(packed.size(), packed.data(), &actual, out.data()) != BROTLI_DECODER_RESULT_SUCCESS || actual != size) {
+          fail("brotli", "decompress");
+        }
+      });
+    #else
+      (void)r; (void)c; (void)packed;
+    #endif
+  }
+}
+
+#endif
@@ -0,0 +1,27 @@
+// analyse files and suggest a compression method for each
+
+#include <andyzip/analysis.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+int main(int argc, const char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: analyse files...\n");
+    return 1;
+  }
+
+  static const char *methods[] = { "stored", "delta+deflate", "brotli" };
+  printf("%-32s %10s %8s %8s %6s %8s %6s  %s\n", "file", "size", "order0", "order1", "stride", "delta", "text", "method");
+  for (int i = 1; i != argc; ++i) {
+    std::ifstream is(argv[i], std::ios::binary);
+    if (!is) {
+      fprintf(stderr, "can't open %s\n", argv[i]);
+      continue;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    andyzip::data_analysis a = andyzip::analyse(data.data(), data.data() + data.size());
+    printf("%-32s %10zu %8.3f %8.3f %6u %8.3f %6.2f  %s\n", argv[i], a.size, a.order0_entropy, a.order1_entropy, a.stride, a.delta_entropy, a.text_fraction, methods[a.suggested]);
+  }
+}
@@ -6,10 +6,14 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <stdio.h>
+#include <string.h>
 #include <andyzip/brotli_decoder.hpp>
+#include <andyzip/brotli_encoder.hpp>
 
 #include <iostream>
 #include <fstream>
+#include <iterator>
+#include <vector>
 #include <chrono>
 
 #if defined(_MSC_VER) && (_MSC_VER >= 1400)
@@ -28,7 +32,7 @@ class bro {
     const char *input_file = nullptr;
     const char *output_file = nullptr;
     const char *custom_dictionary = nullptr;
-    int quality = 0;
+    int quality = 11;
     int repeat = 1;
     int window = 22;
     bool fail = true;
@@ -50,7 +54,7 @@ class bro {
         "v", "-verbose",
         "N", "-no-copy-stat",
         "i", "-in", "-input",
-        "o", "-out", "-output"
+        "o", "-out", "-output",
         "D", "-custom-dictionary",
         "q", "-quality",
         "r", "-repeat",
@@ -78,10 +82,10 @@ class bro {
                   if (!sw[1]) { error(arg, "unknown argument", switches); return; }
                   no_copy_stat = true;
                 } break;
-                case 'i': case 'o': {
+                case 'i': case 'o': case 'D': {
                   if (i+1 == argc) { error(arg, "too few arguments", switches); return; }
                   if (short_code == 'D' && !sw[1]) { error(arg, "unknown argument", switches); return; }
-                  const char * &rhs = short_code == 'i' ? input_file : 'o' ? output_file : custom_dictionary;
+                  const char * &rhs = short_code == 'i' ? input_file : short_code == 'o' ? output_file : custom_dictionary;
                   rhs = argv[++i];
                 } break;
                 case 'q': case 'r': case 'w': {
@@ -89,7 +93,7 @@ class bro {
                   int &rhs = short_code == 'q' ? quality : short_code == 'r' ? repeat : window;
                   rhs = 0;
                   const char *p = argv[++i];
-                  while (*p) {
+                  for (; *p; ++p) {
                     if (*p < '0' || *p > '9') { error(p, "expected number", switches); return; }
                     rhs = rhs * 10 + *p - '0';
                   }
@@ -107,7 +111,7 @@ class bro {
         }
       }
 
-      if (quality > 99) {
+      if (quality > 11) {
         error("", "quality out of range", switches);
       } else if (window < 10 || window >= 25) {
         error("", "window out of range", switches);
@@ -130,33 +134,65 @@ public:
     std::ifstream ifs;
     if (args.input_file) {
       ifs.open(args.input_file, std::ios::binary);
+      if (!ifs) { fprintf(stderr, "could not open %s\n", args.input_file); return; }
     }
 
     std::istream &is = args.input_file ? static_cast<std::istream&>(ifs) : std::cin;
-    
-    //std::ostream os = !args.output_file ? std::cout : (std::ostream&)std::ofstream(args.output_file, std::ios::binary);
-
-    andyzip::brotli_decoder dec;
-
-    andyzip::brotli_decoder_state state;
-
-    static char tmp[0x1000000];
-    if (!ifs.bad() && !ifs.eof()) {
-      auto start = std::chrono::high_resolution_clock::now();
-      ifs.read(tmp, sizeof(tmp));
-      state.src = tmp;
-      state.bitptr = 0;
-      state.bitptr_max = (std::uint32_t)(ifs.gcount() * 8);
-      state.log_file = fopen("log.txt", "wb");
-      dec.decode(state);
-      auto end = std::chrono::high_resolution_clock::now();
-      auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-      printf("err=%d\n", (int)state.error);
-      printf("%d\n", (int)state.bytes_written);
-      if (args.verbose) {
-        printf("Brotli decompression speed: %0.f MB/s\n", (1000000000.0/1024/1024) * state.bytes_written / nanoseconds.count());
+    std::vector<char> input((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    std::vector<char> output;
+
+    std::vector<char> dictionary;
+    if (args.custom_dictionary) {
+      std::ifstream dfs(args.custom_dictionary, std::ios::binary);
+      if (!dfs) { fprintf(stderr, "could not open %s\n", args.custom_dictionary); return; }
+      dictionary.assign(std::istreambuf_iterator<char>(dfs), std::istreambuf_iterator<char>());
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i != args.repeat; ++i) {
+      if (args.decompress) {
+        andyzip::brotli_decoder dec;
+        andyzip::brotli_decoder_state state;
+        state.set_dictionary(dictionary.data(), dictionary.size());
+        output.resize(input.size() * 4 + 0x10000);
+        for (;;) {
+          state.src = input.data();
+          state.bitptr = 0;
+          state.bitptr_max = (std::uint32_t)(input.size() * 8);
+          state.dest = output.data();
+          state.dest_max = output.data() + output.size();
+          dec.decode(state);
+          if (state.error != andyzip::brotli_decoder_state::error_code::output_full) break;
+          output.resize(output.size() * 2);
+        }
+        if (state.error != andyzip::brotli_decoder_state::error_code::ok) {
+          fprintf(stderr, "corrupt input err=%d\n", (int)state.error);
+          return;
+        }
+        output.resize(state.dest - output.data());
+      } else {
+        andyzip::brotli_encoder enc(args.quality, args.window);
+        enc.set_dictionary(dictionary.data(), dictionary.size());
+        output.resize(andyzip::brotli_encoder::max_encoded_size(input.size()));
+        uint8_t *dest = (uint8_t*)output.data();
+        uint8_t *end = enc.encode(dest, dest + output.size(), (const uint8_t*)input.data(), (const uint8_t*)input.data() + input.size());
+        output.resize(end - dest);
       }
     }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    if (args.output_file) {
+      std::ofstream ofs(args.output_file, std::ios::binary);
+      ofs.write(output.data(), output.size());
+    } else {
+      fwrite(output.data(), 1, output.size(), stdout);
+    }
+
+    if (args.verbose) {
+      size_t bytes = args.decompress ? output.size() : input.size();
+      fprintf(stderr, "Brotli %s speed: %0.f MB/s\n", args.decompress ? "decompression" : "compression", (1000000000.0/1024/1024) * bytes * args.repeat / nanoseconds.count());
+    }
   }
 };
 
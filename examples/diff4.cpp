@@ -1,17 +1,30 @@
+// diff4 code a file: split it into four byte planes and delta code each.
+//
+//   diff4 [-d] [-s stride] in out
+//
+// -d decodes, -s sets the stride (default 4, 0 to choose one).
 
-// diff4 code a file
-
-#include <andyzip/algorithm.hpp>
+#include <andyzip/filters.hpp>
 #include <cstdio>
-#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <vector>
 
 int main(int argc, const char **argv) {
   const char *in_file = nullptr;
   const char *out_file = nullptr;
+  bool decode = false;
+  unsigned stride = 4;
   for (int i = 1; i != argc; ++i) {
     const char *arg = argv[i];
-    if (arg[0] == '-') {
+    if (!strcmp(arg, "-d")) {
+      decode = true;
+    } else if (!strcmp(arg, "-s") && i + 1 != argc) {
+      stride = (unsigned)atoi(argv[++i]);
+    } else if (arg[0] == '-') {
+      return 1;
     } else if (!in_file) {
       in_file = arg;
     } else if (!out_file) {
@@ -20,33 +33,27 @@ int main(int argc, const char **argv) {
       return 1;
     }
   }
-
-  std::ifstream istr(in_file, std::ios::binary);
-  std::ofstream ostr(out_file, std::ios::binary);
-
-  std::vector<char> in_data;
-  while (istr) {
-    in_data.push_back(istr.get());
+  if (!in_file || !out_file) {
+    fprintf(stderr, "usage: diff4 [-d] [-s stride] in out\n");
+    return 1;
   }
 
-  char *end = in_data.data() + in_data.size();
-  for (size_t i = 0; i != 4; ++i) {
-    int prev = 0;
-    for (char *p = in_data.data() + i; p < end; p += 4) {
-      ostr.put(*p - prev);
-      prev = *p;
-    }
+  std::ifstream istr(in_file, std::ios::binary);
+  std::vector<uint8_t> in_data((std::istreambuf_iterator<char>(istr)), std::istreambuf_iterator<char>());
+  std::vector<uint8_t> out_data;
+
+  // the first byte of the coded file is the stride.
+  if (decode) {
+    out_data = in_data;
+    if (!andyzip::unfilter(out_data)) return 1;
+  } else {
+    if (stride == 0) stride = andyzip::choose_stride(in_data.data(), in_data.data() + in_data.size());
+    if (stride == 0 || stride > 255) stride = 1;
+    out_data.resize(in_data.size() + 1);
+    out_data[0] = (uint8_t)stride;
+    andyzip::stride_delta_forward(out_data.data() + 1, in_data.data(), in_data.size(), stride);
   }
 
-
-  /*int prev[4] = { 0 };
-  int i = 0;
-  while (istr) {
-    int chr = istr.get();
-    ostr.put(chr - prev[i & 3]);
-    prev[i & 3] = chr;
-    ++i;
-  }*/
+  std::ofstream ostr(out_file, std::ios::binary);
+  ostr.write((const char*)out_data.data(), out_data.size());
 }
-
-
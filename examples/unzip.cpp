@@ -0,0 +1,40 @@
+// list or extract the members of a zip file as it arrives on stdin
+//
+//   unzip [-p] < in.zip
+//
+// -p writes the members to stdout instead of listing them.
+
+#include <andyzip/zipfile_stream_reader.hpp>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+int main(int argc, const char **argv) {
+  bool pipe = argc == 2 && !strcmp(argv[1], "-p");
+  if (argc > 1 && !pipe) {
+    fprintf(stderr, "usage: unzip [-p] < in.zip\n");
+    return 1;
+  }
+
+  andyzip::zipfile_stream_reader reader;
+  andyzip::zipfile_stream_reader::member m;
+  auto use = [&]() {
+    if (pipe) {
+      fwrite(m.data.data(), 1, m.data.size(), stdout);
+    } else {
+      printf("%10zu  %s  %08x  %s\n", m.data.size(), m.method ? "deflated" : "stored  ", m.crc, m.name.c_str());
+    }
+  };
+  try {
+    uint8_t buf[65536];
+    for (size_t n; !reader.done() && (n = fread(buf, 1, sizeof(buf), stdin)) != 0; ) {
+      reader.feed(buf, n);
+      while (reader.next(m)) use();
+    }
+    reader.finish();
+    while (reader.next(m)) use();
+  } catch (std::exception &e) {
+    fprintf(stderr, "unzip: %s\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,61 @@
+// make a zip file
+//
+//   zip [-0..9] [-t threads] out.zip files...
+//
+// A file called - is read from stdin as a member of unknown size named "-".
+
+#include <andyzip/zipfile_writer.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#include <vector>
+
+int main(int argc, const char **argv) {
+  int level = 6;
+  unsigned num_threads = 0;
+  int i = 1;
+  for (; i != argc && argv[i][0] == '-' && argv[i][1]; ++i) {
+    const char *arg = argv[i];
+    if (arg[1] >= '0' && arg[1] <= '9' && !arg[2]) {
+      level = arg[1] - '0';
+    } else if (!strcmp(arg, "-t") && i + 1 != argc) {
+      num_threads = (unsigned)atoi(argv[++i]);
+    } else {
+      return 1;
+    }
+  }
+  if (argc - i < 2) {
+    fprintf(stderr, "usage: zip [-0..9] [-t threads] out.zip files...\n");
+    return 1;
+  }
+
+  FILE *fp = fopen(argv[i], "wb");
+  if (!fp) {
+    fprintf(stderr, "can't create %s\n", argv[i]);
+    return 1;
+  }
+
+  andyzip::zipfile_writer writer([fp](const uint8_t *data, size_t size) { fwrite(data, 1, size, fp); }, level, num_threads);
+  for (++i; i != argc; ++i) {
+    if (!strcmp(argv[i], "-")) {
+      writer.begin_member("-", andyzip::zipfile_writer::automatic, andyzip::zipfile_writer::dos_date_time(time(nullptr)));
+      uint8_t buf[65536];
+      for (size_t n; (n = fread(buf, 1, sizeof(buf), stdin)) != 0; ) writer.write(buf, n);
+      writer.end_member();
+      continue;
+    }
+    std::ifstream is(argv[i], std::ios::binary);
+    struct stat st;
+    if (!is || stat(argv[i], &st)) {
+      fprintf(stderr, "can't open %s\n", argv[i]);
+      continue;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    writer.add(argv[i], std::move(data), andyzip::zipfile_writer::automatic, andyzip::zipfile_writer::dos_date_time(st.st_mtime));
+  }
+  writer.finish();
+  fclose(fp);
+}
@@ -92,4 +92,8 @@ int main() {
   auto entries = reader.dir_entries();
   std::vector<uint8_t> text2 = reader.read_entry(entries[0]);
   std::cout.write((const char*)text2.data(), text2.size());
+
+  for (auto e : reader.entries()) {
+    printf("%.*s %llu bytes, %llu compressed\n", (int)e.name_size(), e.name(), (unsigned long long)e.size(), (unsigned long long)e.compressed_size());
+  }
 }
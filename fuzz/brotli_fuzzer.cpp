@@ -0,0 +1,36 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// libFuzzer harness for brotli_decoder.
+//
+// Configure with -DANDYZIP_FUZZ=ON using clang, then for example:
+//
+//   ./fuzz/brotli_fuzzer -max_len=65536 corpus/
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <andyzip/brotli_decoder.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  andyzip::brotli_decoder dec;
+  andyzip::brotli_decoder_state state;
+
+  // the first byte chooses a custom dictionary of up to 255 bytes from the end of the input.
+  size_t dictionary_size = size ? std::min((size_t)data[0], size - 1) : 0;
+  const uint8_t *src = data + (size ? 1 : 0);
+  const uint8_t *src_max = data + size - dictionary_size;
+  state.set_dictionary(dictionary_size ? src_max : nullptr, dictionary_size);
+
+  std::vector<char> out(1 << 20);
+  state.src = (const char*)src;
+  state.bitptr = 0;
+  state.bitptr_max = (std::uint32_t)((src_max - src) * 8);
+  state.dest = out.data();
+  state.dest_max = out.data() + out.size();
+  dec.decode(state);
+  return 0;
+}
@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// libFuzzer harness for deflate_decoder.
+//
+// Configure with -DANDYZIP_FUZZ=ON using clang, then for example:
+//
+//   ./fuzz/deflate_fuzzer -max_len=65536 corpus/
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <andyzip/deflate_decoder.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  andyzip::deflate_decoder dec;
+
+  // the first byte chooses a preset dictionary of up to 255 bytes from the end of the input.
+  size_t dictionary_size = size ? std::min((size_t)data[0], size - 1) : 0;
+  const uint8_t *src = data + (size ? 1 : 0);
+  const uint8_t *src_max = data + size - dictionary_size;
+
+  std::vector<uint8_t> out;
+  dec.decode_append(out, src, src_max, 0, dictionary_size ? src_max : nullptr, dictionary_size);
+
+  // and block by block into a small fixed buffer.
+  std::vector<uint8_t> buffer(4096);
+  andyzip::deflate_decoder::block_state s;
+  s.src = src;
+  s.bit = 0;
+  s.src_max = src_max;
+  s.dest_begin = s.dest = buffer.data();
+  s.dest_max = buffer.data() + buffer.size();
+  while (dec.decode_block(s) && !s.is_last) {
+  }
+  return 0;
+}
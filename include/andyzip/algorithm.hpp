@@ -1,4 +1,3 @@
-
 ////////////////////////////////////////////////////////////////////////////////
 //
 // (C) Andy Thomason 2012-2016
@@ -6,27 +5,28 @@
 // Autocorrelation entropy test
 
 
-#ifndef MINIZIP_ALGORITHM_INCLUDED
-#define MINIZIP_ALGORITHM_INCLUDED
+#ifndef ANDYZIP_ALGORITHM_HPP_
+#define ANDYZIP_ALGORITHM_HPP_
+
+#include <andyzip/autocorr.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
-#include <cmath>
+#include <initializer_list>
 #include <vector>
 
 namespace andyzip {
   // Get a measure of how correlated the data is at various stride levels.
-  void abs_correlation(std::vector<int> &result, const uint8_t *begin, const uint8_t *end, const std::initializer_list<int> &values) {
+  inline void abs_correlation(std::vector<int> &result, const uint8_t *begin, const uint8_t *end, const std::initializer_list<int> &values) {
     result.clear();
+    if (values.size() == 0) return;
+    std::vector<size_t> sums((size_t)std::max(0, std::max(values)) + 1);
+    autocorrelate(sums.data(), sums.size(), begin, end);
     for (auto n : values) {
-      int value = 0;
-      for (auto p = begin; p < end - n; ++p) {
-        value += std::abs((int8_t)(p[0] - p[n]));
-      }
-      result.push_back(value);
+      result.push_back(n > 0 ? (int)sums[n] : 0);
     }
-  };
-
+  }
 }
 
 #endif
@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Compressibility analysis.
+//
+// analyse() estimates how a buffer will compress without compressing it, to choose
+// a method per file:
+//
+//   andyzip::data_analysis a = andyzip::analyse(data, data + size);
+//   switch (a.suggested) {
+//     case andyzip::data_analysis::stored: ...
+//     case andyzip::data_analysis::delta_deflate: ... delta at a.stride, then deflate
+//     case andyzip::data_analysis::brotli: ...
+//   }
+//
+// Large inputs are sampled: max_sample bytes in 64K chunks spread evenly over the input.
+//
+
+#ifndef ANDYZIP_ANALYSIS_HPP_
+#define ANDYZIP_ANALYSIS_HPP_
+
+#include <andyzip/autocorr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace andyzip {
+  struct data_analysis {
+    enum method { stored, delta_deflate, brotli };
+
+    size_t size;            // of the input
+    size_t sampled;         // bytes analysed
+    double order0_entropy;  // bits per byte
+    double order1_entropy;  // bits per byte given the byte before
+    unsigned stride;        // record size, or 0 if there is no clear one
+    double delta_entropy;   // order 0 entropy after subtracting the byte stride before
+    double text_fraction;   // printable ASCII and whitespace
+    method suggested;
+  };
+
+  namespace detail {
+    inline double entropy(const uint32_t *counts, size_t num_counts, size_t total) {
+      double bits = 0;
+      for (size_t i = 0; i != num_counts; ++i) {
+        if (counts[i]) bits -= counts[i] * std::log2((double)counts[i] / total);
+      }
+      return total ? bits / total : 0;
+    }
+  }
+
+  // Shannon entropy of the byte frequencies in bits per byte.
+  inline double order0_entropy(const uint8_t *begin, const uint8_t *end) {
+    uint32_t counts[256] = {0};
+    for (const uint8_t *p = begin; p != end; ++p) counts[*p]++;
+    return detail::entropy(counts, 256, (size_t)(end - begin));
+  }
+
+  // Entropy of each byte given the one before, in bits per byte.
+  // With fewer than a few million bytes this is an underestimate as many contexts are seen only a few times.
+  inline double order1_entropy(const uint8_t *begin, const uint8_t *end) {
+    if (end - begin < 2) return 0;
+    std::vector<uint32_t> counts(256 * 256);
+    uint32_t context_counts[256] = {0};
+    for (const uint8_t *p = begin + 1; p != end; ++p) {
+      counts[p[-1] * 256 + p[0]]++;
+      context_counts[p[-1]]++;
+    }
+    // H(X|Y) = H(X,Y) - H(Y)
+    size_t total = (size_t)(end - begin - 1);
+    return detail::entropy(counts.data(), counts.size(), total) - detail::entropy(context_counts, 256, total);
+  }
+
+  // Order 0 entropy of p[i] - p[i-stride].
+  inline double delta_entropy(const uint8_t *begin, const uint8_t *end, unsigned stride) {
+    if (stride == 0 || (size_t)(end - begin) <= stride) return order0_entropy(begin, end);
+    uint32_t counts[256] = {0};
+    for (const uint8_t *p = begin + stride; p != end; ++p) counts[(uint8_t)(p[0] - p[-(int)stride])]++;
+    return detail::entropy(counts, 256, (size_t)(end - begin) - stride);
+  }
+
+  // The record size of the data, or 0 if it has none, from the mean byte difference at
+  // strides up to max_stride. A stride must be clearly better than the average to count
+  // and the smallest of the near-best strides wins, so that multiples of the record size are not chosen.
+  inline unsigned detect_stride(const uint8_t *begin, const uint8_t *end, unsigned max_stride = 64) {
+    size_t size = (size_t)(end - begin);
+    if (max_stride < 1 || size < 4 * (size_t)max_stride) return 0;
+    std::vector<size_t> sums(max_stride + 1);
+    autocorrelate(sums.data(), sums.size(), begin, end);
+
+    std::vector<double> mean(max_stride + 1);
+    double average = 0, best = 1e30;
+    for (unsigned n = 1; n <= max_stride; ++n) {
+      mean[n] = (double)sums[n] / (size - n);
+      average += mean[n];
+      best = std::min(best, mean[n]);
+    }
+    average /= max_stride;
+    if (best > average * 0.75) return 0;
+    for (unsigned n = 1; n <= max_stride; ++n) {
+      if (mean[n] <= best * 1.1) return n;
+    }
+    return 0;
+  }
+
+  // Copy up to max_sample bytes of [begin, end) in chunks spread evenly over it.
+  inline std::vector<uint8_t> sample(const uint8_t *begin, const uint8_t *end, size_t max_sample, size_t chunk_size = 65536) {
+    size_t size = (size_t)(end - begin);
+    if (size <= max_sample || max_sample < chunk_size) {
+      return std::vector<uint8_t>(begin, begin + std::min(size, max_sample));
+    }
+    std::vector<uint8_t> result;
+    result.reserve(max_sample);
+    size_t num_chunks = max_sample / chunk_size;
+    for (size_t i = 0; i != num_chunks; ++i) {
+      size_t offset = (size - chunk_size) / std::max((size_t)1, num_chunks - 1) * i;
+      result.insert(result.end(), begin + offset, begin + offset + chunk_size);
+    }
+    return result;
+  }
+
+  inline data_analysis analyse(const uint8_t *begin, const uint8_t *end, size_t max_sample = 1 << 20) {
+    std::vector<uint8_t> data = sample(begin, end, max_sample);
+    const uint8_t *b = data.data(), *e = data.data() + data.size();
+
+    data_analysis a;
+    a.size = (size_t)(end - begin);
+    a.sampled = data.size();
+    a.order0_entropy = order0_entropy(b, e);
+    a.order1_entropy = order1_entropy(b, e);
+    a.stride = detect_stride(b, e);
+    a.delta_entropy = a.stride ? delta_entropy(b, e, a.stride) : a.order0_entropy;
+
+    size_t text = 0;
+    for (auto c : data) text += (c >= 0x20 && c < 0x7f) || c == '\n' || c == '\r' || c == '\t';
+    a.text_fraction = data.empty() ? 0 : (double)text / data.size();
+
+    // Random or already compressed data has close to eight bits of order 0 entropy
+    // and no structure for delta coding to find.
+    if (a.order0_entropy > 7.9 && a.delta_entropy > 7.9) {
+      a.suggested = data_analysis::stored;
+    } else if (a.stride && a.text_fraction < 0.9 && a.delta_entropy < a.order0_entropy * 0.9) {
+      a.suggested = data_analysis::delta_deflate;
+    } else {
+      a.suggested = data_analysis::brotli;
+    }
+    return a;
+  }
+}
+
+#endif
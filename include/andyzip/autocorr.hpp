@@ -1,17 +1,29 @@
-
 ////////////////////////////////////////////////////////////////////////////////
 //
 // (C) Andy Thomason 2012-2016
 //
 // Autocorrelation entropy test
+//
+// autocorrelate() measures how alike the data is with itself shifted by each
+// stride from 1 to num_results-1: the sum of |(int8_t)(p[i] - p[i+n])|.
+// Record-structured data such as tables of integers or pixels has a small sum
+// at its record size. All strides are done in one pass over the data, a few KB
+// at a time so that the shifted loads come from L1. Uses SSE2 on x86-64.
+//
 
+#ifndef ANDYZIP_AUTOCORR_HPP_
+#define ANDYZIP_AUTOCORR_HPP_
 
-#ifndef MINIZIP_ALGORITHM_INCLUDED
-#define MINIZIP_ALGORITHM_INCLUDED
-
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define ANDYZIP_AUTOCORR_SSE2 1
+#endif
+
 namespace andyzip {
   template<class T>
   class range {
@@ -25,17 +37,41 @@ namespace andyzip {
     T end_;
   };
 
+  // result[n] is the sum of |(int8_t)(p[i] - p[i+n])| over [begin,end). result[0] is zero.
+  inline void autocorrelate(size_t *result, size_t num_results, const uint8_t *begin, const uint8_t *end) {
+    enum { block_size = 4096 };
+    size_t size = (size_t)(end - begin);
+    std::fill(result, result + num_results, (size_t)0);
 
-  // result[n] is the autocorrelation of sequence [begin,end)
-  void autocorrelate(size_t *result, size_t num_results, const uint8_t *begin, const uint8_t *end) {
-    for (size_t n : range((size_t)0, num_results)) {
-      for (auto p = begin; p != end; p += n) {
-        
+    for (size_t start = 0; start < size; start += block_size) {
+      for (size_t n = 1; n < num_results && n < size; ++n) {
+        // pairs (i, i+n) with i in this block.
+        size_t stop = std::min(start + block_size, size - n);
+        if (stop <= start) break;
+        const uint8_t *p = begin + start;
+        const uint8_t *p_end = begin + stop;
+        size_t sum = 0;
+        #ifdef ANDYZIP_AUTOCORR_SSE2
+          // min(d, -d) as unsigned bytes is |(int8_t)d|, and psadbw sums it.
+          const __m128i zero = _mm_setzero_si128();
+          __m128i acc = zero;
+          for (; p_end - p >= 16; p += 16) {
+            __m128i a = _mm_loadu_si128((const __m128i*)p);
+            __m128i b = _mm_loadu_si128((const __m128i*)(p + n));
+            __m128i d = _mm_sub_epi8(a, b);
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_min_epu8(d, _mm_sub_epi8(zero, d)), zero));
+          }
+          acc = _mm_add_epi64(acc, _mm_srli_si128(acc, 8));
+          sum = (size_t)_mm_cvtsi128_si32(acc);
+        #endif
+        for (; p != p_end; ++p) {
+          int d = (int8_t)(p[0] - p[n]);
+          sum += (size_t)(d < 0 ? -d : d);
+        }
+        result[n] += sum;
       }
     }
-    
-  };
-
+  }
 }
 
 #endif
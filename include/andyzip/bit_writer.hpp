@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// LSB first bit stream writer shared by the encoders.
+//
+
+#ifndef ANDYZIP_BIT_WRITER_HPP_
+#define ANDYZIP_BIT_WRITER_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace andyzip {
+  class bit_writer {
+  public:
+    // Write the low "bits" bits of value. bits must be 56 or less.
+    void write(unsigned bits, uint64_t value) {
+      size_t byte = bitpos_ >> 3;
+      unsigned shift = bitpos_ & 7;
+      if (bytes_.size() < byte + 8) {
+        bytes_.resize(std::max(bytes_.size() * 2, byte + 64));
+      }
+      uint64_t v = value << shift;
+      for (unsigned n = 0; n < shift + bits; n += 8) {
+        bytes_[byte++] |= (uint8_t)(v >> n);
+      }
+      bitpos_ += bits;
+    }
+
+    // Pad with zeros up to the next byte boundary.
+    void align() {
+      bitpos_ = (bitpos_ + 7) & ~(size_t)7;
+    }
+
+    // Copy bytes to a byte aligned stream.
+    void write_bytes(const uint8_t *src, size_t size) {
+      align();
+      size_t byte = bitpos_ >> 3;
+      if (bytes_.size() < byte + size + 8) {
+        bytes_.resize(std::max(bytes_.size() * 2, byte + size + 64));
+      }
+      if (size) memcpy(bytes_.data() + byte, src, size);
+      bitpos_ += size * 8;
+    }
+
+    // Discard everything written after bit position "bitpos".
+    void truncate(size_t bitpos) {
+      size_t end = (bitpos_ + 7) >> 3;
+      size_t byte = bitpos >> 3;
+      if (byte < end) {
+        bytes_[byte] &= (uint8_t)((1 << (bitpos & 7)) - 1);
+        std::fill(bytes_.begin() + byte + 1, bytes_.begin() + end, 0);
+      }
+      bitpos_ = bitpos;
+    }
+
+    size_t bit_size() const { return bitpos_; }
+    size_t byte_size() const { return (bitpos_ + 7) >> 3; }
+    const uint8_t *data() const { return bytes_.data(); }
+  private:
+    std::vector<uint8_t> bytes_;
+    size_t bitpos_ = 0;
+  };
+}
+
+#endif
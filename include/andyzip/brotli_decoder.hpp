@@ -13,17 +13,50 @@
 #ifndef _ANDYZIP_BROTLI_DECODER_HPP_
 #define _ANDYZIP_BROTLI_DECODER_HPP_
 
+#include <andyzip/decoder_policy.hpp>
+#include <andyzip/decoder_stats.hpp>
 #include <andyzip/huffman_table.hpp>
 
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <vector>
 #include <array>
 #include <algorithm>
+#include <limits>
+#include <memory>
 
 #include <andyzip/brotli_data.hpp>
 
 namespace andyzip {
+  // Storage for decoder tables and buffers that is kept between meta-blocks and streams.
+  // Unlike std::vector, resizing does not zero or preserve the contents
+  // and the storage only ever grows.
+  template <class T>
+  class decoder_arena {
+  public:
+    void resize(size_t size) {
+      if (size > capacity_) {
+        capacity_ = std::max(size, capacity_ * 2);
+        data_.reset(new T[capacity_]);
+      }
+      size_ = size;
+    }
+
+    T *data() { return data_.get(); }
+    const T *data() const { return data_.get(); }
+    size_t size() const { return size_; }
+    size_t capacity_bytes() const { return capacity_ * sizeof(T); }
+    T &operator[](size_t i) { return data_[i]; }
+    const T &operator[](size_t i) const { return data_[i]; }
+  private:
+    std::unique_ptr<T[]> data_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+  };
+
+  // Decoder state for one stream. This can be reused for many streams
+  // (see reset()) to avoid allocating tables and buffers each time.
   struct brotli_decoder_state {
     enum class error_code {
       ok = 0,
@@ -32,57 +65,141 @@ namespace andyzip {
       end = 3,
       huffman_length_error = 4,
       context_map_error = 5,
+      output_full = 6,
+    };
+
+    // Where we are in the stream, so that decoding can be resumed between commands.
+    enum class stage {
+      start,
+      meta_block_header,
+      commands,
+      done,
     };
 
     enum {
       max_types = 256,
-      dump_bits = 0,
+      max_distance_alphabet_size = 16 + (15 << 3) + (48 << 3),
+      max_context_map_alphabet_size = 256 + 16,
     };
 
-    FILE *log_file = nullptr;
     const char *src = nullptr;
     std::uint32_t bitptr = 0;
     std::uint32_t bitptr_max = 0;
     char *dest = 0;
     char *dest_max = 0;
     error_code error;
+    stage next = stage::start;
     int max_backward_distance = 0;
     int num_types[3];
     int last_block_type[3];
     int block_type[3];
     int block_len[3];
     uint8_t context_mode[max_types];
-    uint8_t literal_context_map[256]; // todo: what is the max size?
-    uint8_t distance_context_map[256];
+    uint8_t literal_context_map[max_types << 6];
+    uint8_t distance_context_map[max_types << 2];
     uint64_t bytes_written = 0;
-    std::vector<uint8_t> ring_buffer;
+    decoder_arena<uint8_t> ring_buffer;
     andyzip::huffman_table<256+2> block_type_tables[3];
     andyzip::huffman_table<26> block_count_tables[3];
 
+    // current meta-block
+    uint64_t pos = 0;
+    uint64_t meta_block_end = 0;
+    bool is_last = false;
+    int npostfix = 0;
+    int ndirect = 0;
+    int last_distances[4];
+    int last_distance_idx = 0;
+    decoder_arena<andyzip::huffman_table<256>> literal_tables;
+    decoder_arena<andyzip::huffman_table<704>> iandc_tables;
+    decoder_arena<andyzip::huffman_table<max_distance_alphabet_size>> distance_tables;
+
+    // Optional custom dictionary. This behaves as if it had been decoded
+    // just before the stream, so back references can reach into it.
+    // It is read in place and must outlive the decode; reset() keeps it.
+    const uint8_t *dictionary = nullptr;
+    size_t dictionary_size = 0;
+
+    // Counters for the current stream, filled in by decoders with a with_stats policy.
+    decoder_stats stats;
+
+    void set_dictionary(const void *data, size_t size) {
+      dictionary = (const uint8_t*)data;
+      dictionary_size = data ? size : 0;
+    }
+
+    // Rewind to decode a new stream, keeping the tables and ring buffer.
+    void reset() {
+      src = nullptr;
+      bitptr = 0;
+      bitptr_max = 0;
+      dest = nullptr;
+      dest_max = nullptr;
+      error = error_code::ok;
+      next = stage::start;
+      bytes_written = 0;
+      pos = 0;
+    }
+
+    // Allocate everything needed for streams with windows up to 1 << lg_window_size
+    // so that decoding does not allocate. Tables are sized for the worst case.
+    // Call this between streams.
+    void reserve(int lg_window_size) {
+      ring_buffer.resize((size_t)1 << lg_window_size);
+      literal_tables.resize(max_types);
+      iandc_tables.resize(max_types);
+      distance_tables.resize(max_types);
+    }
+
+    // Bytes of table and buffer storage held by this state.
+    // As storage only grows this is also the peak.
+    size_t peak_memory() const {
+      return
+        sizeof(*this) +
+        ring_buffer.capacity_bytes() +
+        literal_tables.capacity_bytes() +
+        iandc_tables.capacity_bytes() +
+        distance_tables.capacity_bytes()
+      ;
+    }
+
+    template <bool Checked = true>
     int read(int bits) {
-      int value = peek(bits);
-      if (dump_bits) {
-        fprintf(log_file, "[BrotliReadBits]  %d %d %d val: %6x\n", (bitptr_max - bitptr - bits)/8, 24+(bitptr&7), bits, value);
-      }
+      int value = peek<Checked>(bits);
       bitptr += bits;
       return value;
     }
 
-    int peek(int bits) {
-      //if (bitptr + bits > bitptr_max) { error = error_code::need_more_input; return 0; }
+    // The input is read four bytes at a time. When checked, bytes past bitptr_max read as
+    // zero near the end and the decoder fails once it has used them (see overrun()).
+    // Unchecked reads need four bytes of slack after the input.
+    template <bool Checked = true>
+    int peek(int bits) const {
       auto i = bitptr >> 3, j = bitptr & 7;
-      int value = (int)( (unsigned&)src[i] >> j ) & ( (1u << bits) - 1 );
+      std::uint32_t word = 0;
+      if (!Checked || i + 4 <= bitptr_max >> 3) {
+        memcpy(&word, src + i, 4);
+      } else {
+        for (std::uint32_t k = 0; k != 4 && i + k < bitptr_max >> 3; ++k) word |= (std::uint32_t)(uint8_t)src[i+k] << (k*8);
+      }
+      int value = (int)( word >> j ) & ( (1u << bits) - 1 );
       return value;
     }
 
+    bool overrun() const {
+      return bitptr > bitptr_max;
+    }
+
     void drop(int bits) {
       bitptr += bits;
     }
   };
 
-  class brotli_decoder {
+  // Policy is checked_input or trusted_input, optionally with_stats (see decoder_policy.hpp).
+  template <class Policy>
+  class basic_brotli_decoder {
     enum {
-      debug = 0,
+      checked = Policy::checked,
       window_gap = 16,
       literal_context_bits = 6,
       distance_context_bits = 2,
@@ -96,38 +213,51 @@ namespace andyzip {
       idx_L, idx_I, idx_D
     };
 
+    // The state's counters if Policy is with_stats, otherwise a no_decoder_stats that ignores them.
+    typedef typename std::conditional<Policy::stats, decoder_stats &, no_decoder_stats>::type stats_ref;
+
+    static stats_ref stats(brotli_decoder_state &s) {
+      return s.stats;
+    }
+
     static unsigned read_window_size(brotli_decoder_state &s) {
-      auto w0 = s.read(1);
+      auto w0 = s.read<checked>(1);
       if (s.error != error_code::ok) return 0; 
       if (w0 == 0) {
         return 16;
       }
 
-      auto w13 = s.read(3);
+      auto w13 = s.read<checked>(3);
       if (s.error != error_code::ok) return 0; 
       if (w13 != 0) {
         return w13 + 17;
       }
 
-      auto w47 = s.read(4);
+      auto w46 = s.read<checked>(3);
       if (s.error != error_code::ok) return 0; 
 
-      return w47 ? w47 + 10 - 2 : 17;
+      // one is reserved for large windows.
+      if (w46 == 1) {
+        s.error = error_code::syntax_error;
+        return 0;
+      }
+
+      return w46 == 0 ? 17 : w46 + 8;
     }
 
     // read a value from 1 to 256
     int read_256(brotli_decoder_state &s) {
-      int nlt0 = s.read(1);
+      int nlt0 = s.read<checked>(1);
       if (s.error != error_code::ok) return 0; 
 
       if (!nlt0) return 1;
 
-      int nlt14 = s.read(3);
+      int nlt14 = s.read<checked>(3);
       if (s.error != error_code::ok) return 0; 
 
       if (!nlt14) return 2;
 
-      int nlt5x = s.read(nlt14);
+      int nlt5x = s.read<checked>(nlt14);
       if (s.error != error_code::ok) return 0; 
 
       return (1 << nlt14) + nlt5x + 1;
@@ -162,20 +292,22 @@ namespace andyzip {
 
     template <class Table>
     static void read_huffman_code(brotli_decoder_state &s, Table &table, int alphabet_size) {
-      int code_type = s.read(2);
+      int code_type = s.read<checked>(2);
       if (s.error != error_code::ok) return;
       alphabet_size &= 1023;
-      if (debug) fprintf(s.log_file, "[ReadHuffmanCode] s->sub_loop_counter = %d\n", code_type);
+      stats(s).huffman_build();
       if (code_type == 1) {
         // 3.4.  Simple Prefix Codes
-        int num_symbols = s.read(2) + 1;
+        int num_symbols = s.read<checked>(2) + 1;
         int alphabet_bits = log2_floor(alphabet_size - 1);
         uint16_t symbols[Table::max_codes];
         for (int i = 0; i != num_symbols; ++i) {
-          symbols[i] = (uint16_t)s.read(alphabet_bits);
-          if (debug) fprintf(s.log_file, "[ReadSimpleHuffmanSymbols] s->symbols_lists_array[i] = %d\n", symbols[i]);
+          symbols[i] = (uint16_t)s.read<checked>(alphabet_bits);
+          if (symbols[i] >= alphabet_size) {
+            s.error = error_code::huffman_length_error;
+            return;
+          }
         }
-        if (debug) fprintf(s.log_file, "[ReadHuffmanCode] s->symbol = %d\n", num_symbols-1);
         static const uint8_t simple_lengths[][4] = {
           {0},
           {1, 1},
@@ -183,7 +315,11 @@ namespace andyzip {
           {2, 2, 2, 2},
           {1, 2, 3, 3},
         };
-        int tree_select = num_symbols == 4 ? s.read(1) : 0;
+        int tree_select = num_symbols == 4 ? s.read<checked>(1) : 0;
+
+        // symbols of equal length are assigned codes in symbol order.
+        int first_sorted = num_symbols == 3 ? 1 : num_symbols == 4 && tree_select ? 2 : 0;
+        std::sort(symbols + first_sorted, symbols + num_symbols);
         table.init(simple_lengths[num_symbols - 1 + tree_select], symbols, num_symbols);
       } else {
         // 3.5.  Complex Prefix Codes
@@ -193,7 +329,7 @@ namespace andyzip {
           int space = 0;
           int num_codes = 0;
           for (int i = code_type; i != 18; ++i) {
-            int bits = s.peek(4);
+            int bits = s.peek<checked>(4);
             if (s.error != error_code::ok) return;
 
             static const uint8_t kCodeLengthCodeOrder[18] = {
@@ -212,7 +348,6 @@ namespace andyzip {
             s.drop(kCodeLengthPrefixLength[bits]);
             uint8_t length = kCodeLengthPrefixValue[bits];
             lengths[kCodeLengthCodeOrder[i]] = length;
-            if (debug) fprintf(s.log_file, "[ReadCodeLengthCodeLengths] s->code_length_code_lengths[%d] = %d\n", kCodeLengthCodeOrder[i], lengths[kCodeLengthCodeOrder[i]]);
             if (length) {
               ++num_codes;
               space += 32 >> length;
@@ -220,14 +355,18 @@ namespace andyzip {
             }
           }
           if (num_codes != 1 && space != 32) {
-            if (debug) fprintf(s.log_file, "bad\n");
             s.error = error_code::huffman_length_error;
             return;
           }
 
-          complex_table.init(lengths, nullptr, 18);
+          if (num_codes == 1) {
+            // a single code length code uses zero bits.
+            uint16_t symbol = (uint16_t)(std::find_if(lengths, lengths + 18, [](uint8_t l) { return l != 0; }) - lengths);
+            complex_table.init(lengths, &symbol, 1);
+          } else {
+            complex_table.init(lengths, nullptr, 18);
+          }
           if (complex_table.invalid()) {
-            if (debug) fprintf(s.log_file, "bad2\n");
             s.error = error_code::huffman_length_error;
             return;
           }
@@ -242,16 +381,12 @@ namespace andyzip {
           int repeat_code_len = 0;
           int i = 0;
           for(; i < alphabet_size && space < 32768;) {
-            auto code = complex_table.decode(s.peek(16));
+            auto code = complex_table.decode(s.peek<checked>(16));
             s.drop(code.first);
             int code_len = code.second;
             if (code_len < 16) {
-              if (code_len) {
-                if (debug) fprintf(s.log_file, "[ReadHuffmanCode] code_length[%d] = %d\n", i, code_len);
-              }
               if (i + 1 > alphabet_size) {
                 s.error = error_code::huffman_length_error;
-                if (debug) fprintf(s.log_file, "bad3\n");
                 return;
               }
               lengths[i++] = (uint8_t)code_len;
@@ -263,7 +398,7 @@ namespace andyzip {
             } else {
               int extra_bits = code_len == 16 ? 2 : 3;
               int new_len = code_len == 16 ? prev_code_len : 0;
-              int repeat_delta = s.peek(extra_bits);
+              int repeat_delta = s.peek<checked>(extra_bits);
               s.drop(extra_bits);
 
               if (repeat_code_len != new_len) {
@@ -280,9 +415,7 @@ namespace andyzip {
               repeat += repeat_delta + 3;
               repeat_delta = repeat - old_repeat;
 
-              if (debug) fprintf(s.log_file, "[ReadHuffmanCode] code_length[%d..%d] = %d\n", i, i + repeat_delta - 1, new_len);
               if (i + repeat_delta > alphabet_size) {
-                if (debug) fprintf(s.log_file, "bad4 %d %d %d\n", i, repeat_delta, alphabet_size);
                 s.error = error_code::huffman_length_error;
                 return;
               }
@@ -295,14 +428,12 @@ namespace andyzip {
             }
           }
           if (space > 32768) {
-            if (debug) fprintf(s.log_file, "bad5\n");
             s.error = error_code::huffman_length_error;
             return;
           }
           memset(lengths + i, 0, alphabet_size - i);
           table.init(lengths, nullptr, alphabet_size);
           if (table.invalid()) {
-            if (debug) fprintf(s.log_file, "bad6\n");
             s.error = error_code::huffman_length_error;
             return;
           }
@@ -311,21 +442,22 @@ namespace andyzip {
     }
 
     static int read_block_length(brotli_decoder_state &s, int index) {
-      unsigned code = s.peek(16);
+      unsigned code = s.peek<checked>(16);
       auto length_code = s.block_count_tables[index].decode(code);
       s.drop(length_code.first);
       int extra_bits = brotli_data::kBlockLengthPrefixCode[length_code.second].nbits;
-      int value = s.read(extra_bits);
+      int value = s.read<checked>(extra_bits);
       return brotli_data::kBlockLengthPrefixCode[length_code.second].offset + value;
     }
 
     static void read_block_switch_command(brotli_decoder_state &s, int index) {
       int num_types = s.num_types[index];
       if (num_types == 1) return;
+      stats(s).block_switch();
 
       //  read block type using HTREE_BTYPE_D and set BTYPE_D
       // 6.  Encoding of Block-Switch Commands
-      unsigned bits = s.peek(16);
+      unsigned bits = s.peek<checked>(16);
       auto length_code = s.block_type_tables[index].decode(bits);
       s.drop(length_code.first);
       int code = length_code.second;
@@ -333,7 +465,7 @@ namespace andyzip {
       int last = s.last_block_type[index];
 
       int block_type = code == 0 ? last : code == 1 ? cur + 1 : code - 2;
-      if (block_type > num_types) {
+      if (block_type >= num_types) {
         block_type -= num_types;
       }
 
@@ -341,40 +473,32 @@ namespace andyzip {
       s.last_block_type[index] = cur;
       s.block_type[index] = block_type;
 
-      //if (debug) fprintf(s.log_file, "block_type[%d] = {%d, %d}\n", index, cur, block_type);
-
       //  read block count using HTREE_BLEN_D and set BLEN_D
       s.block_len[index] = read_block_length(s, index);
     }
 
     static void read_context_map(brotli_decoder_state &s, uint8_t *context_map, int context_map_size, int num_trees) {
-      if (debug) fprintf(s.log_file, "[DecodeContextMap] context_map_size = %d\n", context_map_size);
-      if (debug) fprintf(s.log_file, "[DecodeContextMap] *num_htrees = %d\n", num_trees);
-
       // if NTREESL >= 2
       if (num_trees >= 2) {
         //  read literal context map, CMAPL[]
-        int bits = s.peek(5);
+        int bits = s.peek<checked>(5);
         if (s.error != error_code::ok) return; 
         int rlemax = (bits & 1) ? (bits >> 1) + 1 : 0;
         s.drop((bits & 1) ? 5 : 1);
-        if (debug) fprintf(s.log_file, "[DecodeContextMap] s->max_run_length_prefix = %d\n", rlemax);
-        andyzip::huffman_table<256> table;
+        andyzip::huffman_table<brotli_decoder_state::max_context_map_alphabet_size> table;
         read_huffman_code(s, table, num_trees + rlemax);
         if (s.error != error_code::ok) return;
         for (int i = 0; i != context_map_size;) {
-          unsigned bits = s.peek(16);
+          unsigned bits = s.peek<checked>(16);
           auto length_value = table.decode(bits);
           s.drop(length_value.first);
           int code = length_value.second;
-          if (debug) fprintf(s.log_file, "[DecodeContextMap] code = %d\n", code);
           if (code == 0) {
             context_map[i++] = (uint8_t)code;
           } else if (code > rlemax) {
             context_map[i++] = (uint8_t)code - rlemax;
           } else {
-            int repeat = s.read(code) + (1 << code);
-            if (debug) fprintf(s.log_file, "[DecodeContextMap] reps = %d\n", repeat);
+            int repeat = s.read<checked>(code) + (1 << code);
             if (i + repeat > context_map_size) {
               s.error = error_code::context_map_error;
               return;
@@ -385,7 +509,7 @@ namespace andyzip {
           }
         }
 
-        int imtf = s.read(1);
+        int imtf = s.read<checked>(1);
         if (s.error != error_code::ok) return; 
         if (imtf) {
           inverse_move_to_front(context_map, context_map_size);
@@ -396,149 +520,227 @@ namespace andyzip {
       }
     }
 
-    int transform_dictionary_word(char *buffer, const uint8_t *src, int transform_idx, int copy_len, int ringbuffer_mask) {
-      char *dest = buffer;
-      auto &t = brotli_data::table[transform_idx];
-      for (const char *psrc = t.prefix; *psrc; ++psrc) {
-        *dest++ = *psrc;
-      }
+    // Precomputed shape of each word transform so that dictionary references
+    // do not need to walk the prefix and suffix strings.
+    struct transform_info {
+      uint8_t prefix_len;
+      uint8_t suffix_len;
+      uint8_t omit_first;
+      uint8_t omit_last;
+      uint8_t ferment;
+    };
 
-      if (t.id >= brotli_data::OmitLast1) {
-        copy_len -= t.id - brotli_data::OmitLast1 + 1;
-      } else if (t.id >= brotli_data::OmitFirst1) {
-        copy_len -= t.id - brotli_data::OmitFirst1 + 1;
-        src += t.id - brotli_data::OmitFirst1 + 1;
-      }
+    enum {
+      num_transforms = sizeof(brotli_data::table) / sizeof(brotli_data::table[0]),
+
+      // longest prefix + longest word + longest suffix
+      max_transformed_word = 5 + 24 + 8,
+    };
 
-      // fermentation (aka. case conversion)
-      if (t.id == brotli_data::FermentFirst || t.id == brotli_data::FermentAll) {
-        uint8_t fermented[24];
-        if (copy_len <= 24) {
-          memcpy(fermented, src, copy_len);
+    static const transform_info *transforms() {
+      struct builder {
+        transform_info info[num_transforms];
+        builder() {
+          for (int i = 0; i != num_transforms; ++i) {
+            auto &t = brotli_data::table[i];
+            transform_info &r = info[i];
+            r.prefix_len = (uint8_t)strlen(t.prefix);
+            r.suffix_len = (uint8_t)strlen(t.suffix);
+            r.omit_first = t.id >= brotli_data::OmitFirst1 && t.id < brotli_data::OmitLast1 ? t.id - brotli_data::OmitFirst1 + 1 : 0;
+            r.omit_last = t.id >= brotli_data::OmitLast1 ? t.id - brotli_data::OmitLast1 + 1 : 0;
+            r.ferment = t.id == brotli_data::FermentFirst || t.id == brotli_data::FermentAll ? t.id : 0;
+          }
         }
-  
-        for (int i = 0; i < copy_len;) {
-          uint8_t chr = src[i];
-          if (chr < 192) {
-            if (chr >= 97 && chr <= 122) {
-              fermented[i] ^= 32;
-            }
-            ++i;
-          } else if (chr < 224) {
-            if (i + 1 < copy_len) {
-              fermented[i+1] ^= 32;
-            }
-            i += 2;
-          } else {
-            if (i + 2 < copy_len) {
-              fermented[i+2] ^= 32;
-            }
-            i += 3;
+      };
+      static const builder b;
+      return b.info;
+    }
+
+    // fermentation (aka. case conversion)
+    static void ferment(uint8_t *word, int len, bool all) {
+      for (int i = 0; i < len;) {
+        uint8_t chr = word[i];
+        if (chr < 192) {
+          if (chr >= 97 && chr <= 122) {
+            word[i] ^= 32;
+          }
+          ++i;
+        } else if (chr < 224) {
+          if (i + 1 < len) {
+            word[i+1] ^= 32;
           }
-          if (t.id == brotli_data::FermentFirst) break;
+          i += 2;
+        } else {
+          if (i + 2 < len) {
+            word[i+2] ^= 5;
+          }
+          i += 3;
         }
-        src = fermented;
+        if (!all) break;
       }
+    }
 
-      for (int i = 0; i != copy_len; ++i) {
-        *dest++ = *src++;
+    // Write a transformed dictionary word to dest, which must have room for max_transformed_word bytes.
+    static int transform_dictionary_word(uint8_t *dest, const uint8_t *src, int transform_idx, int copy_len) {
+      auto &t = brotli_data::table[transform_idx];
+      const transform_info &info = transforms()[transform_idx];
+
+      // Identity: the most common case by far.
+      if (transform_idx == 0) {
+        memcpy(dest, src, copy_len);
+        return copy_len;
       }
 
-      for (const char *dsrc = t.suffix; *dsrc; ++dsrc) {
-        *dest++ = *dsrc;
+      uint8_t *p = dest;
+      memcpy(p, t.prefix, info.prefix_len);
+      p += info.prefix_len;
+
+      int len = copy_len - info.omit_first - info.omit_last;
+      if (len > 0) {
+        memcpy(p, src + info.omit_first, len);
+        if (info.ferment) ferment(p, len, info.ferment == brotli_data::FermentAll);
+        p += len;
       }
 
-      return (int)(dest - buffer);
+      memcpy(p, t.suffix, info.suffix_len);
+      p += info.suffix_len;
+
+      return (int)(p - dest);
     }
-  public:
-    brotli_decoder() {
+    // Write out the part of the ring buffer decoded since the last flush.
+    static void flush(brotli_decoder_state &s) {
+      size_t ring_size = s.ring_buffer.size();
+      while (s.bytes_written != s.pos) {
+        size_t start = (size_t)s.bytes_written & (ring_size - 1);
+        size_t len = (size_t)std::min<uint64_t>(s.pos - s.bytes_written, ring_size - start);
+        if (s.dest) {
+          if (len > (size_t)(s.dest_max - s.dest)) {
+            s.error = error_code::output_full;
+            return;
+          }
+          memcpy(s.dest, s.ring_buffer.data() + start, len);
+          s.dest += len;
+        }
+        s.bytes_written += len;
+      }
     }
 
-    // decode some input bits and return -1 if we need more input.
-    brotli_decoder_state::error_code decode(brotli_decoder_state &s) {
-      typedef brotli_decoder_state::error_code error_code;
-      // https://tools.ietf.org/html/rfc7932
-      s.error = error_code::ok;
-
+    // Read WBITS and set up the ring buffer.
+    static void read_stream_header(brotli_decoder_state &s) {
       // read window size
       unsigned lg_window_size = read_window_size(s);
-      if (s.error != error_code::ok) return s.error;
+      if (s.error != error_code::ok) return;
       s.max_backward_distance = (1 << lg_window_size) - window_gap;
-      if (debug) fprintf(s.log_file, "[BrotliDecoderDecompressStream] s->window_bits = %d\n", lg_window_size);
-      if (debug) fprintf(s.log_file, "[BrotliDecoderDecompressStream] s->pos = %d\n", 0);
+      stats(s).clear();
 
-      s.ring_buffer.resize(1 << lg_window_size);
-      int ringbuffer_mask = (1 << lg_window_size) - 1;
+      // back references cannot reach further than the size of the output,
+      // so small outputs only need a small ring buffer.
+      size_t ring_size = (size_t)1 << lg_window_size;
+      if (s.dest) {
+        while (ring_size > 1024 && ring_size / 2 >= (size_t)(s.dest_max - s.dest)) ring_size /= 2;
+      }
+      s.ring_buffer.resize(ring_size);
+      s.pos = 0;
+      s.bytes_written = 0;
+      s.is_last = false;
+
+      // the last distances persist across meta-blocks.
+      static const int initial_distances[4] = { 16, 15, 11, 4 };
+      std::copy(initial_distances, initial_distances + 4, s.last_distances);
+      s.last_distance_idx = 0;
+      s.next = brotli_decoder_state::stage::meta_block_header;
+    }
+
+    // Read the meta-block header up to and including the prefix codes.
+    void read_meta_block_header(brotli_decoder_state &s) {
+      typedef brotli_decoder_state::stage stage;
 
       //  do
       {
           // read ISLAST bit
-          int is_last = s.read(1);
-          if (s.error != error_code::ok) return s.error;
+          int is_last = s.read<checked>(1);
+          if (s.error != error_code::ok) return;
+          s.is_last = is_last != 0;
 
           // if ISLAST
           if (is_last) {
             //  read ISLASTEMPTY bit
-            int is_last_empty = s.read(1);
-            if (s.error != error_code::ok) return s.error;
+            int is_last_empty = s.read<checked>(1);
+            if (s.error != error_code::ok) return;
 
             //  if ISLASTEMPTY break from loop
-            if (is_last_empty) { s.error = error_code::end; return s.error; }
+            if (is_last_empty) { s.next = stage::done; return; }
           }
 
           // read MNIBBLES
-          int nibbles_code = s.read(2);
-          if (s.error != error_code::ok) return s.error;
+          int nibbles_code = s.read<checked>(2);
+          if (s.error != error_code::ok) return;
 
           // if MNIBBLES is zero
           int mlen = 0;
           if (nibbles_code == 3) {
             //  verify reserved bit is zero
+            if (s.read<checked>(1)) { s.error = error_code::syntax_error; return; }
             //  read MSKIPLEN
+            int skip_bytes = s.read<checked>(2);
+            int skip_len = 0;
+            for (int i = 0; i != skip_bytes; ++i) {
+              skip_len |= s.read<checked>(8) << (i*8);
+            }
+            if (skip_bytes) ++skip_len;
             //  skip any bits up to the next byte boundary
+            s.drop(-(int)s.bitptr & 7);
             //  skip MSKIPLEN bytes
+            s.drop(skip_len * 8);
+            stats(s).block(decoder_stats::metadata_block);
             //  continue to the next meta-block
-            s.error = error_code::syntax_error;
-            return s.error;
+            if (s.is_last) s.next = stage::done;
+            return;
           } else {
             //  read MLEN
             for (int i = 0; i != nibbles_code + 4; ++i) {
-              int val = s.read(4);
-              if (s.error != error_code::ok) return s.error;
+              int val = s.read<checked>(4);
+              if (s.error != error_code::ok) return;
               mlen |= val << (i*4);
             }
             ++mlen;
           }
+          s.meta_block_end = s.pos + mlen;
 
           // if not ISLAST
           if (!is_last) {
             //  read ISUNCOMPRESSED bit
-            int is_uncompressed = s.read(1);
+            int is_uncompressed = s.read<checked>(1);
             //  if ISUNCOMPRESSED
             if (is_uncompressed) {
               // skip any bits up to the next byte boundary
+              s.drop(-(int)s.bitptr & 7);
               // copy MLEN bytes of compressed data as literals
+              if (s.bitptr + mlen * 8 > s.bitptr_max) { s.error = error_code::need_more_input; return; }
+              const uint8_t *src = (const uint8_t*)s.src + s.bitptr / 8;
+              size_t ring_size = s.ring_buffer.size();
+              for (int done = 0; done != mlen;) {
+                size_t start = (size_t)s.pos & (ring_size - 1);
+                size_t len = std::min((size_t)(mlen - done), ring_size - start);
+                memcpy(s.ring_buffer.data() + start, src + done, len);
+                done += (int)len;
+                s.pos += len;
+                if ((s.pos & (ring_size - 1)) == 0) flush(s);
+              }
+              s.drop(mlen * 8);
+              stats(s).block(decoder_stats::stored_block);
               // continue to the next meta-block
-              s.error = error_code::syntax_error;
-              return s.error;
+              return;
             }
           }
 
-          if (debug) fprintf(s.log_file, "[BrotliDecoderDecompressStream] s->is_last_metablock = %d\n", is_last);
-          if (debug) fprintf(s.log_file, "[BrotliDecoderDecompressStream] s->meta_block_remaining_len = %d\n", mlen);
-          if (debug) fprintf(s.log_file, "[BrotliDecoderDecompressStream] s->is_metadata = %d\n", 0);
-          if (debug) fprintf(s.log_file, "[BrotliDecoderDecompressStream] s->is_uncompressed = %d\n", 0);
-
-          enum {
-            idx_L, idx_I, idx_D
-          };
+          stats(s).block(decoder_stats::dynamic_block);
 
           // loop for each three block categories (i = L, I, D)
           for (int i = 0; i != 3; ++i) {
             //  read NBLTYPESi
             int nbltypesi = read_256(s);
-            if (s.error != error_code::ok) return s.error;
-            if (debug) fprintf(s.log_file, "[BrotliDecoderDecompressStream] s->num_block_types[s->loop_counter] = %d\n", nbltypesi);
+            if (s.error != error_code::ok) return;
 
             s.num_types[i] = nbltypesi;
 
@@ -546,17 +748,16 @@ namespace andyzip {
             if (nbltypesi >= 2) {
               // read prefix code for block types, HTREE_BTYPE_i
               read_huffman_code(s, s.block_type_tables[i], nbltypesi + 2);
-              if (s.error != error_code::ok) return s.error;
+              if (s.error != error_code::ok) return;
               // read prefix code for block counts, HTREE_BLEN_i
               read_huffman_code(s, s.block_count_tables[i], block_len_symbols);
-              if (s.error != error_code::ok) return s.error;
+              if (s.error != error_code::ok) return;
               // read block count, BLEN_i
               s.block_len[i] = read_block_length(s, i);
               // set block type, BTYPE_i to 0
               s.block_type[i] = 0;
               // initialize second-to-last and last block types to 0 and 1
               s.last_block_type[i] = 1;
-              if (debug) fprintf(s.log_file, "[BrotliDecoderDecompressStream] s->block_length[s->loop_counter] = %d\n", s.block_len[i]);
             } else {
               // set block type, BTYPE_i to 0
               s.block_type[i] = 0;
@@ -566,230 +767,342 @@ namespace andyzip {
           }
 
           // read NPOSTFIX and NDIRECT
-          int pbits = s.read(6);
-          if (s.error != error_code::ok) return s.error;
-          int NPOSTFIX = pbits & 3;
-          int NDIRECT = (pbits >> 2) << NPOSTFIX;
-          if (s.error != error_code::ok) return s.error;
-          if (debug) fprintf(s.log_file, "[BrotliDecoderDecompressStream] s->num_direct_distance_codes = %d\n", NDIRECT + 16);
-          if (debug) fprintf(s.log_file, "[BrotliDecoderDecompressStream] s->distance_postfix_bits = %d\n", NPOSTFIX);
+          int pbits = s.read<checked>(6);
+          if (s.error != error_code::ok) return;
+          s.npostfix = pbits & 3;
+          s.ndirect = (pbits >> 2) << s.npostfix;
 
           // read array of literal context modes, CMODE[]
           for (int i = 0; i != s.num_types[idx_L]; ++i) {
-            int ctxt = s.read(2) * 2;
-            if (s.error != error_code::ok) return s.error;
+            int ctxt = s.read<checked>(2);
+            if (s.error != error_code::ok) return;
             s.context_mode[i & (brotli_decoder_state::max_types-1)] = ctxt;
-            if (debug) fprintf(s.log_file, "[ReadContextModes] s->context_modes[%d] = %d\n", i, s.context_mode[i]);
           }
 
           // read NTREESL
           int num_literal_htrees = read_256(s);
-          if (s.error != error_code::ok) return s.error;
+          if (s.error != error_code::ok) return;
           read_context_map(s, s.literal_context_map, s.num_types[idx_L] << literal_context_bits, num_literal_htrees);
-          if (s.error != error_code::ok) return s.error;
+          if (s.error != error_code::ok) return;
 
           // read NTREESD
           int num_distance_htrees = read_256(s);
-          if (s.error != error_code::ok) return s.error;
+          if (s.error != error_code::ok) return;
           read_context_map(s, s.distance_context_map, s.num_types[idx_D] << distance_context_bits, num_distance_htrees);
-          if (s.error != error_code::ok) return s.error;
+          if (s.error != error_code::ok) return;
 
           // read array of literal prefix codes, HTREEL[]
-          std::vector<andyzip::huffman_table<256>> literal_tables(num_literal_htrees);
-          for (int i = 0; i != literal_tables.size(); ++i) {
-            read_huffman_code(s, literal_tables[i], 256);
-            if (s.error != error_code::ok) return s.error;
+          s.literal_tables.resize(num_literal_htrees);
+          for (int i = 0; i != num_literal_htrees; ++i) {
+            read_huffman_code(s, s.literal_tables[i], 256);
+            if (s.error != error_code::ok) return;
           }
 
           // read array of insert-and-copy length prefix codes, HTREEI[]
-          std::vector<andyzip::huffman_table<704>> iandc_tables(s.num_types[idx_I]);
-          for (int i = 0; i != iandc_tables.size(); ++i) {
-            read_huffman_code(s, iandc_tables[i], 704);
-            if (s.error != error_code::ok) return s.error;
+          s.iandc_tables.resize(s.num_types[idx_I]);
+          for (int i = 0; i != s.num_types[idx_I]; ++i) {
+            read_huffman_code(s, s.iandc_tables[i], 704);
+            if (s.error != error_code::ok) return;
           }
 
           // read array of distance prefix codes, HTREED[]
-          static const int max_distance_alphabet_size = num_distance_short_codes + (15 << 3) + (48 << 3);
-          std::vector<andyzip::huffman_table<256>> distance_tables(num_distance_htrees);
-          int distance_alphabet_size = 16 + NDIRECT + (48 << NPOSTFIX);
-          for (int i = 0; i != distance_tables.size(); ++i) {
-            read_huffman_code(s, distance_tables[i], distance_alphabet_size);
-            if (s.error != error_code::ok) return s.error;
-          }
-
-          // do
-          int last_distances[4] = { 16, 15, 11, 4 };
-          int last_distance_idx = 0;
-
-          for (int pos = 0; pos < mlen; ) {
-            //  if BLEN_I is zero
-            if (s.block_len[idx_I] == 0) {
-              read_block_switch_command(s, idx_I);
-            }
-            //  decrement BLEN_I
-            s.block_len[idx_I]--;
-
-            //  read insert-and-copy length symbol using HTREEI[BTYPE_I]
-            int peek16 = s.peek(16);
-            auto iandc = iandc_tables[s.block_type[idx_I]].decode(peek16);
-            s.drop(iandc.first);
-
-            //  compute insert length, ILEN, and copy length, CLEN
-            brotli_data::CmdLutElement cmd = brotli_data::kCmdLut[iandc.second];
-            int insert_len =
-              cmd.insert_len_offset + 
-              (cmd.insert_len_extra_bits ? s.read(cmd.insert_len_extra_bits) : 0)
-            ;
-            int copy_len =
-              cmd.copy_len_offset + 
-              (cmd.copy_len_extra_bits ? s.read(cmd.copy_len_extra_bits) : 0)
-            ;
-            //if (debug) fprintf(s.log_file, "{%d %d %d %d} %d\n", last_distances[0], last_distances[1], last_distances[2], last_distances[3], last_distance_idx);
-            if (debug) fprintf(s.log_file, "[ProcessCommandsInternal] pos = %d insert = %d copy = %d\n", pos, insert_len, copy_len);
-
-            //  loop for ILEN
-            int p2 = pos < 2 ? 0 : s.ring_buffer[(pos - 2) & ringbuffer_mask];
-            int p1 = pos < 1 ? 0 : s.ring_buffer[(pos - 1) & ringbuffer_mask];
-            for (int i = 0; i != insert_len && pos < mlen; ++i) {
-              // if BLEN_L is zero
-              if (s.block_len[idx_L] == 0) {
-                read_block_switch_command(s, idx_L);
-              }
-              // decrement BLEN_L
-              s.block_len[idx_L]--;
-
-              // look up context mode CMODE[BTYPE_L]
-              uint8_t cmode = s.context_mode[s.block_type[idx_L]];
-
-              // compute context ID, CIDL from last two uncompressed bytes
-              // 7.1.  Context Modes and Context ID Lookup for Literals
-              // For LSB6:    Context ID = p1 & 0x3f
-              // For MSB6:    Context ID = p1 >> 2
-              // For UTF8:    Context ID = Lut0[p1] | Lut1[p2]
-              // For Signed:  Context ID = (Lut2[p1] << 3) | Lut2[p2]
-              int context_id =
-                cmode < 2 ? (p1 >> cmode*2) & 63 :
-                cmode == 2 ? brotli_data::Lut0[p1] | brotli_data::Lut1[p2] : (brotli_data::Lut2[p1] << 3) | brotli_data::Lut2[p2]
-              ;
-              if (debug) fprintf(s.log_file, "[ProcessCommandsInternal] context = %d\n", context_id);
-
-              // read literal using HTREEL[CMAPL[64*BTYPE_L + CIDL]]
-              int peek16 = s.peek(16);
-              if (debug) fprintf(s.log_file, "%04x\n", peek16);
-              int table = s.literal_context_map[64 * s.block_type[idx_L] + context_id];
-              if (debug) fprintf(s.log_file, "[ProcessCommandsInternal] s->context_map_slice[context] = %d\n", table);
-              auto lit = literal_tables[table].decode(peek16);
-              s.drop(lit.first);
-
-              // write literal to uncompressed stream
-              uint8_t value = (uint8_t)lit.second;
-              if (debug) fprintf(s.log_file, "[ProcessCommandsInternal] s->ringbuffer[%d] = %d\n", pos, value);
-              s.ring_buffer[pos & ringbuffer_mask] = value;
-              p2 = p1;
-              p1 = value;
-              pos++;
-            }
+          s.distance_tables.resize(num_distance_htrees);
+          int distance_alphabet_size = 16 + s.ndirect + (48 << s.npostfix);
+          for (int i = 0; i != num_distance_htrees; ++i) {
+            read_huffman_code(s, s.distance_tables[i], distance_alphabet_size);
+            if (s.error != error_code::ok) return;
+          }
 
-            // if number of uncompressed bytes produced in the loop for
-            if (pos >= mlen) {
-              // this meta-block is MLEN, then break from loop (in this
-              // case the copy length is ignored and can have any value)
-              break;
-            }
+          s.next = stage::commands;
+      }
+    }
 
-            // 4.  Encoding of Distances
+    // Byte "back" places before output position pos (< back) taken from the
+    // custom dictionary, or zero if there is none.
+    static int prefix_byte(const brotli_decoder_state &s, uint64_t pos, int back) {
+      size_t before = (size_t)(back - pos);
+      return before <= s.dictionary_size ? s.dictionary[s.dictionary_size - before] : 0;
+    }
 
-            // if distance code is implicit zero from insert-and-copy code
-            int distance = 0;
-            bool is_dictionary_ref = false;
-            if (cmd.distance_code == 0) {
-              // set backward distance to the last distance
-              distance = last_distances[(last_distance_idx-1) & 3];
-            } else {
-              // if BLEN_D is zero
-              if (s.block_len[idx_D] == 0) {
-                read_block_switch_command(s, idx_D);
-              }
-              // decrement BLEN_D
-              s.block_len[idx_D]--;
-
-              // compute context ID, CIDD from CLEN
-              // read distance code using HTREED[CMAPD[4*BTYPE_D + CIDD]]
-              int peek16 = s.peek(16);
-              int table = s.distance_context_map[4 * s.block_type[idx_D] + cmd.context];
-              auto dist = distance_tables[table].decode(peek16);
-              int dcode = dist.second;
-              s.drop(dist.first);
-
-              if (dcode < 16) {
-                // compute distance by distance short code substitution
-                uint8_t subst = brotli_data::distance_table[dcode];
-                int base = last_distances[(last_distance_idx - (subst >> 4)) & 3];
-                distance = base + (subst & 0x0f) - 4;
-              } else if (dcode - NDIRECT - 16 < 0) {
-                distance = dcode - 15;
-              } else {
-                int ndistbits = 1 + ((dcode - NDIRECT - 16) >> (NPOSTFIX + 1));
-                int dextra = s.read(ndistbits);
-                int POSTFIX_MASK = (1 << NPOSTFIX) - 1;
-                int hcode = (dcode - NDIRECT - 16) >> NPOSTFIX;
-                int lcode = (dcode - NDIRECT - 16) & POSTFIX_MASK;
-                int offset = ((2 + (hcode & 1)) << ndistbits) - 4;
-                distance = ((offset + dextra) << NPOSTFIX) + lcode + NDIRECT + 1;
-              }
+    // Decode up to max_commands insert-and-copy commands of the current meta-block.
+    void decode_commands(brotli_decoder_state &s, int max_commands) {
+      typedef brotli_decoder_state::stage stage;
+
+      uint8_t *ring_buffer = s.ring_buffer.data();
+      size_t ringbuffer_mask = s.ring_buffer.size() - 1;
+      uint64_t pos = s.pos;
+      uint64_t mlen = s.meta_block_end;
+      int NPOSTFIX = s.npostfix;
+      int NDIRECT = s.ndirect;
+
+      // do
+      for (; pos < mlen && max_commands; --max_commands) {
+        if (checked && s.overrun()) {
+          s.error = error_code::need_more_input;
+          return;
+        }
 
-              is_dictionary_ref = distance > pos;
+        //  if BLEN_I is zero
+        if (s.block_len[idx_I] == 0) {
+          read_block_switch_command(s, idx_I);
+        }
+        //  decrement BLEN_I
+        s.block_len[idx_I]--;
+
+        //  read insert-and-copy length symbol using HTREEI[BTYPE_I]
+        int peek16 = s.peek<checked>(16);
+        auto iandc = s.iandc_tables[s.block_type[idx_I]].decode(peek16);
+        s.drop(iandc.first);
+        stats(s).code(iandc.first);
+
+        //  compute insert length, ILEN, and copy length, CLEN
+        brotli_data::CmdLutElement cmd = brotli_data::kCmdLut[iandc.second];
+        int insert_len =
+          cmd.insert_len_offset + 
+          (cmd.insert_len_extra_bits ? s.read<checked>(cmd.insert_len_extra_bits) : 0)
+        ;
+        int copy_len =
+          cmd.copy_len_offset + 
+          (cmd.copy_len_extra_bits ? s.read<checked>(cmd.copy_len_extra_bits) : 0)
+        ;
+
+        //  loop for ILEN
+        int p2 = pos >= 2 ? ring_buffer[(pos - 2) & ringbuffer_mask] : prefix_byte(s, pos, 2);
+        int p1 = pos >= 1 ? ring_buffer[(pos - 1) & ringbuffer_mask] : prefix_byte(s, pos, 1);
+        for (int i = 0; i != insert_len && pos < mlen; ++i) {
+          // if BLEN_L is zero
+          if (s.block_len[idx_L] == 0) {
+            read_block_switch_command(s, idx_L);
+          }
+          // decrement BLEN_L
+          s.block_len[idx_L]--;
+
+          // look up context mode CMODE[BTYPE_L]
+          uint8_t cmode = s.context_mode[s.block_type[idx_L]];
+
+          // compute context ID, CIDL from last two uncompressed bytes
+          // 7.1.  Context Modes and Context ID Lookup for Literals
+          // For LSB6:    Context ID = p1 & 0x3f
+          // For MSB6:    Context ID = p1 >> 2
+          // For UTF8:    Context ID = Lut0[p1] | Lut1[p2]
+          // For Signed:  Context ID = (Lut2[p1] << 3) | Lut2[p2]
+          int context_id =
+            cmode == 0 ? p1 & 63 :
+            cmode == 1 ? p1 >> 2 :
+            cmode == 2 ? brotli_data::Lut0[p1] | brotli_data::Lut1[p2] : (brotli_data::Lut2[p1] << 3) | brotli_data::Lut2[p2]
+          ;
+
+          // read literal using HTREEL[CMAPL[64*BTYPE_L + CIDL]]
+          int peek16 = s.peek<checked>(16);
+          int table = s.literal_context_map[64 * s.block_type[idx_L] + context_id];
+          auto lit = s.literal_tables[table].decode(peek16);
+          s.drop(lit.first);
+          stats(s).code(lit.first);
+          stats(s).literal();
+
+          // write literal to uncompressed stream
+          uint8_t value = (uint8_t)lit.second;
+          ring_buffer[pos & ringbuffer_mask] = value;
+          p2 = p1;
+          p1 = value;
+          pos++;
+          if ((pos & ringbuffer_mask) == 0) { s.pos = pos; flush(s); }
+        }
 
-              // if distance code is not zero,
-              if (dcode != 0 && !is_dictionary_ref) {
-                //  and distance is not a static dictionary reference,
-                //  push distance to the ring buffer of last distances
-                last_distances[last_distance_idx++ & 3] = distance;
-              }
+        // if number of uncompressed bytes produced in the loop for
+        if (pos >= mlen) {
+          // this meta-block is MLEN, then break from loop (in this
+          // case the copy length is ignored and can have any value)
+          break;
+        }
+
+        // 4.  Encoding of Distances
+
+        // if distance code is implicit zero from insert-and-copy code
+        int distance = 0;
+        bool is_dictionary_ref = false;
+        int max_distance = (int)std::min<uint64_t>(pos + s.dictionary_size, (uint64_t)s.max_backward_distance);
+        if (cmd.distance_code == 0) {
+          // set backward distance to the last distance
+          distance = s.last_distances[(s.last_distance_idx-1) & 3];
+        } else {
+          // if BLEN_D is zero
+          if (s.block_len[idx_D] == 0) {
+            read_block_switch_command(s, idx_D);
+          }
+          // decrement BLEN_D
+          s.block_len[idx_D]--;
+
+          // compute context ID, CIDD from CLEN
+          // read distance code using HTREED[CMAPD[4*BTYPE_D + CIDD]]
+          int peek16 = s.peek<checked>(16);
+          int table = s.distance_context_map[4 * s.block_type[idx_D] + cmd.context];
+          auto dist = s.distance_tables[table].decode(peek16);
+          int dcode = dist.second;
+          s.drop(dist.first);
+          stats(s).code(dist.first);
+
+          if (dcode < 16) {
+            // compute distance by distance short code substitution
+            uint8_t subst = brotli_data::distance_table[dcode];
+            int base = s.last_distances[(s.last_distance_idx - (subst >> 4)) & 3];
+            distance = base + (subst & 0x0f) - 4;
+            if (distance <= 0) {
+              s.error = error_code::syntax_error;
+              return;
             }
-            if (insert_len) if (debug) fprintf(s.log_file, "[ProcessCommandsInternal] s->meta_block_remaining_len = %d\n", mlen - pos);
-            if (debug) fprintf(s.log_file, "[ProcessCommandsInternal] pos = %d distance = %d\n", pos, distance);
-  
-            //  if distance is less than the max allowed distance plus one
-            if (!is_dictionary_ref) {
-              // move backwards distance bytes in the uncompressed data,
-              // and copy CLEN bytes from this position to
-              // the uncompressed stream
-              for (int i = 0; i != copy_len; ++i) {
-                s.ring_buffer[pos & ringbuffer_mask] = s.ring_buffer[(pos-distance) & ringbuffer_mask];
-                ++pos;
-              }
-            } else {
-              if (copy_len < 4 || copy_len > 24) {
-                s.error = error_code::syntax_error;
-                return s.error;
-              }
-              // look up the static dictionary word, transform the word as
-              // directed, and copy the result to the uncompressed stream
-              int offset = brotli_data::kBrotliDictionaryOffsetsByLength[copy_len];
-              int word_id = distance - pos - 1;
-              uint8_t shift = brotli_data::kBrotliDictionarySizeBitsByLength[copy_len];
-              int word_idx = word_id & ((1 << shift)-1);
-              int transform_idx = word_id >> shift;
-              const uint8_t *src = brotli_data::kBrotliDictionary + offset + word_idx * copy_len;
-              char buffer[128];
-              int len = transform_dictionary_word(buffer, src, transform_idx, copy_len, ringbuffer_mask);
-              if (debug) fprintf(s.log_file, "[ProcessCommandsInternal] dictionary word: [%.*s]\n", len, buffer);
-              for (int i = 0; i != len; ++i) {
-                s.ring_buffer[pos & ringbuffer_mask] = buffer[i];
-                ++pos;
-              }
+          } else if (dcode - NDIRECT - 16 < 0) {
+            distance = dcode - 15;
+          } else {
+            int ndistbits = 1 + ((dcode - NDIRECT - 16) >> (NPOSTFIX + 1));
+            int dextra = s.read<checked>(ndistbits);
+            int POSTFIX_MASK = (1 << NPOSTFIX) - 1;
+            int hcode = (dcode - NDIRECT - 16) >> NPOSTFIX;
+            int lcode = (dcode - NDIRECT - 16) & POSTFIX_MASK;
+            int offset = ((2 + (hcode & 1)) << ndistbits) - 4;
+            distance = ((offset + dextra) << NPOSTFIX) + lcode + NDIRECT + 1;
+          }
+
+          is_dictionary_ref = distance > max_distance;
+
+          // if distance code is not zero,
+          if (dcode != 0 && !is_dictionary_ref) {
+            //  and distance is not a static dictionary reference,
+            //  push distance to the ring buffer of last distances
+            s.last_distances[s.last_distance_idx++ & 3] = distance;
+          }
+        }
+
+        //  if distance is less than the max allowed distance plus one
+        if (!is_dictionary_ref) {
+          if (pos + copy_len > mlen || distance > max_distance) {
+            s.error = error_code::syntax_error;
+            return;
+          }
+          stats(s).match(copy_len, distance);
+          // move backwards distance bytes in the uncompressed data,
+          // and copy CLEN bytes from this position to
+          // the uncompressed stream
+          if ((uint64_t)distance > pos) {
+            // the start of the copy is in the custom dictionary.
+            const uint8_t *dict_end = s.dictionary + s.dictionary_size;
+            int from_dict = std::min((int)(distance - pos), copy_len);
+            for (int i = 0; i != from_dict; ++i) {
+              ring_buffer[pos & ringbuffer_mask] = dict_end[(int64_t)pos - distance];
+              ++pos;
+              if ((pos & ringbuffer_mask) == 0) { s.pos = pos; flush(s); }
             }
-            if (debug) fprintf(s.log_file, "[ProcessCommandsInternal] s->meta_block_remaining_len = %d\n", mlen - pos);
-          } // while number of uncompressed bytes for this meta-block < MLEN
-          s.bytes_written += mlen;
-      } //  while not ISLAST
+            copy_len -= from_dict;
+          }
+          for (int i = 0; i != copy_len; ++i) {
+            ring_buffer[pos & ringbuffer_mask] = ring_buffer[(pos-distance) & ringbuffer_mask];
+            ++pos;
+            if ((pos & ringbuffer_mask) == 0) { s.pos = pos; flush(s); }
+          }
+        } else {
+          if (copy_len < 4 || copy_len > 24) {
+            s.error = error_code::syntax_error;
+            return;
+          }
+          // look up the static dictionary word, transform the word as
+          // directed, and copy the result to the uncompressed stream
+          int offset = brotli_data::kBrotliDictionaryOffsetsByLength[copy_len];
+          int word_id = distance - max_distance - 1;
+          uint8_t shift = brotli_data::kBrotliDictionarySizeBitsByLength[copy_len];
+          int word_idx = word_id & ((1 << shift)-1);
+          int transform_idx = word_id >> shift;
+          if (transform_idx >= num_transforms) {
+            s.error = error_code::syntax_error;
+            return;
+          }
+          stats(s).dictionary_ref();
+          const uint8_t *src = brotli_data::kBrotliDictionary + offset + word_idx * copy_len;
+          size_t ring_pos = pos & ringbuffer_mask;
+          int len = 0;
+          if (ring_pos + max_transformed_word <= ringbuffer_mask + 1) {
+            // fast path: transform straight into the ring buffer.
+            uint8_t *dest = ring_buffer + ring_pos;
+            len = transform_dictionary_word(dest, src, transform_idx, copy_len);
+            pos += len;
+            if ((pos & ringbuffer_mask) == 0) { s.pos = pos; flush(s); }
+          } else {
+            uint8_t buffer[max_transformed_word];
+            len = transform_dictionary_word(buffer, src, transform_idx, copy_len);
+            for (int i = 0; i != len; ++i) {
+              ring_buffer[pos & ringbuffer_mask] = buffer[i];
+              ++pos;
+              if ((pos & ringbuffer_mask) == 0) { s.pos = pos; flush(s); }
+            }
+          }
+          if (pos > mlen) {
+            s.error = error_code::syntax_error;
+            return;
+          }
+        }
+      } // while number of uncompressed bytes for this meta-block < MLEN
 
+      s.pos = pos;
+      if (pos >= mlen) {
+        s.next = s.is_last ? stage::done : stage::meta_block_header;
+      }
+    }
+
+  public:
+    basic_brotli_decoder() {
+    }
+
+    // Decode up to max_commands commands from the stream.
+    // Returns ok if there is more to do and end when the stream is complete.
+    brotli_decoder_state::error_code step(brotli_decoder_state &s, int max_commands) {
+      typedef brotli_decoder_state::stage stage;
+      // https://tools.ietf.org/html/rfc7932
+      s.error = error_code::ok;
+
+      uint64_t start = stats(s).now();
+      switch (s.next) {
+        case stage::start: {
+          read_stream_header(s);
+          stats(s).header_time(start);
+        } break;
+        case stage::meta_block_header: {
+          read_meta_block_header(s);
+          stats(s).header_time(start);
+        } break;
+        case stage::commands: {
+          decode_commands(s, max_commands);
+          stats(s).symbol_time(start);
+        } break;
+        case stage::done: {
+        } break;
+      }
+
+      if (checked && s.error == error_code::ok && s.overrun()) {
+        s.error = error_code::need_more_input;
+      }
+
+      if (s.error == error_code::ok && s.next == stage::done) {
+        flush(s);
+        if (s.error == error_code::ok) s.error = error_code::end;
+      }
       return s.error;
     }
 
+    // Decode a whole stream from s.src to s.dest.
+    // If s.dest is null, the output is discarded.
+    brotli_decoder_state::error_code decode(brotli_decoder_state &s) {
+      s.next = brotli_decoder_state::stage::start;
+      while (step(s, std::numeric_limits<int>::max()) == error_code::ok) {
+      }
+      if (s.error == error_code::end) s.error = error_code::ok;
+      return s.error;
+    }
   };
 
+  // Decodes untrusted input safely.
+  typedef basic_brotli_decoder<checked_input> brotli_decoder;
+
+  // Faster, for trusted input only.
+  typedef basic_brotli_decoder<trusted_input> trusted_brotli_decoder;
 }
 
 #endif
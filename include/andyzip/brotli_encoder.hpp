@@ -0,0 +1,1139 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+//
+// Brotli encoder.
+//
+// Quality 0-4 uses a hash table match finder and a single literal prefix code.
+// Quality 5-11 uses the suffix array match finder, the static dictionary,
+// literal context modelling and literal block splitting.
+//
+// Meta-blocks that do not compress are stored.
+//
+
+#ifndef _ANDYZIP_BROTLI_ENCODER_HPP_
+#define _ANDYZIP_BROTLI_ENCODER_HPP_
+
+#include <andyzip/huffman_table.hpp>
+#include <andyzip/bit_writer.hpp>
+#include <andyzip/deflate_encoder.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+#include <andyzip/brotli_data.hpp>
+
+namespace andyzip {
+  class brotli_encoder {
+    enum {
+      window_gap = 16,
+      literal_context_bits = 6,
+      min_match = 4,
+      min_last_distance_match = 2,
+      max_meta_block_size = 1 << 18,
+      suffix_array_span = 1 << 20,
+      num_length_codes = 24,
+      distance_alphabet_size = 16 + 48,
+      iandc_alphabet_size = 704,
+      block_len_symbols = 26,
+      max_simple_symbols = 4,
+      max_code_length = 15,
+      dictionary_hash_bits = 15,
+      no_distance = 0xffff,
+    };
+
+    // literal context modes.
+    enum {
+      context_lsb6, context_msb6, context_utf8, context_signed
+    };
+
+    // One insert-and-copy command. The last command of a meta-block may have no copy.
+    struct command {
+      uint32_t insert_len;
+      uint32_t copy_len;
+      uint32_t out_len;
+      uint32_t distance;
+    };
+
+    // A command converted to prefix code symbols and extra bits.
+    struct command_symbols {
+      uint16_t iandc;
+      uint16_t distance;
+      uint8_t insert_bits;
+      uint8_t copy_bits;
+      uint8_t distance_bits;
+      uint32_t insert_extra;
+      uint32_t copy_extra;
+      uint32_t distance_extra;
+    };
+
+    struct match {
+      uint32_t len;
+      uint32_t out_len;
+      uint32_t distance;
+      int score;
+    };
+
+    struct histogram {
+      uint32_t counts[256];
+      uint32_t total;
+    };
+
+    struct prefix_code {
+      std::vector<uint8_t> lengths;
+      std::vector<uint16_t> codes;
+
+      void put(bit_writer &w, int symbol) const {
+        w.write(lengths[symbol], codes[symbol]);
+      }
+    };
+
+    // State kept between meta-blocks.
+    struct stream_state {
+      const uint8_t *src;
+      size_t size;
+      size_t max_backward;
+      std::vector<uint32_t> hash_table;
+      std::unique_ptr<suffix_array<uint8_t, uint32_t>> sa;
+      size_t sa_base;
+      size_t sa_end;
+      int last_distances[4];
+      int last_distance_idx;
+    };
+
+    // Insert and copy length codes and the insert-and-copy symbols, derived from kCmdLut.
+    struct length_codes {
+      uint32_t insert_offset[num_length_codes];
+      uint8_t insert_bits[num_length_codes];
+      uint32_t copy_offset[num_length_codes];
+      uint8_t copy_bits[num_length_codes];
+      // [insert code][copy code][implicit last distance]
+      uint16_t symbol[num_length_codes][num_length_codes][2];
+    };
+
+    static const length_codes &codes() {
+      struct builder {
+        length_codes c;
+        builder() {
+          std::vector<std::pair<uint32_t, uint8_t>> ins, cpy;
+          for (auto &e : brotli_data::kCmdLut) {
+            ins.emplace_back(e.insert_len_offset, e.insert_len_extra_bits);
+            cpy.emplace_back(e.copy_len_offset, e.copy_len_extra_bits);
+          }
+          std::sort(ins.begin(), ins.end());
+          ins.erase(std::unique(ins.begin(), ins.end()), ins.end());
+          std::sort(cpy.begin(), cpy.end());
+          cpy.erase(std::unique(cpy.begin(), cpy.end()), cpy.end());
+          for (int i = 0; i != num_length_codes; ++i) {
+            c.insert_offset[i] = ins[i].first;
+            c.insert_bits[i] = ins[i].second;
+            c.copy_offset[i] = cpy[i].first;
+            c.copy_bits[i] = cpy[i].second;
+          }
+          std::fill(&c.symbol[0][0][0], &c.symbol[0][0][0] + sizeof(c.symbol) / sizeof(uint16_t), (uint16_t)no_distance);
+          for (int s = 0; s != iandc_alphabet_size; ++s) {
+            auto &e = brotli_data::kCmdLut[s];
+            int icode = (int)(std::find(c.insert_offset, c.insert_offset + num_length_codes, e.insert_len_offset) - c.insert_offset);
+            int ccode = (int)(std::find(c.copy_offset, c.copy_offset + num_length_codes, e.copy_len_offset) - c.copy_offset);
+            c.symbol[icode][ccode][e.distance_code == 0] = (uint16_t)s;
+          }
+        }
+      };
+      static const builder b;
+      return b.c;
+    }
+
+    // Index of the static dictionary words by their first four bytes.
+    struct dictionary_index {
+      std::vector<uint32_t> heads;
+      std::vector<uint32_t> words;
+    };
+
+    static uint32_t hash4(const uint8_t *p, int bits) {
+      uint32_t value;
+      memcpy(&value, p, 4);
+      return (value * 0x1e35a7bd) >> (32 - bits);
+    }
+
+    static const dictionary_index &dictionary() {
+      struct builder {
+        dictionary_index d;
+        builder() {
+          d.heads.assign((1 << dictionary_hash_bits) + 1, 0);
+          for (int pass = 0; pass != 2; ++pass) {
+            for (uint32_t len = 4; len <= 24; ++len) {
+              uint32_t num_words = 1 << brotli_data::kBrotliDictionarySizeBitsByLength[len];
+              const uint8_t *base = brotli_data::kBrotliDictionary + brotli_data::kBrotliDictionaryOffsetsByLength[len];
+              for (uint32_t idx = 0; idx != num_words; ++idx) {
+                uint32_t h = hash4(base + idx * len, dictionary_hash_bits);
+                if (pass == 0) {
+                  d.heads[h + 1]++;
+                } else {
+                  d.words[d.heads[h]++] = len << 16 | idx;
+                }
+              }
+            }
+            if (pass == 0) {
+              for (size_t i = 1; i != d.heads.size(); ++i) d.heads[i] += d.heads[i-1];
+              d.words.resize(d.heads.back());
+            } else {
+              // heads[h] now points at the end of bucket h.
+              for (size_t i = d.heads.size() - 1; i != 0; --i) d.heads[i] = d.heads[i-1];
+              d.heads[0] = 0;
+            }
+          }
+        }
+      };
+      static const builder b;
+      return b.d;
+    }
+
+    // number of bits needed to hold x.
+    static int bit_length(uint64_t x) {
+      int result = 0;
+      while (x) {
+        x >>= 1;
+        ++result;
+      }
+      return result;
+    }
+
+    static int insert_code(uint32_t len) {
+      const length_codes &c = codes();
+      int i = num_length_codes - 1;
+      while (c.insert_offset[i] > len) --i;
+      return i;
+    }
+
+    static int copy_code(uint32_t len) {
+      const length_codes &c = codes();
+      int i = num_length_codes - 1;
+      while (c.copy_offset[i] > len) --i;
+      return i;
+    }
+
+    // Estimated benefit of a backward reference, from the reference encoder.
+    static int score(uint32_t len, uint32_t distance) {
+      return 135 * (int)len - 30 * bit_length(distance);
+    }
+
+    static size_t max_distance(const stream_state &s, size_t pos) {
+      return std::min(pos, s.max_backward);
+    }
+
+    static uint32_t match_length(const uint8_t *a, const uint8_t *b, size_t max_len) {
+      size_t len = 0;
+      while (len != max_len && a[len] == b[len]) ++len;
+      return (uint32_t)len;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Match finding
+    //
+
+    // Try the last distance, which is cheap enough to encode to be worth even short copies.
+    void last_distance_match(const stream_state &s, size_t pos, size_t end, match &best) const {
+      uint32_t distance = s.last_distances[(s.last_distance_idx - 1) & 3];
+      if (distance <= max_distance(s, pos)) {
+        uint32_t len = match_length(s.src + pos, s.src + pos - distance, end - pos);
+        int sc = 135 * (int)len + 15;
+        if (len >= min_last_distance_match && sc > best.score) {
+          best = match{len, len, distance, sc};
+        }
+      }
+    }
+
+    // Try identity and "word " references into the static dictionary.
+    void dictionary_match(const stream_state &s, size_t pos, size_t end, match &best) const {
+      if (end - pos < 4) return;
+      const dictionary_index &d = dictionary();
+      uint32_t h = hash4(s.src + pos, dictionary_hash_bits);
+      uint32_t base_distance = (uint32_t)max_distance(s, pos) + 1;
+      for (uint32_t i = d.heads[h]; i != d.heads[h+1]; ++i) {
+        uint32_t len = d.words[i] >> 16;
+        uint32_t idx = d.words[i] & 0xffff;
+        if (len > end - pos || len * 135 + 135 <= (uint32_t)std::max(best.score, 0)) continue;
+        const uint8_t *word = brotli_data::kBrotliDictionary + brotli_data::kBrotliDictionaryOffsetsByLength[len] + idx * len;
+        if (memcmp(word, s.src + pos, len)) continue;
+        int shift = brotli_data::kBrotliDictionarySizeBitsByLength[len];
+        bool space = len + 1 <= end - pos && s.src[pos + len] == ' ';
+        uint32_t out_len = len + space;
+        uint32_t distance = base_distance + ((uint32_t)space << shift | idx);
+        int sc = score(out_len, distance);
+        if (sc > best.score) {
+          best = match{len, out_len, distance, sc};
+        }
+      }
+    }
+
+    void hash_insert(stream_state &s, size_t pos) const {
+      uint32_t *bucket = s.hash_table.data() + (hash4(s.src + pos, hash_bits_) << hash_ways_log2_);
+      int ways = 1 << hash_ways_log2_;
+      for (int i = ways - 1; i != 0; --i) bucket[i] = bucket[i-1];
+      bucket[0] = (uint32_t)pos + 1;
+    }
+
+    match hash_find(const stream_state &s, size_t pos, size_t end) const {
+      match best{0, 0, 0, 0};
+      last_distance_match(s, pos, end, best);
+      const uint32_t *bucket = s.hash_table.data() + (hash4(s.src + pos, hash_bits_) << hash_ways_log2_);
+      size_t max_dist = max_distance(s, pos);
+      for (int i = 0; i != 1 << hash_ways_log2_ && bucket[i]; ++i) {
+        size_t candidate = bucket[i] - 1;
+        size_t distance = pos - candidate;
+        if (distance == 0 || distance > max_dist) continue;
+        if (best.len && best.len < end - pos && s.src[candidate + best.len] != s.src[pos + best.len]) continue;
+        uint32_t len = match_length(s.src + pos, s.src + candidate, end - pos);
+        int sc = score(len, (uint32_t)distance);
+        if (len >= min_match && sc > best.score) {
+          best = match{len, len, (uint32_t)distance, sc};
+        }
+      }
+      return best;
+    }
+
+    // Quality 0-4: greedy (or one step lazy) parse with a hash table.
+    void find_matches_fast(stream_state &s, size_t start, size_t end, std::vector<command> &commands) const {
+      size_t insert_start = start;
+      size_t pos = start;
+      while (pos + min_match <= end) {
+        match m = hash_find(s, pos, end);
+        if (m.len && lazy_ && pos + 1 + min_match <= end) {
+          hash_insert(s, pos);
+          match m2 = hash_find(s, pos + 1, end);
+          if (m2.score > m.score + 175) {
+            ++pos;
+            continue;
+          }
+        } else {
+          hash_insert(s, pos);
+        }
+        if (!m.len) {
+          ++pos;
+          continue;
+        }
+        commands.push_back(command{(uint32_t)(pos - insert_start), m.len, m.out_len, m.distance});
+        s.last_distances[s.last_distance_idx++ & 3] = m.distance;
+        size_t next = pos + m.len;
+        size_t step = quality_ >= 2 ? 1 : 8;
+        for (pos += 1; pos < next && pos + min_match <= end; pos += step) {
+          hash_insert(s, pos);
+        }
+        pos = insert_start = next;
+      }
+      if (insert_start != end) {
+        commands.push_back(command{(uint32_t)(end - insert_start), 0, 0, 0});
+      }
+    }
+
+    // Quality 5-11: use the neighbours of each suffix in the suffix array.
+    void find_matches_hq(stream_state &s, size_t start, size_t end, std::vector<command> &commands) const {
+      // one suffix array covers several meta-blocks and some history before them.
+      if (!s.sa || end > s.sa_end) {
+        s.sa_base = start - std::min(start, std::min(s.max_backward, (size_t)suffix_array_span));
+        s.sa_end = std::min(s.size, start + suffix_array_span);
+        s.sa.reset();
+        s.sa.reset(new suffix_array<uint8_t, uint32_t>(s.src + s.sa_base, s.src + s.sa_end));
+      }
+      const suffix_array<uint8_t, uint32_t> &sa = *s.sa;
+      size_t base = s.sa_base;
+      size_t n = s.sa_end - base;
+
+      auto find = [&](size_t pos) {
+        match best{0, 0, 0, 0};
+        last_distance_match(s, pos, end, best);
+        size_t max_dist = max_distance(s, pos);
+        size_t rank = sa.rank(pos - base);
+        for (int dir = -1; dir <= 1; dir += 2) {
+          uint32_t len = (uint32_t)(end - pos);
+          size_t i = rank;
+          for (int k = 0; k != max_scan_; ++k) {
+            if (dir < 0) {
+              if (i == 0) break;
+              len = std::min(len, (uint32_t)sa.lcp(i));
+              --i;
+            } else {
+              if (i == n) break;
+              ++i;
+              len = std::min(len, (uint32_t)sa.lcp(i));
+            }
+            if (len < min_match || (int)len * 135 + 15 <= best.score) break;
+            size_t candidate = sa.addr(i) + base;
+            if (candidate >= pos || pos - candidate > max_dist) continue;
+            int sc = score(len, (uint32_t)(pos - candidate));
+            if (sc > best.score) {
+              best = match{len, len, (uint32_t)(pos - candidate), sc};
+            }
+          }
+        }
+        if (use_dictionary_) {
+          dictionary_match(s, pos, end, best);
+        }
+        return best;
+      };
+
+      size_t insert_start = start;
+      size_t pos = start;
+      while (pos + min_match <= end) {
+        match m = find(pos);
+        if (m.len && pos + 1 + min_match <= end) {
+          match m2 = find(pos + 1);
+          if (m2.score > m.score + 175) {
+            ++pos;
+            continue;
+          }
+        }
+        if (!m.len || m.score <= 0) {
+          ++pos;
+          continue;
+        }
+        commands.push_back(command{(uint32_t)(pos - insert_start), m.len, m.out_len, m.distance});
+        if (m.distance <= max_distance(s, pos)) {
+          s.last_distances[s.last_distance_idx++ & 3] = m.distance;
+        }
+        pos = insert_start = pos + m.out_len;
+      }
+      if (insert_start != end) {
+        commands.push_back(command{(uint32_t)(end - insert_start), 0, 0, 0});
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Symbols
+    //
+
+    static void encode_distance(uint32_t distance, command_symbols &sym) {
+      uint32_t x = distance + 3;
+      int nbits = bit_length(x) - 2;
+      uint32_t bit = (x >> nbits) & 1;
+      sym.distance = (uint16_t)(16 + 2 * (nbits - 1) + bit);
+      sym.distance_bits = (uint8_t)nbits;
+      sym.distance_extra = x - ((2 + bit) << nbits);
+    }
+
+    // Convert commands to symbols, tracking the last distances as the decoder does.
+    static void make_symbols(stream_state &s, size_t start, const std::vector<command> &commands, std::vector<command_symbols> &symbols) {
+      const length_codes &c = codes();
+      size_t pos = start;
+      symbols.resize(commands.size());
+      for (size_t i = 0; i != commands.size(); ++i) {
+        const command &cmd = commands[i];
+        command_symbols &sym = symbols[i];
+        int icode = insert_code(cmd.insert_len);
+        int ccode = cmd.copy_len ? copy_code(cmd.copy_len) : 0;
+        sym.insert_bits = c.insert_bits[icode];
+        sym.insert_extra = cmd.insert_len - c.insert_offset[icode];
+        sym.copy_bits = c.copy_bits[ccode];
+        sym.copy_extra = cmd.copy_len ? cmd.copy_len - c.copy_offset[ccode] : 0;
+        sym.distance = no_distance;
+        sym.distance_bits = 0;
+        sym.distance_extra = 0;
+        bool can_be_implicit = icode < 8 && ccode < 16;
+        pos += cmd.insert_len;
+
+        if (!cmd.copy_len) {
+          // the decoder stops at the end of the meta-block before the distance.
+          sym.iandc = c.symbol[icode][ccode][can_be_implicit];
+          continue;
+        }
+
+        bool is_dictionary_ref = cmd.distance > max_distance(s, pos);
+        int dcode = -1;
+        if (!is_dictionary_ref) {
+          for (int j = 0; j != 16; ++j) {
+            uint8_t subst = brotli_data::distance_table[j];
+            int distance = s.last_distances[(s.last_distance_idx - (subst >> 4)) & 3] + (subst & 0x0f) - 4;
+            if (distance == (int)cmd.distance) {
+              dcode = j;
+              break;
+            }
+          }
+        }
+
+        if (dcode == 0 && can_be_implicit) {
+          sym.iandc = c.symbol[icode][ccode][1];
+        } else {
+          sym.iandc = c.symbol[icode][ccode][0];
+          if (dcode >= 0) {
+            sym.distance = (uint16_t)dcode;
+          } else {
+            encode_distance(cmd.distance, sym);
+          }
+          if (dcode != 0 && !is_dictionary_ref) {
+            s.last_distances[s.last_distance_idx++ & 3] = cmd.distance;
+          }
+        }
+        pos += cmd.out_len;
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Prefix codes
+    //
+
+    static void write_256(bit_writer &w, int value) {
+      if (value == 1) {
+        w.write(1, 0);
+      } else {
+        int v = value - 1;
+        int nbits = bit_length(v) - 1;
+        w.write(1, 1);
+        w.write(3, nbits);
+        w.write(nbits, v - (1 << nbits));
+      }
+    }
+
+    // 3.4. Simple Prefix Codes and 3.5. Complex Prefix Codes
+    static void write_prefix_code(bit_writer &w, prefix_code &code, const uint32_t *counts, int alphabet_size) {
+      code.lengths.assign(alphabet_size, 0);
+      code.codes.assign(alphabet_size, 0);
+
+      int used[max_simple_symbols];
+      int num_used = 0;
+      for (int i = 0; i != alphabet_size && num_used <= max_simple_symbols; ++i) {
+        if (counts[i]) {
+          if (num_used < max_simple_symbols) used[num_used] = i;
+          ++num_used;
+        }
+      }
+
+      if (num_used <= max_simple_symbols) {
+        if (num_used == 0) used[num_used++] = 0;
+        int tree_select = 0;
+        std::sort(used, used + num_used, [counts](int a, int b) { return counts[a] > counts[b]; });
+        if (num_used == 2) {
+          code.lengths[used[0]] = code.lengths[used[1]] = 1;
+        } else if (num_used == 3) {
+          code.lengths[used[0]] = 1;
+          code.lengths[used[1]] = code.lengths[used[2]] = 2;
+        } else if (num_used == 4) {
+          tree_select = counts[used[0]] > counts[used[2]] + counts[used[3]];
+          static const uint8_t lengths[2][4] = { {2, 2, 2, 2}, {1, 2, 3, 3} };
+          for (int i = 0; i != 4; ++i) code.lengths[used[i]] = lengths[tree_select][i];
+        }
+        // symbols are listed in code order.
+        std::sort(used, used + num_used, [&code](int a, int b) {
+          return code.lengths[a] != code.lengths[b] ? code.lengths[a] < code.lengths[b] : a < b;
+        });
+        int alphabet_bits = bit_length(alphabet_size - 1);
+        w.write(2, 1);
+        w.write(2, num_used - 1);
+        for (int i = 0; i != num_used; ++i) {
+          w.write(alphabet_bits, used[i]);
+        }
+        if (num_used == 4) w.write(1, tree_select);
+        huffman_codes(code.codes.data(), code.lengths.data(), alphabet_size);
+        return;
+      }
+
+      huffman_code_lengths(code.lengths.data(), counts, alphabet_size, max_code_length);
+      huffman_codes(code.codes.data(), code.lengths.data(), alphabet_size);
+
+      // run length code the lengths with repeat codes 16 (previous non-zero) and 17 (zero).
+      std::vector<uint8_t> tokens;
+      std::vector<uint8_t> extra;
+      int last = alphabet_size;
+      while (code.lengths[last-1] == 0) --last;
+      uint8_t prev = 8;
+      for (int i = 0; i < last;) {
+        uint8_t value = code.lengths[i];
+        int run = 1;
+        while (i + run < last && code.lengths[i + run] == value) ++run;
+        i += run;
+        if (value != 0 && value != prev) {
+          tokens.push_back(value);
+          extra.push_back(0);
+          prev = value;
+          --run;
+        }
+        if (run < 3) {
+          tokens.insert(tokens.end(), run, value);
+          extra.insert(extra.end(), run, 0);
+        } else {
+          // consecutive repeat codes multiply the previous repeat count.
+          int shift = value ? 2 : 3;
+          size_t first = tokens.size();
+          int reps = run - 3;
+          for (;;) {
+            tokens.push_back(value ? 16 : 17);
+            extra.push_back((uint8_t)(reps & ((1 << shift) - 1)));
+            reps >>= shift;
+            if (!reps) break;
+            --reps;
+          }
+          std::reverse(tokens.begin() + first, tokens.end());
+          std::reverse(extra.begin() + first, extra.end());
+        }
+      }
+
+      uint32_t cl_counts[18] = {0};
+      for (auto t : tokens) cl_counts[t]++;
+      uint8_t cl_lengths[18];
+      uint16_t cl_codes[18];
+      huffman_code_lengths(cl_lengths, cl_counts, 18, 5);
+      huffman_codes(cl_codes, cl_lengths, 18);
+      int num_cl_codes = 18 - (int)std::count(cl_lengths, cl_lengths + 18, 0);
+      if (num_cl_codes == 1) {
+        // a single code length code uses zero bits.
+        std::fill(cl_codes, cl_codes + 18, 0);
+        for (auto &l : cl_lengths) l = l ? 1 : 0;
+      }
+
+      static const uint8_t kCodeLengthCodeOrder[18] = {
+        1, 2, 3, 4, 0, 5, 17, 6, 16, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+      };
+      static const uint8_t kCodeLengthPrefixCode[6] = { 0, 7, 3, 2, 1, 15 };
+      static const uint8_t kCodeLengthPrefixLength[6] = { 2, 4, 3, 2, 2, 4 };
+
+      int hskip = 0;
+      if (!cl_lengths[kCodeLengthCodeOrder[0]] && !cl_lengths[kCodeLengthCodeOrder[1]]) {
+        hskip = cl_lengths[kCodeLengthCodeOrder[2]] ? 2 : 3;
+      }
+      int num_stored = 18;
+      if (num_cl_codes > 1) {
+        while (!cl_lengths[kCodeLengthCodeOrder[num_stored - 1]]) --num_stored;
+      }
+      w.write(2, hskip);
+      for (int i = hskip; i != num_stored; ++i) {
+        int length = cl_lengths[kCodeLengthCodeOrder[i]];
+        w.write(kCodeLengthPrefixLength[length], kCodeLengthPrefixCode[length]);
+      }
+
+      for (size_t i = 0; i != tokens.size(); ++i) {
+        int t = tokens[i];
+        w.write(num_cl_codes == 1 ? 0 : cl_lengths[t], cl_codes[t]);
+        if (t == 16) w.write(2, extra[i]);
+        if (t == 17) w.write(3, extra[i]);
+      }
+    }
+
+    // 7.3. Encoding of the Context Map
+    static void write_context_map(bit_writer &w, const std::vector<uint8_t> &context_map, int num_trees) {
+      write_256(w, num_trees);
+      if (num_trees == 1) return;
+
+      // move to front
+      std::vector<uint8_t> values(context_map);
+      uint8_t mtf[256];
+      for (int i = 0; i != 256; ++i) mtf[i] = (uint8_t)i;
+      for (auto &v : values) {
+        uint8_t value = v;
+        int index = (int)(std::find(mtf, mtf + 256, value) - mtf);
+        v = (uint8_t)index;
+        for (; index; --index) mtf[index] = mtf[index-1];
+        mtf[0] = value;
+      }
+
+      // runs of zeros
+      size_t max_run = 0;
+      for (size_t i = 0; i != values.size();) {
+        size_t run = 0;
+        while (i + run != values.size() && values[i + run] == 0) ++run;
+        max_run = std::max(max_run, run);
+        i += run ? run : 1;
+      }
+      int rlemax = std::min(bit_length(max_run) - 1, 16);
+      if (rlemax < 0) rlemax = 0;
+
+      std::vector<uint16_t> tokens;
+      std::vector<uint32_t> extra;
+      for (size_t i = 0; i != values.size();) {
+        if (values[i] != 0) {
+          tokens.push_back((uint16_t)(values[i] + rlemax));
+          extra.push_back(0);
+          ++i;
+          continue;
+        }
+        size_t run = 0;
+        while (i + run != values.size() && values[i + run] == 0) ++run;
+        i += run;
+        while (run) {
+          int k = std::min(bit_length(run) - 1, rlemax);
+          if (k == 0) {
+            tokens.push_back(0);
+            extra.push_back(0);
+            --run;
+          } else {
+            size_t take = std::min(run, ((size_t)2 << k) - 1);
+            tokens.push_back((uint16_t)k);
+            extra.push_back((uint32_t)(take - ((size_t)1 << k)));
+            run -= take;
+          }
+        }
+      }
+
+      int alphabet_size = num_trees + rlemax;
+      std::vector<uint32_t> counts(alphabet_size);
+      for (auto t : tokens) counts[t]++;
+      if (rlemax) {
+        w.write(1, 1);
+        w.write(4, rlemax - 1);
+      } else {
+        w.write(1, 0);
+      }
+      prefix_code code;
+      write_prefix_code(w, code, counts.data(), alphabet_size);
+      for (size_t i = 0; i != tokens.size(); ++i) {
+        code.put(w, tokens[i]);
+        if (tokens[i] && tokens[i] <= rlemax) w.write(tokens[i], extra[i]);
+      }
+      // IMTF
+      w.write(1, 1);
+    }
+
+    static int block_length_code(uint32_t len) {
+      int i = block_len_symbols - 1;
+      while (brotli_data::kBlockLengthPrefixCode[i].offset > len) --i;
+      return i;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Literal modelling
+    //
+
+    static double entropy(const histogram &h) {
+      double bits = 0;
+      for (auto c : h.counts) {
+        if (c) bits -= c * std::log2((double)c);
+      }
+      return h.total ? bits + h.total * std::log2((double)h.total) : 0;
+    }
+
+    // Rough cost of storing a literal prefix code.
+    static double code_cost(const histogram &h) {
+      int used = 256 - (int)std::count(h.counts, h.counts + 256, 0);
+      return 20 + 4 * used;
+    }
+
+    static void add(histogram &a, const histogram &b) {
+      for (int i = 0; i != 256; ++i) a.counts[i] += b.counts[i];
+      a.total += b.total;
+    }
+
+    // Greedily merge the pair of histograms that costs least to merge until merging
+    // stops saving bits and there are at most max_clusters clusters.
+    // Returns the cluster of each histogram, numbered in order of first use.
+    // Empty histograms join the cluster before them.
+    static std::vector<uint8_t> cluster(std::vector<histogram> h, int max_clusters, double split_cost) {
+      size_t n = h.size();
+      std::vector<size_t> active;
+      std::vector<size_t> owner(n);
+      std::vector<double> cost(n);
+      for (size_t i = 0; i != n; ++i) {
+        owner[i] = i;
+        if (h[i].total) {
+          active.push_back(i);
+          cost[i] = entropy(h[i]);
+        }
+      }
+
+      auto merge_cost = [&](size_t i, size_t j) {
+        histogram m = h[i];
+        add(m, h[j]);
+        double saving = split_cost > 0 ? split_cost : std::min(code_cost(h[i]), code_cost(h[j]));
+        return entropy(m) - cost[i] - cost[j] - saving;
+      };
+
+      size_t k = active.size();
+      std::vector<double> pair(k * k);
+      for (size_t a = 0; a != k; ++a) {
+        for (size_t b = a + 1; b != k; ++b) {
+          pair[a * k + b] = merge_cost(active[a], active[b]);
+        }
+      }
+      std::vector<bool> alive(k, true);
+      size_t num_alive = k;
+      while (num_alive > 1) {
+        double best = 1e300;
+        size_t best_a = 0, best_b = 0;
+        for (size_t a = 0; a != k; ++a) {
+          if (!alive[a]) continue;
+          for (size_t b = a + 1; b != k; ++b) {
+            if (alive[b] && pair[a * k + b] < best) {
+              best = pair[a * k + b];
+              best_a = a;
+              best_b = b;
+            }
+          }
+        }
+        if (best >= 0 && num_alive <= (size_t)max_clusters) break;
+        size_t i = active[best_a], j = active[best_b];
+        add(h[i], h[j]);
+        cost[i] = entropy(h[i]);
+        owner[j] = i;
+        alive[best_b] = false;
+        --num_alive;
+        for (size_t c = 0; c != k; ++c) {
+          if (alive[c] && c != best_a) {
+            double v = merge_cost(i, active[c]);
+            if (c < best_a) pair[c * k + best_a] = v; else pair[best_a * k + c] = v;
+          }
+        }
+      }
+
+      std::vector<uint8_t> result(n);
+      std::vector<int> number(n, -1);
+      int next_number = 0;
+      int prev = 0;
+      for (size_t i = 0; i != n; ++i) {
+        if (!h[i].total && owner[i] == i) {
+          result[i] = (uint8_t)prev;
+          continue;
+        }
+        size_t root = i;
+        while (owner[root] != root) root = owner[root];
+        if (number[root] < 0) number[root] = next_number++;
+        result[i] = (uint8_t)(prev = number[root]);
+      }
+      return result;
+    }
+
+    static int literal_context(int mode, int p1, int p2) {
+      return mode == context_utf8 ?
+        brotli_data::Lut0[p1] | brotli_data::Lut1[p2] :
+        (brotli_data::Lut2[p1] << 3) | brotli_data::Lut2[p2]
+      ;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Meta-blocks
+    //
+
+    static void write_meta_block_length(bit_writer &w, size_t len) {
+      size_t m = len - 1;
+      int nibbles = m < (1 << 16) ? 4 : m < (1 << 20) ? 5 : 6;
+      w.write(2, nibbles - 4);
+      w.write(nibbles * 4, m);
+    }
+
+    static void write_uncompressed_meta_block(bit_writer &w, const uint8_t *src, size_t len) {
+      // ISLAST
+      w.write(1, 0);
+      write_meta_block_length(w, len);
+      // ISUNCOMPRESSED
+      w.write(1, 1);
+      w.write_bytes(src, len);
+    }
+
+    void write_compressed_meta_block(bit_writer &w, stream_state &s, size_t start, size_t end, const std::vector<command> &commands) const {
+      std::vector<command_symbols> symbols;
+      make_symbols(s, start, commands, symbols);
+
+      // gather the literals and their context ids.
+      std::vector<uint8_t> literals;
+      std::vector<uint8_t> contexts;
+      size_t pos = start;
+      for (auto &cmd : commands) {
+        literals.insert(literals.end(), s.src + pos, s.src + pos + cmd.insert_len);
+        pos += cmd.insert_len + cmd.out_len;
+      }
+
+      int mode = context_lsb6;
+      if (!fast_) {
+        size_t ascii = 0;
+        for (auto c : literals) ascii += c < 0x80;
+        mode = ascii * 4 >= literals.size() * 3 ? context_utf8 : context_signed;
+        contexts.reserve(literals.size());
+        pos = start;
+        for (auto &cmd : commands) {
+          for (size_t p = pos; p != pos + cmd.insert_len; ++p) {
+            int p1 = p >= 1 ? s.src[p-1] : 0;
+            int p2 = p >= 2 ? s.src[p-2] : 0;
+            contexts.push_back((uint8_t)literal_context(mode, p1, p2));
+          }
+          pos += cmd.insert_len + cmd.out_len;
+        }
+      }
+
+      // split the literals into blocks of similar statistics.
+      std::vector<uint8_t> block_types(1, 0);
+      std::vector<uint32_t> block_lens(1, (uint32_t)literals.size());
+      if (!fast_ && max_literal_types_ > 1 && literals.size() >= 4096) {
+        size_t segment = std::max((size_t)1024, literals.size() / 64);
+        size_t num_segments = (literals.size() + segment - 1) / segment;
+        std::vector<histogram> h(num_segments);
+        for (size_t i = 0; i != num_segments; ++i) {
+          histogram &hi = h[i];
+          memset(&hi, 0, sizeof(hi));
+          size_t e = std::min(literals.size(), (i + 1) * segment);
+          for (size_t j = i * segment; j != e; ++j) hi.counts[literals[j]]++;
+          hi.total = (uint32_t)(e - i * segment);
+        }
+        std::vector<uint8_t> types = cluster(h, max_literal_types_, 3000);
+        block_types.clear();
+        block_lens.clear();
+        for (size_t i = 0; i != num_segments; ++i) {
+          uint32_t len = (uint32_t)(std::min(literals.size(), (i + 1) * segment) - i * segment);
+          if (!block_types.empty() && block_types.back() == types[i]) {
+            block_lens.back() += len;
+          } else {
+            block_types.push_back(types[i]);
+            block_lens.push_back(len);
+          }
+        }
+      }
+      int num_literal_types = *std::max_element(block_types.begin(), block_types.end()) + 1;
+
+      // cluster the (block type, context) histograms into literal prefix codes.
+      std::vector<uint8_t> literal_context_map(num_literal_types << literal_context_bits, 0);
+      int num_literal_trees = 1;
+      if (!fast_) {
+        std::vector<histogram> h(num_literal_types << literal_context_bits);
+        memset(h.data(), 0, h.size() * sizeof(histogram));
+        size_t lit = 0;
+        for (size_t b = 0; b != block_types.size(); ++b) {
+          for (uint32_t j = 0; j != block_lens[b]; ++j, ++lit) {
+            histogram &hi = h[(block_types[b] << literal_context_bits) + contexts[lit]];
+            hi.counts[literals[lit]]++;
+            hi.total++;
+          }
+        }
+        literal_context_map = cluster(h, max_literal_trees_, 0);
+        num_literal_trees = *std::max_element(literal_context_map.begin(), literal_context_map.end()) + 1;
+      }
+
+      // histograms of the symbols.
+      std::vector<uint32_t> literal_counts((size_t)num_literal_trees * 256);
+      std::vector<uint32_t> iandc_counts(iandc_alphabet_size);
+      std::vector<uint32_t> distance_counts(distance_alphabet_size);
+      std::vector<uint32_t> type_counts(num_literal_types + 2);
+      std::vector<uint32_t> len_counts(block_len_symbols);
+      {
+        size_t lit = 0;
+        for (size_t b = 0; b != block_types.size(); ++b) {
+          for (uint32_t j = 0; j != block_lens[b]; ++j, ++lit) {
+            int tree = fast_ ? 0 : literal_context_map[(block_types[b] << literal_context_bits) + contexts[lit]];
+            literal_counts[tree * 256 + literals[lit]]++;
+          }
+        }
+        for (auto &sym : symbols) {
+          iandc_counts[sym.iandc]++;
+          if (sym.distance != no_distance) distance_counts[sym.distance]++;
+        }
+      }
+
+      // block switch commands: 0 = second to last type, 1 = last type + 1, else type + 2.
+      std::vector<uint16_t> type_codes(block_types.size());
+      if (num_literal_types >= 2) {
+        int cur = 0, last = 1;
+        for (size_t b = 0; b != block_types.size(); ++b) {
+          len_counts[block_length_code(block_lens[b])]++;
+          if (b == 0) continue;
+          int type = block_types[b];
+          type_codes[b] = type == last ? 0 : type == (cur + 1) % num_literal_types ? 1 : type + 2;
+          type_counts[type_codes[b]]++;
+          last = cur;
+          cur = type;
+        }
+      }
+
+      // meta-block header
+      // ISLAST
+      w.write(1, 0);
+      write_meta_block_length(w, end - start);
+      // ISUNCOMPRESSED
+      w.write(1, 0);
+
+      prefix_code type_code, len_code;
+      write_256(w, num_literal_types);
+      if (num_literal_types >= 2) {
+        write_prefix_code(w, type_code, type_counts.data(), num_literal_types + 2);
+        write_prefix_code(w, len_code, len_counts.data(), block_len_symbols);
+        int lc = block_length_code(block_lens[0]);
+        len_code.put(w, lc);
+        w.write(brotli_data::kBlockLengthPrefixCode[lc].nbits, block_lens[0] - brotli_data::kBlockLengthPrefixCode[lc].offset);
+      }
+      // NBLTYPESI, NBLTYPESD
+      write_256(w, 1);
+      write_256(w, 1);
+      // NPOSTFIX, NDIRECT
+      w.write(6, 0);
+      for (int i = 0; i != num_literal_types; ++i) {
+        w.write(2, mode);
+      }
+      write_context_map(w, literal_context_map, num_literal_trees);
+      // NTREESD
+      write_256(w, 1);
+
+      std::vector<prefix_code> literal_codes(num_literal_trees);
+      for (int i = 0; i != num_literal_trees; ++i) {
+        write_prefix_code(w, literal_codes[i], literal_counts.data() + i * 256, 256);
+      }
+      prefix_code iandc_code, distance_code;
+      write_prefix_code(w, iandc_code, iandc_counts.data(), iandc_alphabet_size);
+      write_prefix_code(w, distance_code, distance_counts.data(), distance_alphabet_size);
+
+      // commands
+      size_t lit = 0;
+      size_t block = 0;
+      uint32_t block_left = block_lens[0];
+      const uint8_t *tree_map = literal_context_map.data() + (block_types[0] << literal_context_bits);
+      pos = start;
+      for (size_t i = 0; i != commands.size(); ++i) {
+        const command &cmd = commands[i];
+        const command_symbols &sym = symbols[i];
+        iandc_code.put(w, sym.iandc);
+        w.write(sym.insert_bits, sym.insert_extra);
+        w.write(sym.copy_bits, sym.copy_extra);
+        for (uint32_t j = 0; j != cmd.insert_len; ++j, ++lit) {
+          if (block_left == 0) {
+            ++block;
+            type_code.put(w, type_codes[block]);
+            int lc = block_length_code(block_lens[block]);
+            len_code.put(w, lc);
+            w.write(brotli_data::kBlockLengthPrefixCode[lc].nbits, block_lens[block] - brotli_data::kBlockLengthPrefixCode[lc].offset);
+            block_left = block_lens[block];
+            tree_map = literal_context_map.data() + (block_types[block] << literal_context_bits);
+          }
+          --block_left;
+          int tree = fast_ ? 0 : tree_map[contexts[lit]];
+          literal_codes[tree].put(w, literals[lit]);
+        }
+        pos += cmd.insert_len;
+        if (pos >= end) break;
+        if (sym.distance != no_distance) {
+          distance_code.put(w, sym.distance);
+          w.write(sym.distance_bits, sym.distance_extra);
+        }
+        pos += cmd.out_len;
+      }
+    }
+
+  public:
+    // quality is 0 (fastest) to 11 (smallest), lg_window_size is 10 to 24.
+    brotli_encoder(int quality = 11, int lg_window_size = 22) {
+      quality_ = std::max(0, std::min(11, quality));
+      lg_window_size_ = std::max(10, std::min(24, lg_window_size));
+      fast_ = quality_ <= 4;
+      hash_bits_ = 14 + quality_ / 2;
+      hash_ways_log2_ = quality_ <= 1 ? 0 : quality_ - 1;
+      lazy_ = quality_ >= 3;
+      max_scan_ = 4 << std::max(0, quality_ - 5);
+      use_dictionary_ = quality_ >= 6;
+      max_literal_types_ = quality_ >= 9 ? 4 : quality_ >= 7 ? 2 : 1;
+      max_literal_trees_ = quality_ >= 9 ? 64 : 16;
+    }
+
+    // Upper bound of the encoded size of size bytes.
+    static size_t max_encoded_size(size_t size) {
+      return size + (size / max_meta_block_size + 1) * 8 + 8;
+    }
+
+    // Use a custom dictionary, which the decoder must also be given.
+    // Matches may refer to the dictionary as if it came before the input.
+    void set_dictionary(const void *data, size_t size) {
+      dictionary_ = (const uint8_t*)data;
+      dictionary_size_ = data ? size : 0;
+    }
+
+    // Encode src to dest. Returns the end of the encoded data or nullptr if dest is too small.
+    uint8_t *encode(uint8_t *dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max) const {
+      stream_state s;
+      s.max_backward = ((size_t)1 << lg_window_size_) - window_gap;
+      static const int initial_distances[4] = { 16, 15, 11, 4 };
+      std::copy(initial_distances, initial_distances + 4, s.last_distances);
+      s.last_distance_idx = 0;
+      if (fast_) {
+        s.hash_table.assign((size_t)1 << (hash_bits_ + hash_ways_log2_), 0);
+      }
+
+      // With a dictionary, positions are in the dictionary followed by the input so
+      // that the match finders see it as history. Only the last window of it is reachable.
+      size_t prefix = std::min(dictionary_size_, s.max_backward);
+      std::vector<uint8_t> history;
+      if (prefix) {
+        history.reserve(prefix + (src_max - src));
+        history.insert(history.end(), dictionary_ + dictionary_size_ - prefix, dictionary_ + dictionary_size_);
+        history.insert(history.end(), src, src_max);
+        s.src = history.data();
+        s.size = history.size();
+        if (fast_) {
+          for (size_t pos = 0; pos != prefix && pos + min_match <= s.size; ++pos) {
+            hash_insert(s, pos);
+          }
+        }
+      } else {
+        s.src = src;
+        s.size = (size_t)(src_max - src);
+      }
+
+      bit_writer w;
+
+      // WBITS
+      if (lg_window_size_ == 16) {
+        w.write(1, 0);
+      } else if (lg_window_size_ >= 18) {
+        w.write(1, 1);
+        w.write(3, lg_window_size_ - 17);
+      } else {
+        w.write(1, 1);
+        w.write(3, 0);
+        w.write(3, lg_window_size_ == 17 ? 0 : lg_window_size_ - 8);
+      }
+
+      std::vector<command> commands;
+      for (size_t start = prefix; start != s.size; ) {
+        size_t end = std::min(s.size, start + max_meta_block_size);
+        int saved_distances[4];
+        std::copy(s.last_distances, s.last_distances + 4, saved_distances);
+        int saved_idx = s.last_distance_idx;
+
+        commands.clear();
+        if (fast_) {
+          find_matches_fast(s, start, end, commands);
+        } else {
+          find_matches_hq(s, start, end, commands);
+        }
+
+        // the match finders guess the distances; the symbols use the exact ones.
+        std::copy(saved_distances, saved_distances + 4, s.last_distances);
+        s.last_distance_idx = saved_idx;
+
+        size_t mark = w.bit_size();
+        write_compressed_meta_block(w, s, start, end, commands);
+        if (w.bit_size() - mark > (end - start + 4) * 8) {
+          w.truncate(mark);
+          std::copy(saved_distances, saved_distances + 4, s.last_distances);
+          s.last_distance_idx = saved_idx;
+          write_uncompressed_meta_block(w, s.src + start, end - start);
+        }
+        start = end;
+      }
+
+      // ISLAST, ISLASTEMPTY
+      w.write(1, 1);
+      w.write(1, 1);
+      w.align();
+
+      if (w.byte_size() > (size_t)(dest_max - dest)) return nullptr;
+      memcpy(dest, w.data(), w.byte_size());
+      return dest + w.byte_size();
+    }
+
+  private:
+    int quality_;
+    int lg_window_size_;
+    bool fast_;
+    int hash_bits_;
+    int hash_ways_log2_;
+    bool lazy_;
+    int max_scan_;
+    bool use_dictionary_;
+    int max_literal_types_;
+    int max_literal_trees_;
+    const uint8_t *dictionary_ = nullptr;
+    size_t dictionary_size_ = 0;
+  };
+}
+
+#endif
@@ -0,0 +1,433 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// bzip2 decoder.
+//
+//   std::vector<uint8_t> out;
+//   andyzip::bzip2_decoder dec;
+//   if (!dec.decode_append(out, src, src_max)) fail();
+//
+// A bzip2 stream is "BZh" and a block size digit followed by blocks of up to
+// 900k bytes, each the Burrows-Wheeler transform of run length coded data, move
+// to front coded and Huffman coded with up to six tables. Every block has a CRC
+// and the stream ends with a CRC of the block CRCs. Concatenated streams, as
+// written by pbzip2, decode as one.
+//
+// The inverse BWT builds two 32 bit entries per byte, each holding the byte and
+// the index of the next or the previous entry, and follows two chains at once:
+// forwards from the start of the block and backwards from its end. Each step is
+// a cache miss, so having two independent ones in flight nearly halves the time.
+// parallel_bzip2_decoder.hpp decodes the blocks of a stream on many threads.
+//
+// Randomised blocks, only written by bzip2 0.9.0 and earlier, are not supported.
+//
+
+#ifndef ANDYZIP_BZIP2_DECODER_HPP_
+#define ANDYZIP_BZIP2_DECODER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace andyzip {
+  namespace detail {
+    // The bzip2 CRC is CRC-32 with the bits the other way round to zip's.
+    // bzip2_crc_tables()[k][b] is the crc of byte b followed by k zero bytes.
+    struct bzip2_crc_tables_t {
+      uint32_t t[4][256];
+      bzip2_crc_tables_t() {
+        for (uint32_t i = 0; i != 256; ++i) {
+          uint32_t c = i << 24;
+          for (int k = 0; k != 8; ++k) c = c & 0x80000000 ? (c << 1) ^ 0x04c11db7 : c << 1;
+          t[0][i] = c;
+        }
+        for (int k = 1; k != 4; ++k) {
+          for (uint32_t i = 0; i != 256; ++i) {
+            uint32_t c = t[k-1][i];
+            t[k][i] = (c << 8) ^ t[0][c >> 24];
+          }
+        }
+      }
+    };
+
+    static inline const bzip2_crc_tables_t &bzip2_crc_tables() {
+      static const bzip2_crc_tables_t tables;
+      return tables;
+    }
+
+    // Running bzip2 CRC, starting from zero, as for crc32(). Slicing by four.
+    static inline uint32_t bzip2_crc(uint32_t crc, const uint8_t *p, size_t size) {
+      const bzip2_crc_tables_t &t = bzip2_crc_tables();
+      crc = ~crc;
+      for (; size >= 4; size -= 4, p += 4) {
+        crc ^= (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+        crc = t.t[3][crc >> 24] ^ t.t[2][(crc >> 16) & 0xff] ^ t.t[1][(crc >> 8) & 0xff] ^ t.t[0][crc & 0xff];
+      }
+      for (; size; --size) {
+        crc = (crc << 8) ^ t.t[0][(crc >> 24) ^ *p++];
+      }
+      return ~crc;
+    }
+  }
+
+  class bzip2_decoder {
+  public:
+    enum {
+      max_block_size = 900000,
+      max_groups = 6,
+      max_code_length = 20,
+      group_size = 50,
+    };
+
+    struct workspace;
+
+    // Decode one or more bzip2 streams, appending the output to out.
+    // Returns the first byte after the last stream or nullptr on failure.
+    const uint8_t *decode_append(std::vector<uint8_t> &out, const uint8_t *src, const uint8_t *src_max) const {
+      size_t start = out.size();
+      workspace ws;
+      const uint8_t *p = src;
+      do {
+        p = decode_stream(out, p, src_max, ws);
+        if (!p) {
+          out.resize(start);
+          return nullptr;
+        }
+      } while (block_size(p, src_max));
+      return p;
+    }
+
+    // The largest block of the stream with this header, or 0 if src is not the start of a stream.
+    static unsigned block_size(const uint8_t *src, const uint8_t *src_max) {
+      if (src_max - src < 4 || src[0] != 'B' || src[1] != 'Z' || src[2] != 'h' || src[3] < '1' || src[3] > '9') return 0;
+      return (src[3] - '0') * 100000;
+    }
+
+    // Decode the block whose magic is at bit offset bit from src, appending it to out.
+    // block_size is from the stream header. On success, bit is the offset after the
+    // block and crc the block's CRC, which the output has been checked against.
+    bool decode_block(std::vector<uint8_t> &out, const uint8_t *src, const uint8_t *src_max, uint64_t &bit, unsigned block_size, workspace &ws, uint32_t &crc) const {
+      bit_reader in(src, src_max, bit);
+      if (in.get(24) != 0x314159 || in.get(24) != 0x265359) return false;
+      crc = in.get(32);
+      size_t start = out.size();
+      if (!decode_block_body(out, in, block_size, ws) || detail::bzip2_crc(0, out.data() + start, out.size() - start) != crc) {
+        out.resize(start);
+        return false;
+      }
+      bit = in.position();
+      return true;
+    }
+
+    // If the end of stream marker is at bit offset bit from src, set crc to the
+    // stream's CRC and bit to the offset after it and return true.
+    bool decode_end(const uint8_t *src, const uint8_t *src_max, uint64_t &bit, uint32_t &crc) const {
+      bit_reader in(src, src_max, bit);
+      if (in.get(24) != 0x177245 || in.get(24) != 0x385090) return false;
+      crc = in.get(32);
+      if (in.overrun()) return false;
+      bit = in.position();
+      return true;
+    }
+
+  private:
+    // Reads bits most significant first. Bytes past the end read as zero;
+    // overrun() says if any were used.
+    class bit_reader {
+    public:
+      bit_reader(const uint8_t *src, const uint8_t *src_max, uint64_t bit) : src_(src), size_((size_t)(src_max - src)), i_((size_t)(bit / 8)) {
+        refill();
+        skip((unsigned)(bit & 7));
+      }
+
+      // Make sure there are at least 57 bits in the buffer.
+      void refill() {
+        while (count_ <= 56) {
+          uint64_t b = i_ < size_ ? src_[i_] : 0;
+          bits_ |= b << (56 - count_);
+          i_++;
+          count_ += 8;
+        }
+      }
+
+      // The next n bits, 1 <= n <= 32, after a refill().
+      unsigned peek(unsigned n) const { return (unsigned)(bits_ >> (64 - n)); }
+      void skip(unsigned n) { bits_ <<= n; count_ -= n; }
+
+      unsigned get(unsigned n) {
+        refill();
+        unsigned value = peek(n);
+        skip(n);
+        return value;
+      }
+
+      // Bit offset of the next bit from src.
+      uint64_t position() const { return (uint64_t)i_ * 8 - count_; }
+      bool overrun() const { return position() > (uint64_t)size_ * 8; }
+
+    private:
+      const uint8_t *src_;
+      size_t size_;
+      size_t i_;
+      uint64_t bits_ = 0;
+      unsigned count_ = 0;
+    };
+
+    // Canonical Huffman code of up to 258 symbols and 20 bits. Codes of up to
+    // fast_bits are looked up in one go and longer ones by comparing with the
+    // left justified ends of each length.
+    class huffman {
+    public:
+      enum { fast_bits = 10 };
+
+      bool init(const uint8_t *lengths, unsigned num_symbols) {
+        unsigned count[max_code_length + 1] = {};
+        for (unsigned i = 0; i != num_symbols; ++i) count[lengths[i]]++;
+
+        // perm_ holds the symbols in code order, base_[len] maps a code of len to perm_.
+        unsigned code = 0, offset = 0;
+        unsigned offsets[max_code_length + 1];
+        for (unsigned len = 1; len <= max_code_length; ++len) {
+          offsets[len] = offset;
+          base_[len] = (int)offset - (int)code;
+          code += count[len];
+          if (code > (1u << len)) return false;
+          limit_[len] = code << (max_code_length - len);
+          offset += count[len];
+          code <<= 1;
+        }
+        for (unsigned i = 0; i != num_symbols; ++i) {
+          perm_[offsets[lengths[i]]++] = (uint16_t)i;
+        }
+
+        for (unsigned v = 0; v != 1u << fast_bits; ++v) {
+          unsigned left = v << (max_code_length - fast_bits);
+          uint16_t entry = 0;
+          for (unsigned len = 1; len <= fast_bits; ++len) {
+            if (left < limit_[len]) {
+              entry = (uint16_t)(perm_[base_[len] + (left >> (max_code_length - len))] << 5 | len);
+              break;
+            }
+          }
+          fast_[v] = entry;
+        }
+        return true;
+      }
+
+      // The next symbol, or ~0 if the bits are not a code. Needs 20 bits in the reader.
+      unsigned decode(bit_reader &in) const {
+        unsigned v = in.peek(max_code_length);
+        unsigned entry = fast_[v >> (max_code_length - fast_bits)];
+        if (entry) {
+          in.skip(entry & 31);
+          return entry >> 5;
+        }
+        unsigned len = fast_bits + 1;
+        while (v >= limit_[len]) {
+          if (++len > max_code_length) return ~0u;
+        }
+        in.skip(len);
+        return perm_[base_[len] + (v >> (max_code_length - len))];
+      }
+
+    private:
+      uint16_t fast_[1 << fast_bits];
+      uint32_t limit_[max_code_length + 1];
+      int base_[max_code_length + 1];
+      uint16_t perm_[258];
+    };
+
+  public:
+    // Memory reused from block to block.
+    struct workspace {
+      std::vector<uint32_t> tt;   // byte and index of the next entry
+      std::vector<uint32_t> lf;   // byte and index of the previous entry
+      std::vector<uint8_t> block;
+      std::vector<uint8_t> selectors;
+      huffman tables[max_groups];
+    };
+
+  private:
+    const uint8_t *decode_stream(std::vector<uint8_t> &out, const uint8_t *src, const uint8_t *src_max, workspace &ws) const {
+      unsigned size = block_size(src, src_max);
+      if (!size) return nullptr;
+      uint64_t bit = 32;
+      uint32_t combined_crc = 0, crc;
+      for (;;) {
+        if (decode_end(src, src_max, bit, crc)) {
+          // then padding to a byte.
+          return crc == combined_crc ? src + (bit + 7) / 8 : nullptr;
+        }
+        if (!decode_block(out, src, src_max, bit, size, ws, crc)) return nullptr;
+        combined_crc = (combined_crc << 1 | combined_crc >> 31) ^ crc;
+      }
+    }
+
+    // Decode a block after its magic and CRC, appending it to out.
+    bool decode_block_body(std::vector<uint8_t> &out, bit_reader &in, unsigned block_size, workspace &ws) const {
+      if (in.get(1)) return false;  // randomised
+      unsigned orig_ptr = in.get(24);
+
+      // the bytes used, as a 16 bit map of 16 bit maps.
+      uint8_t seq_to_unseq[256];
+      unsigned num_used = 0;
+      unsigned used16 = in.get(16);
+      for (unsigned i = 0; i != 16; ++i) {
+        if (used16 & (0x8000 >> i)) {
+          unsigned used = in.get(16);
+          for (unsigned j = 0; j != 16; ++j) {
+            if (used & (0x8000 >> j)) seq_to_unseq[num_used++] = (uint8_t)(i * 16 + j);
+          }
+        }
+      }
+      if (num_used == 0) return false;
+      unsigned alpha_size = num_used + 2;
+
+      // which table each group of 50 symbols uses, move to front coded in unary.
+      unsigned num_groups = in.get(3);
+      unsigned num_selectors = in.get(15);
+      if (num_groups < 2 || num_groups > max_groups || num_selectors == 0) return false;
+      ws.selectors.resize(num_selectors);
+      uint8_t group_mtf[max_groups] = { 0, 1, 2, 3, 4, 5 };
+      for (unsigned i = 0; i != num_selectors; ++i) {
+        unsigned j = 0;
+        while (in.get(1)) {
+          if (++j == num_groups) return false;
+        }
+        uint8_t g = group_mtf[j];
+        for (; j != 0; --j) group_mtf[j] = group_mtf[j-1];
+        group_mtf[0] = g;
+        ws.selectors[i] = g;
+      }
+      if (in.overrun()) return false;
+
+      // code lengths, delta coded from a five bit start.
+      for (unsigned t = 0; t != num_groups; ++t) {
+        uint8_t lengths[258];
+        unsigned len = in.get(5);
+        for (unsigned i = 0; i != alpha_size; ++i) {
+          for (;;) {
+            if (len < 1 || len > max_code_length) return false;
+            if (!in.get(1)) break;
+            len = in.get(1) ? len - 1 : len + 1;
+          }
+          lengths[i] = (uint8_t)len;
+        }
+        if (!ws.tables[t].init(lengths, alpha_size)) return false;
+      }
+
+      // Huffman coded move to front indices with runs of index zero coded in
+      // bijective base 2 by RUNA and RUNB. tt gets the last column of the BWT.
+      ws.tt.resize(block_size);
+      uint32_t *tt = ws.tt.data();
+      unsigned counts[256] = {};
+      uint8_t mtf[256];
+      for (unsigned i = 0; i != 256; ++i) mtf[i] = (uint8_t)i;
+      unsigned eob = alpha_size - 1;
+      unsigned n = 0, run = 0, run_weight = 1;
+      unsigned selector = 0, group_left = 0;
+      const huffman *table = nullptr;
+      for (;;) {
+        if (group_left == 0) {
+          if (selector == num_selectors) return false;
+          table = &ws.tables[ws.selectors[selector++]];
+          group_left = group_size;
+        }
+        group_left--;
+        in.refill();
+        unsigned sym = table->decode(in);
+        if (sym == ~0u) return false;
+        if (sym <= 1) {
+          if (run_weight > block_size) return false;
+          run += run_weight << sym;
+          run_weight <<= 1;
+          continue;
+        }
+        if (run) {
+          uint8_t b = seq_to_unseq[mtf[0]];
+          if (run > block_size - n) return false;
+          counts[b] += run;
+          for (unsigned i = 0; i != run; ++i) tt[n++] = b;
+          run = 0;
+        }
+        run_weight = 1;
+        if (sym == eob) break;
+
+        unsigned index = sym - 1;
+        uint8_t v = mtf[index];
+        memmove(mtf + 1, mtf, index);
+        mtf[0] = v;
+        uint8_t b = seq_to_unseq[v];
+        if (n == block_size) return false;
+        counts[b]++;
+        tt[n++] = b;
+      }
+      if (in.overrun() || orig_ptr >= n) return false;
+
+      // link each entry of the last column to the next one and back: the entries
+      // of each byte appear in the same order in the first column.
+      ws.lf.resize(n);
+      uint32_t *lf = ws.lf.data();
+      unsigned next[256];
+      for (unsigned b = 0, sum = 0; b != 256; ++b) {
+        next[b] = sum;
+        sum += counts[b];
+      }
+      for (unsigned i = 0; i != n; ++i) {
+        uint32_t b = tt[i] & 0xff;
+        uint32_t j = next[b]++;
+        tt[j] |= i << 8;
+        lf[i] = j << 8 | b;
+      }
+
+      // the chain from orig_ptr visits every entry and ends at orig_ptr, the last byte.
+      ws.block.resize(n);
+      uint8_t *block = ws.block.data();
+      uint32_t pos = tt[orig_ptr] >> 8, back = orig_ptr;
+      unsigned half = n / 2;
+      for (unsigned i = 0; i != half; ++i) {
+        uint32_t entry = tt[pos];
+        uint32_t back_entry = lf[back];
+        block[i] = (uint8_t)entry;
+        block[n - 1 - i] = (uint8_t)back_entry;
+        pos = entry >> 8;
+        back = back_entry >> 8;
+      }
+      if (n & 1) block[half] = (uint8_t)tt[pos];
+      return undo_initial_rle(out, block, n);
+    }
+
+    // Four equal bytes are followed by a count of 0 to 255 more.
+    static bool undo_initial_rle(std::vector<uint8_t> &out, const uint8_t *block, unsigned n) {
+      size_t size = 0;
+      for (unsigned i = 0, same = 0; i != n; ++i) {
+        if (same == 4) {
+          size += block[i];
+          same = 0;
+        } else {
+          same = i != 0 && same != 0 && block[i] == block[i-1] ? same + 1 : 1;
+          size++;
+        }
+      }
+
+      size_t start = out.size();
+      out.resize(start + size);
+      uint8_t *dest = out.data() + start;
+      for (unsigned i = 0, same = 0; i != n; ++i) {
+        if (same == 4) {
+          memset(dest, block[i-1], block[i]);
+          dest += block[i];
+          same = 0;
+        } else {
+          same = i != 0 && same != 0 && block[i] == block[i-1] ? same + 1 : 1;
+          *dest++ = block[i];
+        }
+      }
+      return true;
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,252 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// CRC-32 (gzip, zip, png) and Adler-32 (zlib) checksums.
+//
+// Both take the running value so that data can be checksummed in pieces:
+//
+//   uint32_t crc = andyzip::crc32(0, a, a_size);
+//   crc = andyzip::crc32(crc, b, b_size);
+//
+// CRC-32 uses carry-less multiply folding when built with -mpclmul -msse4.1
+// and slicing by eight otherwise. Adler-32 uses SSE2 on x86-64. On x86-64 with
+// GCC, clang or MSVC, the folding and an AVX2 Adler-32 are also compiled for their
+// instruction sets and used when the CPU has them (see cpu_features.hpp).
+//
+
+#ifndef ANDYZIP_CHECKSUM_HPP_
+#define ANDYZIP_CHECKSUM_HPP_
+
+#include <andyzip/cpu_features.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define ANDYZIP_ADLER32_SSE2 1
+#endif
+
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+  #include <wmmintrin.h>
+  #include <smmintrin.h>
+  #define ANDYZIP_CRC32_PCLMUL 1
+#elif defined(ANDYZIP_X86_DISPATCH) && (defined(__x86_64__) || defined(_M_X64))
+  // chosen at run time.
+  #include <immintrin.h>
+  #define ANDYZIP_CRC32_PCLMUL 2
+#endif
+
+#if defined(ANDYZIP_X86_DISPATCH) && (defined(__x86_64__) || defined(_M_X64))
+  #include <immintrin.h>
+  #define ANDYZIP_ADLER32_AVX2 1
+#endif
+
+namespace andyzip {
+  namespace detail {
+    // crc32_tables()[k][b] is the crc of byte b followed by k zero bytes.
+    struct crc32_tables_t {
+      uint32_t t[8][256];
+      crc32_tables_t() {
+        for (uint32_t i = 0; i != 256; ++i) {
+          uint32_t c = i;
+          for (int k = 0; k != 8; ++k) c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+          t[0][i] = c;
+        }
+        for (uint32_t i = 0; i != 256; ++i) {
+          for (int k = 1; k != 8; ++k) t[k][i] = (t[k-1][i] >> 8) ^ t[0][t[k-1][i] & 0xff];
+        }
+      }
+    };
+
+    static inline const crc32_tables_t &crc32_tables() {
+      static const crc32_tables_t tables;
+      return tables;
+    }
+
+    // Slicing by eight: eight table lookups per eight bytes. crc is not inverted.
+    static inline uint32_t crc32_slice8(uint32_t crc, const uint8_t *p, size_t size) {
+      const uint32_t (*t)[256] = crc32_tables().t;
+      for (; size >= 8; size -= 8, p += 8) {
+        uint32_t lo = crc ^ (p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24);
+        uint32_t hi = p[4] | p[5] << 8 | p[6] << 16 | (uint32_t)p[7] << 24;
+        crc =
+          t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+          t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24]
+        ;
+      }
+      for (; size; --size) crc = t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+      return crc;
+    }
+
+  #ifdef ANDYZIP_CRC32_PCLMUL
+    ANDYZIP_TARGET("pclmul,sse4.1")
+    static inline __m128i crc32_fold(__m128i x, __m128i k, __m128i data) {
+      __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+      __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+      return _mm_xor_si128(_mm_xor_si128(lo, hi), data);
+    }
+
+    // Fold 64 bytes at a time with carry-less multiplies, then reduce
+    // (Intel, "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ").
+    // size must be a multiple of 16 and at least 64. crc is not inverted.
+    ANDYZIP_TARGET("pclmul,sse4.1")
+    static inline uint32_t crc32_pclmul(uint32_t crc, const uint8_t *p, size_t size) {
+      const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+      const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+      const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+      const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+      const __m128i mask32 = _mm_set_epi32(0, 0, 0, -1);
+
+      __m128i x0 = _mm_loadu_si128((const __m128i*)(p + 0x00));
+      __m128i x1 = _mm_loadu_si128((const __m128i*)(p + 0x10));
+      __m128i x2 = _mm_loadu_si128((const __m128i*)(p + 0x20));
+      __m128i x3 = _mm_loadu_si128((const __m128i*)(p + 0x30));
+      x0 = _mm_xor_si128(x0, _mm_cvtsi32_si128((int)crc));
+      p += 64;
+      size -= 64;
+
+      for (; size >= 64; size -= 64, p += 64) {
+        x0 = crc32_fold(x0, k1k2, _mm_loadu_si128((const __m128i*)(p + 0x00)));
+        x1 = crc32_fold(x1, k1k2, _mm_loadu_si128((const __m128i*)(p + 0x10)));
+        x2 = crc32_fold(x2, k1k2, _mm_loadu_si128((const __m128i*)(p + 0x20)));
+        x3 = crc32_fold(x3, k1k2, _mm_loadu_si128((const __m128i*)(p + 0x30)));
+      }
+
+      // fold the four lanes into one, then any remaining 16 byte blocks.
+      x0 = crc32_fold(x0, k3k4, x1);
+      x0 = crc32_fold(x0, k3k4, x2);
+      x0 = crc32_fold(x0, k3k4, x3);
+      for (; size >= 16; size -= 16, p += 16) {
+        x0 = crc32_fold(x0, k3k4, _mm_loadu_si128((const __m128i*)p));
+      }
+
+      // 128 bits to 64 bits.
+      __m128i x = _mm_xor_si128(_mm_clmulepi64_si128(x0, k3k4, 0x10), _mm_srli_si128(x0, 8));
+      x = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x, mask32), k5k0, 0x00), _mm_srli_si128(x, 4));
+
+      // Barrett reduction to 32 bits.
+      __m128i t = _mm_clmulepi64_si128(_mm_and_si128(x, mask32), poly, 0x10);
+      t = _mm_clmulepi64_si128(_mm_and_si128(t, mask32), poly, 0x00);
+      return (uint32_t)_mm_extract_epi32(_mm_xor_si128(x, t), 1);
+    }
+  #endif
+
+  #ifdef ANDYZIP_ADLER32_SSE2
+    // Adler-32 sums of blocks of 16 bytes, without the modulo.
+    // per 16 bytes: b += 16 * a + sum((16 - i) * p[i]), a += sum(p[i]).
+    static inline void adler32_sse2(uint32_t &a, uint32_t &b, const uint8_t *p, size_t blocks) {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i weights_hi = _mm_set_epi16(9, 10, 11, 12, 13, 14, 15, 16);
+      const __m128i weights_lo = _mm_set_epi16(1, 2, 3, 4, 5, 6, 7, 8);
+      __m128i va = _mm_cvtsi32_si128((int)a);
+      __m128i vb = _mm_cvtsi32_si128((int)b);
+      __m128i va_sum = zero;
+      for (; blocks; --blocks, p += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)p);
+        va_sum = _mm_add_epi32(va_sum, va);
+        va = _mm_add_epi32(va, _mm_sad_epu8(bytes, zero));
+        __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+        __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+        vb = _mm_add_epi32(vb, _mm_madd_epi16(lo, weights_hi));
+        vb = _mm_add_epi32(vb, _mm_madd_epi16(hi, weights_lo));
+      }
+      vb = _mm_add_epi32(vb, _mm_slli_epi32(va_sum, 4));
+      // horizontal sums: va has two 64 bit lanes, vb four 32 bit lanes.
+      va = _mm_add_epi32(va, _mm_srli_si128(va, 8));
+      vb = _mm_add_epi32(vb, _mm_srli_si128(vb, 8));
+      vb = _mm_add_epi32(vb, _mm_srli_si128(vb, 4));
+      a = (uint32_t)_mm_cvtsi128_si32(va);
+      b = (uint32_t)_mm_cvtsi128_si32(vb);
+    }
+  #endif
+
+  #ifdef ANDYZIP_ADLER32_AVX2
+    ANDYZIP_TARGET("avx2")
+    static inline uint32_t sum_epi32(__m256i v) {
+      __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+      s = _mm_add_epi32(s, _mm_srli_si128(s, 8));
+      s = _mm_add_epi32(s, _mm_srli_si128(s, 4));
+      return (uint32_t)_mm_cvtsi128_si32(s);
+    }
+
+    // Adler-32 sums of blocks of 32 bytes, without the modulo.
+    // per 32 bytes: b += 32 * a + sum((32 - i) * p[i]), a += sum(p[i]).
+    ANDYZIP_TARGET("avx2")
+    static inline void adler32_avx2(uint32_t &a, uint32_t &b, const uint8_t *p, size_t blocks) {
+      const __m256i zero = _mm256_setzero_si256();
+      const __m256i weights = _mm256_set_epi8(
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+        17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32
+      );
+      const __m256i ones = _mm256_set1_epi16(1);
+      __m256i va = _mm256_setr_epi32((int)a, 0, 0, 0, 0, 0, 0, 0);
+      __m256i vb = zero;
+      __m256i va_sum = zero;
+      for (; blocks; --blocks, p += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*)p);
+        va_sum = _mm256_add_epi32(va_sum, va);
+        va = _mm256_add_epi32(va, _mm256_sad_epu8(bytes, zero));
+        vb = _mm256_add_epi32(vb, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), ones));
+      }
+      vb = _mm256_add_epi32(vb, _mm256_slli_epi32(va_sum, 5));
+      a = sum_epi32(va);
+      b += sum_epi32(vb);
+    }
+  #endif
+  }
+
+  // CRC-32 with the polynomial used by gzip, zip and png.
+  static inline uint32_t crc32(uint32_t crc, const void *data, size_t size) {
+    const uint8_t *p = (const uint8_t*)data;
+    crc = ~crc;
+    #ifdef ANDYZIP_CRC32_PCLMUL
+      if (size >= 64 && (ANDYZIP_CRC32_PCLMUL == 1 || (cpu_features().pclmul && cpu_features().sse41))) {
+        size_t n = size & ~(size_t)15;
+        crc = detail::crc32_pclmul(crc, p, n);
+        p += n;
+        size -= n;
+      }
+    #endif
+    return ~detail::crc32_slice8(crc, p, size);
+  }
+
+  // Adler-32 as used by zlib. Start with 1.
+  static inline uint32_t adler32(uint32_t adler, const void *data, size_t size) {
+    enum { base = 65521, nmax = 5552 };
+    const uint8_t *p = (const uint8_t*)data;
+    uint32_t a = adler & 0xffff;
+    uint32_t b = adler >> 16;
+    while (size) {
+      // nmax is the most bytes we can sum before b overflows 32 bits.
+      size_t n = size < (size_t)nmax ? size : (size_t)nmax;
+      size -= n;
+      #ifdef ANDYZIP_ADLER32_AVX2
+        if (n >= 32 && cpu_features().avx2) {
+          size_t blocks = n / 32;
+          detail::adler32_avx2(a, b, p, blocks);
+          p += blocks * 32;
+          n -= blocks * 32;
+        }
+      #endif
+      #ifdef ANDYZIP_ADLER32_SSE2
+        if (n >= 16) {
+          size_t blocks = n / 16;
+          detail::adler32_sse2(a, b, p, blocks);
+          p += blocks * 16;
+          n -= blocks * 16;
+        }
+      #endif
+      for (; n; --n) {
+        a += *p++;
+        b += a;
+      }
+      a %= base;
+      b %= base;
+    }
+    return b << 16 | a;
+  }
+}
+
+#endif
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Run time CPU feature detection.
+//
+// The library is header only, so it compiles for whatever flags the program is
+// built with and a baseline x86-64 build would never use the newer instructions.
+// Kernels that gain from them are also compiled for their instruction set with
+// ANDYZIP_TARGET and chosen at run time:
+//
+//   ANDYZIP_TARGET("avx2") static inline void kernel_avx2(...) { ... }
+//
+//   if (andyzip::cpu_features().avx2) kernel_avx2(...); else kernel(...);
+//
+// cpuid runs once, on the first call. The features are only set when the OS
+// saves the wider registers too. A program may clear features at start up, for
+// example to test the fallbacks; cpu_features() is shared by the whole program.
+//
+// ANDYZIP_X86_DISPATCH is defined where this works: x86 with GCC, clang or MSVC.
+//
+
+#ifndef ANDYZIP_CPU_FEATURES_HPP_
+#define ANDYZIP_CPU_FEATURES_HPP_
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+  #include <cpuid.h>
+  #define ANDYZIP_X86_DISPATCH 1
+  #define ANDYZIP_TARGET(t) __attribute__((target(t)))
+#elif defined(_M_X64) || defined(_M_IX86)
+  #include <intrin.h>
+  #define ANDYZIP_X86_DISPATCH 1
+  // MSVC lets any function use any intrinsic.
+  #define ANDYZIP_TARGET(t)
+#else
+  #define ANDYZIP_TARGET(t)
+#endif
+
+namespace andyzip {
+  struct cpu_feature_set {
+    bool sse2 = false;
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool pclmul = false;
+    bool avx2 = false;
+    bool bmi2 = false;
+    bool avx512bw = false;    // with avx512f and avx512vl
+    bool avx512vbmi = false;
+    bool vpclmul = false;     // 256 bit carry-less multiply, with avx2
+  };
+
+  namespace detail {
+    #ifdef ANDYZIP_X86_DISPATCH
+      // registers[] gets eax, ebx, ecx, edx.
+      static inline void cpuid(unsigned leaf, unsigned subleaf, unsigned *registers) {
+        #if defined(__GNUC__)
+          __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+        #else
+          int r[4];
+          __cpuidex(r, (int)leaf, (int)subleaf);
+          for (int i = 0; i != 4; ++i) registers[i] = (unsigned)r[i];
+        #endif
+      }
+
+      // Which register states the OS saves on a context switch.
+      static inline unsigned long long xgetbv() {
+        #if defined(__GNUC__)
+          unsigned lo, hi;
+          __asm__ volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+          return (unsigned long long)hi << 32 | lo;
+        #else
+          return _xgetbv(0);
+        #endif
+      }
+    #endif
+
+    static inline cpu_feature_set detect_cpu_features() {
+      cpu_feature_set f;
+      #ifdef ANDYZIP_X86_DISPATCH
+        unsigned r[4];
+        cpuid(0, 0, r);
+        unsigned max_leaf = r[0];
+        if (max_leaf < 1) return f;
+
+        cpuid(1, 0, r);
+        f.sse2 = (r[3] >> 26) & 1;
+        f.ssse3 = (r[2] >> 9) & 1;
+        f.sse41 = (r[2] >> 19) & 1;
+        f.pclmul = (r[2] >> 1) & 1;
+        bool osxsave = (r[2] >> 27) & 1;
+        bool avx = (r[2] >> 28) & 1;
+
+        // xmm and ymm state for AVX, and the opmask and zmm state for AVX-512.
+        unsigned long long xcr0 = osxsave ? xgetbv() : 0;
+        bool os_avx = avx && (xcr0 & 0x06) == 0x06;
+        bool os_avx512 = os_avx && (xcr0 & 0xe0) == 0xe0;
+
+        if (max_leaf >= 7) {
+          cpuid(7, 0, r);
+          f.bmi2 = (r[1] >> 8) & 1;
+          f.avx2 = os_avx && ((r[1] >> 5) & 1);
+          bool avx512f = (r[1] >> 16) & 1, avx512vl = (r[1] >> 31) & 1;
+          f.avx512bw = os_avx512 && avx512f && avx512vl && ((r[1] >> 30) & 1);
+          f.avx512vbmi = f.avx512bw && ((r[2] >> 1) & 1);
+          f.vpclmul = f.avx2 && f.pclmul && ((r[2] >> 10) & 1);
+        }
+      #endif
+      return f;
+    }
+  }
+
+  // The features of this CPU, detected on the first call.
+  inline cpu_feature_set &cpu_features() {
+    static cpu_feature_set features = detail::detect_cpu_features();
+    return features;
+  }
+}
+
+#endif
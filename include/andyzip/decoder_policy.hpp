@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Compile-time options for deflate_decoder and brotli_decoder.
+//
+// Each option is an enum of the policy class, so the decoders test them with
+// plain ifs that the compiler folds away and every combination gets its own
+// loop with only the code it needs. decoder_options sets them all at once:
+//
+//   basic_deflate_decoder<decoder_options<1, 0, 65536, ring_output>>
+//
+// is a checked deflate64 decoder without stats that streams its output.
+//
+// checked_input bounds checks every read of the compressed data, so corrupt or
+// truncated input can only make decoding fail. Use it for anything from outside.
+//
+// trusted_input drops the per-symbol end of input checks. The bit readers load
+// four bytes at a time and may read up to four bytes past the end of the input,
+// so the input must be valid and have four readable bytes after it.
+//
+// with_stats<Policy> also counts what is decoded (see decoder_stats.hpp).
+//
+// deflate64_format<Policy> has a 64k window, which makes deflate_decoder read
+// deflate64, PKWARE's "enhanced deflate" (zip method 9): distance codes 30 and 31
+// and length code 285 with 16 extra bits. brotli_decoder ignores the window size.
+//
+// with_ring_output<Policy> lets deflate_decoder::decode_to() stream the output
+// of a deflate stream of any size through a buffer of the window and a chunk.
+//
+
+#ifndef ANDYZIP_DECODER_POLICY_HPP_
+#define ANDYZIP_DECODER_POLICY_HPP_
+
+namespace andyzip {
+  // Where deflate_decoder puts its output.
+  enum decoder_output {
+    flat_output,   // one buffer that holds the whole stream
+    ring_output,   // also a window sized buffer handed to a callback as it fills
+  };
+
+  template <int Checked, int Stats = 0, unsigned WindowSize = 32768, decoder_output Output = flat_output>
+  struct decoder_options {
+    enum { checked = Checked, stats = Stats, window_size = WindowSize, output = Output };
+  };
+
+  struct checked_input : decoder_options<1> {
+  };
+
+  struct trusted_input : decoder_options<0> {
+  };
+
+  template <class Policy>
+  struct with_stats : decoder_options<Policy::checked, 1, Policy::window_size, (decoder_output)Policy::output> {
+  };
+
+  template <class Policy>
+  struct deflate64_format : decoder_options<Policy::checked, Policy::stats, 65536, (decoder_output)Policy::output> {
+  };
+
+  template <class Policy>
+  struct with_ring_output : decoder_options<Policy::checked, Policy::stats, Policy::window_size, ring_output> {
+  };
+}
+
+#endif
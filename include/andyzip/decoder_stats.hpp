@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Decoder instrumentation.
+//
+// A decoder built with a stats policy, eg. basic_deflate_decoder<with_stats<checked_input>>,
+// counts what it decodes in a decoder_stats: block types, literals and matches,
+// match length and distance histograms, Huffman table builds, code lengths,
+// dictionary references, block switches and the time spent reading headers
+// and decoding symbols.
+//
+// Other decoders use no_decoder_stats, whose members do nothing, so the
+// counting compiles away.
+//
+
+#ifndef ANDYZIP_DECODER_STATS_HPP_
+#define ANDYZIP_DECODER_STATS_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+namespace andyzip {
+  struct decoder_stats {
+    // deflate block types. Brotli uncompressed meta-blocks count as stored,
+    // compressed meta-blocks as dynamic and skipped metadata as metadata.
+    enum block_kind { stored_block, fixed_block, dynamic_block, metadata_block, num_block_kinds };
+
+    enum { histogram_size = 32 };
+
+    uint64_t blocks[num_block_kinds] = {};
+    uint64_t literals = 0;
+    uint64_t matches = 0;
+    uint64_t match_bytes = 0;
+    uint64_t length_histogram[histogram_size] = {};    // matches by floor(log2(length))
+    uint64_t distance_histogram[histogram_size] = {};  // matches by floor(log2(distance))
+    uint64_t huffman_builds = 0;
+    uint64_t codes = 0;            // Huffman coded symbols in the symbol loop
+    uint64_t code_bits = 0;        // and their total length
+    uint64_t dictionary_refs = 0;  // brotli static dictionary or deflate preset dictionary
+    uint64_t block_switches = 0;   // brotli only
+    uint64_t header_ns = 0;
+    uint64_t symbol_ns = 0;
+
+    void clear() {
+      *this = decoder_stats();
+    }
+
+    void block(block_kind kind) { blocks[kind]++; }
+    void literal() { literals++; }
+    void match(unsigned length, unsigned distance) {
+      matches++;
+      match_bytes += length;
+      length_histogram[log2(length)]++;
+      distance_histogram[log2(distance)]++;
+    }
+    void code(unsigned bits) { codes++; code_bits += bits; }
+    void huffman_build() { huffman_builds++; }
+    void dictionary_ref() { dictionary_refs++; }
+    void block_switch() { block_switches++; }
+
+    // t = now(); ...; header_time(t);
+    uint64_t now() const {
+      return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    void header_time(uint64_t start) { header_ns += now() - start; }
+    void symbol_time(uint64_t start) { symbol_ns += now() - start; }
+
+    double average_code_length() const {
+      return codes ? (double)code_bits / codes : 0;
+    }
+
+    void print(FILE *fp) const {
+      fprintf(fp, "blocks: %llu stored, %llu fixed, %llu dynamic, %llu metadata\n", (unsigned long long)blocks[stored_block], (unsigned long long)blocks[fixed_block], (unsigned long long)blocks[dynamic_block], (unsigned long long)blocks[metadata_block]);
+      fprintf(fp, "literals: %llu  matches: %llu (%llu bytes)  dictionary refs: %llu\n", (unsigned long long)literals, (unsigned long long)matches, (unsigned long long)match_bytes, (unsigned long long)dictionary_refs);
+      fprintf(fp, "huffman builds: %llu  block switches: %llu  average code length: %.2f bits\n", (unsigned long long)huffman_builds, (unsigned long long)block_switches, average_code_length());
+      fprintf(fp, "time: %.3fms headers, %.3fms symbols\n", header_ns * 1e-6, symbol_ns * 1e-6);
+      print_histogram(fp, "match lengths", length_histogram);
+      print_histogram(fp, "match distances", distance_histogram);
+    }
+
+  private:
+    static unsigned log2(unsigned value) {
+      unsigned result = 0;
+      while (value >>= 1) ++result;
+      return result;
+    }
+
+    static void print_histogram(FILE *fp, const char *name, const uint64_t *histogram) {
+      fprintf(fp, "%s:", name);
+      for (unsigned i = 0; i != histogram_size; ++i) {
+        if (histogram[i]) fprintf(fp, " %u-%u:%llu", 1u << i, (2u << i) - 1, (unsigned long long)histogram[i]);
+      }
+      fprintf(fp, "\n");
+    }
+  };
+
+  // The same interface as decoder_stats, doing nothing.
+  struct no_decoder_stats {
+    no_decoder_stats() {}
+    no_decoder_stats(decoder_stats &) {}
+
+    void clear() {}
+    void block(decoder_stats::block_kind) {}
+    void literal() {}
+    void match(unsigned, unsigned) {}
+    void code(unsigned) {}
+    void huffman_build() {}
+    void dictionary_ref() {}
+    void block_switch() {}
+    uint64_t now() const { return 0; }
+    void header_time(uint64_t) {}
+    void symbol_time(uint64_t) {}
+  };
+
+  // The stats type of a decoder policy.
+  template <class Policy>
+  using decoder_stats_type = typename std::conditional<Policy::stats, decoder_stats, no_decoder_stats>::type;
+}
+
+#endif
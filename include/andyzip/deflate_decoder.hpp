@@ -8,13 +8,38 @@
 #ifndef ANDYZIP_DEFLATE_DECODER_HPP_
 #define ANDYZIP_DEFLATE_DECODER_HPP_
 
+#include <andyzip/decoder_policy.hpp>
+#include <andyzip/decoder_stats.hpp>
+
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
+#include <functional>
+#include <vector>
 
 namespace andyzip {
 
-  class deflate_decoder {
-    enum { debug = 0 };
+  // Policy is checked_input or trusted_input, optionally with_stats, deflate64_format or
+  // with_ring_output, or any decoder_options (see decoder_policy.hpp).
+  template <class Policy>
+  class basic_deflate_decoder {
+  public:
+    typedef decoder_stats_type<Policy> stats_type;
+
+    // Receives the output of decode_to().
+    typedef std::function<void(const uint8_t *data, size_t size)> sink_type;
+
+    enum {
+      window_size = Policy::window_size,
+      // a 64k window is deflate64.
+      deflate64 = window_size > 32768,
+      // ring output: the output buffer of decode_to() beyond the window.
+      ring_chunk_size = 1 << 18,
+    };
+
+  private:
 
     struct huffman_table {
       uint8_t min_lit_length;
@@ -33,7 +58,22 @@ namespace andyzip {
       uint16_t dist_base[18];
     };
 
-    huffman_table fixed_;
+    // What back references can reach: the output so far and a preset dictionary before it.
+    // Also records if decoding stopped because dest was full.
+    // Out is uint8_t except when decoding with an unknown window (see parallel_deflate_decoder.hpp).
+    // With ring output and a sink, output from dest_begin on after the first flushed bytes
+    // goes to the sink when dest is full.
+    template <class Out>
+    struct basic_history {
+      const Out *dest_begin;
+      const Out *dictionary;
+      size_t dictionary_size;
+      bool output_full;
+      stats_type *stats;
+      const sink_type *sink = nullptr;
+      size_t flushed = 0;
+    };
+    typedef basic_history<uint8_t> history;
 
     // on ARM we can do this faster with the "rev" instruction
     inline static uint16_t rev16(uint16_t value) {
@@ -85,89 +125,98 @@ namespace andyzip {
       //return value;
     }
 
+    // Build a decode table from code lengths: codes[] holds the symbols sorted by code length
+    // (a counting sort, so symbols of equal length stay in order), limits[] the largest
+    // left-aligned code of each length and base[] the code of the first symbol of each length.
     static bool build_huffman(uint8_t *lengths, unsigned num_lengths, uint8_t &min_length, uint8_t &max_length, uint16_t *codes, uint16_t *limits, uint16_t *base) {
+      unsigned count[17] = {0};
+      for (unsigned i = 0; i != num_lengths; ++i) {
+        count[lengths[i]]++;
+      }
+
       min_length = 16;
       max_length = 0;
-      for (unsigned i = 0; i != num_lengths; ++i) {
-        if (debug) printf("%d,", lengths[i]);
-        if (lengths[i]) {
-          if (min_length > lengths[i]) min_length = lengths[i];
-          if (max_length < lengths[i]) max_length = lengths[i];
+      for (unsigned length = 1; length != 17; ++length) {
+        if (count[length]) {
+          if (min_length > length) min_length = length;
+          max_length = length;
         }
       }
-      if (debug) printf("\n");
-
-      if (debug) printf("min_length=%d\n", min_length);
-      if (debug) printf("max_length=%d\n", max_length);
 
       if ( min_length <= 0 || min_length > max_length || max_length > 16 ) {
         return false;
       }
 
+      unsigned offset[17];
       unsigned code = 0;
       unsigned huffcode = 0;
       for (unsigned length = min_length; length <= max_length; ++length) {
+        offset[length] = code;
         base[length-min_length] = huffcode - code;
-        for (unsigned i = 0; i != num_lengths; ++i) {
-          if (lengths[i] == length) {
-            codes[code++] = i;
-            //dump_bits(huffcode << (16-length), 16, "huffcode");
-            huffcode++;
-          }
-        }
+        code += count[length];
+        huffcode += count[length];
         limits[length-min_length] = (uint16_t)( ( huffcode << (16-length) ) - 1 );
-        if (debug) printf("length %d: lim=%04x base=%04x\n", length, ( huffcode << (16-length) ) - 1, base[length-min_length]);
         if (( huffcode << (16-length) ) - 1 > 0xffff) {
-          if (debug) printf("invalid huffman table\n");
           return false;
         }
         huffcode *= 2;
       }
 
+      for (unsigned i = 0; i != num_lengths; ++i) {
+        if (lengths[i]) codes[offset[lengths[i]]++] = i;
+      }
+
+      if (huffcode != 2u << max_length) {
+        // an incomplete code is only allowed for a single symbol (RFC1951 3.2.7).
+        // the unused code decodes to an invalid symbol.
+        if (code != 1) return false;
+        limits[0] = 0xffff;
+        codes[1] = 0xffff;
+        return true;
+      }
+
       // prevent escape from bitstream decoding loop.
       limits[max_length+1-min_length] = 0xffff;
       return true;
     }
 
-    /// debug function for dumping bit fields
-    static void dump_bits(unsigned value, unsigned bits, const char *name) {
-      char tmp[64];
-      if (bits < sizeof(tmp)-1) {
-        for (unsigned i = 0; i != bits; ++i) tmp[i] = ( ( value >> (bits-1-i) ) & 1 ) + '0';
-        tmp[bits] = 0;
-        printf("[%s] %s\n", tmp, name);
-      }
-    }
-
     /// peek a fixed number of little-endian bits from the bitstream
     /// note: this will have to be fixed on PPC and other big-endian devices
-    static unsigned peek(const uint8_t *src, unsigned bitptr, unsigned bits, const char *name) {
+    /// The input is read four bytes at a time. When checked, bytes from src_max on read as
+    /// zero near the end and decoding fails if it uses them; trusted input needs four bytes of slack.
+    static unsigned peek(const uint8_t *src, const uint8_t *src_max, unsigned bitptr, unsigned bits) {
       unsigned i = bitptr >> 3, j = bitptr & 7;
-      unsigned value = ( (unsigned&)src[i] >> j ) & ( (1u << bits) - 1 );
-      if (debug && name) dump_bits(value, bits, name);
-      return value;
+      uint32_t word = 0;
+      if (!Policy::checked || src_max - src >= (ptrdiff_t)i + 4) {
+        memcpy(&word, src + i, 4);
+      } else {
+        for (unsigned k = 0; k != 4 && src_max - src > (ptrdiff_t)(i + k); ++k) word |= (uint32_t)src[i+k] << (k*8);
+      }
+      return ( word >> j ) & ( (1u << bits) - 1 );
     }
 
-    unsigned decode_uncompressed(uint8_t *&dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max, unsigned bitptr) const {
+    template <class Out>
+    unsigned decode_uncompressed(Out *&dest, Out *dest_max, const uint8_t *src, const uint8_t *src_max, unsigned bitptr, basic_history<Out> &hist) const {
       bitptr = ( bitptr + 7 ) & ~7;
-      unsigned bytes_to_copy = peek(src, bitptr, 16, "bytes_to_copy");
-      unsigned clength = peek(src, bitptr + 16, 16, "store length check");
+      unsigned bytes_to_copy = peek(src, src_max, bitptr, 16);
+      unsigned clength = peek(src, src_max, bitptr + 16, 16);
       bitptr += 32;
 
       if (bytes_to_copy != (clength^0xffff)) return ~0;
-      if (dest + bytes_to_copy > dest_max) return ~0;
+      if (dest + bytes_to_copy > dest_max && !make_room(dest, dest_max, bytes_to_copy, hist)) return ~0;
       if ((src + bitptr/8) + bytes_to_copy > src_max) return ~0;
 
-      memcpy(dest, src + bitptr/8, bytes_to_copy);
+      std::copy(src + bitptr/8, src + bitptr/8 + bytes_to_copy, dest);
       dest += bytes_to_copy;
       bitptr += bytes_to_copy * 8;
       return bitptr;
     }
 
-    static unsigned decode_lz77(uint8_t *&dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max, unsigned bitptr, const huffman_table *table_) {
+    template <class Out>
+    static unsigned decode_lz77(Out *&dest, Out *dest_max, const uint8_t *src, const uint8_t *src_max, unsigned bitptr, const huffman_table *table_, basic_history<Out> &hist) {
       for(;;) {
-        if (src + bitptr/8 > src_max) return ~0;
-        unsigned peek16 = peek(src, bitptr, 16, NULL);
+        if (Policy::checked && src + bitptr/8 > src_max) return ~0;
+        unsigned peek16 = peek(src, src_max, bitptr, 16);
         unsigned value = rev16(peek16);
         unsigned index = 0;
         while (value > table_->lit_limits[index]) {
@@ -177,79 +226,204 @@ namespace andyzip {
         unsigned offset = ( value >> ( 16 - length ) );
         unsigned code = table_->lit_codes[offset - table_->lit_base[index]];
         bitptr += length;
-        if (debug) dump_bits(peek16, length, "code");
+        hist.stats->code(length);
 
         if (code < 256) {
-          if (dest+1 > dest_max) return ~0;
+          if (dest+1 > dest_max && !make_room(dest, dest_max, 1, hist)) return ~0;
           *dest++ = code;
-          if (debug) printf("%02x\n", code);
+          hist.stats->literal();
         } else if (code == 256) {
           return bitptr;
         } else {
-          unsigned block_length;
-          unsigned distance;
-          {
-            if (debug) printf("[%d]\n", code);
-            static const uint8_t extra[] = {
-              0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
-            };
-            static const uint8_t base[] = {
-              3-3, 4-3, 5-3, 6-3, 7-3, 8-3, 9-3, 10-3,
-              11-3, 13-3, 15-3, 17-3, 19-3, 23-3, 27-3, 31-3,
-              35-3, 43-3, 51-3, 59-3, 67-3, 83-3, 99-3, 115-3,
-              131-3, 163-3, 195-3, 227-3, 258-3,
-            };
-            if (code-257 > sizeof(extra)) return ~0;
-            unsigned extra_length = extra[ code-257 ];
-            block_length = base[ code-257 ] + 3 + peek(src, bitptr, extra_length, "extra");
-            bitptr += extra_length;
-          }
-          {
-            //if (src + (bitptr + table_->max_dist_length)/8 > src_max ) return ~0;
-            unsigned peek16 = peek(src, bitptr, 16, NULL);
-            unsigned value = rev16(peek16);
-            unsigned index = 0;
-            while (value > table_->dist_limits[index]) {
-              index++;
-            }
-            unsigned length = table_->min_dist_length + index;
-            unsigned offset = ( value >> ( 16 - length ) );
-            unsigned code = table_->dist_codes[offset - table_->dist_base[index]];
-            bitptr += length;
-
-            if (debug) printf("{%d}\n", code);
-            static const uint8_t extra[] = {
-              0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 0, 0, 0,
-            };
-            static const uint16_t base[] = {
-              1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
-            };
-            if (code > sizeof(extra)) return ~0;
-            unsigned extra_length = extra[ code ];
-            distance = base[ code ] + peek(src, bitptr, extra_length, "extra");
-            bitptr += extra_length;
+          unsigned block_length = match_length(code, src, src_max, bitptr);
+          if (!block_length) return ~0;
+
+          //if (src + (bitptr + table_->max_dist_length)/8 > src_max ) return ~0;
+          unsigned peek16 = peek(src, src_max, bitptr, 16);
+          unsigned value = rev16(peek16);
+          unsigned index = 0;
+          while (value > table_->dist_limits[index]) {
+            index++;
           }
+          unsigned length = table_->min_dist_length + index;
+          unsigned offset = ( value >> ( 16 - length ) );
+          bitptr += length;
+          hist.stats->code(length);
+          unsigned distance = match_distance(table_->dist_codes[offset - table_->dist_base[index]], src, src_max, bitptr);
+          if (!distance || !copy_match(dest, dest_max, block_length, distance, hist)) return ~0;
+        }
+      }
+    }
 
-          if (debug) printf("length=%d distance=%d\n", block_length, distance);
+    // Length of a match from a literal/length code of 257 or more and its extra bits at bitptr, or 0 if the code is invalid.
+    static unsigned match_length(unsigned code, const uint8_t *src, const uint8_t *src_max, unsigned &bitptr) {
+      static const uint8_t extra[] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+      };
+      static const uint8_t base[] = {
+        3-3, 4-3, 5-3, 6-3, 7-3, 8-3, 9-3, 10-3,
+        11-3, 13-3, 15-3, 17-3, 19-3, 23-3, 27-3, 31-3,
+        35-3, 43-3, 51-3, 59-3, 67-3, 83-3, 99-3, 115-3,
+        131-3, 163-3, 195-3, 227-3, 258-3,
+      };
+      if (code-257 >= sizeof(base)) return 0;
+      if (deflate64 && code == 285) {
+        // deflate64 lengths run from 3 to 65538 with 16 extra bits.
+        unsigned block_length = 3 + peek(src, src_max, bitptr, 16);
+        bitptr += 16;
+        return block_length;
+      }
+      unsigned extra_length = extra[ code-257 ];
+      unsigned block_length = base[ code-257 ] + 3 + peek(src, src_max, bitptr, extra_length);
+      bitptr += extra_length;
+      return block_length;
+    }
+
+    // Distance of a match from a distance code and its extra bits at bitptr, or 0 if the code is invalid.
+    static unsigned match_distance(unsigned code, const uint8_t *src, const uint8_t *src_max, unsigned &bitptr) {
+      static const uint8_t extra[] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 0,
+      };
+      static const uint16_t base[] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+        32769, 49153
+      };
+      // codes 30 and 31 reach into the 64k window of deflate64.
+      if (code >= (deflate64 ? 32u : 30u)) return 0;
+      unsigned extra_length = extra[ code ];
+      unsigned distance = base[ code ] + peek(src, src_max, bitptr, extra_length);
+      bitptr += extra_length;
+      return distance;
+    }
 
-          if (dest+block_length > dest_max) return ~0;
+    // Called when n more bytes do not fit in dest: decoding stops with output_full.
+    template <class Out>
+    static bool make_room(Out *&, Out *, size_t, basic_history<Out> &hist) {
+      hist.output_full = true;
+      return false;
+    }
 
-          for(unsigned i = 0; i != block_length; ++i) {
-            dest[0] = dest[-(int)distance];
-            dest++;
-          }
+    // With ring output and a sink, hand the output so far to the sink and move the last
+    // window of it to the start of the buffer, unless that still leaves too little room.
+    static bool make_room(uint8_t *&dest, uint8_t *dest_max, size_t n, history &hist) {
+      if ((decoder_output)Policy::output == ring_output && hist.sink) {
+        uint8_t *begin = dest - (dest - hist.dest_begin);
+        size_t keep = std::min((size_t)(dest - begin), (size_t)window_size);
+        if ((size_t)(dest_max - begin) - keep >= n) {
+          (*hist.sink)(begin + hist.flushed, (size_t)(dest - begin) - hist.flushed);
+          memmove(begin, dest - keep, keep);
+          dest = begin + keep;
+          hist.flushed = keep;
+          // back references now reach the window, never the dictionary.
+          hist.dictionary_size = 0;
+          return true;
         }
       }
+      hist.output_full = true;
+      return false;
+    }
+
+    template <class Out>
+    static bool copy_match(Out *&dest, Out *dest_max, unsigned block_length, unsigned distance, basic_history<Out> &hist) {
+      if (dest+block_length > dest_max && !make_room(dest, dest_max, block_length, hist)) return false;
+      hist.stats->match(block_length, distance);
+
+      size_t available = (size_t)(dest - hist.dest_begin);
+      if (distance > available) {
+        // the start of the copy is in the dictionary.
+        if (distance > available + hist.dictionary_size) return false;
+        hist.stats->dictionary_ref();
+        size_t from_dict = std::min((size_t)block_length, distance - available);
+        const Out *from = hist.dictionary + hist.dictionary_size - (distance - available);
+        std::copy(from, from + from_dict, dest);
+        dest += from_dict;
+        block_length -= (unsigned)from_dict;
+      }
+
+      // sixteen at a time where the copy does not overlap itself within sixteen
+      // and there is room to overshoot the end of the match.
+      if (distance >= 16 && (size_t)(dest_max - dest) >= block_length + 15) {
+        Out *end = dest + block_length;
+        for (; dest < end; dest += 16) {
+          memcpy(dest, dest - distance, 16 * sizeof(Out));
+        }
+        dest = end;
+        return true;
+      }
+      for(unsigned i = 0; i != block_length; ++i) {
+        dest[0] = dest[-(int)distance];
+        dest++;
+      }
+      return true;
+    }
+
+    // Fixed block codes (RFC1951 3.2.6) indexed by the next 9 bits of the stream, as symbol << 4 | code length.
+    // Literals and lengths need up to 9 bits and distances are all 5 bits, so there is no limit search.
+    struct fixed_codes {
+      uint16_t lit[512];
+      uint8_t dist[32];
+    };
+
+    static constexpr unsigned reverse_bits(unsigned value, unsigned bits) {
+      unsigned result = 0;
+      for (unsigned i = 0; i != bits; ++i) result |= ( ( value >> i ) & 1 ) << (bits-1-i);
+      return result;
+    }
+
+    static constexpr fixed_codes make_fixed_codes() {
+      fixed_codes t = {};
+      for (unsigned sym = 0; sym != 288; ++sym) {
+        unsigned length = sym < 144 ? 8 : sym < 256 ? 9 : sym < 280 ? 7 : 8;
+        unsigned code = sym < 144 ? 0x30 + sym : sym < 256 ? 0x190 + sym - 144 : sym < 280 ? sym - 256 : 0xc0 + sym - 280;
+        for (unsigned i = reverse_bits(code, length); i < 512; i += 1u << length) {
+          t.lit[i] = (uint16_t)( sym << 4 | length );
+        }
+      }
+      for (unsigned i = 0; i != 32; ++i) t.dist[i] = (uint8_t)reverse_bits(i, 5);
+      return t;
+    }
+
+    // Shared by all decoders and built by the compiler.
+    static const fixed_codes &fixed() {
+      static constexpr fixed_codes codes = make_fixed_codes();
+      return codes;
     }
 
-    unsigned decode_fixed(uint8_t *&dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max, unsigned bitptr) const {
-      return decode_lz77(dest, dest_max, src, src_max, bitptr, &fixed_);
+    template <class Out>
+    static unsigned decode_fixed(Out *&dest, Out *dest_max, const uint8_t *src, const uint8_t *src_max, unsigned bitptr, basic_history<Out> &hist) {
+      const fixed_codes &codes = fixed();
+      for(;;) {
+        if (Policy::checked && src + bitptr/8 > src_max) return ~0;
+        unsigned peek9 = peek(src, src_max, bitptr, 9);
+        unsigned entry = codes.lit[peek9];
+        unsigned code = entry >> 4;
+        bitptr += entry & 15;
+        hist.stats->code(entry & 15);
+
+        if (code < 256) {
+          if (dest+1 > dest_max && !make_room(dest, dest_max, 1, hist)) return ~0;
+          *dest++ = code;
+          hist.stats->literal();
+        } else if (code == 256) {
+          return bitptr;
+        } else {
+          unsigned block_length = match_length(code, src, src_max, bitptr);
+          if (!block_length) return ~0;
+          unsigned dist_code = codes.dist[peek(src, src_max, bitptr, 5)];
+          bitptr += 5;
+          hist.stats->code(5);
+          unsigned distance = match_distance(dist_code, src, src_max, bitptr);
+          if (!distance || !copy_match(dest, dest_max, block_length, distance, hist)) return ~0;
+        }
+      }
     }
 
-    unsigned decode_variable(uint8_t *&dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max, unsigned bitptr) const {
-      unsigned num_lit_codes = peek(src, bitptr, 5, "num_lit_codes") + 257;
-      unsigned num_dist_codes = peek(src, bitptr+5, 5, "num_dist_codes") + 1;
-      unsigned num_length_codes = peek(src, bitptr+10, 4, "num_length_codes") + 4;
+    template <class Out>
+    unsigned decode_variable(Out *&dest, Out *dest_max, const uint8_t *src, const uint8_t *src_max, unsigned bitptr, basic_history<Out> &hist) const {
+      uint64_t start = hist.stats->now();
+      unsigned num_lit_codes = peek(src, src_max, bitptr, 5) + 257;
+      unsigned num_dist_codes = peek(src, src_max, bitptr+5, 5) + 1;
+      unsigned num_length_codes = peek(src, src_max, bitptr+10, 4) + 4;
       
       bitptr += 14;
 
@@ -258,48 +432,56 @@ namespace andyzip {
       if (src + bitptr/8 + num_length_codes > src_max ) return ~0;
       for (unsigned i = 0; i != num_length_codes; ++i) {
         static const uint8_t order[] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
-        lengths[order[i]] = peek(src, bitptr, 3, "length code lenghs");
+        lengths[order[i]] = peek(src, src_max, bitptr, 3);
         bitptr += 3;
       }
       
-      uint16_t codes[19];
-      uint16_t limits[18];
-      uint16_t base[18];
-      uint8_t min_length;
-      uint8_t max_length;
-      if (!build_huffman(lengths, 19, min_length, max_length, codes, limits, base)) return ~0;
-      
+      // code length codes are at most 7 bits, so decode them with a table indexed by
+      // the next 7 bits of the stream: symbol << 3 | code length, or 0 for an unused code.
+      unsigned count[8] = {0};
+      for (unsigned i = 0; i != 19; ++i) count[lengths[i]]++;
+      count[0] = 0;
+      unsigned next[8] = {0};
+      int left = 1;
+      for (unsigned length = 1; length != 8; ++length) {
+        next[length] = (next[length-1] + count[length-1]) << 1;
+        left = left * 2 - (int)count[length];
+        if (left < 0) return ~0;
+      }
+      uint8_t lookup[128] = {0};
+      for (unsigned i = 0; i != 19; ++i) {
+        unsigned length = lengths[i];
+        if (length) {
+          for (unsigned j = reverse_bits(next[length]++, length); j < 128; j += 1u << length) {
+            lookup[j] = (uint8_t)( i << 3 | length );
+          }
+        }
+      }
+
       unsigned todo = num_lit_codes + num_dist_codes;
       for(unsigned done = 0; done < todo;) {
-        if (src + bitptr/8 + max_length > src_max ) return ~0;
-        unsigned peek16 = peek(src, bitptr, 16, NULL);
-        unsigned value = rev16(peek16);
-        unsigned index = 0;
-        while (value > limits[index]) {
-          index++;
-        }
-        unsigned length = min_length + index;
-        unsigned offset = ( value >> ( 16 - length ) );
-        unsigned code = codes[offset - base[index]];
-        bitptr += length;
-        if (debug) dump_bits(peek16, length, "length");
-        //fprintf(source_.debug(), "code=%03x\n", code);
+        if (src + bitptr/8 > src_max ) return ~0;
+        unsigned peek7 = peek(src, src_max, bitptr, 7);
+        unsigned entry = lookup[peek7];
+        if (!entry) return ~0;
+        unsigned code = entry >> 3;
+        bitptr += entry & 7;
         unsigned copy = 1;
         if (code < 16) {
         } else if(code == 16) {
           if (src + (bitptr+2)/8 > src_max ) return ~0;
-          copy = peek(src, bitptr, 2, NULL) + 3;
+          copy = peek(src, src_max, bitptr, 2) + 3;
           bitptr += 2;
           if (done == 0) return ~0;
           code = lengths[ done-1 ];
         } else if(code == 17) {
           if (src + (bitptr+3)/8 > src_max ) return ~0;
-          copy = peek(src, bitptr, 3, NULL) + 3;
+          copy = peek(src, src_max, bitptr, 3) + 3;
           bitptr += 3;
           code = 0;
         } else if(code == 18) {
           if (src + (bitptr+7)/8 > src_max ) return ~0;
-          copy = peek(src, bitptr, 7, NULL) + 11;
+          copy = peek(src, src_max, bitptr, 7) + 11;
           bitptr += 7;
           code = 0;
         } else {
@@ -311,8 +493,6 @@ namespace andyzip {
         } while( --copy );
       }
 
-      if (debug) printf("lengths done\n");
-
       huffman_table var;
       if(
         !build_huffman(lengths, num_lit_codes, var.min_lit_length, var.max_lit_length, var.lit_codes, var.lit_limits, var.lit_base) ||
@@ -320,24 +500,36 @@ namespace andyzip {
       ) {
         return ~0;
       }
-      return decode_lz77(dest, dest_max, src, src_max, bitptr, &var);
+      // the code length code, literal/length and distance tables.
+      hist.stats->huffman_build();
+      hist.stats->huffman_build();
+      hist.stats->huffman_build();
+      hist.stats->header_time(start);
+
+      start = hist.stats->now();
+      bitptr = decode_lz77(dest, dest_max, src, src_max, bitptr, &var, hist);
+      hist.stats->symbol_time(start);
+      return bitptr;
     }
-  public:
-    deflate_decoder() {
-      uint8_t lit_lengths[288];
-      uint8_t dist_lengths[32];
-      memset(lit_lengths +   0, 8, 144 - 0);
-      memset(lit_lengths + 144, 9, 256-144);
-      memset(lit_lengths + 256, 7, 280-256);
-      memset(lit_lengths + 280, 8, 288-280);
-      memset(dist_lengths, 5, 32);
-      build_huffman(lit_lengths, 288, fixed_.min_lit_length, fixed_.max_lit_length, fixed_.lit_codes, fixed_.lit_limits, fixed_.lit_base);
-      build_huffman(dist_lengths, 32, fixed_.min_dist_length, fixed_.max_dist_length, fixed_.dist_codes, fixed_.dist_limits, fixed_.dist_base);
+
+    // Decode a block after its three bit header.
+    template <class Out>
+    unsigned decode_block_body(unsigned kind, Out *&dest, Out *dest_max, const uint8_t *src, const uint8_t *src_max, unsigned bitptr, basic_history<Out> &hist) const {
+      if (kind > 2) return ~0;
+      hist.stats->block((decoder_stats::block_kind)kind);
+      if (kind == 2) return decode_variable(dest, dest_max, src, src_max, bitptr, hist);
+
+      uint64_t start = hist.stats->now();
+      bitptr = kind == 0 ? decode_uncompressed(dest, dest_max, src, src_max, bitptr, hist) : decode_fixed(dest, dest_max, src, src_max, bitptr, hist);
+      hist.stats->symbol_time(start);
+      return bitptr;
     }
 
-    bool decode(uint8_t *dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max) const {
+    // Decode blocks up to and including the last one.
+    bool decode_stream(uint8_t *dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max, uint8_t *&dest_end, const uint8_t *&src_end, history &hist) const {
       unsigned bitptr = 0;
       unsigned is_last_block;
+      stats_.clear();
 
       // for each "deflate" block:
       do {
@@ -346,23 +538,141 @@ namespace andyzip {
         bitptr %= 8;
 
         // three bits determine kind and exit condition
-        is_last_block = peek(src, bitptr, 1, "deflate last") != 0;
-        unsigned kind = peek(src, bitptr + 1, 2, "deflate kind");
+        is_last_block = peek(src, src_max, bitptr, 1) != 0;
+        unsigned kind = peek(src, src_max, bitptr + 1, 2);
 
-        bitptr += 3;
-        switch (kind) {
-        case 0: bitptr = decode_uncompressed(dest, dest_max, src, src_max, bitptr); break;
-        case 1: bitptr = decode_fixed(dest, dest_max, src, src_max, bitptr); break;
-        case 2: bitptr = decode_variable(dest, dest_max, src, src_max, bitptr); break;
-        default: return false;
-        }
+        bitptr = decode_block_body(kind, dest, dest_max, src, src_max, bitptr + 3, hist);
       } while( !is_last_block && bitptr != ~0);
-      if (debug) printf("%p %p\n", dest, dest_max);
-      if (debug) printf("%p %p\n", src + bitptr / 8, src_max);
-      return is_last_block && bitptr != ~0 && dest == dest_max;
+      if (bitptr == ~0u || src + (bitptr + 7) / 8 > src_max) return false;
+      dest_end = dest;
+      src_end = src + (bitptr + 7) / 8;
+      return true;
+    }
+
+    // counters for the last stream, if Policy is with_stats.
+    mutable stats_type stats_;
+
+  public:
+    basic_deflate_decoder() {
+    }
+
+    // What the last stream decoded contained (see decoder_stats.hpp). decode_block()
+    // adds to this, so call clear_stats() at the start of a stream. Decoders with
+    // stats must not be shared between threads.
+    const stats_type &stats() const { return stats_; }
+    void clear_stats() { stats_.clear(); }
+
+    // Decode a raw deflate stream. If a preset dictionary is given, back references
+    // may reach into it as if it came just before dest. It is not copied.
+    bool decode(uint8_t *dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max, const uint8_t *dictionary = nullptr, size_t dictionary_size = 0) const {
+      uint8_t *dest_end;
+      const uint8_t *src_end;
+      return decode_stream(dest, dest_max, src, src_max, dest_end, src_end, dictionary, dictionary_size) && dest_end == dest_max;
+    }
+
+    // Decode a raw deflate stream of unknown decoded size that may be followed by other data.
+    // On success, dest_end is the end of the output and src_end the first byte after the stream.
+    // Fails if the stream is corrupt or does not fit in dest.
+    bool decode_stream(uint8_t *dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max, uint8_t *&dest_end, const uint8_t *&src_end, const uint8_t *dictionary = nullptr, size_t dictionary_size = 0) const {
+      history hist = { dest, dictionary, dictionary ? dictionary_size : 0, false, &stats_ };
+      return decode_stream(dest, dest_max, src, src_max, dest_end, src_end, hist);
+    }
+
+    // Where decode_block() is in a stream. Set src, bit, src_max, dest, dest_max
+    // and dest_begin before the first block; the block functions update them.
+    template <class Out>
+    struct basic_block_state {
+      const uint8_t *src;
+      unsigned bit;
+      const uint8_t *src_max;
+      Out *dest;
+      Out *dest_max;
+      // back references may reach back to dest_begin and then into the dictionary.
+      const Out *dest_begin;
+      const Out *dictionary = nullptr;
+      size_t dictionary_size = 0;
+      bool is_last = false;
+      bool output_full = false;
+    };
+    typedef basic_block_state<uint8_t> block_state;
+
+    // Decode the block at s.src, s.bit. On failure the state is unchanged
+    // apart from output_full, which is set if the block did not fit in dest.
+    template <class Out>
+    bool decode_block(basic_block_state<Out> &s) const {
+      basic_history<Out> hist = { s.dest_begin, s.dictionary, s.dictionary ? s.dictionary_size : 0, false, &stats_ };
+      Out *dest = s.dest;
+      const uint8_t *src = s.src;
+      unsigned bitptr = s.bit;
+      bool is_last_block = peek(src, s.src_max, bitptr, 1) != 0;
+      unsigned kind = peek(src, s.src_max, bitptr + 1, 2);
+      bitptr = decode_block_body(kind, dest, s.dest_max, src, s.src_max, bitptr + 3, hist);
+      s.output_full = hist.output_full;
+      if (bitptr == ~0u || src + (bitptr + 7) / 8 > s.src_max) return false;
+      s.src = src + bitptr / 8;
+      s.bit = bitptr % 8;
+      s.dest = dest;
+      s.is_last = is_last_block;
+      return true;
+    }
+
+    // Decode a raw deflate stream of unknown size, appending the output to out.
+    // size_hint is the expected decoded size, if known. The output grows until the
+    // stream fits or exceeds the largest possible expansion of the input.
+    // Returns the first byte after the stream or nullptr on failure.
+    const uint8_t *decode_append(std::vector<uint8_t> &out, const uint8_t *src, const uint8_t *src_max, size_t size_hint = 0, const uint8_t *dictionary = nullptr, size_t dictionary_size = 0) const {
+      // a 258 byte match costs at least one bit, a deflate64 one of up to 65538 bytes at least 17.
+      size_t per_bit = deflate64 ? 65538 / 17 + 1 : 258;
+      size_t max_size = (size_t)(src_max - src) * 8 * per_bit + per_bit;
+      size_t start = out.size();
+      size_t room = std::min(max_size, std::max(size_hint, (size_t)(src_max - src) * 4 + 1024));
+      for (;;) {
+        out.resize(start + room);
+        uint8_t *dest_end;
+        const uint8_t *src_end;
+        history hist = { out.data() + start, dictionary, dictionary ? dictionary_size : 0, false, &stats_ };
+        if (decode_stream(out.data() + start, out.data() + out.size(), src, src_max, dest_end, src_end, hist)) {
+          out.resize(dest_end - out.data());
+          return src_end;
+        }
+        if (!hist.output_full || room == max_size) {
+          out.resize(start);
+          return nullptr;
+        }
+        room = std::min(max_size, room * 2);
+      }
+    }
+
+    // Decode a raw deflate stream of any size in a buffer of window_size + ring_chunk_size
+    // bytes, calling sink with the output in order as the buffer fills. Needs ring output
+    // (with_ring_output). Returns the first byte after the stream or nullptr on failure,
+    // which may come after some of the output has gone to the sink.
+    const uint8_t *decode_to(const sink_type &sink, const uint8_t *src, const uint8_t *src_max, const uint8_t *dictionary = nullptr, size_t dictionary_size = 0) const {
+      static_assert((decoder_output)Policy::output == ring_output, "decode_to() needs a with_ring_output policy");
+      std::vector<uint8_t> ring(window_size + ring_chunk_size);
+      history hist = { ring.data(), dictionary, dictionary ? dictionary_size : 0, false, &stats_ };
+      hist.sink = &sink;
+      uint8_t *dest_end;
+      const uint8_t *src_end;
+      if (!decode_stream(ring.data(), ring.data() + ring.size(), src, src_max, dest_end, src_end, hist)) {
+        return nullptr;
+      }
+      sink(ring.data() + hist.flushed, (size_t)(dest_end - ring.data()) - hist.flushed);
+      return src_end;
     }
   };
 
+  // Decodes untrusted input safely.
+  typedef basic_deflate_decoder<checked_input> deflate_decoder;
+
+  // Faster, for trusted input only.
+  typedef basic_deflate_decoder<trusted_input> trusted_deflate_decoder;
+
+  // Decodes deflate64 (zip method 9) safely.
+  typedef basic_deflate_decoder<deflate64_format<checked_input>> deflate64_decoder;
+
+  // Decodes untrusted input of any size in fixed memory with decode_to().
+  typedef basic_deflate_decoder<with_ring_output<checked_input>> streaming_deflate_decoder;
 }
 
 #endif
@@ -8,7 +8,15 @@
 #ifndef MINIZIP_DEFLATE_ENCODER_INCLUDED
 #define MINIZIP_DEFLATE_ENCODER_INCLUDED
 
+#include <andyzip/huffman_table.hpp>
+#include <andyzip/bit_writer.hpp>
+
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 namespace andyzip {
     template <class CharType = uint8_t, class AddrType = uint32_t, template<typename> typename Allocator = std::allocator>
@@ -21,92 +29,89 @@ namespace andyzip {
     suffix_array(const char_type *src, const char_type *src_max) {
       size_t size = src_max - src;
 
-      struct sorter_t {
-        addr_type group;
-        addr_type next_group;
-        addr_type addr;
-      };
-
-      std::vector<sorter_t, Allocator<sorter_t>> sorter(size + 1);
+      // Prefix doubling: sort by the first characters, then repeatedly sort each group
+      // of suffixes that share their first h characters by the group h characters on.
+      // Groups of one suffix are finished and are not visited again.
+      // The group number of a suffix is the index of the first suffix of its group.
+      addresses_.resize(size + 1);
       addr_to_sa_.resize(size + 1);
-
-      for (size_t i = 0; i != size+1; ++i) {
-        sorter_t &s = sorter[i];
-        s.group = i == size ? 0 : src[i];
-        s.next_group = i == size ? 0 : 1;
-        s.addr = (addr_type)i;
-      }
-
-      auto sort_by_group_and_next = [](const sorter_t &a, const sorter_t &b) {
-        return a.group < b.group + (a.next_group < b.next_group);
-      };
-
-      auto debug_dump = [src, &sorter](const char *msg, size_t h) {
-        printf("\n%s h=%d\n", msg, (int)h);
-        for (size_t i = 0; i != sorter.size(); ++i) {
-        //for (size_t i = 0; i != 4; ++i) {
-          auto &s = sorter[i];
-          printf("%4d %12d %4d %4d %s\n", (int)i, (int)s.group, (int)s.next_group, (int)s.addr, (char*)src + s.addr);
-        }
-      };
-
-      // todo: limit work to parts of the array not yet complete.
-      constexpr bool debug = false;
-      for (size_t h = 1; ; h *= 2) {
-        // sort by group
-        std::sort(sorter.begin(), sorter.end(), sort_by_group_and_next);
-
-        int finished = 1;
-        for (size_t i = 0; i != size+1;) {
-          auto si = sorter[i];
-          size_t j = i+1;
-          sorter[i].group = (addr_type)i;
-          int done = 0;
-          for (; j != size+1 && sorter[j].group == si.group && sorter[j].next_group == si.next_group; ++j) {
-            sorter[j].group = (addr_type)i;
-            done = 1;
+      std::vector<addr_type, Allocator<addr_type>> next_group(size + 1);
+      std::vector<addr_type, Allocator<addr_type>> &group = addr_to_sa_;
+
+      // ranges of addresses_ that are not yet sorted.
+      std::vector<std::pair<size_t, size_t>> unfinished;
+      std::vector<std::pair<size_t, size_t>> next_unfinished;
+      auto make_groups = [&](size_t begin, size_t end, const addr_type *key, std::vector<std::pair<size_t, size_t>> &ranges) {
+        for (size_t i = begin; i != end;) {
+          size_t j = i + 1;
+          while (j != end && key[addresses_[j]] == key[addresses_[i]]) ++j;
+          for (size_t k = i; k != j; ++k) {
+            group[addresses_[k]] = (addr_type)i;
           }
-          finished &= !done;
+          if (j - i > 1) ranges.emplace_back(i, j);
           i = j;
         }
+      };
 
-        if (debug) debug_dump("built group numbers", h);
-
-        for (size_t i = 0; i != size+1; ++i) {
-          addr_to_sa_[sorter[i].addr] = i;
+      // The first pass sorts bytes two at a time with a counting sort.
+      // Shorter suffixes sort first, so the end of the data is zero.
+      size_t first_h = sizeof(char_type) == 1 ? 2 : 1;
+      {
+        std::vector<addr_type, Allocator<addr_type>> &key = next_group;
+        for (size_t i = 0; i != size; ++i) {
+          addr_type c0 = (addr_type)src[i] + 1;
+          addr_type c1 = i + 1 < size ? (addr_type)src[i+1] + 1 : 0;
+          key[i] = first_h == 2 ? c0 * 257 + c1 : c0;
         }
-
-        if (finished) break;
-
-        for (size_t i = 0; i != size+1; ++i) {
-          sorter_t &s = sorter[i];
-          s.next_group = s.addr < size - h ? sorter[addr_to_sa_[s.addr + h]].group : 0;
+        key[size] = 0;
+
+        if (first_h == 2) {
+          std::vector<size_t> start(257 * 257 + 1);
+          for (size_t i = 0; i != size+1; ++i) start[key[i] + 1]++;
+          for (size_t i = 1; i != start.size(); ++i) start[i] += start[i-1];
+          for (size_t i = 0; i != size+1; ++i) addresses_[start[key[i]]++] = (addr_type)i;
+        } else {
+          for (size_t i = 0; i != size+1; ++i) addresses_[i] = (addr_type)i;
+          std::sort(addresses_.begin(), addresses_.end(), [&key](addr_type a, addr_type b) { return key[a] < key[b]; });
         }
-
-        if (debug) debug_dump("set next_group", h);
+        make_groups(0, size + 1, key.data(), unfinished);
       }
 
-      addresses_.resize(size+1);
-      for (size_t i = 0; i != size+1; ++i) {
-        addresses_[i] = sorter[i].addr;
+      for (size_t h = first_h; !unfinished.empty(); h *= 2) {
+        // suffixes in an unfinished group are at least h long.
+        for (auto &r : unfinished) {
+          for (size_t i = r.first; i != r.second; ++i) {
+            addr_type a = addresses_[i];
+            next_group[a] = group[a + h];
+          }
+        }
+
+        next_unfinished.clear();
+        for (auto &r : unfinished) {
+          addr_type *key = next_group.data();
+          std::sort(addresses_.begin() + r.first, addresses_.begin() + r.second, [key](addr_type a, addr_type b) { return key[a] < key[b]; });
+          make_groups(r.first, r.second, key, next_unfinished);
+        }
+        std::swap(unfinished, next_unfinished);
       }
 
-      sorter.resize(0);
-      sorter.shrink_to_fit();
+      // every group is now a single suffix, so the group number is the rank.
 
       // Kasai, T.; Lee, G.; Arimura, H.; Arikawa, S.; Park, K. (2001). Linear-Time Longest-Common-Prefix Computation in Suffix Arrays and Its Applications.
       // Proceedings of the 12th Annual Symposium on Combinatorial Pattern Matching. Lecture Notes in Computer Science. 2089. pp. 181192. doi:10.1007/3-540-48194-X_17. ISBN 978-3-540-42271-6.
       longest_common_prefix_.resize(size+1);
       addr_type h = 0;
-      for (size_t i = 0; i != sorter.size(); ++i) {
+      for (size_t i = 0; i != size; ++i) {
         addr_type r = addr_to_sa_[i];
         if (r > 0) {
           addr_type j = addresses_[r-1];
-          while (src[i+h] == src[j+h]) {
+          while (i+h < size && j+h < size && src[i+h] == src[j+h]) {
             ++h;
           }
           longest_common_prefix_[r] = h;
           h -= h > 0;
+        } else {
+          h = 0;
         }
       }
     }
@@ -237,34 +242,422 @@ namespace andyzip {
     std::vector<sorter_t> sorter;
   };
 
+  // Deflate (RFC 1951) encoder.
+  //
+  // Level 0 stores, levels 1-3 use a greedy parse and levels 4-9 a lazy parse
+  // with hash chains, as in zlib. Each block is written with whichever of
+  // dynamic, fixed or stored codes is smallest.
   class deflate_encoder {
   public:
-    deflate_encoder() {
+    enum {
+      min_match = 3,
+      max_match = 258,
+      window_size = 32768,
+      hash_bits = 15,
+      max_block_symbols = 1 << 14,
+      max_stored_block = 65535,
+    };
+
+    deflate_encoder(int level = 6) {
+      // good_length, max_lazy, nice_length, max_chain from zlib's configuration table.
+      static const uint16_t config[10][4] = {
+        {0, 0, 0, 0}, {4, 4, 8, 4}, {4, 5, 16, 8}, {4, 6, 32, 32},
+        {4, 4, 16, 16}, {8, 16, 32, 32}, {8, 16, 128, 128},
+        {8, 32, 128, 256}, {32, 128, 258, 1024}, {32, 258, 258, 4096},
+      };
+      level_ = std::max(0, std::min(9, level));
+      good_length_ = config[level_][0];
+      max_lazy_ = config[level_][1];
+      nice_length_ = config[level_][2];
+      max_chain_ = config[level_][3];
+    }
+
+    // Upper bound of the encoded size of size bytes. Blocks never exceed their stored size.
+    static size_t max_encoded_size(size_t size) {
+      return size + (size / max_block_symbols + size / max_stored_block + 2) * 5 + 8;
     }
 
-    bool encode(uint8_t *dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max) const {
-      size_t block_size = 0x10000;
-      FILE *log = fopen("1.txt", "wb");
+    // Encode src to dest as a raw deflate stream. Returns the end of the encoded data
+    // or nullptr if dest is too small. With a preset dictionary, matches may refer to
+    // its last 32k as if it came just before src.
+    uint8_t *encode(uint8_t *dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max, const uint8_t *dictionary = nullptr, size_t dictionary_size = 0) const {
+      return encode_blocks(dest, dest_max, src, src_max, dictionary, dictionary_size, true);
+    }
 
-      while (src != src_max) {
-        size_t size = std::min((size_t)(src_max - src), block_size);
-        suffix_array<uint8_t, uint32_t> sa(src, src + size);
-        for (size_t i = 0; i != size; ++i) {
-          size_t addr = sa.addr(i);
-          char buf[12];
-          size_t k = 0;
-          for (size_t j = std::max((size_t)1u, addr)-1; k != 10 && j != size; ++j) {
-            buf[k++] = src[j] < ' ' || src[j] >= 0x7f  ? '.' : src[j];
+    // Encode src as non-final blocks followed by an empty stored block, as zlib's Z_SYNC_FLUSH,
+    // so that the output of another encode() or encode_flush() can follow it in the same stream.
+    // Pass the input before src as the dictionary to keep matches across the join.
+    // dest needs five bytes more than for encode().
+    uint8_t *encode_flush(uint8_t *dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max, const uint8_t *dictionary = nullptr, size_t dictionary_size = 0) const {
+      return encode_blocks(dest, dest_max, src, src_max, dictionary, dictionary_size, false);
+    }
+
+  private:
+    uint8_t *encode_blocks(uint8_t *dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max, const uint8_t *dictionary, size_t dictionary_size, bool final) const {
+      size_t prefix = dictionary ? std::min(dictionary_size, (size_t)window_size) : 0;
+      std::vector<uint8_t> history;
+      const uint8_t *data = src;
+      size_t size = (size_t)(src_max - src);
+      if (prefix) {
+        history.reserve(prefix + size);
+        history.insert(history.end(), dictionary + dictionary_size - prefix, dictionary + dictionary_size);
+        history.insert(history.end(), src, src_max);
+        data = history.data();
+        size = history.size();
+      }
+
+      bit_writer w;
+      if (level_ == 0) {
+        write_stored(w, data + prefix, size - prefix, final);
+      } else {
+        std::vector<symbol> symbols;
+        symbols.reserve(max_block_symbols);
+        parser p(data, size, prefix);
+        bool last = false;
+        while (!last) {
+          size_t block_start = p.pos;
+          symbols.clear();
+          if (max_lazy_ && level_ >= 4) {
+            parse_lazy(p, symbols);
+          } else {
+            parse_greedy(p, symbols);
           }
-          buf[k] = 0;
-          fprintf(log, "%8d <%s>\n", i, buf);
+          last = p.pos == size;
+          write_block(w, symbols, data + block_start, p.pos - block_start, last && final);
         }
-        break;
-        src += size;
       }
-      return false;
+      if (!final) {
+        write_stored(w, nullptr, 0, false);
+      }
+      w.align();
+
+      if (w.byte_size() > (size_t)(dest_max - dest)) return nullptr;
+      memcpy(dest, w.data(), w.byte_size());
+      return dest + w.byte_size();
     }
-  private:
+
+    // A literal (distance == 0) or a match.
+    struct symbol {
+      uint16_t len_or_literal;
+      uint16_t distance;
+    };
+
+    // Match finder state: hash chains over the last 32k.
+    struct parser {
+      const uint8_t *src;
+      size_t size;
+      size_t pos;
+      size_t next_insert = 0;
+      std::vector<uint32_t> head;
+      std::vector<uint32_t> prev;
+
+      parser(const uint8_t *src, size_t size, size_t pos) : src(src), size(size), pos(pos), head((size_t)1 << hash_bits), prev(window_size) {
+      }
+
+      static uint32_t hash3(const uint8_t *p) {
+        uint32_t v = p[0] | p[1] << 8 | p[2] << 16;
+        return (v * 2654435761u) >> (32 - hash_bits);
+      }
+
+      // Add positions up to (but not including) p to the hash chains.
+      void insert_to(size_t p) {
+        for (; next_insert < p; ++next_insert) {
+          if (next_insert + min_match > size) continue;
+          uint32_t &h = head[hash3(src + next_insert)];
+          prev[next_insert & (window_size - 1)] = h;
+          h = (uint32_t)next_insert + 1;
+        }
+      }
+    };
+
+    // Count matching bytes, eight at a time.
+    static unsigned match_length(const uint8_t *a, const uint8_t *b, unsigned max_len) {
+      unsigned len = 0;
+      for (; len + 8 <= max_len; len += 8) {
+        uint64_t x, y;
+        memcpy(&x, a + len, 8);
+        memcpy(&y, b + len, 8);
+        if (x != y) {
+          // the first differing byte on a little-endian machine.
+          uint64_t diff = x ^ y;
+          while (!(diff & 0xff)) { diff >>= 8; ++len; }
+          return len;
+        }
+      }
+      while (len != max_len && a[len] == b[len]) ++len;
+      return len;
+    }
+
+    // Find the longest match at p.pos. Returns its length (0 if none).
+    unsigned longest_match(parser &p, size_t pos, unsigned prev_length, unsigned &distance) const {
+      p.insert_to(pos);
+      unsigned max_len = (unsigned)std::min(p.size - pos, (size_t)max_match);
+      if (max_len < min_match) return 0;
+      const uint8_t *s = p.src + pos;
+      unsigned best = std::max(prev_length, (unsigned)min_match - 1);
+      if (best >= max_len) return 0;
+      unsigned chain = prev_length >= good_length_ ? max_chain_ >> 2 : max_chain_;
+      for (uint32_t cand = p.head[parser::hash3(s)]; cand && chain; --chain) {
+        size_t c = cand - 1;
+        if (pos - c > window_size) break;
+        const uint8_t *m = p.src + c;
+        // check the bytes that would make a longer match before counting.
+        if (m[best] == s[best] && m[best-1] == s[best-1] && m[0] == s[0] && m[1] == s[1]) {
+          unsigned len = match_length(m, s, max_len);
+          if (len > best) {
+            best = len;
+            distance = (unsigned)(pos - c);
+            if (len >= nice_length_ || len == max_len) break;
+          }
+        }
+        cand = p.prev[c & (window_size - 1)];
+      }
+      return best > prev_length && best >= min_match ? best : 0;
+    }
+
+    // Levels 1-3: take the longest match at each position.
+    void parse_greedy(parser &p, std::vector<symbol> &symbols) const {
+      while (p.pos < p.size && symbols.size() < max_block_symbols) {
+        unsigned distance = 0;
+        unsigned len = longest_match(p, p.pos, 0, distance);
+        if (len) {
+          symbols.push_back(symbol{(uint16_t)len, (uint16_t)distance});
+          // skip inserting the inside of long matches for speed, as zlib does.
+          if (len > max_lazy_) {
+            p.insert_to(p.pos + 1);
+            p.next_insert = p.pos + len;
+          }
+          p.pos += len;
+        } else {
+          symbols.push_back(symbol{p.src[p.pos++], 0});
+        }
+      }
+    }
+
+    // Levels 4-9: only take a match if the next position does not have a longer one.
+    void parse_lazy(parser &p, std::vector<symbol> &symbols) const {
+      unsigned distance = 0;
+      unsigned len = p.pos < p.size ? longest_match(p, p.pos, 0, distance) : 0;
+      while (p.pos < p.size && symbols.size() < max_block_symbols) {
+        if (!len) {
+          symbols.push_back(symbol{p.src[p.pos++], 0});
+          len = longest_match(p, p.pos, 0, distance);
+          continue;
+        }
+        if (len < max_lazy_ && p.pos + 1 < p.size) {
+          unsigned next_distance = 0;
+          unsigned next_len = longest_match(p, p.pos + 1, len, next_distance);
+          if (next_len) {
+            symbols.push_back(symbol{p.src[p.pos++], 0});
+            len = next_len;
+            distance = next_distance;
+            continue;
+          }
+        }
+        symbols.push_back(symbol{(uint16_t)len, (uint16_t)distance});
+        p.pos += len;
+        len = p.pos < p.size ? longest_match(p, p.pos, 0, distance) : 0;
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Block writing
+    //
+
+    static int length_code(unsigned len, unsigned &extra_bits, unsigned &extra) {
+      unsigned x = len - 3;
+      if (len == max_match) { extra_bits = extra = 0; return 285; }
+      if (x < 8) { extra_bits = extra = 0; return 257 + x; }
+      unsigned nb = floor_log2(x);
+      extra_bits = nb - 2;
+      extra = x & ((1u << extra_bits) - 1);
+      return 257 + 4 * (nb - 1) + ((x >> extra_bits) & 3);
+    }
+
+    static int distance_code(unsigned distance, unsigned &extra_bits, unsigned &extra) {
+      unsigned x = distance - 1;
+      if (x < 4) { extra_bits = extra = 0; return x; }
+      unsigned nb = floor_log2(x);
+      extra_bits = nb - 1;
+      extra = x & ((1u << extra_bits) - 1);
+      return 2 * nb + ((x >> extra_bits) & 1);
+    }
+
+    static unsigned floor_log2(unsigned x) {
+      unsigned result = 0;
+      while (x >>= 1) ++result;
+      return result;
+    }
+
+    // Code lengths as a sequence of code length symbols (0-18) with extra bits.
+    struct cl_token {
+      uint8_t symbol;
+      uint8_t extra;
+    };
+
+    static void run_length_code(std::vector<cl_token> &tokens, const uint8_t *lengths, unsigned num_lengths) {
+      for (unsigned i = 0; i != num_lengths; ) {
+        unsigned v = lengths[i];
+        unsigned run = 1;
+        while (i + run != num_lengths && lengths[i + run] == v) ++run;
+        i += run;
+        if (v == 0) {
+          for (; run >= 11; ) {
+            unsigned r = std::min(run, 138u);
+            tokens.push_back(cl_token{18, (uint8_t)(r - 11)});
+            run -= r;
+          }
+          if (run >= 3) {
+            tokens.push_back(cl_token{17, (uint8_t)(run - 3)});
+            run = 0;
+          }
+        } else {
+          tokens.push_back(cl_token{(uint8_t)v, 0});
+          --run;
+          for (; run >= 3; ) {
+            unsigned r = std::min(run, 6u);
+            tokens.push_back(cl_token{16, (uint8_t)(r - 3)});
+            run -= r;
+          }
+        }
+        for (; run; --run) tokens.push_back(cl_token{(uint8_t)v, 0});
+      }
+    }
+
+    void write_block(bit_writer &w, const std::vector<symbol> &symbols, const uint8_t *src, size_t size, bool last) const {
+      // symbol frequencies, with one end of block.
+      uint32_t lit_counts[286] = {0};
+      uint32_t dist_counts[30] = {0};
+      size_t extra_bits = 0;
+      for (auto &sym : symbols) {
+        if (sym.distance) {
+          unsigned eb, e;
+          ++lit_counts[length_code(sym.len_or_literal, eb, e)];
+          extra_bits += eb;
+          ++dist_counts[distance_code(sym.distance, eb, e)];
+          extra_bits += eb;
+        } else {
+          ++lit_counts[sym.len_or_literal];
+        }
+      }
+      lit_counts[256] = 1;
+
+      // dynamic codes
+      uint8_t lengths[286 + 30];
+      uint8_t *lit_lengths = lengths, *dist_lengths = lengths + 286;
+      huffman_code_lengths(lit_lengths, lit_counts, 286, 15);
+      huffman_code_lengths(dist_lengths, dist_counts, 30, 15);
+      unsigned num_lit = 286, num_dist = 30;
+      while (num_lit > 257 && !lit_lengths[num_lit-1]) --num_lit;
+      while (num_dist > 1 && !dist_lengths[num_dist-1]) --num_dist;
+      // the decoder needs at least one distance code.
+      if (!dist_lengths[0] && num_dist == 1) dist_lengths[0] = 1;
+      memmove(lengths + num_lit, dist_lengths, num_dist);
+
+      std::vector<cl_token> tokens;
+      run_length_code(tokens, lengths, num_lit + num_dist);
+      uint32_t cl_counts[19] = {0};
+      for (auto &t : tokens) ++cl_counts[t.symbol];
+      // a code length code with one symbol would be incomplete.
+      if (std::count_if(cl_counts, cl_counts + 19, [](uint32_t c) { return c != 0; }) == 1) {
+        ++cl_counts[cl_counts[0] ? 1 : 0];
+      }
+      uint8_t cl_lengths[19];
+      huffman_code_lengths(cl_lengths, cl_counts, 19, 7);
+      static const uint8_t order[] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+      unsigned num_cl = 19;
+      while (num_cl > 4 && !cl_lengths[order[num_cl-1]]) --num_cl;
+
+      size_t dynamic_bits = 3 + 14 + num_cl * 3 + extra_bits;
+      for (auto &t : tokens) dynamic_bits += cl_lengths[t.symbol] + (t.symbol == 16 ? 2 : t.symbol == 17 ? 3 : t.symbol == 18 ? 7 : 0);
+      for (unsigned i = 0; i != 286; ++i) dynamic_bits += (size_t)lit_counts[i] * lit_lengths[i];
+      for (unsigned i = 0; i != 30; ++i) dynamic_bits += (size_t)dist_counts[i] * lengths[num_lit + i] * (i < num_dist);
+
+      size_t fixed_bits = 3 + extra_bits;
+      for (unsigned i = 0; i != 286; ++i) fixed_bits += (size_t)lit_counts[i] * (i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8);
+      for (unsigned i = 0; i != 30; ++i) fixed_bits += (size_t)dist_counts[i] * 5;
+
+      size_t stored_bits = (size / max_stored_block + 1) * (3 + 7 + 32) + size * 8;
+
+      if (stored_bits < dynamic_bits && stored_bits < fixed_bits) {
+        write_stored(w, src, size, last);
+        return;
+      }
+
+      uint8_t fixed_lengths[288 + 32];
+      uint16_t lit_codes[288], dist_codes[32];
+      const uint8_t *lit_len, *dist_len;
+      if (fixed_bits <= dynamic_bits) {
+        memset(fixed_lengths +   0, 8, 144 - 0);
+        memset(fixed_lengths + 144, 9, 256-144);
+        memset(fixed_lengths + 256, 7, 280-256);
+        memset(fixed_lengths + 280, 8, 288-280);
+        memset(fixed_lengths + 288, 5, 32);
+        lit_len = fixed_lengths;
+        dist_len = fixed_lengths + 288;
+        huffman_codes(lit_codes, lit_len, 288);
+        huffman_codes(dist_codes, dist_len, 32);
+        w.write(1, last);
+        w.write(2, 1);
+      } else {
+        lit_len = lengths;
+        dist_len = lengths + num_lit;
+        huffman_codes(lit_codes, lit_len, num_lit);
+        huffman_codes(dist_codes, dist_len, num_dist);
+        uint16_t cl_codes[19];
+        huffman_codes(cl_codes, cl_lengths, 19);
+        w.write(1, last);
+        w.write(2, 2);
+        w.write(5, num_lit - 257);
+        w.write(5, num_dist - 1);
+        w.write(4, num_cl - 4);
+        for (unsigned i = 0; i != num_cl; ++i) {
+          w.write(3, cl_lengths[order[i]]);
+        }
+        for (auto &t : tokens) {
+          w.write(cl_lengths[t.symbol], cl_codes[t.symbol]);
+          if (t.symbol >= 16) w.write(t.symbol == 16 ? 2 : t.symbol == 17 ? 3 : 7, t.extra);
+        }
+      }
+
+      for (auto &sym : symbols) {
+        if (sym.distance) {
+          unsigned leb, le, deb, de;
+          int lc = length_code(sym.len_or_literal, leb, le);
+          int dc = distance_code(sym.distance, deb, de);
+          uint64_t bits = lit_codes[lc];
+          unsigned n = lit_len[lc];
+          bits |= (uint64_t)le << n; n += leb;
+          bits |= (uint64_t)dist_codes[dc] << n; n += dist_len[dc];
+          bits |= (uint64_t)de << n; n += deb;
+          w.write(n, bits);
+        } else {
+          w.write(lit_len[sym.len_or_literal], lit_codes[sym.len_or_literal]);
+        }
+      }
+      w.write(lit_len[256], lit_codes[256]);
+    }
+
+    static void write_stored(bit_writer &w, const uint8_t *src, size_t size, bool last) {
+      do {
+        size_t len = std::min(size, (size_t)max_stored_block);
+        size -= len;
+        w.write(1, last && !size);
+        w.write(2, 0);
+        w.align();
+        w.write(16, len);
+        w.write(16, len ^ 0xffff);
+        w.write_bytes(src, len);
+        src += len;
+      } while (size);
+    }
+
+    int level_;
+    unsigned good_length_;
+    unsigned max_lazy_;
+    unsigned nice_length_;
+    unsigned max_chain_;
   };
 }
 
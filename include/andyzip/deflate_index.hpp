@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Random access to large deflate streams (as in zlib's zran.c).
+//
+// One full decode records a checkpoint at a block boundary every "span" bytes of
+// output: the input bit offset, the output offset and the 32k window before it.
+// A read then starts from the nearest checkpoint instead of the start of the stream.
+//
+//   andyzip::deflate_index index(gz.data(), gz.end());    // raw deflate data
+//   std::vector<uint8_t> side_file = index.serialize();
+//   ...
+//   auto index = andyzip::deflate_index::deserialize(side_file.data(), side_file.data() + side_file.size());
+//   index.read(gz.data(), gz.end(), offset, buffer, size);
+//
+// For a .gz file, use gzip_reader::data() to find the deflate data.
+//
+
+#ifndef ANDYZIP_DEFLATE_INDEX_HPP_
+#define ANDYZIP_DEFLATE_INDEX_HPP_
+
+#include <andyzip/deflate_decoder.hpp>
+#include <andyzip/deflate_encoder.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace andyzip {
+  class deflate_index {
+  public:
+    enum {
+      window_size = 32768,
+      version = 1,
+    };
+
+    struct checkpoint {
+      uint64_t in_bit;
+      uint64_t out_offset;
+      std::vector<uint8_t> window;
+    };
+
+    deflate_index() {
+    }
+
+    // Decode the raw deflate stream [begin, end) once and record a checkpoint
+    // at the first block boundary after every span bytes of output.
+    deflate_index(const uint8_t *begin, const uint8_t *end, uint64_t span = 1 << 20) : span_(span) {
+      checkpoint start = { 0, 0, {} };
+      uint64_t next_checkpoint = 0;
+      bool ok = walk(begin, end, start,
+        [&](uint64_t in_bit, uint64_t out_offset, const uint8_t *window_end, size_t window_bytes) {
+          if (out_offset >= next_checkpoint) {
+            size_t n = std::min(window_bytes, (size_t)window_size);
+            checkpoints_.push_back(checkpoint{in_bit, out_offset, std::vector<uint8_t>(window_end - n, window_end)});
+            next_checkpoint = out_offset + span_;
+          }
+          return true;
+        },
+        [&](const uint8_t *, size_t size) {
+          size_ += size;
+          return true;
+        }
+      );
+      if (!ok) {
+        throw std::runtime_error("deflate decode failure");
+      }
+      compressed_size_ = (uint64_t)(end - begin);
+    }
+
+    // Decoded size of the stream.
+    uint64_t size() const { return size_; }
+
+    uint64_t span() const { return span_; }
+
+    const std::vector<checkpoint> &checkpoints() const { return checkpoints_; }
+
+    // Read up to size bytes at offset in the decoded stream. [begin, end) must be the
+    // stream the index was built from. Returns the number of bytes read.
+    size_t read(const uint8_t *begin, const uint8_t *end, uint64_t offset, uint8_t *dest, size_t size) const {
+      if ((uint64_t)(end - begin) != compressed_size_) {
+        throw std::runtime_error("deflate index does not match stream");
+      }
+      if (offset >= size_ || size == 0) return 0;
+      auto cp = std::upper_bound(
+        checkpoints_.begin(), checkpoints_.end(), offset,
+        [](uint64_t o, const checkpoint &c) { return o < c.out_offset; }
+      );
+      if (cp == checkpoints_.begin()) {
+        throw std::runtime_error("deflate index has no checkpoints");
+      }
+      --cp;
+
+      uint64_t out = cp->out_offset;
+      size_t done = 0;
+      bool ok = walk(begin, end, *cp,
+        [&](uint64_t, uint64_t, const uint8_t *, size_t) {
+          return done != size;
+        },
+        [&](const uint8_t *data, size_t len) {
+          // copy the part of this block that overlaps [offset, offset + size).
+          uint64_t block_end = out + len;
+          if (block_end > offset) {
+            uint64_t from = std::max(offset + done, out);
+            size_t n = (size_t)std::min<uint64_t>(block_end - from, size - done);
+            memcpy(dest + done, data + (from - out), n);
+            done += n;
+          }
+          out = block_end;
+          return done != size;
+        }
+      );
+      if (!ok) {
+        throw std::runtime_error("deflate decode failure");
+      }
+      return done;
+    }
+
+    // Save the index for a side file. Windows are deflated.
+    std::vector<uint8_t> serialize() const {
+      std::vector<uint8_t> result;
+      put(result, 0x58445a41, 4);  // "AZDX"
+      put(result, version, 4);
+      put(result, compressed_size_, 8);
+      put(result, size_, 8);
+      put(result, span_, 8);
+      put(result, checkpoints_.size(), 8);
+      deflate_encoder enc(1);
+      std::vector<uint8_t> packed(deflate_encoder::max_encoded_size(window_size));
+      for (auto &c : checkpoints_) {
+        const uint8_t *w = c.window.data();
+        uint8_t *e = enc.encode(packed.data(), packed.data() + packed.size(), w, w + c.window.size());
+        put(result, c.in_bit, 8);
+        put(result, c.out_offset, 8);
+        put(result, c.window.size(), 4);
+        put(result, e - packed.data(), 4);
+        result.insert(result.end(), packed.data(), e);
+      }
+      return result;
+    }
+
+    // Load an index made by serialize().
+    static deflate_index deserialize(const uint8_t *begin, const uint8_t *end) {
+      deflate_index result;
+      const uint8_t *p = begin;
+      if (get(p, end, 4) != 0x58445a41 || get(p, end, 4) != version) {
+        throw std::runtime_error("not a deflate index");
+      }
+      result.compressed_size_ = get(p, end, 8);
+      result.size_ = get(p, end, 8);
+      result.span_ = get(p, end, 8);
+      uint64_t count = get(p, end, 8);
+      if (count > (uint64_t)(end - p) / 24) {
+        throw std::runtime_error("corrupt deflate index");
+      }
+      deflate_decoder dec;
+      result.checkpoints_.resize((size_t)count);
+      for (auto &c : result.checkpoints_) {
+        c.in_bit = get(p, end, 8);
+        c.out_offset = get(p, end, 8);
+        size_t window_bytes = (size_t)get(p, end, 4);
+        size_t packed_bytes = (size_t)get(p, end, 4);
+        if (window_bytes > window_size || packed_bytes > (size_t)(end - p)) {
+          throw std::runtime_error("corrupt deflate index");
+        }
+        c.window.resize(window_bytes);
+        if (!dec.decode(c.window.data(), c.window.data() + window_bytes, p, p + packed_bytes)) {
+          throw std::runtime_error("corrupt deflate index");
+        }
+        p += packed_bytes;
+      }
+      return result;
+    }
+
+  private:
+    // Decode blocks from a checkpoint. Before each block, on_block(in_bit, out_offset,
+    // window_end, window_bytes) is called and after it on_data(data, size).
+    // Either can return false to stop. Returns false if the stream is corrupt.
+    template <class OnBlock, class OnData>
+    static bool walk(const uint8_t *begin, const uint8_t *end, const checkpoint &start, OnBlock on_block, OnData on_data) {
+      enum { chunk = 1 << 20 };
+      if (start.in_bit / 8 >= (uint64_t)(end - begin)) return false;
+
+      // the buffer holds the last 32k of output as history, then new output.
+      std::vector<uint8_t> buffer(window_size + chunk);
+      std::copy(start.window.begin(), start.window.end(), buffer.begin());
+
+      deflate_decoder dec;
+      deflate_decoder::block_state s;
+      s.src = begin + start.in_bit / 8;
+      s.bit = (unsigned)(start.in_bit % 8);
+      s.src_max = end;
+      s.dest_begin = buffer.data();
+      s.dest = buffer.data() + start.window.size();
+      s.dest_max = buffer.data() + buffer.size();
+
+      uint64_t out = start.out_offset;
+      do {
+        uint64_t in_bit = (uint64_t)(s.src - begin) * 8 + s.bit;
+        if (!on_block(in_bit, out, s.dest, (size_t)(s.dest - s.dest_begin))) return true;
+
+        // keep just the window once the buffer is getting full.
+        if ((size_t)(s.dest_max - s.dest) < chunk / 2 && s.dest - s.dest_begin > window_size) {
+          memmove(buffer.data(), s.dest - window_size, window_size);
+          s.dest = buffer.data() + window_size;
+        }
+
+        uint8_t *block_begin = s.dest;
+        while (!dec.decode_block(s)) {
+          if (!s.output_full) return false;
+          // a very large block: make the buffer bigger.
+          size_t used = s.dest - buffer.data();
+          buffer.resize(buffer.size() * 2);
+          s.dest_begin = buffer.data();
+          s.dest = buffer.data() + used;
+          s.dest_max = buffer.data() + buffer.size();
+          block_begin = s.dest;
+        }
+
+        size_t len = (size_t)(s.dest - block_begin);
+        out += len;
+        if (!on_data(block_begin, len)) return true;
+      } while (!s.is_last);
+      return true;
+    }
+
+    static void put(std::vector<uint8_t> &out, uint64_t value, int bytes) {
+      for (int i = 0; i != bytes; ++i) out.push_back((uint8_t)(value >> (i * 8)));
+    }
+
+    static uint64_t get(const uint8_t *&p, const uint8_t *end, int bytes) {
+      if (end - p < bytes) {
+        throw std::runtime_error("truncated deflate index");
+      }
+      uint64_t value = 0;
+      for (int i = 0; i != bytes; ++i) value |= (uint64_t)p[i] << (i * 8);
+      p += bytes;
+      return value;
+    }
+
+    std::vector<checkpoint> checkpoints_;
+    uint64_t compressed_size_ = 0;
+    uint64_t size_ = 0;
+    uint64_t span_ = 0;
+  };
+}
+
+#endif
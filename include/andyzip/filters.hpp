@@ -0,0 +1,265 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Reversible filters to apply before compression.
+//
+// The stride delta filter splits data made of records of "stride" bytes into
+// byte planes, plane k holding bytes k, k+stride, k+2*stride... and codes each
+// byte as the difference from the one before it in its plane. Arrays of integers,
+// floats and pixels become runs of small values that compress much better.
+//
+//   std::vector<uint8_t> out(src_size + 1);
+//   unsigned stride = andyzip::choose_stride(src, src + src_size);
+//   andyzip::stride_delta_forward(out.data() + 1, src, src_size, stride);
+//   out[0] = stride;
+//
+// or use encode_filtered() with any encoder and unfilter() after decoding.
+//
+// Strides of 1, 2, 4, 8 and 16 use SSE2 on x86-64 and the rest are scalar.
+//
+
+#ifndef ANDYZIP_FILTERS_HPP_
+#define ANDYZIP_FILTERS_HPP_
+
+#include <andyzip/analysis.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define ANDYZIP_FILTERS_SSE2 1
+#endif
+
+namespace andyzip {
+  namespace detail {
+    // Start of each byte plane in the filtered data.
+    inline void plane_offsets(size_t *offsets, size_t size, unsigned stride) {
+      size_t offset = 0;
+      for (unsigned k = 0; k != stride; ++k) {
+        offsets[k] = offset;
+        offset += size > k ? (size - k + stride - 1) / stride : 0;
+      }
+    }
+
+    #ifdef ANDYZIP_FILTERS_SSE2
+      // Split 16*S interleaved bytes in v[] into S planes of 16 bytes in out[]
+      // by repeatedly separating even and odd bytes.
+      template <unsigned S>
+      struct planes {
+        static void split(__m128i *out, const __m128i *v) {
+          const __m128i mask = _mm_set1_epi16(0x00ff);
+          __m128i even[S/2], odd[S/2], even_out[S/2], odd_out[S/2];
+          for (unsigned i = 0; i != S/2; ++i) {
+            even[i] = _mm_packus_epi16(_mm_and_si128(v[2*i], mask), _mm_and_si128(v[2*i+1], mask));
+            odd[i] = _mm_packus_epi16(_mm_srli_epi16(v[2*i], 8), _mm_srli_epi16(v[2*i+1], 8));
+          }
+          planes<S/2>::split(even_out, even);
+          planes<S/2>::split(odd_out, odd);
+          for (unsigned i = 0; i != S/2; ++i) {
+            out[2*i] = even_out[i];
+            out[2*i+1] = odd_out[i];
+          }
+        }
+
+        // The inverse of split.
+        static void merge(__m128i *out, const __m128i *p) {
+          __m128i even[S/2], odd[S/2], even_out[S/2], odd_out[S/2];
+          for (unsigned i = 0; i != S/2; ++i) {
+            even[i] = p[2*i];
+            odd[i] = p[2*i+1];
+          }
+          planes<S/2>::merge(even_out, even);
+          planes<S/2>::merge(odd_out, odd);
+          for (unsigned i = 0; i != S/2; ++i) {
+            out[2*i] = _mm_unpacklo_epi8(even_out[i], odd_out[i]);
+            out[2*i+1] = _mm_unpackhi_epi8(even_out[i], odd_out[i]);
+          }
+        }
+      };
+
+      template <>
+      struct planes<1> {
+        static void split(__m128i *out, const __m128i *v) { out[0] = v[0]; }
+        static void merge(__m128i *out, const __m128i *p) { out[0] = p[0]; }
+      };
+
+      // The last S bytes of v repeated.
+      template <unsigned S>
+      inline __m128i broadcast_last(__m128i v) {
+        switch (S) {
+          case 1: v = _mm_unpackhi_epi8(v, v); // fall through
+          case 2: v = _mm_shufflehi_epi16(v, 0xff); // fall through
+          case 4: return _mm_shuffle_epi32(v, 0xff);
+          case 8: return _mm_unpackhi_epi64(v, v);
+          default: return v;
+        }
+      }
+
+      // Running sum at stride S of the bytes of d, continuing from the previous 16 bytes.
+      template <unsigned S>
+      inline __m128i prefix_sum(__m128i d, __m128i prev) {
+        if (S < 16) d = _mm_add_epi8(d, _mm_slli_si128(d, S & 15));
+        if (S * 2 < 16) d = _mm_add_epi8(d, _mm_slli_si128(d, (S * 2) & 15));
+        if (S * 4 < 16) d = _mm_add_epi8(d, _mm_slli_si128(d, (S * 4) & 15));
+        if (S * 8 < 16) d = _mm_add_epi8(d, _mm_slli_si128(d, (S * 8) & 15));
+        return _mm_add_epi8(d, broadcast_last<S>(prev));
+      }
+
+      // Filter whole blocks of 16*S bytes. Returns the number of bytes done.
+      template <unsigned S>
+      inline size_t forward_blocks(uint8_t *dest, const uint8_t *src, size_t size, const size_t *offsets) {
+        size_t blocks = size / (16 * S);
+        for (size_t b = 0; b != blocks; ++b) {
+          const uint8_t *p = src + b * 16 * S;
+          __m128i v[S], out[S];
+          for (unsigned j = 0; j != S; ++j) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(p + j * 16));
+            __m128i before;
+            if (b == 0 && j == 0) {
+              // nothing before the start.
+              uint8_t tmp[16];
+              for (unsigned i = 0; i != 16; ++i) tmp[i] = i >= S ? p[i - S] : 0;
+              before = _mm_loadu_si128((const __m128i*)tmp);
+            } else {
+              before = _mm_loadu_si128((const __m128i*)(p + j * 16 - S));
+            }
+            v[j] = _mm_sub_epi8(x, before);
+          }
+          planes<S>::split(out, v);
+          for (unsigned k = 0; k != S; ++k) {
+            _mm_storeu_si128((__m128i*)(dest + offsets[k] + b * 16), out[k]);
+          }
+        }
+        return blocks * 16 * S;
+      }
+
+      template <unsigned S>
+      inline size_t inverse_blocks(uint8_t *dest, const uint8_t *src, size_t size, const size_t *offsets) {
+        size_t blocks = size / (16 * S);
+        __m128i prev = _mm_setzero_si128();
+        for (size_t b = 0; b != blocks; ++b) {
+          __m128i p[S], v[S];
+          for (unsigned k = 0; k != S; ++k) {
+            p[k] = _mm_loadu_si128((const __m128i*)(src + offsets[k] + b * 16));
+          }
+          planes<S>::merge(v, p);
+          for (unsigned j = 0; j != S; ++j) {
+            prev = prefix_sum<S>(v[j], prev);
+            _mm_storeu_si128((__m128i*)(dest + b * 16 * S + j * 16), prev);
+          }
+        }
+        return blocks * 16 * S;
+      }
+    #endif
+  }
+
+  // Split src into stride byte planes, delta coded, in dest. dest and src must not overlap.
+  // A stride of 0 or 1 is a plain delta.
+  inline void stride_delta_forward(uint8_t *dest, const uint8_t *src, size_t size, unsigned stride) {
+    if (stride == 0) stride = 1;
+    std::vector<size_t> offsets(stride);
+    detail::plane_offsets(offsets.data(), size, stride);
+
+    size_t done = 0;
+    #ifdef ANDYZIP_FILTERS_SSE2
+      switch (stride) {
+        case 1: done = detail::forward_blocks<1>(dest, src, size, offsets.data()); break;
+        case 2: done = detail::forward_blocks<2>(dest, src, size, offsets.data()); break;
+        case 4: done = detail::forward_blocks<4>(dest, src, size, offsets.data()); break;
+        case 8: done = detail::forward_blocks<8>(dest, src, size, offsets.data()); break;
+        case 16: done = detail::forward_blocks<16>(dest, src, size, offsets.data()); break;
+      }
+    #endif
+
+    // done is a multiple of stride, so the rest starts at plane 0.
+    for (size_t j = done / stride; j * stride < size; ++j) {
+      for (unsigned k = 0; k != stride && j * stride + k < size; ++k) {
+        size_t i = j * stride + k;
+        dest[offsets[k] + j] = (uint8_t)(src[i] - (i >= stride ? src[i - stride] : 0));
+      }
+    }
+  }
+
+  // The inverse of stride_delta_forward.
+  inline void stride_delta_inverse(uint8_t *dest, const uint8_t *src, size_t size, unsigned stride) {
+    if (stride == 0) stride = 1;
+    std::vector<size_t> offsets(stride);
+    detail::plane_offsets(offsets.data(), size, stride);
+
+    size_t done = 0;
+    #ifdef ANDYZIP_FILTERS_SSE2
+      switch (stride) {
+        case 1: done = detail::inverse_blocks<1>(dest, src, size, offsets.data()); break;
+        case 2: done = detail::inverse_blocks<2>(dest, src, size, offsets.data()); break;
+        case 4: done = detail::inverse_blocks<4>(dest, src, size, offsets.data()); break;
+        case 8: done = detail::inverse_blocks<8>(dest, src, size, offsets.data()); break;
+        case 16: done = detail::inverse_blocks<16>(dest, src, size, offsets.data()); break;
+      }
+    #endif
+
+    for (size_t j = done / stride; j * stride < size; ++j) {
+      for (unsigned k = 0; k != stride && j * stride + k < size; ++k) {
+        size_t i = j * stride + k;
+        dest[i] = (uint8_t)(src[offsets[k] + j] + (i >= stride ? dest[i - stride] : 0));
+      }
+    }
+  }
+
+  // The best stride for [begin, end) or 0 if filtering would not help, judged by
+  // the order 0 entropy of a sample before and after.
+  inline unsigned choose_stride(const uint8_t *begin, const uint8_t *end, size_t max_sample = 1 << 18) {
+    std::vector<uint8_t> data = sample(begin, end, max_sample);
+    const uint8_t *b = data.data(), *e = data.data() + data.size();
+    double best_entropy = order0_entropy(b, e) * 0.95;
+    unsigned best = 0;
+    unsigned candidates[] = { detect_stride(b, e), 1, 2, 4, 8 };
+    for (unsigned stride : candidates) {
+      if (stride == 0 || stride > 255) continue;
+      double entropy = delta_entropy(b, e, stride);
+      if (entropy < best_entropy) {
+        best_entropy = entropy;
+        best = stride;
+      }
+    }
+    return best;
+  }
+
+  // Filter src with stride (0 to choose one) and encode it with enc.encode(dest, dest_max, src, src_max).
+  // The encoded data is one byte of stride, zero if unfiltered, and the filtered data.
+  // Returns the end of the output as the encoder does.
+  template <class Encoder>
+  uint8_t *encode_filtered(Encoder &enc, uint8_t *dest, uint8_t *dest_max, const uint8_t *src, const uint8_t *src_max, unsigned stride = 0) {
+    size_t size = (size_t)(src_max - src);
+    if (stride == 0) stride = choose_stride(src, src_max);
+    if (stride > 255) stride = 0;
+    std::vector<uint8_t> buffer(size + 1);
+    buffer[0] = (uint8_t)stride;
+    if (stride) {
+      stride_delta_forward(buffer.data() + 1, src, size, stride);
+    } else {
+      std::copy(src, src_max, buffer.begin() + 1);
+    }
+    return enc.encode(dest, dest_max, buffer.data(), buffer.data() + buffer.size());
+  }
+
+  // Undo the filtering of decoded encode_filtered() output, leaving the original data.
+  // Returns false if data is empty.
+  inline bool unfilter(std::vector<uint8_t> &data) {
+    if (data.empty()) return false;
+    unsigned stride = data[0];
+    if (stride) {
+      std::vector<uint8_t> out(data.size() - 1);
+      stride_delta_inverse(out.data(), data.data() + 1, out.size(), stride);
+      data.swap(out);
+    } else {
+      data.erase(data.begin());
+    }
+    return true;
+  }
+}
+
+#endif
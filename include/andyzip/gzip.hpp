@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// gzip (RFC 1952) reader and writer
+//
+
+#ifndef ANDYZIP_GZIP_HPP_
+#define ANDYZIP_GZIP_HPP_
+
+#include <andyzip/deflate_decoder.hpp>
+#include <andyzip/deflate_encoder.hpp>
+#include <andyzip/checksum.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace andyzip {
+  // Read a mapped .gz file. Concatenated members are decoded as one file.
+  //
+  //   andyzip::gzip_reader reader(begin, end);
+  //   std::vector<uint8_t> data = reader.read();
+  //
+  class gzip_reader {
+  public:
+    gzip_reader(const uint8_t *begin, const uint8_t *end) : begin_(begin), end_(end) {
+      // check the first header and keep its file name and time.
+      data_ = parse_header(begin_, &filename_, &comment_, &mtime_);
+    }
+
+    // Decode all members. Throws if the data is corrupt or a checksum does not match.
+    std::vector<uint8_t> read() const {
+      std::vector<uint8_t> result;
+      const uint8_t *p = begin_;
+      do {
+        const uint8_t *data = parse_header(p, nullptr, nullptr, nullptr);
+        size_t start = result.size();
+
+        // ISIZE at the end of the file is the size of the last (usually only) member.
+        size_t size_hint = end_ - begin_ >= 18 ? u4(end_ - 4) : 0;
+        const uint8_t *trailer = dec_.decode_append(result, data, end_, size_hint);
+        if (!trailer) {
+          throw std::runtime_error("deflate decode failure");
+        }
+        if (end_ - trailer < 8) {
+          throw std::runtime_error("truncated gzip file");
+        }
+
+        size_t size = result.size() - start;
+        if (u4(trailer) != crc32(0, result.data() + start, size)) {
+          throw std::runtime_error("gzip crc mismatch");
+        }
+        if (u4(trailer + 4) != (uint32_t)size) {
+          throw std::runtime_error("gzip size mismatch");
+        }
+        p = trailer + 8;
+      } while (is_member(p));
+      return result;
+    }
+
+    // Values from the first member's header.
+    const std::string &filename() const { return filename_; }
+    const std::string &comment() const { return comment_; }
+    uint32_t mtime() const { return mtime_; }
+
+    // Start of the first member's deflate data, for deflate_index.
+    const uint8_t *data() const { return data_; }
+
+  private:
+    enum {
+      ftext = 1,
+      fhcrc = 2,
+      fextra = 4,
+      fname = 8,
+      fcomment = 16,
+    };
+
+    bool is_member(const uint8_t *p) const {
+      // anything else after a member, such as zero padding, is ignored as gzip does.
+      return end_ - p >= 18 && p[0] == 0x1f && p[1] == 0x8b;
+    }
+
+    // Check a member header at p and return the start of its deflate data.
+    const uint8_t *parse_header(const uint8_t *p, std::string *filename, std::string *comment, uint32_t *mtime) const {
+      // 0 1 ID1 = 0x1f
+      // 1 1 ID2 = 0x8b
+      // 2 1 CM = 8 (deflate)
+      // 3 1 FLG
+      // 4 4 MTIME
+      // 8 1 XFL
+      // 9 1 OS
+      if (!is_member(p)) {
+        throw std::runtime_error("not a gzip file");
+      }
+      uint8_t flags = p[3];
+      if (p[2] != 8 || (flags & 0xe0)) {
+        throw std::runtime_error("unsupported gzip file");
+      }
+      if (mtime) *mtime = u4(p + 4);
+      const uint8_t *q = p + 10;
+      if (flags & fextra) {
+        if (end_ - q < 2 || end_ - q - 2 < (ptrdiff_t)u2(q)) throw std::runtime_error("truncated gzip file");
+        q += 2 + u2(q);
+      }
+      if (flags & fname) q = read_string(q, filename);
+      if (flags & fcomment) q = read_string(q, comment);
+      if (flags & fhcrc) {
+        if (end_ - q < 2) throw std::runtime_error("truncated gzip file");
+        if (u2(q) != (crc32(0, p, q - p) & 0xffff)) throw std::runtime_error("gzip header crc mismatch");
+        q += 2;
+      }
+      return q;
+    }
+
+    // Zero terminated ISO 8859-1 string.
+    const uint8_t *read_string(const uint8_t *q, std::string *str) const {
+      const uint8_t *e = (const uint8_t*)memchr(q, 0, end_ - q);
+      if (!e) throw std::runtime_error("truncated gzip file");
+      if (str) str->assign((const char*)q, (const char*)e);
+      return e + 1;
+    }
+
+    static inline uint32_t u4(const uint8_t *p) {
+      return (p[3] << 24) | (p[2] << 16) | (p[1] << 8) | (p[0] << 0);
+    }
+
+    static inline unsigned u2(const uint8_t *p) {
+      return (p[1] << 8) | (p[0] << 0);
+    }
+
+    const uint8_t *begin_;
+    const uint8_t *end_;
+    const uint8_t *data_;
+    std::string filename_;
+    std::string comment_;
+    uint32_t mtime_ = 0;
+    andyzip::deflate_decoder dec_;
+  };
+
+  // Make a .gz file with a single member.
+  class gzip_writer {
+  public:
+    gzip_writer(int level = 6) : enc_(level), level_(level) {
+    }
+
+    std::vector<uint8_t> write(const uint8_t *begin, const uint8_t *end, const std::string &filename = std::string(), uint32_t mtime = 0) const {
+      size_t size = (size_t)(end - begin);
+      std::vector<uint8_t> result(10 + filename.size() + 1 + deflate_encoder::max_encoded_size(size) + 8);
+      uint8_t *p = result.data();
+      *p++ = 0x1f;
+      *p++ = 0x8b;
+      *p++ = 8;
+      *p++ = filename.empty() ? 0 : 8;
+      p = put4(p, mtime);
+      // XFL: 2 = best compression, 4 = fastest
+      *p++ = level_ >= 9 ? 2 : level_ <= 1 ? 4 : 0;
+      // OS: unknown
+      *p++ = 255;
+      if (!filename.empty()) {
+        memcpy(p, filename.c_str(), filename.size() + 1);
+        p += filename.size() + 1;
+      }
+      p = enc_.encode(p, result.data() + result.size(), begin, end);
+      p = put4(p, crc32(0, begin, size));
+      p = put4(p, (uint32_t)size);
+      result.resize(p - result.data());
+      return result;
+    }
+
+  private:
+    static uint8_t *put4(uint8_t *p, uint32_t value) {
+      p[0] = (uint8_t)value;
+      p[1] = (uint8_t)(value >> 8);
+      p[2] = (uint8_t)(value >> 16);
+      p[3] = (uint8_t)(value >> 24);
+      return p + 4;
+    }
+
+    andyzip::deflate_encoder enc_;
+    int level_;
+  };
+}
+
+#endif
@@ -7,8 +7,10 @@
 #ifndef ANDYZIP_HUFFMAN_TABLE_HPP_
 #define ANDYZIP_HUFFMAN_TABLE_HPP_
 
+#include <algorithm>
 #include <cstdint>
 #include <utility>
+#include <vector>
 
 #if _MSC_VER > 0
   #define ALWAYS_INLINE __forceinline
@@ -33,6 +35,77 @@ namespace andyzip {
     return BitReverseTable256[value&0xff] << 8 | BitReverseTable256[(value>>8)&0xff];
   }
 
+  // Make Huffman code lengths of at most max_length bits for an encoder.
+  // Unused symbols get zero length and a single used symbol gets length one.
+  // If the tree is too deep, the smallest counts are raised and the tree rebuilt.
+  static inline void huffman_code_lengths(uint8_t *lengths, const uint32_t *counts, unsigned num_symbols, unsigned max_length) {
+    std::vector<uint16_t> leaves;
+    for (unsigned i = 0; i != num_symbols; ++i) {
+      lengths[i] = 0;
+      if (counts[i]) leaves.push_back((uint16_t)i);
+    }
+    if (leaves.size() <= 1) {
+      if (leaves.size() == 1) lengths[leaves[0]] = 1;
+      return;
+    }
+
+    size_t n = leaves.size();
+    std::vector<uint64_t> weight(n * 2 - 1);
+    std::vector<uint32_t> parent(n * 2 - 1);
+    std::vector<uint8_t> depth(n * 2 - 1);
+    for (uint32_t min_count = 1; ; min_count *= 2) {
+      auto clamped = [&](uint16_t sym) { return std::max(counts[sym], min_count); };
+      std::sort(leaves.begin(), leaves.end(), [&](uint16_t a, uint16_t b) {
+        return clamped(a) != clamped(b) ? clamped(a) < clamped(b) : a < b;
+      });
+      for (size_t i = 0; i != n; ++i) {
+        weight[i] = clamped(leaves[i]);
+      }
+
+      // two queue method: leaves and internal nodes are both made in increasing weight order.
+      size_t leaf = 0, node = n;
+      for (size_t next = n; next != n * 2 - 1; ++next) {
+        size_t a = leaf < n && (node == next || weight[leaf] <= weight[node]) ? leaf++ : node++;
+        size_t b = leaf < n && (node == next || weight[leaf] <= weight[node]) ? leaf++ : node++;
+        weight[next] = weight[a] + weight[b];
+        parent[a] = parent[b] = (uint32_t)next;
+      }
+
+      unsigned max_depth = 0;
+      depth[n * 2 - 2] = 0;
+      for (size_t i = n * 2 - 2; i-- != 0; ) {
+        depth[i] = depth[parent[i]] + 1;
+        if (i < n) max_depth = std::max(max_depth, (unsigned)depth[i]);
+      }
+
+      if (max_depth <= max_length) {
+        for (size_t i = 0; i != n; ++i) {
+          lengths[leaves[i]] = depth[i];
+        }
+        return;
+      }
+    }
+  }
+
+  // Assign canonical codes to code lengths, bit reversed for an LSB first bit stream.
+  static inline void huffman_codes(uint16_t *codes, const uint8_t *lengths, unsigned num_symbols) {
+    unsigned count[17] = {0};
+    for (unsigned i = 0; i != num_symbols; ++i) {
+      ++count[lengths[i]];
+    }
+    count[0] = 0;
+    unsigned next[17] = {0};
+    unsigned code = 0;
+    for (unsigned length = 1; length <= 16; ++length) {
+      code = (code + count[length-1]) << 1;
+      next[length] = code;
+    }
+    for (unsigned i = 0; i != num_symbols; ++i) {
+      unsigned length = lengths[i];
+      codes[i] = length ? (uint16_t)(rev16((uint16_t)next[length]++) >> (16 - length)) : 0;
+    }
+  }
+
   template<int MaxCodes>
   class huffman_table {
     uint8_t min_length_;
@@ -50,7 +123,8 @@ namespace andyzip {
     void init(const uint8_t *lengths, const uint16_t *symbols, unsigned num_lengths) {
       invalid_ = true;
 
-      if (num_lengths == 1) {
+      // simple codes of one or two symbols (a list of symbols is given) use zero or one bits.
+      if (symbols && num_lengths == 1) {
         min_length_ = 0;
         max_length_ = 0;
         limits_[0] = 0xffff;
@@ -59,7 +133,7 @@ namespace andyzip {
         invalid_ = false;
         return;
       }
-      if (num_lengths == 2) {
+      if (symbols && num_lengths == 2) {
         min_length_ = 1;
         max_length_ = 1;
         limits_[0] = 0xffff;
@@ -100,6 +174,11 @@ namespace andyzip {
         huffcode *= 2;
       }
 
+      // incomplete codes would decode unused codes past the end of symbols_.
+      if (huffcode != 2u << max_length_) {
+        return;
+      }
+
       // prevent escape from bitstream decoding loop.
       limits_[max_length_+1-min_length_] = 0xffff;
       invalid_ = false;
@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Parallel decoding of bzip2 streams.
+//
+// bzip2 blocks are independent and each starts with the 48 bit magic 0x314159265359
+// at any bit offset. The input is cut into chunks that are searched for the block
+// and end of stream magics on all threads, then every block found is decoded on
+// its own thread and the blocks are joined in order.
+//
+// A magic may also turn up by chance inside the compressed data. Such a false
+// start either fails to decode or is never reached from the block before it, so it
+// is skipped. The block and stream CRCs are checked as in bzip2_decoder.
+//
+
+#ifndef ANDYZIP_PARALLEL_BZIP2_DECODER_HPP_
+#define ANDYZIP_PARALLEL_BZIP2_DECODER_HPP_
+
+#include <andyzip/bzip2_decoder.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace andyzip {
+  class parallel_bzip2_decoder {
+  public:
+    enum {
+      scan_chunk_size = 1 << 20,
+    };
+
+    // num_threads = 0 uses all hardware threads.
+    parallel_bzip2_decoder(unsigned num_threads = 0) {
+      num_threads_ = num_threads ? num_threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Decode one or more bzip2 streams, appending the output to out, as bzip2_decoder::decode_append.
+    // Returns the first byte after the last stream or nullptr on failure.
+    const uint8_t *decode_append(std::vector<uint8_t> &out, const uint8_t *src, const uint8_t *src_max) const {
+      unsigned first_block_size = bzip2_decoder::block_size(src, src_max);
+      if (num_threads_ == 1 || !first_block_size) {
+        return dec_.decode_append(out, src, src_max);
+      }
+
+      // find the magics in each chunk.
+      size_t size = (size_t)(src_max - src);
+      size_t num_chunks = (size + scan_chunk_size - 1) / scan_chunk_size;
+      std::vector<std::vector<uint64_t>> chunk_starts(num_chunks), chunk_ends(num_chunks);
+      parallel_for(num_chunks, [&](size_t k, unsigned) {
+        size_t end = std::min(size, (k + 1) * (size_t)scan_chunk_size);
+        find_magics(chunk_starts[k], chunk_ends[k], src, src_max, k * (size_t)scan_chunk_size, end);
+      });
+      std::vector<uint64_t> starts, ends;
+      for (size_t k = 0; k != num_chunks; ++k) {
+        starts.insert(starts.end(), chunk_starts[k].begin(), chunk_starts[k].end());
+        ends.insert(ends.end(), chunk_ends[k].begin(), chunk_ends[k].end());
+      }
+
+      // decode every block, with the first stream's block size. A later stream may differ.
+      std::vector<block> blocks(starts.size());
+      std::vector<bzip2_decoder::workspace> workspaces(std::min((size_t)num_threads_, blocks.size()));
+      parallel_for(blocks.size(), [&](size_t k, unsigned t) {
+        block &b = blocks[k];
+        b.end = starts[k];
+        b.ok = dec_.decode_block(b.data, src, src_max, b.end, first_block_size, workspaces[t], b.crc);
+      });
+
+      // follow the blocks from one to the next, checking the stream CRCs.
+      size_t start = out.size();
+      size_t total = 0;
+      std::vector<size_t> path;
+      const uint8_t *p = src;
+      bzip2_decoder::workspace ws;
+      while (unsigned block_size = bzip2_decoder::block_size(p, src_max)) {
+        uint64_t bit = (uint64_t)(p - src) * 8 + 32;
+        uint32_t combined_crc = 0, crc;
+        for (;;) {
+          if (std::binary_search(ends.begin(), ends.end(), bit) && dec_.decode_end(src, src_max, bit, crc)) break;
+          auto i = std::lower_bound(starts.begin(), starts.end(), bit);
+          if (i == starts.end() || *i != bit) return fail(out, start);
+          block &b = blocks[i - starts.begin()];
+          if (!b.ok || block_size < first_block_size) {
+            // decode it again with the right block size.
+            b.data.clear();
+            b.end = bit;
+            b.ok = dec_.decode_block(b.data, src, src_max, b.end, block_size, ws, b.crc);
+            if (!b.ok) return fail(out, start);
+          }
+          path.push_back(i - starts.begin());
+          total += b.data.size();
+          combined_crc = (combined_crc << 1 | combined_crc >> 31) ^ b.crc;
+          bit = b.end;
+        }
+        if (crc != combined_crc) return fail(out, start);
+        p = src + (bit + 7) / 8;
+      }
+
+      out.resize(start + total);
+      std::vector<size_t> offsets(path.size());
+      for (size_t i = 0, offset = start; i != path.size(); ++i) {
+        offsets[i] = offset;
+        offset += blocks[path[i]].data.size();
+      }
+      parallel_for(path.size(), [&](size_t i, unsigned) {
+        const std::vector<uint8_t> &data = blocks[path[i]].data;
+        if (!data.empty()) memcpy(out.data() + offsets[i], data.data(), data.size());
+      });
+      return p;
+    }
+
+  private:
+    struct block {
+      std::vector<uint8_t> data;
+      uint64_t end = 0;    // bit offset after the block
+      uint32_t crc = 0;
+      bool ok = false;
+    };
+
+    static const uint8_t *fail(std::vector<uint8_t> &out, size_t start) {
+      out.resize(start);
+      return nullptr;
+    }
+
+    // fn(i, t) for i in [0, n), where t is the thread, less than num_threads_.
+    template <class Fn>
+    void parallel_for(size_t n, Fn fn) const {
+      std::atomic<size_t> next(0);
+      auto worker = [&](unsigned t) {
+        for (size_t i; (i = next++) < n; ) fn(i, t);
+      };
+      std::vector<std::thread> threads;
+      for (unsigned t = 1; t < num_threads_ && t < n; ++t) threads.emplace_back(worker, t);
+      worker(0);
+      for (auto &t : threads) t.join();
+    }
+
+    // Bit offsets of the block and end of stream magics that start in bytes [begin, end).
+    static void find_magics(std::vector<uint64_t> &starts, std::vector<uint64_t> &ends, const uint8_t *src, const uint8_t *src_max, size_t begin, size_t end) {
+      const uint64_t mask = 0xffffffffffff;
+      size_t size = (size_t)(src_max - src);
+      // window holds bytes i to i+7, most significant first, with zeros past the end.
+      uint64_t window = 0;
+      for (size_t j = begin; j != begin + 8; ++j) {
+        window = window << 8 | (j < size ? src[j] : 0);
+      }
+      for (size_t i = begin; i != end; ++i) {
+        for (unsigned shift = 0; shift != 8; ++shift) {
+          uint64_t v = (window >> (16 - shift)) & mask;
+          if (v == 0x314159265359) {
+            starts.push_back((uint64_t)i * 8 + shift);
+          } else if (v == 0x177245385090) {
+            ends.push_back((uint64_t)i * 8 + shift);
+          }
+        }
+        window = window << 8 | (i + 8 < size ? src[i + 8] : 0);
+      }
+    }
+
+    bzip2_decoder dec_;
+    unsigned num_threads_;
+  };
+}
+
+#endif
@@ -0,0 +1,354 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Speculative parallel decoding of a single deflate stream (after pugz and rapidgzip).
+//
+// The input is cut into chunks. Each chunk after the first looks for the first bit
+// offset that parses as a dynamic block header and decodes a trial block from it.
+// Then every chunk is decoded on its own thread until it reaches the block boundary
+// where a later chunk started. The 32k window before a chunk is not known yet, so
+// back references into it are written as placeholders (256 + window offset) in 16 bit
+// symbols. Once the chunks are stitched together in order, the placeholders are
+// replaced by bytes from the output before them.
+//
+// A chunk whose start was a false positive is never reached by its predecessor and
+// is skipped; the predecessor carries on into the next chunk. A stream with no
+// dynamic blocks is decoded by the first chunk alone, which is the serial decode.
+//
+
+#ifndef ANDYZIP_PARALLEL_DEFLATE_DECODER_HPP_
+#define ANDYZIP_PARALLEL_DEFLATE_DECODER_HPP_
+
+#include <andyzip/deflate_decoder.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace andyzip {
+  class parallel_deflate_decoder {
+  public:
+    enum {
+      window_size = 32768,
+      min_chunk_size = 1 << 16,
+    };
+
+    // num_threads = 0 uses all hardware threads. chunk_size is in compressed bytes.
+    parallel_deflate_decoder(unsigned num_threads = 0, size_t chunk_size = 4 << 20) {
+      num_threads_ = num_threads ? num_threads : std::max(1u, std::thread::hardware_concurrency());
+      chunk_size_ = std::max(chunk_size, (size_t)min_chunk_size);
+      chunks_joined_ = 0;
+    }
+
+    // Number of chunks the last decode_append stitched together; 1 for a serial decode.
+    size_t chunks_joined() const {
+      return chunks_joined_;
+    }
+
+    // Decode a raw deflate stream, appending the output to out, as deflate_decoder::decode_append.
+    // Returns the first byte after the stream or nullptr on failure.
+    const uint8_t *decode_append(std::vector<uint8_t> &out, const uint8_t *src, const uint8_t *src_max) const {
+      size_t num_chunks = (size_t)(src_max - src) / chunk_size_;
+      chunks_joined_ = 1;
+      if (num_threads_ == 1 || num_chunks < 2) {
+        return dec_.decode_append(out, src, src_max);
+      }
+
+      // find a plausible block boundary in each chunk.
+      std::vector<uint64_t> starts(num_chunks);
+      parallel_for(num_chunks, [&](size_t k) {
+        uint64_t begin_bit = (uint64_t)k * chunk_size_ * 8;
+        uint64_t end_bit = k + 1 == num_chunks ? (uint64_t)(src_max - src) * 8 : begin_bit + chunk_size_ * 8;
+        starts[k] = k == 0 ? 0 : find_block(src, src_max, begin_bit, end_bit);
+      });
+
+      // decode each chunk until it meets the start of a later one.
+      std::vector<chunk> chunks(num_chunks);
+      parallel_for(num_chunks, [&](size_t k) {
+        if (starts[k] == no_start) return;
+        if (k == 0) {
+          decode_chunk(chunks[0], chunks[0].bytes, src, src_max, starts, 0, nullptr);
+        } else {
+          decode_chunk(chunks[k], chunks[k].symbols, src, src_max, starts, k, placeholders().data());
+        }
+      });
+
+      // follow the chain of chunks that continue each other.
+      std::vector<size_t> path;
+      std::vector<size_t> offsets;
+      size_t total = 0;
+      for (size_t k = 0; k != num_chunks; k = chunks[k].next) {
+        if (!chunks[k].ok) {
+          return nullptr;
+        }
+        path.push_back(k);
+        offsets.push_back(total);
+        total += k == 0 ? chunks[k].bytes.size() : chunks[k].symbols.size();
+      }
+      chunks_joined_ = path.size();
+
+      size_t start = out.size();
+      out.resize(start + total);
+      uint8_t *stream = out.data() + start;
+      memcpy(stream, chunks[0].bytes.data(), chunks[0].bytes.size());
+
+      // the window of each chunk is the last 32k of the chunks before it, so resolve
+      // the last 32k of every chunk in order, then the rest of each chunk in parallel.
+      bool ok = true;
+      for (size_t i = 1; i != path.size() && ok; ++i) {
+        const chunk &c = chunks[path[i]];
+        size_t size = c.symbols.size();
+        ok = resolve(stream, offsets[i], c.symbols.data(), size - std::min(size, (size_t)window_size), size);
+      }
+      std::atomic<bool> heads_ok(ok);
+      if (ok) {
+        parallel_for(path.size() - 1, [&](size_t i) {
+          const chunk &c = chunks[path[i + 1]];
+          size_t size = c.symbols.size();
+          if (!resolve(stream, offsets[i + 1], c.symbols.data(), 0, size - std::min(size, (size_t)window_size))) {
+            heads_ok = false;
+          }
+        });
+      }
+      if (!heads_ok) {
+        out.resize(start);
+        return nullptr;
+      }
+      return chunks[path.back()].src_end;
+    }
+
+  private:
+    static const uint64_t no_start = ~(uint64_t)0;
+
+    struct chunk {
+      std::vector<uint8_t> bytes;     // output of the first chunk
+      std::vector<uint16_t> symbols;  // output of later chunks, with placeholders
+      size_t next = 0;                // the chunk that continues this one
+      const uint8_t *src_end = nullptr;
+      bool ok = false;
+    };
+
+    // Placeholders for the unknown window, used as a dictionary.
+    static const std::vector<uint16_t> &placeholders() {
+      struct builder {
+        std::vector<uint16_t> p;
+        builder() : p(window_size) {
+          for (size_t i = 0; i != window_size; ++i) p[i] = (uint16_t)(256 + i);
+        }
+      };
+      static const builder b;
+      return b.p;
+    }
+
+    template <class Fn>
+    void parallel_for(size_t n, Fn fn) const {
+      std::atomic<size_t> next(0);
+      auto worker = [&]() {
+        for (size_t i; (i = next++) < n; ) fn(i);
+      };
+      std::vector<std::thread> threads;
+      for (unsigned t = 1; t < num_threads_ && t < n; ++t) threads.emplace_back(worker);
+      worker();
+      for (auto &t : threads) t.join();
+    }
+
+    // Decode blocks from starts[k] until a block ends where a later chunk starts
+    // or the stream ends.
+    template <class Out>
+    void decode_chunk(chunk &c, std::vector<Out> &buf, const uint8_t *src, const uint8_t *src_max, const std::vector<uint64_t> &starts, size_t k, const uint16_t *window) const {
+      buf.resize((size_t)(chunk_size_ * 4));
+      deflate_decoder::basic_block_state<Out> s;
+      s.src = src + starts[k] / 8;
+      s.bit = (unsigned)(starts[k] % 8);
+      s.src_max = src_max;
+      s.dest_begin = buf.data();
+      s.dest = buf.data();
+      s.dest_max = buf.data() + buf.size();
+      set_window(s, window);
+
+      size_t next = k + 1;
+      for (;;) {
+        while (!dec_.decode_block(s)) {
+          if (!s.output_full) return;
+          size_t used = s.dest - buf.data();
+          buf.resize(buf.size() * 2);
+          s.dest_begin = buf.data();
+          s.dest = buf.data() + used;
+          s.dest_max = buf.data() + buf.size();
+        }
+        if (s.is_last) {
+          c.next = starts.size();
+          c.src_end = s.src + (s.bit ? 1 : 0);
+          break;
+        }
+        uint64_t bit = (uint64_t)(s.src - src) * 8 + s.bit;
+        while (next != starts.size() && (starts[next] == no_start || starts[next] < bit)) ++next;
+        if (next != starts.size() && starts[next] == bit) {
+          c.next = next;
+          break;
+        }
+      }
+      buf.resize(s.dest - buf.data());
+      c.ok = true;
+    }
+
+    static void set_window(deflate_decoder::basic_block_state<uint8_t> &, const uint16_t *) {
+    }
+
+    static void set_window(deflate_decoder::basic_block_state<uint16_t> &s, const uint16_t *window) {
+      s.dictionary = window;
+      s.dictionary_size = window_size;
+    }
+
+    // Replace placeholders in symbols[from, to) of the chunk at offset in the stream.
+    static bool resolve(uint8_t *stream, size_t offset, const uint16_t *symbols, size_t from, size_t to) {
+      const uint8_t *window = stream + offset - window_size;
+      // placeholders before the start of the stream are errors.
+      unsigned min_symbol = 256 + (unsigned)(offset < window_size ? window_size - offset : 0);
+      uint8_t *dest = stream + offset;
+      for (size_t i = from; i != to; ++i) {
+        unsigned v = symbols[i];
+        if (v < 256) {
+          dest[i] = (uint8_t)v;
+        } else if (v >= min_symbol) {
+          dest[i] = window[v - 256];
+        } else {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Block boundary search
+    //
+
+    // Find the first bit in [begin_bit, end_bit) that looks like the start of a
+    // non-final dynamic block and from which a whole block decodes.
+    uint64_t find_block(const uint8_t *src, const uint8_t *src_max, uint64_t begin_bit, uint64_t end_bit) const {
+      std::vector<uint16_t> buf;
+      for (uint64_t bit = begin_bit; bit != end_bit; ++bit) {
+        if (!plausible_header(src, src_max, bit)) continue;
+
+        deflate_decoder::basic_block_state<uint16_t> s;
+        s.src = src + bit / 8;
+        s.bit = (unsigned)(bit % 8);
+        s.src_max = src_max;
+        buf.resize(1 << 16);
+        s.dest_begin = s.dest = buf.data();
+        s.dest_max = buf.data() + buf.size();
+        set_window(s, placeholders().data());
+        bool ok;
+        while (!(ok = dec_.decode_block(s)) && s.output_full && buf.size() < (1u << 24)) {
+          buf.resize(buf.size() * 2);
+          s.dest_begin = s.dest = buf.data();
+          s.dest_max = buf.data() + buf.size();
+        }
+        // a huge block that decodes this far is as good as a whole one.
+        if (ok || s.output_full) return bit;
+      }
+      return no_start;
+    }
+
+    // Reads bits for the header checks, failing at the end of the input.
+    struct bit_reader {
+      const uint8_t *src;
+      uint64_t size_bits;
+      uint64_t pos;
+      bool fail;
+
+      unsigned get(unsigned n) {
+        if (pos + n > size_bits) { fail = true; return 0; }
+        unsigned value = 0;
+        for (unsigned i = 0; i != n; ++i, ++pos) {
+          value |= ((src[pos >> 3] >> (pos & 7)) & 1) << i;
+        }
+        return value;
+      }
+    };
+
+    // Number of codes left unused by these lengths (0 for a complete code), or -1 if over-subscribed.
+    static int unused_codes(const uint8_t *lengths, unsigned n, unsigned max_length) {
+      int left = 1;
+      unsigned count[16] = {0};
+      for (unsigned i = 0; i != n; ++i) ++count[lengths[i]];
+      for (unsigned len = 1; len <= max_length; ++len) {
+        left = left * 2 - (int)count[len];
+        if (left < 0) return -1;
+      }
+      return left;
+    }
+
+    // Check a dynamic block header as thoroughly as a decoder would, without decoding symbols.
+    static bool plausible_header(const uint8_t *src, const uint8_t *src_max, uint64_t bit) {
+      bit_reader r = { src, (uint64_t)(src_max - src) * 8, bit, false };
+      // BFINAL = 0, BTYPE = 2
+      if (r.get(3) != 4) return false;
+      unsigned num_lit = r.get(5) + 257;
+      unsigned num_dist = r.get(5) + 1;
+      if (num_lit > 286 || num_dist > 30) return false;
+      unsigned num_cl = r.get(4) + 4;
+
+      static const uint8_t order[] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+      uint8_t cl_lengths[19] = {0};
+      for (unsigned i = 0; i != num_cl; ++i) cl_lengths[order[i]] = (uint8_t)r.get(3);
+      if (r.fail || unused_codes(cl_lengths, 19, 7) != 0) return false;
+
+      // canonical decoding of the code length code, one bit at a time.
+      unsigned count[8] = {0};
+      uint8_t symbols[19];
+      for (unsigned i = 0; i != 19; ++i) ++count[cl_lengths[i]];
+      unsigned offs[8] = {0};
+      for (unsigned len = 1; len != 7; ++len) offs[len + 1] = offs[len] + count[len];
+      for (unsigned i = 0; i != 19; ++i) if (cl_lengths[i]) symbols[offs[cl_lengths[i]]++] = (uint8_t)i;
+
+      uint8_t lengths[286 + 30];
+      for (unsigned done = 0; done < num_lit + num_dist; ) {
+        int code = 0, first = 0, index = 0, sym = -1;
+        for (unsigned len = 1; len <= 7; ++len) {
+          code |= r.get(1);
+          int n = (int)count[len];
+          if (code - n < first) { sym = symbols[index + code - first]; break; }
+          index += n;
+          first = (first + n) << 1;
+          code <<= 1;
+        }
+        if (r.fail || sym < 0) return false;
+        unsigned value = sym, repeat = 1;
+        if (sym == 16) {
+          if (done == 0) return false;
+          value = lengths[done - 1];
+          repeat = 3 + r.get(2);
+        } else if (sym == 17) {
+          value = 0;
+          repeat = 3 + r.get(3);
+        } else if (sym == 18) {
+          value = 0;
+          repeat = 11 + r.get(7);
+        }
+        if (r.fail || done + repeat > num_lit + num_dist) return false;
+        while (repeat--) lengths[done++] = (uint8_t)value;
+      }
+
+      // the end of block code must exist and both codes must be complete,
+      // except that one distance code or none at all is allowed.
+      if (!lengths[256]) return false;
+      if (unused_codes(lengths, num_lit, 15) != 0) return false;
+      int dist_left = unused_codes(lengths + num_lit, num_dist, 15);
+      unsigned num_dist_codes = (unsigned)std::count_if(lengths + num_lit, lengths + num_lit + num_dist, [](uint8_t l) { return l != 0; });
+      return dist_left == 0 || (dist_left > 0 && num_dist_codes <= 1);
+    }
+
+    deflate_decoder dec_;
+    unsigned num_threads_;
+    size_t chunk_size_;
+    mutable std::atomic<size_t> chunks_joined_;
+  };
+}
+
+#endif
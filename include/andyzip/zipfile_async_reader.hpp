@@ -0,0 +1,565 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Asynchronous zipfile extraction from a file descriptor
+//
+// For archives that are not mapped, such as those on network block storage,
+// where a zipfile_reader would stall on page faults. Only the central directory
+// is read up front; extract() queues a member and calls back with its data on a
+// worker thread once it has been read and decoded:
+//
+//   andyzip::zipfile_async_reader reader(fd);
+//   for (auto e : reader.entries()) {
+//     reader.extract(e, [](const zipfile_reader::entry &e, std::vector<uint8_t> &data, std::exception_ptr error) {
+//       ...
+//     });
+//   }
+//   reader.wait();
+//
+// Member data is read with io_uring on Linux, so that many reads are in flight
+// at once from one thread, and with pread on a pool of threads where io_uring is
+// not available. Decoding overlaps the reads of later members. The bytes of
+// members read but not yet handed to their callback are capped at max_in_flight.
+//
+// The entries are views of the directory only: use extract(), not local_header().
+// If io_uring fails, or rejects reads of the file, the reads not yet in flight go
+// to the pread threads instead.
+// An exception thrown by a callback is passed on by wait(). POSIX only.
+//
+
+#ifndef ANDYZIP_ZIPFILE_ASYNC_READER_HPP_
+#define ANDYZIP_ZIPFILE_ASYNC_READER_HPP_
+
+#include <andyzip/checksum.hpp>
+#include <andyzip/zipfile_reader.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+  #if __has_include(<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #define ANDYZIP_IO_URING 1
+  #endif
+#endif
+
+namespace andyzip {
+  namespace detail {
+    // Read all of [offset, offset + size) unless the file ends first. Returns the bytes read or -1.
+    inline ssize_t pread_all(int fd, uint8_t *buf, size_t size, uint64_t offset) {
+      size_t done = 0;
+      while (done != size) {
+        ssize_t n = ::pread(fd, buf + done, size - done, (off_t)(offset + done));
+        if (n < 0) return -1;
+        if (n == 0) break;
+        done += (size_t)n;
+      }
+      return (ssize_t)done;
+    }
+
+    #ifdef ANDYZIP_IO_URING
+      // A minimal io_uring submission and completion queue for reads, using the system calls directly.
+      // Used from one thread.
+      class io_uring_queue {
+      public:
+        io_uring_queue() {
+        }
+
+        io_uring_queue(const io_uring_queue &) = delete;
+        io_uring_queue &operator=(const io_uring_queue &) = delete;
+
+        ~io_uring_queue() {
+          if (sqes_) munmap(sqes_, sqes_size_);
+          if (cq_ring_ && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_size_);
+          if (sq_ring_) munmap(sq_ring_, sq_ring_size_);
+          if (fd_ >= 0) close(fd_);
+        }
+
+        // Returns false if io_uring is not available, eg. on an old kernel or in a sandbox.
+        // Kernels before 5.6 have io_uring but not IORING_OP_READ, nor the probe that finds it.
+        bool init(unsigned entries) {
+          io_uring_params p;
+          memset(&p, 0, sizeof(p));
+          fd_ = (int)syscall(__NR_io_uring_setup, entries, &p);
+          if (fd_ < 0 || !supports(IORING_OP_READ)) return false;
+
+          sq_ring_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+          cq_ring_size_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+          bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+          if (single_mmap) sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+          sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+          if (!sq_ring_) return false;
+          cq_ring_ = single_mmap ? sq_ring_ : map(cq_ring_size_, IORING_OFF_CQ_RING);
+          if (!cq_ring_) return false;
+          sqes_size_ = p.sq_entries * sizeof(io_uring_sqe);
+          sqes_ = (io_uring_sqe*)map(sqes_size_, IORING_OFF_SQES);
+          if (!sqes_) return false;
+
+          uint8_t *sq = (uint8_t*)sq_ring_, *cq = (uint8_t*)cq_ring_;
+          sq_head_ = (unsigned*)(sq + p.sq_off.head);
+          sq_tail_ = (unsigned*)(sq + p.sq_off.tail);
+          sq_mask_ = *(unsigned*)(sq + p.sq_off.ring_mask);
+          sq_array_ = (unsigned*)(sq + p.sq_off.array);
+          cq_head_ = (unsigned*)(cq + p.cq_off.head);
+          cq_tail_ = (unsigned*)(cq + p.cq_off.tail);
+          cq_mask_ = *(unsigned*)(cq + p.cq_off.ring_mask);
+          cqes_ = (io_uring_cqe*)(cq + p.cq_off.cqes);
+          entries_ = p.sq_entries;
+          return true;
+        }
+
+        // Queue a read. Returns false if the queue is full.
+        bool read(int fd, void *buf, unsigned size, uint64_t offset, uint64_t user_data) {
+          unsigned tail = *sq_tail_;
+          if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) == entries_) return false;
+          unsigned index = tail & sq_mask_;
+          io_uring_sqe &sqe = sqes_[index];
+          memset(&sqe, 0, sizeof(sqe));
+          sqe.opcode = IORING_OP_READ;
+          sqe.fd = fd;
+          sqe.addr = (uint64_t)(uintptr_t)buf;
+          sqe.len = size;
+          sqe.off = offset;
+          sqe.user_data = user_data;
+          sq_array_[index] = index;
+          __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+          to_submit_++;
+          return true;
+        }
+
+        // Submit the queued reads and wait for at least min_complete completions.
+        // Returns 0 or an errno. After EAGAIN or EBUSY, take some completions and try again.
+        int submit(unsigned min_complete) {
+          for (;;) {
+            int n = (int)syscall(__NR_io_uring_enter, fd_, to_submit_, min_complete, min_complete ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (n >= 0) {
+              to_submit_ -= std::min(to_submit_, (unsigned)n);
+              return 0;
+            }
+            if (errno != EINTR) return errno;
+          }
+        }
+
+        // Take back the last queued read that the kernel has not taken: its user_data.
+        // Returns false when there are none left.
+        bool unqueue(uint64_t &user_data) {
+          unsigned tail = *sq_tail_;
+          if (tail == __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE)) {
+            to_submit_ = 0;
+            return false;
+          }
+          user_data = sqes_[(tail - 1) & sq_mask_].user_data;
+          __atomic_store_n(sq_tail_, tail - 1, __ATOMIC_RELEASE);
+          if (to_submit_) to_submit_--;
+          return true;
+        }
+
+        // Take a completion: the user_data of the read and its result, bytes read or -errno.
+        bool complete(uint64_t &user_data, int &result) {
+          unsigned head = *cq_head_;
+          if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) return false;
+          const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+          user_data = cqe.user_data;
+          result = cqe.res;
+          __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+          return true;
+        }
+
+      private:
+        bool supports(unsigned op) {
+          const unsigned num_ops = 256;
+          std::vector<uint8_t> buf(sizeof(io_uring_probe) + num_ops * sizeof(io_uring_probe_op));
+          io_uring_probe *probe = (io_uring_probe*)buf.data();
+          if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, num_ops) < 0) return false;
+          return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+        }
+
+        void *map(size_t size, uint64_t offset) {
+          void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, (off_t)offset);
+          return p == MAP_FAILED ? nullptr : p;
+        }
+
+        int fd_ = -1;
+        void *sq_ring_ = nullptr;
+        void *cq_ring_ = nullptr;
+        io_uring_sqe *sqes_ = nullptr;
+        size_t sq_ring_size_ = 0;
+        size_t cq_ring_size_ = 0;
+        size_t sqes_size_ = 0;
+        unsigned *sq_head_ = nullptr;
+        unsigned *sq_tail_ = nullptr;
+        unsigned sq_mask_ = 0;
+        unsigned *sq_array_ = nullptr;
+        unsigned *cq_head_ = nullptr;
+        unsigned *cq_tail_ = nullptr;
+        unsigned cq_mask_ = 0;
+        io_uring_cqe *cqes_ = nullptr;
+        unsigned entries_ = 0;
+        unsigned to_submit_ = 0;
+      };
+    #endif
+  }
+
+  class zipfile_async_reader {
+  public:
+    enum {
+      queue_depth = 64,
+      // read this much more than a member's data for its local header, whose extra field may differ from the directory's.
+      header_slack = 30 + 256,
+    };
+
+    // Called with the member's data, or an exception and empty data if it could not be read.
+    typedef std::function<void (const zipfile_reader::entry &e, std::vector<uint8_t> &data, std::exception_ptr error)> callback_type;
+
+    // fd stays open and owned by the caller. num_threads = 0 uses all hardware threads.
+    // use_io_uring = false forces the pread fallback.
+    zipfile_async_reader(int fd, unsigned num_threads = 0, size_t max_in_flight = 64 << 20, bool use_io_uring = true) : fd_(fd), max_in_flight_(max_in_flight) {
+      read_directory();
+      num_threads = num_threads ? num_threads : std::max(1u, std::thread::hardware_concurrency());
+      #ifdef ANDYZIP_IO_URING
+        if (use_io_uring && ring_.init(queue_depth)) {
+          uring_ = true;
+          io_thread_ = std::thread([this]() { io_work(); });
+        }
+      #endif
+      for (unsigned t = 0; t != num_threads; ++t) {
+        threads_.emplace_back([this]() { work(); });
+      }
+    }
+
+    zipfile_async_reader(const zipfile_async_reader &) = delete;
+    zipfile_async_reader &operator=(const zipfile_async_reader &) = delete;
+
+    // Waits for the queued members.
+    ~zipfile_async_reader() {
+      try {
+        wait();
+      } catch (...) {
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+      }
+      changed_.notify_all();
+      if (io_thread_.joinable()) io_thread_.join();
+      for (auto &t : threads_) t.join();
+    }
+
+    zipfile_reader::entry_range entries() const {
+      return dir_->entries();
+    }
+
+    zipfile_reader::entry_iterator find(const std::string &filename) const {
+      return dir_->find(filename);
+    }
+
+    // True if reads go through io_uring.
+    bool uses_io_uring() const {
+      return uring_;
+    }
+
+    // Queue a member. done is called on a worker thread.
+    void extract(const zipfile_reader::entry &e, callback_type done) {
+      std::unique_ptr<job> j(new job(e));
+      j->done = std::move(done);
+      j->offset = e.offset() + bias_;
+      j->size = (size_t)std::min<uint64_t>(header_slack + e.name_size() + e.extra_size() + e.compressed_size(), file_size_ - std::min(file_size_, j->offset));
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_.push_back(std::move(j));
+        outstanding_++;
+      }
+      changed_.notify_all();
+    }
+
+    // Wait until all the queued members have been handed to their callbacks.
+    // Rethrows the first exception thrown by a callback since the last wait().
+    void wait() {
+      std::unique_lock<std::mutex> lock(mutex_);
+      idle_.wait(lock, [this]() { return outstanding_ == 0; });
+      if (callback_error_) {
+        std::exception_ptr error = callback_error_;
+        callback_error_ = nullptr;
+        std::rethrow_exception(error);
+      }
+    }
+
+  private:
+    struct job {
+      job(const zipfile_reader::entry &e) : e(e) {}
+      zipfile_reader::entry e;
+      callback_type done;
+      uint64_t offset;        // of the local header in the file
+      size_t size;            // to read
+      std::vector<uint8_t> buf;
+      ssize_t result = 0;     // bytes read or -1
+    };
+
+    // Find the end record in the last 64K of the file and read the central directory,
+    // which zipfile_reader then parses.
+    void read_directory() {
+      struct stat st;
+      if (fstat(fd_, &st) != 0) {
+        throw std::runtime_error("cannot stat zip file");
+      }
+      file_size_ = (uint64_t)st.st_size;
+      size_t tail_size = (size_t)std::min<uint64_t>(file_size_, 65535 + 22 + 20 + 56);
+      std::vector<uint8_t> tail(tail_size);
+      if (detail::pread_all(fd_, tail.data(), tail_size, file_size_ - tail_size) != (ssize_t)tail_size) {
+        throw std::runtime_error("cannot read zip file");
+      }
+      const uint8_t *p = tail.data() + tail_size - 22;
+      for (; tail_size >= 22 && p >= tail.data(); --p) {
+        if (*p == 'P' && u4(p) == 0x06054b50) break;
+      }
+      if (tail_size < 22 || p < tail.data()) {
+        throw std::runtime_error("cannot find central directory");
+      }
+      uint64_t end_pos = file_size_ - tail_size + (p - tail.data());
+      uint64_t dir_size = u4(p + 12), dir_offset = u4(p + 16);
+      uint64_t dir_end = end_pos;
+      if (p - tail.data() >= 20 + 56 && u4(p - 20) == 0x07064b50 && u4(p - 20 - 56) == 0x06064b50) {
+        // zip64 end record just before the locator, see zipfile_reader.
+        dir_size = u8(p - 20 - 56 + 40);
+        dir_offset = u8(p - 20 - 56 + 48);
+        dir_end = end_pos - 20 - 56;
+      }
+      if (dir_size > dir_end) {
+        throw std::runtime_error("cannot find central directory");
+      }
+      // data before the archive, as in self extracting archives, moves every offset.
+      uint64_t dir_begin = dir_end - dir_size;
+      bias_ = dir_begin - dir_offset;
+
+      dir_data_.resize((size_t)(file_size_ - dir_begin));
+      if (detail::pread_all(fd_, dir_data_.data(), dir_data_.size(), dir_begin) != (ssize_t)dir_data_.size()) {
+        throw std::runtime_error("cannot read central directory");
+      }
+      dir_.reset(new zipfile_reader(dir_data_.data(), dir_data_.data() + dir_data_.size()));
+    }
+
+    // Move queued jobs to the ring while there is room and they fit in max_in_flight, then hand on completions.
+    // A job's buffer stays in reading_ until the kernel is done with it.
+    #ifdef ANDYZIP_IO_URING
+      void io_work() {
+        unsigned in_ring = 0;
+        for (;;) {
+          {
+            std::unique_lock<std::mutex> lock(mutex_);
+            changed_.wait(lock, [&]() { return stopping_ || in_ring || (uring_ && can_start()); });
+            if (!in_ring && (stopping_ || !uring_)) return;
+            while (uring_ && in_ring != queue_depth && can_start()) {
+              job *j = start(lock);
+              if (!ring_.read(fd_, j->buf.data(), (unsigned)j->size, j->offset, (uint64_t)(uintptr_t)j)) {
+                // cannot happen as the completion queue is twice the submission queue.
+                j->result = -1;
+                finish_read(j);
+                continue;
+              }
+              in_ring++;
+            }
+          }
+          int error = ring_.submit(1);
+          if (error && error != EAGAIN && error != EBUSY) {
+            // the ring is broken. Read what the kernel has not taken with pread and wait for the rest.
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_uring(in_ring);
+          }
+          uint64_t user_data;
+          int result;
+          bool completed = false;
+          while (ring_.complete(user_data, result)) {
+            job *j = (job*)(uintptr_t)user_data;
+            in_ring--;
+            completed = true;
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (result == -EINVAL || result == -EOPNOTSUPP) {
+              // the kernel or file system cannot do these reads, so pread this one and the rest.
+              requeue(j);
+              stop_uring(in_ring);
+            } else {
+              j->result = result < 0 ? -1 : result;
+              finish_read(j);
+            }
+          }
+          changed_.notify_all();
+          if (error && !completed) {
+            // out of kernel resources, or waiting for reads in a broken ring.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          }
+        }
+      }
+    #endif
+
+    void work() {
+      for (;;) {
+        std::unique_ptr<job> j;
+        bool read = false;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          changed_.wait(lock, [&]() { return stopping_ || !ready_.empty() || (!uring_ && can_start()); });
+          if (!ready_.empty()) {
+            j = std::move(ready_.front());
+            ready_.pop_front();
+          } else if (!uring_ && can_start()) {
+            start(lock);
+            j = std::move(reading_.back());
+            reading_.pop_back();
+            read = true;
+          } else {
+            return;
+          }
+        }
+        if (read) {
+          j->result = detail::pread_all(fd_, j->buf.data(), j->size, j->offset);
+        }
+        std::exception_ptr error;
+        try {
+          decode(*j);
+        } catch (...) {
+          error = std::current_exception();
+        }
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (error && !callback_error_) callback_error_ = error;
+          in_flight_ -= j->size;
+          if (--outstanding_ == 0) idle_.notify_all();
+        }
+        changed_.notify_all();
+      }
+    }
+
+    // The next queued job fits in the in flight budget. One job may always be in flight.
+    bool can_start() const {
+      return !queued_.empty() && (in_flight_ == 0 || in_flight_ + queued_.front()->size <= max_in_flight_);
+    }
+
+    // Give the next queued job its buffer. It is owned by reading_ until its read completes.
+    job *start(std::unique_lock<std::mutex> &) {
+      std::unique_ptr<job> j = std::move(queued_.front());
+      queued_.pop_front();
+      in_flight_ += j->size;
+      j->buf.resize(j->size);
+      job *result = j.get();
+      reading_.push_back(std::move(j));
+      return result;
+    }
+
+    void finish_read(job *j) {
+      auto i = std::find_if(reading_.begin(), reading_.end(), [j](const std::unique_ptr<job> &r) { return r.get() == j; });
+      ready_.push_back(std::move(*i));
+      reading_.erase(i);
+    }
+
+    // Put a job whose read never started back at the front of the queue.
+    #ifdef ANDYZIP_IO_URING
+      // Send the reads the kernel has not taken to the pread threads. Called with the lock held.
+      void stop_uring(unsigned &in_ring) {
+        for (uint64_t user_data; ring_.unqueue(user_data); ) {
+          requeue((job*)(uintptr_t)user_data);
+          in_ring--;
+        }
+        uring_ = false;
+      }
+    #endif
+
+    void requeue(job *j) {
+      auto i = std::find_if(reading_.begin(), reading_.end(), [j](const std::unique_ptr<job> &r) { return r.get() == j; });
+      in_flight_ -= j->size;
+      j->buf = std::vector<uint8_t>();
+      queued_.push_front(std::move(*i));
+      reading_.erase(i);
+    }
+
+    // Decode the member in j->buf and call back. Only the callback throws.
+    void decode(job &j) const {
+      std::vector<uint8_t> data;
+      std::exception_ptr error;
+      try {
+        const zipfile_reader::entry &e = j.e;
+        if (j.result < 30 || u4(j.buf.data()) != 0x04034b50) {
+          throw std::runtime_error("cannot read local header");
+        }
+        size_t header_size = 30 + u2(j.buf.data() + 26) + u2(j.buf.data() + 28);
+        size_t needed = header_size + (size_t)e.compressed_size();
+        if ((size_t)j.result < needed) {
+          // the local extra field was longer than the slack allowed for.
+          j.buf.resize(needed);
+          ssize_t more = detail::pread_all(fd_, j.buf.data() + j.result, needed - j.result, j.offset + j.result);
+          if (more != (ssize_t)(needed - j.result)) {
+            throw std::runtime_error("cannot read member");
+          }
+        }
+        const uint8_t *b = j.buf.data() + header_size;
+        data = dir_->decode(e.method(), b, b + e.compressed_size(), e.size());
+        if (crc32(0, data.data(), data.size()) != e.crc()) {
+          throw std::runtime_error("crc mismatch");
+        }
+      } catch (...) {
+        data.clear();
+        error = std::current_exception();
+      }
+      j.buf = std::vector<uint8_t>();
+      j.done(j.e, data, error);
+    }
+
+    static inline uint32_t u4(const uint8_t *p) {
+      return ((uint32_t)p[3] << 24) | (p[2] << 16) | (p[1] << 8) | (p[0] << 0);
+    }
+
+    static inline unsigned u2(const uint8_t *p) {
+      return (p[1] << 8) | (p[0] << 0);
+    }
+
+    static inline uint64_t u8(const uint8_t *p) {
+      return ((uint64_t)u4(p + 4) << 32) | u4(p);
+    }
+
+    int fd_;
+    uint64_t file_size_ = 0;
+    uint64_t bias_ = 0;
+    std::vector<uint8_t> dir_data_;
+    std::unique_ptr<zipfile_reader> dir_;
+    size_t max_in_flight_;
+
+    // jobs move from queued_ to reading_ to ready_ and are decoded on the worker threads.
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::condition_variable idle_;
+    std::deque<std::unique_ptr<job>> queued_;
+    std::vector<std::unique_ptr<job>> reading_;
+    std::deque<std::unique_ptr<job>> ready_;
+    size_t in_flight_ = 0;
+    size_t outstanding_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr callback_error_;
+
+    std::atomic<bool> uring_{false};
+    #ifdef ANDYZIP_IO_URING
+      detail::io_uring_queue ring_;
+    #endif
+    std::thread io_thread_;
+    std::vector<std::thread> threads_;
+  };
+}
+
+#endif
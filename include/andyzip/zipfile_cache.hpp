@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Cache of decompressed zipfile members
+//
+// Keeps the most recently read members of a zipfile_reader, up to a byte
+// budget, so that hot members are inflated once:
+//
+//   andyzip::zipfile_cache cache(reader, 64 << 20);
+//   andyzip::zipfile_cache::buffer data = cache.read("shaders/sky.glsl");
+//   use(data->data(), data->size());
+//
+// Buffers are shared and immutable. Evicting a member only drops the cache's
+// reference, so a buffer stays valid for as long as someone holds it. The cache
+// may be used from many threads. Members are decoded outside the lock, so two
+// threads that miss on the same member at once both decode it and one copy is kept.
+// Members bigger than the budget are not cached. The names are indexed once when
+// the cache is made, so a hit by name costs a hash lookup, as a hit by entry does.
+//
+
+#ifndef ANDYZIP_ZIPFILE_CACHE_HPP_
+#define ANDYZIP_ZIPFILE_CACHE_HPP_
+
+#include <andyzip/zipfile_reader.hpp>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace andyzip {
+  class zipfile_cache {
+  public:
+    typedef std::shared_ptr<const std::vector<uint8_t>> buffer;
+
+    zipfile_cache(const zipfile_reader &reader, size_t max_bytes = 64 << 20) : reader_(reader), max_bytes_(max_bytes) {
+      // the first of any members with the same name, as zipfile_reader::find.
+      for (zipfile_reader::entry e : reader_.entries()) {
+        names_.emplace(std::string(e.name(), e.name_size()), e);
+      }
+    }
+
+    // Read a member by directory entry, from the cache if it is there.
+    buffer read(const zipfile_reader::entry &e) {
+      uint64_t key = e.offset();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto i = map_.find(key);
+        if (i != map_.end()) {
+          // move to the front of the list: the most recently used.
+          lru_.splice(lru_.begin(), lru_, i->second);
+          hits_++;
+          return i->second->data;
+        }
+        misses_++;
+      }
+
+      buffer data = std::make_shared<const std::vector<uint8_t>>(reader_.read(e));
+      if (data->size() > max_bytes_) return data;
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto i = map_.find(key);
+      if (i != map_.end()) return i->second->data;
+      lru_.push_front(item{ key, data });
+      map_.emplace(key, lru_.begin());
+      bytes_ += data->size();
+      while (bytes_ > max_bytes_) {
+        const item &oldest = lru_.back();
+        bytes_ -= oldest.data->size();
+        map_.erase(oldest.key);
+        lru_.pop_back();
+        evictions_++;
+      }
+      return data;
+    }
+
+    // Read a member by filename.
+    buffer read(const std::string &filename) {
+      auto i = names_.find(filename);
+      if (i == names_.end()) {
+        throw std::runtime_error("file not found");
+      }
+      return read(i->second);
+    }
+
+    // Drop all the members.
+    void clear() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      map_.clear();
+      lru_.clear();
+      bytes_ = 0;
+    }
+
+    uint64_t hits() const { std::lock_guard<std::mutex> lock(mutex_); return hits_; }
+    uint64_t misses() const { std::lock_guard<std::mutex> lock(mutex_); return misses_; }
+    uint64_t evictions() const { std::lock_guard<std::mutex> lock(mutex_); return evictions_; }
+
+    // Decompressed bytes held.
+    size_t bytes() const { std::lock_guard<std::mutex> lock(mutex_); return bytes_; }
+
+  private:
+    struct item {
+      uint64_t key;
+      buffer data;
+    };
+
+    const zipfile_reader &reader_;
+    size_t max_bytes_;
+    std::unordered_map<std::string, zipfile_reader::entry> names_;
+
+    // items from most to least recently used, and the items by local header offset.
+    mutable std::mutex mutex_;
+    std::list<item> lru_;
+    std::unordered_map<uint64_t, std::list<item>::iterator> map_;
+    size_t bytes_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+  };
+}
+
+#endif
@@ -5,10 +5,16 @@
 // Zipfile reader class
 //
 
+#ifndef ANDYZIP_ZIPFILE_READER_HPP_
+#define ANDYZIP_ZIPFILE_READER_HPP_
 
 #include <vector>
 #include <stdexcept>
 #include <cstring>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <andyzip/bzip2_decoder.hpp>
 #include <andyzip/deflate_decoder.hpp>
 
 // Simple zipfile reader. Allows extraction of files in a mapped zipfile.
@@ -37,100 +43,220 @@ public:
     for (; p >= begin_; --p) {
       if (*p == 'P' && u4(p) == 0x06054b50) break;
     }
-    if (p < begin_ || p - u4(p + 12) < begin_) {
+    if (p < begin_) {
       throw std::runtime_error("cannot find central directory");
     }
-    central_dir_begin_ = p - u4(p + 12);
-    central_dir_end_ = p;
+    uint64_t dir_size = u4(p + 12);
+    const uint8_t *dir_end = p;
+
+    // zip64 end of central dir locator    4 bytes  (0x07064b50)
+    // disk of the zip64 end record        4 bytes
+    // offset of the zip64 end record      8 bytes
+    // total number of disks               4 bytes
+    //
+    // zip64 end of central dir record     4 bytes  (0x06064b50)
+    // ...
+    // size of the central directory       8 bytes (+40)
+    // offset of the central directory     8 bytes (+48)
+    //                                             (+56)
+    // The central directory ends at the zip64 end record, which is usually just before the locator.
+    if (p - begin_ >= 20 + 56 && u4(p - 20) == 0x07064b50) {
+      uint64_t record_offset = u8(p - 20 + 8);
+      const uint8_t *record = record_offset <= (uint64_t)(p - begin_) - 56 ? begin_ + record_offset : p - 20 - 56;
+      if (u4(record) != 0x06064b50) record = p - 20 - 56;
+      if (u4(record) != 0x06064b50) {
+        throw std::runtime_error("cannot find zip64 end of central directory");
+      }
+      dir_size = u8(record + 40);
+      dir_end = record;
+    }
+    if (dir_size > (uint64_t)(dir_end - begin_)) {
+      throw std::runtime_error("cannot find central directory");
+    }
+    central_dir_begin_ = dir_end - dir_size;
+    central_dir_end_ = dir_end;
   }
 
-  // Get a list of filenames.
-  std::vector<std::string> filenames() const {
-    // central file header signature   4 bytes  (0x02014b50)
-    // version made by                 2 bytes (+4)
-    // version needed to extract       2 bytes (+6)
-    // general purpose bit flag        2 bytes (+8)
-    // compression method              2 bytes (+10)
-    // last mod file time              2 bytes (+12)
-    // last mod file date              2 bytes (+14)
-    // crc-32                          4 bytes (+16)
-    // compressed size                 4 bytes (+20)
-    // uncompressed size               4 bytes (+24)
-    // file name length                2 bytes (+28)
-    // extra field length              2 bytes (+30)
-    // file comment length             2 bytes (+32)
-    // disk number start               2 bytes (+34)
-    // internal file attributes        2 bytes (+36)
-    // external file attributes        4 bytes (+38)
-    // relative offset of local header 4 bytes (+42)
-    //                                         (+46)
-
-    // file name (variable size)
-    // extra field (variable size)
-    // file comment (variable size)
+  // A view of a central directory entry. Sizes and offset are from the zip64 extra field if they do not fit in 32 bits.
+  //
+  // central file header signature   4 bytes  (0x02014b50)
+  // version made by                 2 bytes (+4)
+  // version needed to extract       2 bytes (+6)
+  // general purpose bit flag        2 bytes (+8)
+  // compression method              2 bytes (+10)
+  // last mod file time              2 bytes (+12)
+  // last mod file date              2 bytes (+14)
+  // crc-32                          4 bytes (+16)
+  // compressed size                 4 bytes (+20)
+  // uncompressed size               4 bytes (+24)
+  // file name length                2 bytes (+28)
+  // extra field length              2 bytes (+30)
+  // file comment length             2 bytes (+32)
+  // disk number start               2 bytes (+34)
+  // internal file attributes        2 bytes (+36)
+  // external file attributes        4 bytes (+38)
+  // relative offset of local header 4 bytes (+42)
+  //                                         (+46)
+  // file name (variable size)
+  // extra field (variable size)
+  // file comment (variable size)
+  class entry {
+  public:
+    entry(const uint8_t *p, const uint8_t *zip_begin) : p_(p), zip_begin_(zip_begin) {
+    }
 
-    std::vector<std::string> names;
-    for (const uint8_t *p = central_dir_begin_; p < central_dir_end_; ) {
-      if (u4(p) != 0x02014b50) {
+    // The name is not zero terminated.
+    const char *name() const { return (const char*)p_ + 46; }
+    size_t name_size() const { return u2(p_ + 28); }
+    bool name_is(const std::string &name) const {
+      return name.size() == name_size() && !memcmp(name.data(), p_ + 46, name.size());
+    }
+
+    unsigned flags() const { return u2(p_ + 8); }
+    unsigned method() const { return u2(p_ + 10); }
+    uint32_t dos_date_time() const { return u4(p_ + 12); }
+    uint32_t crc() const { return u4(p_ + 16); }
+    uint64_t compressed_size() const { return zip64_field(20, 1); }
+    uint64_t size() const { return zip64_field(24, 0); }
+    uint64_t offset() const { return zip64_field(42, 2); }
+
+    const uint8_t *extra() const { return p_ + 46 + name_size(); }
+    size_t extra_size() const { return u2(p_ + 30); }
+
+    // The local file header, as returned by dir_entries().
+    const uint8_t *local_header() const { return zip_begin_ + offset(); }
+
+    // The central directory record.
+    const uint8_t *data() const { return p_; }
+    size_t record_size() const { return 46 + u2(p_ + 28) + u2(p_ + 30) + u2(p_ + 32); }
+
+  private:
+    // A 32 bit field at p_ + pos, or field "index" of usize, csize, offset in the
+    // zip64 extra field if it is 0xffffffff. Only saturated fields are in the extra field.
+    uint64_t zip64_field(unsigned pos, unsigned index) const {
+      uint64_t value = u4(p_ + pos);
+      if (value != 0xffffffff) return value;
+      const uint8_t *q = extra(), *q_end = q + extra_size();
+      for (; q_end - q >= 4; q += 4 + u2(q + 2)) {
+        if (u2(q) != 0x0001) continue;
+        const uint8_t *f = q + 4;
+        static const unsigned positions[] = { 24, 20, 42 };
+        for (unsigned i = 0; i != index; ++i) {
+          if (u4(p_ + positions[i]) == 0xffffffff) f += 8;
+        }
+        return f + 8 <= q_end && f + 8 <= q + 4 + u2(q + 2) ? u8(f) : value;
+      }
+      return value;
+    }
+
+    const uint8_t *p_;
+    const uint8_t *zip_begin_;
+  };
+
+  // Forward iterator over the central directory. Checks each record as it reaches it.
+  class entry_iterator {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef entry value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const entry *pointer;
+    typedef entry reference;
+
+    entry_iterator(const uint8_t *p, const uint8_t *end, const uint8_t *zip_begin) : p_(p), end_(end), zip_begin_(zip_begin) {
+      check();
+    }
+
+    entry operator*() const { return entry(p_, zip_begin_); }
+    entry_iterator &operator++() {
+      p_ += entry(p_, zip_begin_).record_size();
+      check();
+      return *this;
+    }
+    entry_iterator operator++(int) { entry_iterator result = *this; ++*this; return result; }
+    bool operator==(const entry_iterator &rhs) const { return p_ == rhs.p_; }
+    bool operator!=(const entry_iterator &rhs) const { return p_ != rhs.p_; }
+
+  private:
+    void check() const {
+      if (p_ == end_) return;
+      if (end_ - p_ < 46 || u4(p_) != 0x02014b50 || (size_t)(end_ - p_) < entry(p_, zip_begin_).record_size()) {
         throw std::runtime_error("bad directory entry");
       }
-      uint16_t filename_len = u2(p + 28);
-      uint16_t extra_len = u2(p + 30);
-      uint16_t comment_len = u2(p + 32);
-      names.emplace_back((const char*)p + 46, (const char*)p + 46 + filename_len);
-      p += 46 + filename_len + extra_len + comment_len;
+    }
+
+    const uint8_t *p_;
+    const uint8_t *end_;
+    const uint8_t *zip_begin_;
+  };
+
+  struct entry_range {
+    entry_iterator begin_;
+    entry_iterator end_;
+    entry_iterator begin() const { return begin_; }
+    entry_iterator end() const { return end_; }
+  };
+
+  // The central directory entries, without allocating:
+  //
+  //   for (auto e : reader.entries()) printf("%.*s %llu\n", (int)e.name_size(), e.name(), (unsigned long long)e.size());
+  entry_range entries() const {
+    return entry_range{ entry_iterator(central_dir_begin_, central_dir_end_, begin_), entry_iterator(central_dir_end_, central_dir_end_, begin_) };
+  }
+
+  // The entry for filename, or entries().end().
+  entry_iterator find(const std::string &filename) const {
+    entry_range r = entries();
+    entry_iterator i = r.begin();
+    while (i != r.end() && !(*i).name_is(filename)) ++i;
+    return i;
+  }
+
+  // Get a list of filenames.
+  std::vector<std::string> filenames() const {
+    std::vector<std::string> names;
+    for (entry e : entries()) {
+      names.emplace_back(e.name(), e.name_size());
     }
     return names;
   }
 
-  // Get a list of directory entries.
-  // todo: make a class for a directory entry that wraps the pointer.
+  // Get a list of local file headers. See entries() for the directory entries themselves.
   std::vector<const uint8_t *> dir_entries() const {
-    // central file header signature   4 bytes  (0x02014b50)
-    // version made by                 2 bytes (+4)
-    // version needed to extract       2 bytes (+6)
-    // general purpose bit flag        2 bytes (+8)
-    // compression method              2 bytes (+10)
-    // last mod file time              2 bytes (+12)
-    // last mod file date              2 bytes (+14)
-    // crc-32                          4 bytes (+16)
-    // compressed size                 4 bytes (+20)
-    // uncompressed size               4 bytes (+24)
-    // file name length                2 bytes (+28)
-    // extra field length              2 bytes (+30)
-    // file comment length             2 bytes (+32)
-    // disk number start               2 bytes (+34)
-    // internal file attributes        2 bytes (+36)
-    // external file attributes        4 bytes (+38)
-    // relative offset of local header 4 bytes (+42)
-    //                                         (+46)
-
-    // file name (variable size)
-    // extra field (variable size)
-    // file comment (variable size)
-
     std::vector<const uint8_t *> result;
-    for (const uint8_t *p = central_dir_begin_; p < central_dir_end_; ) {
-      if (u4(p) != 0x02014b50) {
-        throw std::runtime_error("bad directory entry");
-      }
-      uint16_t filename_len = u2(p + 28);
-      uint16_t extra_len = u2(p + 30);
-      uint16_t comment_len = u2(p + 32);
-      result.emplace_back(begin_ + u4(p + 42));
-      p += 46 + filename_len + extra_len + comment_len;
+    for (entry e : entries()) {
+      result.emplace_back(e.local_header());
     }
     return result;
   }
 
+  // Use a shared preset dictionary for deflated members. Archives of many small
+  // similar files can be written with one; standard zip tools do not support this.
+  void set_dictionary(const uint8_t *data, size_t size) {
+    dictionary_ = data;
+    dictionary_size_ = data ? size : 0;
+  }
+
   // Read a file by filename.
   std::vector<uint8_t> read(const std::string &filename) const {
-    const uint8_t *p = get_dir_entry(filename);
-    if (!p || u4(p + 0) != 0x04034b50) {
+    entry_iterator i = find(filename);
+    if (i == entries().end()) {
       throw std::runtime_error("file not found");
     }
+    return read(*i);
+  }
 
-    return read_entry(p);
+  // Read a file by directory entry. The sizes come from the central directory, so this
+  // works for members written with a data descriptor and for zip64 members.
+  std::vector<uint8_t> read(const entry &e) const {
+    if (central_dir_begin_ - begin_ < 30 || e.offset() > (uint64_t)(central_dir_begin_ - begin_) - 30 || u4(e.local_header()) != 0x04034b50) {
+      throw std::runtime_error("bad local header");
+    }
+    const uint8_t *p = e.local_header();
+    const uint8_t *b = p + 30 + u2(p + 26) + u2(p + 28);
+    if (b > central_dir_begin_ || e.compressed_size() > (uint64_t)(central_dir_begin_ - b)) {
+      throw std::runtime_error("bad compressed size");
+    }
+    return decode(e.method(), b, b + e.compressed_size(), e.size());
   }
 
   // Read a file by directory entry.
@@ -161,15 +287,45 @@ public:
 
     const uint8_t *b = p + 30 + namelen + extlen;
     const uint8_t *e = b + csize;
+    return decode(method, b, e, usize);
+  }
+
+  // Convert a filename to a local file header.
+  const uint8_t *get_dir_entry(const std::string &filename) const {
+    entry_iterator i = find(filename);
+    return i == entries().end() ? nullptr : (*i).local_header();
+  }
 
-    std::vector<uint8_t> result(usize);
+  // Decode the data of a member from b to e, usize bytes compressed with method:
+  // stored (0), deflate (8), deflate64 (9) or bzip2 (12). For readers that fetch the data themselves.
+  std::vector<uint8_t> decode(unsigned method, const uint8_t *b, const uint8_t *e, uint64_t usize) const {
+    // the size comes from the archive, so check it before allocating.
+    if (usize > max_size(method, (uint64_t)(e - b)) || (size_t)usize != usize) {
+      throw std::runtime_error("uncompressed size too large");
+    }
+    std::vector<uint8_t> result(method == 12 ? 0 : usize);
     if (method == 8) {
-      if (!dec_.decode(result.data(), result.data() + result.size(), b, e)) {
+      if (!dec_.decode(result.data(), result.data() + result.size(), b, e, dictionary_, dictionary_size_)) {
         result.resize(0);
         throw std::runtime_error("deflate decode failure");
       }
+    } else if (method == 9) {
+      if (!dec64_.decode(result.data(), result.data() + result.size(), b, e)) {
+        result.resize(0);
+        throw std::runtime_error("deflate64 decode failure");
+      }
+    } else if (method == 12) {
+      // bzip2 can expand a great deal, so grow the output as it decodes.
+      result.reserve((size_t)std::min(usize, (uint64_t)(e - b) * 16));
+      if (!bzip2_dec_.decode_append(result, b, e) || result.size() != usize) {
+        result.resize(0);
+        throw std::runtime_error("bzip2 decode failure");
+      }
     } else if (method == 0) {
-      memcpy(result.data(), b, usize);
+      if (usize != (uint64_t)(e - b)) {
+        throw std::runtime_error("bad stored size");
+      }
+      if (usize) memcpy(result.data(), b, (size_t)usize);
     } else {
       result.resize(0);
       throw std::runtime_error("unsupported compression method");
@@ -177,24 +333,23 @@ public:
     return result;
   }
 
-  // Convert a filename to a directory entry.
-  const uint8_t *get_dir_entry(const std::string &filename) const {
-    uint8_t c0 = filename[0];
-    uint16_t len = (uint16_t)filename.size();
-    for (const uint8_t *p = central_dir_begin_; p < central_dir_end_; ) {
-      if (u2(p + 28) == len) {
-        if (!memcmp(filename.data(), p + 46, u2(p + 28))) {
-          return begin_ + u4(p + 42);
-        }
-      }
-      uint16_t filename_len = u2(p + 28);
-      uint16_t extra_len = u2(p + 30);
-      uint16_t comment_len = u2(p + 32);
-      p += 46 + filename_len + extra_len + comment_len;
+private:
+  // The most csize bytes can decode to with method.
+  static uint64_t max_size(unsigned method, uint64_t csize) {
+    const uint64_t max = ~(uint64_t)0;
+    switch (method) {
+      case 0: return csize;
+      // a 258 byte match in two bits.
+      case 8: return csize <= max / 1032 ? csize * 1032 : max;
+      // a 65538 byte match in 18 bits.
+      case 9: return csize <= max / 29128 ? csize * 29128 : max;
+      // 900k run lengths of 259 bytes in a block of more than 16 bytes.
+      case 12: return (csize / 16 + 1) <= max / 46620000 ? (csize / 16 + 1) * 46620000 : max;
     }
-    return nullptr;
+    // unknown methods fail in decode.
+    return max;
   }
-private:
+
   static inline unsigned u4(const uint8_t *p) {
     return (p[3] << 24) | (p[2] << 16) | (p[1] << 8) | (p[0] << 0);
   }
@@ -203,9 +358,19 @@ private:
     return (p[1] << 8) | (p[0] << 0);
   }
 
+  static inline uint64_t u8(const uint8_t *p) {
+    return ((uint64_t)u4(p + 4) << 32) | u4(p);
+  }
+
   const uint8_t *begin_;
   const uint8_t *end_;
   const uint8_t *central_dir_begin_;
   const uint8_t *central_dir_end_;
   andyzip::deflate_decoder dec_;
+  andyzip::deflate64_decoder dec64_;
+  andyzip::bzip2_decoder bzip2_dec_;
+  const uint8_t *dictionary_ = nullptr;
+  size_t dictionary_size_ = 0;
 };
+
+#endif
@@ -0,0 +1,321 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Streaming zipfile reader class
+//
+// Reads a zip file front to back as it arrives, from a socket or pipe, without
+// the central directory at its end. Feed it the bytes as they come and take the
+// members that are complete:
+//
+//   andyzip::zipfile_stream_reader reader;
+//   andyzip::zipfile_stream_reader::member m;
+//   while ((n = read(fd, buf, sizeof(buf))) > 0) {
+//     reader.feed(buf, n);
+//     while (reader.next(m)) use(m.name, m.data);
+//   }
+//   reader.finish();
+//   while (reader.next(m)) use(m.name, m.data);
+//
+// Deflated members are decoded a block at a time as their data arrives, so
+// members with a data descriptor (general purpose bit 3), whose sizes are only
+// known after the data, end where the deflate stream ends. A block that has not
+// all arrived is tried again once its input has grown by half, so small reads
+// do not decode it over and over. Stored members need their sizes in the local
+// header. The CRC of every member is checked, and a header claiming more data
+// than its compressed size could hold is rejected before any output is allocated.
+//
+
+#ifndef ANDYZIP_ZIPFILE_STREAM_READER_HPP_
+#define ANDYZIP_ZIPFILE_STREAM_READER_HPP_
+
+#include <andyzip/checksum.hpp>
+#include <andyzip/deflate_decoder.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace andyzip {
+  class zipfile_stream_reader {
+  public:
+    enum {
+      // A deflate block that does not decode with this much input after its start is corrupt.
+      max_block_input = 1 << 22,
+      // Deflate expands by at most 258 bytes for every two bits of input.
+      max_ratio = 1032,
+    };
+
+    struct member {
+      std::string name;
+      unsigned method;
+      uint32_t dos_date_time;
+      uint32_t crc;
+      std::vector<uint8_t> data;
+    };
+
+    // Append the next bytes of the archive.
+    void feed(const uint8_t *data, size_t size) {
+      // drop what has been read once it is most of the buffer.
+      if (pos_ >= (1 << 16) && pos_ * 2 >= in_.size()) {
+        in_.erase(in_.begin(), in_.begin() + pos_);
+        base_ += pos_;
+        pos_ = 0;
+      }
+      in_.insert(in_.end(), data, data + size);
+    }
+
+    // Get the next member that has arrived in full. Returns false if there is
+    // none yet or the members have ended. Throws on a corrupt or unsupported archive
+    // and, after finish(), on one that ends before the central directory.
+    bool next(member &m) {
+      while (state_ != in_directory) {
+        bool progress = state_ == in_header ? read_header() : state_ == in_data ? read_data() : read_descriptor();
+        if (!progress) {
+          if (end_of_input_) throw std::runtime_error("truncated zip file");
+          return false;
+        }
+        if (complete_) {
+          complete_ = false;
+          m = std::move(current_);
+          current_ = member();
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // True once the central directory has been reached: there are no more members.
+    bool done() const {
+      return state_ == in_directory;
+    }
+
+    // Call at the end of the input, then next() until it returns false for the last members.
+    void finish() {
+      end_of_input_ = true;
+    }
+
+  private:
+    enum state_type { in_header, in_data, in_descriptor, in_directory };
+
+    size_t available() const {
+      return in_.size() - pos_;
+    }
+
+    // The absolute offset of the read position, which does not move when in_ is compacted.
+    uint64_t offset() const {
+      return base_ + pos_;
+    }
+
+    bool read_header() {
+      // Local file header, see zipfile_reader.
+      const uint8_t *p = in_.data() + pos_;
+      if (available() < 4) return false;
+      uint32_t sig = u4(p);
+      if (sig == 0x02014b50 || sig == 0x06054b50 || sig == 0x06064b50) {
+        // central directory, end record or zip64 end record.
+        state_ = in_directory;
+        return true;
+      }
+      if (sig != 0x04034b50) {
+        throw std::runtime_error("bad local header");
+      }
+      if (available() < 30) return false;
+      unsigned flags = u2(p + 6);
+      unsigned namelen = u2(p + 26);
+      unsigned extlen = u2(p + 28);
+      if (available() < 30 + namelen + extlen) return false;
+
+      if (flags & 1) {
+        throw std::runtime_error("encrypted members are not supported");
+      }
+      current_.method = u2(p + 8);
+      if (current_.method != 0 && current_.method != 8) {
+        throw std::runtime_error("unsupported compression method");
+      }
+      current_.dos_date_time = u4(p + 10);
+      current_.crc = u4(p + 14);
+      current_.name.assign((const char*)p + 30, namelen);
+      csize_ = u4(p + 18);
+      usize_ = u4(p + 22);
+      descriptor_ = (flags & 8) != 0;
+      if (descriptor_ && current_.method == 0) {
+        throw std::runtime_error("stored members with a data descriptor are not supported");
+      }
+
+      // the zip64 extra field has the sizes that are 0xffffffff in the header.
+      zip64_ = false;
+      const uint8_t *extra = p + 30 + namelen, *extra_end = extra + extlen;
+      for (const uint8_t *q = extra; extra_end - q >= 4; q += 4 + u2(q + 2)) {
+        const uint8_t *f = q + 4, *f_end = std::min(extra_end, f + u2(q + 2));
+        if (u2(q) != 0x0001) continue;
+        zip64_ = true;
+        if (usize_ == 0xffffffff && f_end - f >= 8) { usize_ = u8(f); f += 8; }
+        if (csize_ == 0xffffffff && f_end - f >= 8) { csize_ = u8(f); f += 8; }
+      }
+
+      // the output is sized from usize_, so do not believe one that the
+      // compressed data could not produce.
+      if (!descriptor_ && (current_.method == 0 ? usize_ != csize_ : usize_ / max_ratio > csize_)) {
+        throw std::runtime_error("member size mismatch");
+      }
+
+      pos_ += 30 + namelen + extlen;
+      data_start_ = offset();
+      bit_ = 0;
+      out_size_ = 0;
+      current_.data.clear();
+      state_ = in_data;
+      return true;
+    }
+
+    bool read_data() {
+      std::vector<uint8_t> &out = current_.data;
+      if (current_.method == 0) {
+        if (available() < csize_) return false;
+        out.assign(in_.data() + pos_, in_.data() + pos_ + csize_);
+        pos_ += (size_t)csize_;
+        return end_data();
+      }
+
+      // decode the deflate blocks that have arrived.
+      for (;;) {
+        // without a descriptor, the member's data ends the input of its stream.
+        const uint8_t *src_max = in_.data() + in_.size();
+        if (!descriptor_ && data_start_ + csize_ - base_ < in_.size()) {
+          src_max = in_.data() + (size_t)(data_start_ + csize_ - base_);
+        }
+        size_t block_input = (size_t)(src_max - in_.data()) - pos_;
+        bool all_input = end_of_input_ || (!descriptor_ && offset() + block_input == data_start_ + csize_);
+        if (block_input < retry_input_ && !all_input) return false;
+        if (out.size() - out_size_ < 65536) {
+          // no more than the input so far can expand to.
+          uint64_t received = offset() + block_input - data_start_;
+          size_t hint = descriptor_ ? 0 : (size_t)std::min(usize_, received * max_ratio);
+          out.resize(std::max(std::max(out.size() * 2, out_size_ + 65536), hint));
+        }
+
+        deflate_decoder::block_state s;
+        s.src = in_.data() + pos_;
+        s.bit = bit_;
+        s.src_max = src_max;
+        s.dest_begin = out.data();
+        s.dest = out.data() + out_size_;
+        s.dest_max = out.data() + out.size();
+        if (!dec_.decode_block(s)) {
+          // a 258 byte match costs at least one bit.
+          if (s.output_full && out.size() - out_size_ <= block_input * 8 * 258 + 258) {
+            out.resize(out.size() * 2);
+            continue;
+          }
+          // the rest of the block may not have arrived yet.
+          if (end_of_input_ && src_max == in_.data() + in_.size()) {
+            throw std::runtime_error("truncated zip file");
+          }
+          if (all_input || block_input > max_block_input) {
+            throw std::runtime_error("deflate decode failure");
+          }
+          retry_input_ = block_input + std::max(block_input / 2, (size_t)4096);
+          return false;
+        }
+        retry_input_ = 0;
+
+        pos_ = s.src - in_.data();
+        bit_ = s.bit;
+        out_size_ = s.dest - out.data();
+        if (s.is_last) {
+          if (bit_) {
+            pos_++;
+            bit_ = 0;
+          }
+          out.resize(out_size_);
+          return end_data();
+        }
+      }
+    }
+
+    bool end_data() {
+      if (descriptor_) {
+        state_ = in_descriptor;
+        return true;
+      }
+      if (offset() - data_start_ != csize_ || current_.data.size() != usize_) {
+        throw std::runtime_error("member size mismatch");
+      }
+      return end_member();
+    }
+
+    bool read_descriptor() {
+      // data descriptor signature (optional) 4 bytes  (0x08074b50)
+      // crc-32                               4 bytes
+      // compressed size                      4 bytes, 8 with zip64
+      // uncompressed size                    4 bytes, 8 with zip64
+      const uint8_t *p = in_.data() + pos_;
+      if (available() < 4) return false;
+      size_t sig = u4(p) == 0x08074b50 ? 4 : 0;
+      if (available() < sig + 12) return false;
+
+      // some writers use 8 byte sizes without a zip64 extra field in the local
+      // header, so try them if 4 byte sizes do not match.
+      uint64_t csize = offset() - data_start_;
+      uint64_t usize = current_.data.size();
+      size_t len = sig + 12;
+      if (zip64_ || u4(p + sig + 4) != csize || u4(p + sig + 8) != usize) {
+        if (available() < sig + 20) return false;
+        if (u8(p + sig + 4) != csize || u8(p + sig + 12) != usize) {
+          throw std::runtime_error("bad data descriptor");
+        }
+        len = sig + 20;
+      }
+      current_.crc = u4(p + sig);
+      pos_ += len;
+      return end_member();
+    }
+
+    bool end_member() {
+      if (crc32(0, current_.data.data(), current_.data.size()) != current_.crc) {
+        throw std::runtime_error("crc mismatch");
+      }
+      complete_ = true;
+      state_ = in_header;
+      return true;
+    }
+
+    static inline uint32_t u4(const uint8_t *p) {
+      return ((uint32_t)p[3] << 24) | (p[2] << 16) | (p[1] << 8) | (p[0] << 0);
+    }
+
+    static inline unsigned u2(const uint8_t *p) {
+      return (p[1] << 8) | (p[0] << 0);
+    }
+
+    static inline uint64_t u8(const uint8_t *p) {
+      return ((uint64_t)u4(p + 4) << 32) | u4(p);
+    }
+
+    std::vector<uint8_t> in_;   // input from base_ on
+    uint64_t base_ = 0;
+    size_t pos_ = 0;            // read position in in_
+    unsigned bit_ = 0;          // and bit, in a deflate stream
+    state_type state_ = in_header;
+    bool complete_ = false;
+    bool end_of_input_ = false;
+
+    // the member being read.
+    member current_;
+    bool descriptor_ = false;
+    bool zip64_ = false;
+    uint64_t csize_ = 0;
+    uint64_t usize_ = 0;
+    uint64_t data_start_ = 0;
+    size_t out_size_ = 0;
+    size_t retry_input_ = 0;    // input the current block needs before it is tried again
+
+    andyzip::deflate_decoder dec_;
+  };
+}
+
+#endif
@@ -0,0 +1,507 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Zipfile writer class
+//
+// Members are compressed on a pool of threads and written to the output in the
+// order they were added, each as a local header followed by its data. finish()
+// writes the central directory.
+//
+//   andyzip::zipfile_writer writer([fp](const uint8_t *data, size_t size) { fwrite(data, 1, size, fp); });
+//   writer.add("a.txt", a.data(), a.data() + a.size());
+//   writer.add("b.bin", std::move(b));
+//   writer.finish();
+//
+// The method of each member is chosen from a sample of its data: data that looks
+// random or already compressed is stored and the rest is deflated. Members whose
+// size is not known in advance are written with begin_member(), write() and
+// end_member(), in chunks of stream_chunk_size, with the sizes and CRC in a data
+// descriptor after the data. They are always deflated, in stored blocks when they
+// do not compress, so that zipfile_stream_reader can find their end. Zip64 records
+// are used for members and archives over 4GB and for more than 65535 members.
+//
+
+#ifndef ANDYZIP_ZIPFILE_WRITER_HPP_
+#define ANDYZIP_ZIPFILE_WRITER_HPP_
+
+#include <andyzip/analysis.hpp>
+#include <andyzip/checksum.hpp>
+#include <andyzip/deflate_encoder.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace andyzip {
+  class zipfile_writer {
+  public:
+    enum {
+      // compression methods
+      stored = 0,
+      deflated = 8,
+      automatic = 0xffff,
+
+      stream_chunk_size = 1 << 20,
+      dos_epoch = 0x00210000,   // 1980-01-01 00:00:00
+    };
+
+    // Receives the archive in order.
+    typedef std::function<void (const uint8_t *data, size_t size)> output_type;
+
+    // num_threads = 0 uses all hardware threads.
+    zipfile_writer(output_type output, int level = 6, unsigned num_threads = 0) : output_(std::move(output)), enc_(level) {
+      num_threads_ = num_threads ? num_threads : std::max(1u, std::thread::hardware_concurrency());
+      for (unsigned t = 0; t != num_threads_; ++t) {
+        threads_.emplace_back([this]() { work(); });
+      }
+    }
+
+    zipfile_writer(const zipfile_writer &) = delete;
+    zipfile_writer &operator=(const zipfile_writer &) = delete;
+
+    // Members not yet written are discarded: call finish() to complete the archive.
+    ~zipfile_writer() {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        work_.clear();
+        stopping_ = true;
+      }
+      work_ready_.notify_all();
+      for (auto &t : threads_) t.join();
+    }
+
+    // Add a member. It is compressed on the thread pool and written after the members before it.
+    // Returns once there are few enough members in flight, writing any that are finished.
+    // method is stored, deflated or automatic; any other throws std::invalid_argument.
+    void add(const std::string &name, std::vector<uint8_t> data, unsigned method = automatic, uint32_t dos_date_time = dos_epoch) {
+      if (in_member_ || finished_) {
+        throw std::runtime_error("zipfile_writer: add() inside a member or after finish()");
+      }
+      std::unique_ptr<member> m(new member);
+      m->e = make_entry(name, method, dos_date_time);
+      m->data.swap(data);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        work_.push_back(m.get());
+      }
+      pending_.push_back(std::move(m));
+      work_ready_.notify_one();
+      drain(num_threads_ * 2);
+    }
+
+    void add(const std::string &name, const uint8_t *begin, const uint8_t *end, unsigned method = automatic, uint32_t dos_date_time = dos_epoch) {
+      add(name, std::vector<uint8_t>(begin, end), method, dos_date_time);
+    }
+
+    // Start a member of unknown size. Its data is given with write() and it ends with end_member().
+    // The members added before it are written first.
+    void begin_member(const std::string &name, unsigned method = automatic, uint32_t dos_date_time = dos_epoch) {
+      if (in_member_ || finished_) {
+        throw std::runtime_error("zipfile_writer: begin_member() inside a member or after finish()");
+      }
+      drain(0);
+      stream_ = make_entry(name, method, dos_date_time);
+      stream_.flags |= data_descriptor_flag;
+      stream_started_ = false;
+      stream_buffer_.clear();
+      stream_history_.clear();
+      in_member_ = true;
+    }
+
+    void write(const uint8_t *data, size_t size) {
+      if (!in_member_) {
+        throw std::runtime_error("zipfile_writer: write() outside a member");
+      }
+      while (size) {
+        size_t len = std::min(size, (size_t)stream_chunk_size - stream_buffer_.size());
+        stream_buffer_.insert(stream_buffer_.end(), data, data + len);
+        data += len;
+        size -= len;
+        if (stream_buffer_.size() == stream_chunk_size) {
+          write_chunk(false);
+        }
+      }
+    }
+
+    void end_member() {
+      if (!in_member_) {
+        throw std::runtime_error("zipfile_writer: end_member() outside a member");
+      }
+      write_chunk(true);
+
+      // data descriptor signature       4 bytes  (0x08074b50)
+      // crc-32                          4 bytes
+      // compressed size                 4 bytes, 8 with zip64
+      // uncompressed size               4 bytes, 8 with zip64
+      std::vector<uint8_t> d;
+      put4(d, 0x08074b50);
+      put4(d, stream_.crc);
+      if (needs_zip64(stream_)) {
+        put8(d, stream_.csize);
+        put8(d, stream_.usize);
+      } else {
+        put4(d, (uint32_t)stream_.csize);
+        put4(d, (uint32_t)stream_.usize);
+      }
+      emit(d);
+      entries_.push_back(std::move(stream_));
+      in_member_ = false;
+    }
+
+    // Write the remaining members and the central directory.
+    void finish(const std::string &comment = std::string()) {
+      if (in_member_ || finished_) {
+        throw std::runtime_error("zipfile_writer: finish() inside a member or after finish()");
+      }
+      drain(0);
+
+      uint64_t dir_offset = offset_;
+      std::vector<uint8_t> d;
+      for (const entry &e : entries_) {
+        d.clear();
+        put_central_header(d, e);
+        emit(d);
+      }
+      uint64_t dir_size = offset_ - dir_offset;
+      uint64_t num_entries = entries_.size();
+
+      d.clear();
+      bool zip64 = num_entries >= 0xffff || dir_size >= 0xffffffff || dir_offset >= 0xffffffff;
+      if (zip64) {
+        // zip64 end of central dir signature  4 bytes  (0x06064b50)
+        // size of this record less 12         8 bytes
+        // version made by                     2 bytes
+        // version needed to extract           2 bytes
+        // number of this disk                 4 bytes
+        // disk of the central directory       4 bytes
+        // entries on this disk                8 bytes
+        // total entries                       8 bytes
+        // size of the central directory       8 bytes
+        // offset of the central directory     8 bytes
+        uint64_t record_offset = offset_;
+        put4(d, 0x06064b50);
+        put8(d, 44);
+        put2(d, zip64_version);
+        put2(d, zip64_version);
+        put4(d, 0);
+        put4(d, 0);
+        put8(d, num_entries);
+        put8(d, num_entries);
+        put8(d, dir_size);
+        put8(d, dir_offset);
+
+        // zip64 end of central dir locator    4 bytes  (0x07064b50)
+        // disk of the zip64 end record        4 bytes
+        // offset of the zip64 end record      8 bytes
+        // total number of disks               4 bytes
+        put4(d, 0x07064b50);
+        put4(d, 0);
+        put8(d, record_offset);
+        put4(d, 1);
+      }
+
+      // end of central dir signature, see zipfile_reader.
+      size_t comment_len = std::min(comment.size(), (size_t)0xffff);
+      put4(d, 0x06054b50);
+      put2(d, 0);
+      put2(d, 0);
+      put2(d, (uint16_t)std::min(num_entries, (uint64_t)0xffff));
+      put2(d, (uint16_t)std::min(num_entries, (uint64_t)0xffff));
+      put4(d, (uint32_t)std::min(dir_size, (uint64_t)0xffffffff));
+      put4(d, (uint32_t)std::min(dir_offset, (uint64_t)0xffffffff));
+      put2(d, (uint16_t)comment_len);
+      d.insert(d.end(), comment.begin(), comment.begin() + comment_len);
+      emit(d);
+      finished_ = true;
+    }
+
+    // Bytes written so far.
+    uint64_t size() const {
+      return offset_;
+    }
+
+    // The MS-DOS date and time used in zip headers of a time in the local time zone.
+    static uint32_t dos_date_time(std::time_t t) {
+      std::tm *tm = std::localtime(&t);
+      if (!tm || tm->tm_year < 80) return dos_epoch;
+      return
+        (uint32_t)(tm->tm_year - 80) << 25 | (uint32_t)(tm->tm_mon + 1) << 21 | (uint32_t)tm->tm_mday << 16 |
+        (uint32_t)tm->tm_hour << 11 | (uint32_t)tm->tm_min << 5 | (uint32_t)(tm->tm_sec / 2);
+    }
+
+    // The method automatic chooses for data.
+    static unsigned choose_method(const uint8_t *begin, const uint8_t *end) {
+      // small members deflate quickly and analysis would cost as much.
+      if (end - begin < 4096) return deflated;
+      data_analysis a = analyse(begin, end, 1 << 16);
+      if (a.suggested != data_analysis::stored) return deflated;
+
+      // order 0 entropy misses long range repeats of random data, so trial deflate
+      // the first 64k at level 1 and store only if that saves less than 1/16.
+      size_t trial_size = std::min((size_t)(end - begin), (size_t)1 << 16);
+      std::vector<uint8_t> trial(deflate_encoder::max_encoded_size(trial_size));
+      uint8_t *trial_end = deflate_encoder(1).encode(trial.data(), trial.data() + trial.size(), begin, begin + trial_size);
+      return trial_end && (size_t)(trial_end - trial.data()) < trial_size - trial_size / 16 ? deflated : stored;
+    }
+
+  private:
+    enum {
+      data_descriptor_flag = 1 << 3,
+      utf8_flag = 1 << 11,
+      default_version = 20,
+      zip64_version = 45,
+    };
+
+    // A central directory entry.
+    struct entry {
+      std::string name;
+      unsigned flags;
+      unsigned method;
+      uint32_t dos_date_time;
+      uint32_t crc;
+      uint64_t csize;
+      uint64_t usize;
+      uint64_t offset;
+    };
+
+    // A member added with add(). data becomes the compressed data on a worker thread.
+    struct member {
+      entry e;
+      std::vector<uint8_t> data;
+      bool done = false;
+    };
+
+    static entry make_entry(const std::string &name, unsigned method, uint32_t dos_date_time) {
+      if (method != stored && method != deflated && method != automatic) {
+        throw std::invalid_argument("zipfile_writer: unsupported compression method " + std::to_string(method));
+      }
+      entry e;
+      e.name = name.size() > 0xffff ? name.substr(0, 0xffff) : name;
+      e.flags = 0;
+      for (char c : e.name) {
+        if ((uint8_t)c >= 0x80) e.flags = utf8_flag;
+      }
+      e.method = method;
+      e.dos_date_time = dos_date_time;
+      e.crc = 0;
+      e.csize = 0;
+      e.usize = 0;
+      e.offset = 0;
+      return e;
+    }
+
+    static bool needs_zip64(const entry &e) {
+      return e.csize >= 0xffffffff || e.usize >= 0xffffffff;
+    }
+
+    void work() {
+      for (;;) {
+        member *m;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          work_ready_.wait(lock, [this]() { return stopping_ || !work_.empty(); });
+          if (stopping_) return;
+          m = work_.front();
+          work_.pop_front();
+        }
+        compress(*m);
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          m->done = true;
+        }
+        member_done_.notify_all();
+      }
+    }
+
+    void compress(member &m) const {
+      entry &e = m.e;
+      const uint8_t *begin = m.data.data(), *end = begin + m.data.size();
+      e.usize = m.data.size();
+      e.crc = crc32(0, begin, m.data.size());
+      unsigned method = e.method == automatic ? choose_method(begin, end) : e.method;
+      if (method == deflated) {
+        std::vector<uint8_t> packed(deflate_encoder::max_encoded_size(m.data.size()));
+        uint8_t *packed_end = enc_.encode(packed.data(), packed.data() + packed.size(), begin, end);
+        packed.resize(packed_end ? packed_end - packed.data() : 0);
+        // deflate can expand data that the sample made look compressible.
+        if (e.method == deflated || (packed_end && packed.size() < m.data.size())) {
+          m.data.swap(packed);
+        } else {
+          method = stored;
+        }
+      }
+      e.method = method;
+      e.csize = m.data.size();
+    }
+
+    // Write members from the front of the queue as they finish until no more than max_pending are left.
+    void drain(size_t max_pending) {
+      while (!pending_.empty()) {
+        member *m = pending_.front().get();
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          if (!m->done && pending_.size() <= max_pending) return;
+          member_done_.wait(lock, [m]() { return m->done; });
+        }
+        m->e.offset = offset_;
+        std::vector<uint8_t> header;
+        put_local_header(header, m->e);
+        emit(header);
+        emit(m->data);
+        entries_.push_back(std::move(m->e));
+        pending_.pop_front();
+      }
+    }
+
+    // Compress and write the buffered data of a streamed member. Streamed members are
+    // always deflated, in stored blocks if the method is stored, as the end of stored
+    // data with a data descriptor cannot be found without the central directory.
+    void write_chunk(bool last) {
+      entry &e = stream_;
+      const uint8_t *begin = stream_buffer_.data(), *end = begin + stream_buffer_.size();
+      if (!stream_started_) {
+        if (e.method == automatic) e.method = choose_method(begin, end);
+        stream_stored_ = e.method == stored;
+        e.method = deflated;
+        e.offset = offset_;
+        std::vector<uint8_t> header;
+        put_local_header(header, e);
+        emit(header);
+        stream_started_ = true;
+      }
+      e.crc = crc32(e.crc, begin, stream_buffer_.size());
+      e.usize += stream_buffer_.size();
+
+      // each chunk ends with a sync flush and the one before it is its dictionary.
+      deflate_encoder store(0);
+      const deflate_encoder &enc = stream_stored_ ? store : enc_;
+      std::vector<uint8_t> packed(deflate_encoder::max_encoded_size(stream_buffer_.size()) + 5);
+      uint8_t *dest = packed.data(), *dest_max = packed.data() + packed.size();
+      const uint8_t *dict = stream_history_.empty() ? nullptr : stream_history_.data();
+      uint8_t *packed_end = last ?
+        enc.encode(dest, dest_max, begin, end, dict, stream_history_.size()) :
+        enc.encode_flush(dest, dest_max, begin, end, dict, stream_history_.size());
+      packed.resize(packed_end - dest);
+      e.csize += packed.size();
+      emit(packed);
+      size_t keep = std::min(stream_buffer_.size(), (size_t)deflate_encoder::window_size);
+      stream_history_.assign(end - keep, end);
+      stream_buffer_.clear();
+    }
+
+    void put_local_header(std::vector<uint8_t> &d, const entry &e) const {
+      // Local file header, see zipfile_reader. With a data descriptor the crc
+      // and sizes are zero. Zip64 sizes are 0xffffffff here and in the extra field.
+      bool descriptor = (e.flags & data_descriptor_flag) != 0;
+      bool zip64 = !descriptor && needs_zip64(e);
+      put4(d, 0x04034b50);
+      put2(d, zip64 ? zip64_version : default_version);
+      put2(d, e.flags);
+      put2(d, e.method);
+      put4(d, e.dos_date_time);
+      put4(d, descriptor ? 0 : e.crc);
+      put4(d, descriptor ? 0 : zip64 ? 0xffffffff : (uint32_t)e.csize);
+      put4(d, descriptor ? 0 : zip64 ? 0xffffffff : (uint32_t)e.usize);
+      put2(d, (uint16_t)e.name.size());
+      put2(d, zip64 ? 20 : 0);
+      d.insert(d.end(), e.name.begin(), e.name.end());
+      if (zip64) {
+        put2(d, 0x0001);
+        put2(d, 16);
+        put8(d, e.usize);
+        put8(d, e.csize);
+      }
+    }
+
+    void put_central_header(std::vector<uint8_t> &d, const entry &e) const {
+      // Central file header, see zipfile_reader. The zip64 extra field holds
+      // the uncompressed size, compressed size and offset, in that order, of
+      // those that do not fit in 32 bits.
+      std::vector<uint8_t> extra;
+      if (e.usize >= 0xffffffff) put8(extra, e.usize);
+      if (e.csize >= 0xffffffff) put8(extra, e.csize);
+      if (e.offset >= 0xffffffff) put8(extra, e.offset);
+      unsigned version = extra.empty() ? default_version : zip64_version;
+      put4(d, 0x02014b50);
+      put2(d, version);
+      put2(d, version);
+      put2(d, e.flags);
+      put2(d, e.method);
+      put4(d, e.dos_date_time);
+      put4(d, e.crc);
+      put4(d, (uint32_t)std::min(e.csize, (uint64_t)0xffffffff));
+      put4(d, (uint32_t)std::min(e.usize, (uint64_t)0xffffffff));
+      put2(d, (uint16_t)e.name.size());
+      put2(d, extra.empty() ? 0 : (uint16_t)(4 + extra.size()));
+      put2(d, 0);
+      put2(d, 0);
+      put2(d, 0);
+      put4(d, 0);
+      put4(d, (uint32_t)std::min(e.offset, (uint64_t)0xffffffff));
+      d.insert(d.end(), e.name.begin(), e.name.end());
+      if (!extra.empty()) {
+        put2(d, 0x0001);
+        put2(d, (uint16_t)extra.size());
+        d.insert(d.end(), extra.begin(), extra.end());
+      }
+    }
+
+    void emit(const std::vector<uint8_t> &d) {
+      if (!d.empty()) output_(d.data(), d.size());
+      offset_ += d.size();
+    }
+
+    static void put2(std::vector<uint8_t> &d, unsigned value) {
+      d.push_back((uint8_t)value);
+      d.push_back((uint8_t)(value >> 8));
+    }
+
+    static void put4(std::vector<uint8_t> &d, uint32_t value) {
+      put2(d, value & 0xffff);
+      put2(d, value >> 16);
+    }
+
+    static void put8(std::vector<uint8_t> &d, uint64_t value) {
+      put4(d, (uint32_t)value);
+      put4(d, (uint32_t)(value >> 32));
+    }
+
+    output_type output_;
+    deflate_encoder enc_;
+    unsigned num_threads_;
+    uint64_t offset_ = 0;
+    std::vector<entry> entries_;
+    bool finished_ = false;
+
+    // members added but not yet written, in order. Only the calling thread touches this.
+    std::deque<std::unique_ptr<member>> pending_;
+
+    // the thread pool. work_ and member::done are guarded by mutex_.
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable member_done_;
+    std::deque<member*> work_;
+    bool stopping_ = false;
+
+    // the member being streamed.
+    entry stream_;
+    bool in_member_ = false;
+    bool stream_started_ = false;
+    bool stream_stored_ = false;
+    std::vector<uint8_t> stream_buffer_;
+    std::vector<uint8_t> stream_history_;
+  };
+}
+
+#endif
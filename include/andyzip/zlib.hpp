@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// zlib (RFC 1950) stream reader and writer, as used by HTTP deflate and PNG.
+//
+
+#ifndef ANDYZIP_ZLIB_HPP_
+#define ANDYZIP_ZLIB_HPP_
+
+#include <andyzip/deflate_decoder.hpp>
+#include <andyzip/deflate_encoder.hpp>
+#include <andyzip/checksum.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace andyzip {
+  // Read a zlib stream.
+  class zlib_reader {
+  public:
+    zlib_reader(const uint8_t *begin, const uint8_t *end) : begin_(begin), end_(end) {
+      // 0 1 CMF: CM = 8 (deflate) in the low four bits, CINFO = log2(window) - 8 in the high four.
+      // 1 1 FLG: FCHECK makes CMF * 256 + FLG a multiple of 31, bit 5 is FDICT, bits 6-7 FLEVEL.
+      // 2 4 DICTID if FDICT, the big-endian Adler-32 of the dictionary.
+      if (end_ - begin_ < 6 || (begin_[0] & 0x0f) != 8 || (begin_[0] >> 4) > 7 || (begin_[0] * 256 + begin_[1]) % 31) {
+        throw std::runtime_error("not a zlib stream");
+      }
+      has_dictionary_ = (begin_[1] & 0x20) != 0;
+      if (has_dictionary_) {
+        if (end_ - begin_ < 10) throw std::runtime_error("truncated zlib stream");
+        dictionary_id_ = b4(begin_ + 2);
+      }
+    }
+
+    // True if the stream needs a preset dictionary to decode.
+    bool has_dictionary() const { return has_dictionary_; }
+
+    // Adler-32 of the preset dictionary the stream was made with.
+    uint32_t dictionary_id() const { return dictionary_id_; }
+
+    // Decode the stream. Throws if the data is corrupt or the checksum does not match.
+    std::vector<uint8_t> read(const uint8_t *dictionary = nullptr, size_t dictionary_size = 0) const {
+      if (has_dictionary_) {
+        if (!dictionary) throw std::runtime_error("zlib stream needs a dictionary");
+        if (adler32(1, dictionary, dictionary_size) != dictionary_id_) throw std::runtime_error("wrong zlib dictionary");
+      } else {
+        dictionary = nullptr;
+      }
+
+      std::vector<uint8_t> result;
+      const uint8_t *data = begin_ + (has_dictionary_ ? 6 : 2);
+      const uint8_t *trailer = dec_.decode_append(result, data, end_, 0, dictionary, dictionary_size);
+      if (!trailer) {
+        throw std::runtime_error("deflate decode failure");
+      }
+      if (end_ - trailer < 4) {
+        throw std::runtime_error("truncated zlib stream");
+      }
+      if (b4(trailer) != adler32(1, result.data(), result.size())) {
+        throw std::runtime_error("zlib adler32 mismatch");
+      }
+      return result;
+    }
+
+  private:
+    static inline uint32_t b4(const uint8_t *p) {
+      return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | (p[3] << 0);
+    }
+
+    const uint8_t *begin_;
+    const uint8_t *end_;
+    bool has_dictionary_ = false;
+    uint32_t dictionary_id_ = 0;
+    andyzip::deflate_decoder dec_;
+  };
+
+  // Make a zlib stream, optionally with a preset dictionary.
+  class zlib_writer {
+  public:
+    zlib_writer(int level = 6) : enc_(level), level_(level) {
+    }
+
+    std::vector<uint8_t> write(const uint8_t *begin, const uint8_t *end, const uint8_t *dictionary = nullptr, size_t dictionary_size = 0) const {
+      size_t size = (size_t)(end - begin);
+      std::vector<uint8_t> result(6 + deflate_encoder::max_encoded_size(size) + 4);
+      uint8_t *p = result.data();
+      unsigned cmf = 0x78;
+      unsigned flevel = level_ <= 1 ? 0 : level_ <= 5 ? 1 : level_ == 6 ? 2 : 3;
+      unsigned flg = flevel << 6 | (dictionary ? 0x20 : 0);
+      flg += 31 - (cmf * 256 + flg) % 31;
+      *p++ = (uint8_t)cmf;
+      *p++ = (uint8_t)flg;
+      if (dictionary) {
+        p = put4(p, adler32(1, dictionary, dictionary_size));
+      }
+      p = enc_.encode(p, result.data() + result.size(), begin, end, dictionary, dictionary_size);
+      p = put4(p, adler32(1, begin, size));
+      result.resize(p - result.data());
+      return result;
+    }
+
+  private:
+    static uint8_t *put4(uint8_t *p, uint32_t value) {
+      p[0] = (uint8_t)(value >> 24);
+      p[1] = (uint8_t)(value >> 16);
+      p[2] = (uint8_t)(value >> 8);
+      p[3] = (uint8_t)value;
+      return p + 4;
+    }
+
+    andyzip::deflate_encoder enc_;
+    int level_;
+  };
+}
+
+#endif
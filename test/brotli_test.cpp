@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Brotli: word transforms against RFC 7932, streams from the reference encoder,
+// resumable decoding with step(), reuse of a decoder state, brotli_encoder round
+// trips and custom dictionaries.
+//
+
+#include <andyzip/brotli_decoder.hpp>
+#include <andyzip/brotli_encoder.hpp>
+
+#include "brotli_test_data.hpp"
+#include "test.hpp"
+
+#include <cstring>
+
+namespace {
+  typedef andyzip::brotli_decoder_state::error_code error_code;
+
+  // A stream of one meta-block holding a single static dictionary word of
+  // length copy_len, word index word_idx, with the given transform.
+  // out_len is the length of the transformed word.
+  std::vector<uint8_t> dictionary_word_stream(int copy_len, int word_idx, int transform, int out_len) {
+    andyzip_test::bit_writer w;
+    w.put(1, 0);              // WBITS: 16
+    w.put(1, 1);              // ISLAST
+    w.put(1, 0);              // ISLASTEMPTY
+    w.put(2, 0);              // MNIBBLES: 4
+    w.put(16, out_len - 1);   // MLEN - 1
+    w.put(1, 0);              // NBLTYPESL: 1
+    w.put(1, 0);              // NBLTYPESI: 1
+    w.put(1, 0);              // NBLTYPESD: 1
+    w.put(2, 0);              // NPOSTFIX
+    w.put(4, 0);              // NDIRECT
+    w.put(2, 0);              // CMODE: LSB6
+    w.put(1, 0);              // NTREESL: 1
+    w.put(1, 0);              // NTREESD: 1
+
+    // Simple prefix codes of one symbol each, which take no bits to code.
+    // Insert and copy code 128 + copy code has no insert, copy lengths 2..9
+    // and an explicit distance.
+    w.put(2, 1); w.put(2, 0); w.put(8, 0);                      // literals
+    w.put(2, 1); w.put(2, 0); w.put(10, 128 + copy_len - 2);    // insert and copy
+    // Nothing has been written yet, so any distance is past the window and
+    // distance - 1 is the word id: the transform above the index bits.
+    uint32_t distance = ((uint32_t)transform << andyzip::brotli_data::kBrotliDictionarySizeBitsByLength[copy_len]) + word_idx + 1;
+    int dcode = 16, ndistbits = 1, offset = 0;
+    for (;; ++dcode) {
+      ndistbits = 1 + ((dcode - 16) >> 1);
+      offset = ((2 + ((dcode - 16) & 1)) << ndistbits) - 4;
+      if (distance - 1 < (uint32_t)(offset + (1 << ndistbits))) break;
+    }
+    w.put(2, 1); w.put(2, 0); w.put(6, dcode);                  // distances
+
+    // the command: all codes are implied, leaving just the distance extra bits.
+    w.put(ndistbits, distance - 1 - offset);
+    w.flush();
+    return w.bytes;
+  }
+
+  std::vector<uint8_t> decode(const uint8_t *src, size_t size, size_t max_size, andyzip::brotli_decoder_state &s) {
+    std::vector<uint8_t> out(max_size);
+    s.reset();
+    s.src = (const char*)src;
+    s.bitptr_max = (uint32_t)(size * 8);
+    s.dest = (char*)out.data();
+    s.dest_max = (char*)out.data() + out.size();
+    andyzip::brotli_decoder dec;
+    if (dec.decode(s) != error_code::ok) return andyzip_test::bytes("decode failed");
+    out.resize((size_t)(s.dest - (char*)out.data()));
+    return out;
+  }
+
+  std::vector<uint8_t> decode(const std::vector<uint8_t> &src, size_t max_size, const std::vector<uint8_t> &dictionary = std::vector<uint8_t>()) {
+    andyzip::brotli_decoder_state s;
+    s.set_dictionary(dictionary.empty() ? nullptr : dictionary.data(), dictionary.size());
+    return decode(src.data(), src.size(), max_size, s);
+  }
+
+  std::vector<uint8_t> encode(const std::vector<uint8_t> &in, int quality, int lg_window_size, const std::vector<uint8_t> &dictionary = std::vector<uint8_t>()) {
+    andyzip::brotli_encoder enc(quality, lg_window_size);
+    if (!dictionary.empty()) enc.set_dictionary(dictionary.data(), dictionary.size());
+    std::vector<uint8_t> out(andyzip::brotli_encoder::max_encoded_size(in.size()));
+    uint8_t *end = enc.encode(out.data(), out.data() + out.size(), in.data(), in.data() + in.size());
+    out.resize(end ? end - out.data() : 0);
+    return out;
+  }
+
+  struct reference_stream {
+    const uint8_t *data;
+    size_t size;
+    std::vector<uint8_t> expected;
+  };
+
+  std::vector<reference_stream> reference_streams() {
+    using namespace andyzip_test;
+    std::vector<uint8_t> prose(brotli_prose, brotli_prose + sizeof(brotli_prose) - 1);
+    return std::vector<reference_stream> {
+      { brotli_prose_q11, sizeof(brotli_prose_q11), prose },
+      { brotli_prose_q5_w10, sizeof(brotli_prose_q5_w10), prose },
+      { brotli_text_q1, sizeof(brotli_text_q1), text(5000, 1) },
+      { brotli_text_q6, sizeof(brotli_text_q6), text(5000, 1) },
+      { brotli_text_q11, sizeof(brotli_text_q11), text(5000, 1) },
+      { brotli_noise_q5, sizeof(brotli_noise_q5), noise(600, 1) },
+    };
+  }
+}
+
+int main() {
+  // Transforms 9 and 44 are FermentFirst and FermentAll with no prefix or suffix.
+  // RFC 7932 section 8: ASCII letters and the second byte of a two byte UTF-8
+  // sequence are flipped with 32, the third byte of a three byte sequence with 5.
+  {
+    // word 1 of length 6 is "domain".
+    CHECK(decode(dictionary_word_stream(6, 1, 0, 6), 6) == andyzip_test::bytes("domain"));
+    CHECK(decode(dictionary_word_stream(6, 1, 9, 6), 6) == andyzip_test::bytes("Domain"));
+    CHECK(decode(dictionary_word_stream(6, 1, 44, 6), 6) == andyzip_test::bytes("DOMAIN"));
+
+    // word 628 of length 6 is U+4E2D U+6587, e4 b8 ad e6 96 87.
+    std::vector<uint8_t> identity = { 0xe4, 0xb8, 0xad, 0xe6, 0x96, 0x87 };
+    std::vector<uint8_t> first = { 0xe4, 0xb8, 0xa8, 0xe6, 0x96, 0x87 };
+    std::vector<uint8_t> all = { 0xe4, 0xb8, 0xa8, 0xe6, 0x96, 0x82 };
+    CHECK(decode(dictionary_word_stream(6, 628, 0, 6), 6) == identity);
+    CHECK(decode(dictionary_word_stream(6, 628, 9, 6), 6) == first);
+    CHECK(decode(dictionary_word_stream(6, 628, 44, 6), 6) == all);
+
+    // word 808 of length 9 is three Thai letters, e0 b9 84 e0 b8 97 e0 b8 a2.
+    std::vector<uint8_t> thai = { 0xe0, 0xb9, 0x81, 0xe0, 0xb8, 0x92, 0xe0, 0xb8, 0xa7 };
+    CHECK(decode(dictionary_word_stream(9, 808, 44, 9), 9) == thai);
+  }
+
+  // RFC 7932 appendix B has 121 transforms, the last six of which are 115 to 120.
+  {
+    CHECK(decode(dictionary_word_stream(6, 1, 115, 8), 8) == andyzip_test::bytes(" DOMAIN."));
+    CHECK(decode(dictionary_word_stream(6, 1, 120, 9), 9) == andyzip_test::bytes(" Domain='"));
+    // transform 121 does not exist.
+    CHECK(decode(dictionary_word_stream(6, 1, 121, 6), 6) == andyzip_test::bytes("decode failed"));
+  }
+
+  // WBITS 1000001 is the large window escape, which RFC 7932 does not allow.
+  CHECK(decode(std::vector<uint8_t>{ 0x11, 0, 0, 0 }, 16) == andyzip_test::bytes("decode failed"));
+
+  // Streams from the reference encoder, with output buffers of exactly the right
+  // size and one byte short.
+  for (auto &r : reference_streams()) {
+    std::vector<uint8_t> src(r.data, r.data + r.size);
+    CHECK(decode(src, r.expected.size()) == r.expected);
+    CHECK(decode(src, r.expected.size() + 100) == r.expected);
+    if (!r.expected.empty()) CHECK(decode(src, r.expected.size() - 1) == andyzip_test::bytes("decode failed"));
+
+    // truncated.
+    CHECK(decode(std::vector<uint8_t>(src.begin(), src.end() - 1), r.expected.size()) == andyzip_test::bytes("decode failed"));
+  }
+
+  // step() decodes a few commands at a time and picks up where it left off.
+  for (auto &r : reference_streams()) {
+    for (int max_commands : { 1, 7 }) {
+      std::vector<uint8_t> out(r.expected.size());
+      andyzip::brotli_decoder_state s;
+      s.src = (const char*)r.data;
+      s.bitptr_max = (uint32_t)(r.size * 8);
+      s.dest = (char*)out.data();
+      s.dest_max = (char*)out.data() + out.size();
+      andyzip::brotli_decoder dec;
+      error_code error;
+      int steps = 0;
+      while ((error = dec.step(s, max_commands)) == error_code::ok) ++steps;
+      CHECK(error == error_code::end);
+      CHECK(out == r.expected);
+      // stored meta-blocks have no commands.
+      CHECK(steps > 2 || r.data == andyzip_test::brotli_noise_q5);
+    }
+  }
+
+  // One state decodes many streams, interleaved with streams that fail, and
+  // stops allocating once it has seen the largest window.
+  {
+    andyzip::brotli_decoder_state s;
+    std::vector<reference_stream> streams = reference_streams();
+    size_t peak = 0;
+    for (int round = 0; round != 3; ++round) {
+      for (auto &r : streams) {
+        CHECK(decode(r.data, r.size, r.expected.size(), s) == r.expected);
+        CHECK(decode(r.data, r.size / 2, r.expected.size(), s) == andyzip_test::bytes("decode failed"));
+      }
+      if (round == 1) peak = s.peak_memory();
+    }
+    CHECK(s.peak_memory() == peak);
+
+    // reserve() allocates up front.
+    andyzip::brotli_decoder_state reserved;
+    reserved.reserve(22);
+    size_t reserved_peak = reserved.peak_memory();
+    for (auto &r : streams) CHECK(decode(r.data, r.size, r.expected.size(), reserved) == r.expected);
+    CHECK(reserved.peak_memory() == reserved_peak);
+  }
+
+  // brotli_encoder round trips at every quality on a range of data.
+  {
+    std::vector<uint8_t> prose(andyzip_test::brotli_prose, andyzip_test::brotli_prose + sizeof(andyzip_test::brotli_prose) - 1);
+    std::vector<uint8_t> records;
+    for (uint32_t i = 0; i != 10000; ++i) {
+      uint32_t value = i * 37;
+      records.insert(records.end(), { (uint8_t)value, (uint8_t)(value >> 8), 0, 0 });
+    }
+    std::vector<std::vector<uint8_t> > inputs = {
+      std::vector<uint8_t>(),
+      andyzip_test::bytes("a"),
+      prose,
+      andyzip_test::text(100000, 3),
+      andyzip_test::noise(20000, 3),
+      std::vector<uint8_t>(50000, 'z'),
+      records,
+    };
+    for (int quality : { 0, 1, 3, 4, 5, 9, 11 }) {
+      for (int lg_window_size : { 10, 16, 22 }) {
+        for (auto &in : inputs) {
+          std::vector<uint8_t> z = encode(in, quality, lg_window_size);
+          CHECK(!z.empty());
+          CHECK(decode(z, in.size()) == in);
+        }
+      }
+    }
+
+    // text compresses and better at higher quality.
+    std::vector<uint8_t> &text = inputs[3];
+    size_t q1 = encode(text, 1, 22).size(), q11 = encode(text, 11, 22).size();
+    CHECK(q1 < text.size() / 3);
+    CHECK(q11 < q1);
+
+    // data that does not compress grows by a few bytes only.
+    CHECK(encode(inputs[4], 11, 22).size() < inputs[4].size() + 64);
+  }
+
+  // A custom dictionary is history before the stream for both the encoder and decoder.
+  {
+    std::vector<uint8_t> dictionary = andyzip_test::text(20000, 5);
+    std::vector<uint8_t> in(dictionary.begin() + 5000, dictionary.begin() + 9000);
+    for (int quality : { 1, 5, 11 }) {
+      std::vector<uint8_t> plain = encode(in, quality, 16);
+      std::vector<uint8_t> z = encode(in, quality, 16, dictionary);
+      CHECK(z.size() < plain.size() / 4);
+      CHECK(decode(z, in.size(), dictionary) == in);
+      CHECK(decode(z, in.size()) != in);
+    }
+  }
+
+  return andyzip_test::result();
+}
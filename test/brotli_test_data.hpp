@@ -0,0 +1,342 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Brotli streams made by the reference encoder (BrotliEncoderCompress from
+// libbrotlienc, generic mode) for brotli_test.cpp. The name of each gives the
+// quality and, where it is not the default of 22, lg_window_size:
+//
+//   brotli_prose_*     brotli_prose below
+//   brotli_text_*      andyzip_test::text(5000, 1) with lg_window_size 16 (q1), 18 (q6) or 22 (q11)
+//   brotli_noise_q5    andyzip_test::noise(600, 1) with lg_window_size 16
+//
+
+#ifndef ANDYZIP_BROTLI_TEST_DATA_HPP_
+#define ANDYZIP_BROTLI_TEST_DATA_HPP_
+
+#include <cstdint>
+
+namespace andyzip_test {
+  // Capitalised words and markup, which the reference encoder codes with
+  // transformed static dictionary words.
+  const char brotli_prose[] =
+    "The Committee met in London on Tuesday. Members of the Committee discussed the Report, "
+    "which the Government had published the week before. THE REPORT SAID that the Service would "
+    "need more Money. The Chairman asked whether the Department of Health could find it. "
+    "Information about the Meeting is available from the Secretary. Contact the Office for more "
+    "Information. The Committee will meet again in January. <div class=\"Content\">Home | About | Contact</div>\n";
+
+  const uint8_t brotli_prose_q11[] = {
+    0x1b, 0xc9, 0x01, 0xc0, 0x1c, 0x09, 0x36, 0x2e, 0xd2, 0xbb, 0x25, 0x4f, 0x41, 0x05, 0xb5, 0xb9,
+    0x9e, 0x84, 0x95, 0x3a, 0xd8, 0xc3, 0x19, 0x5c, 0xba, 0x68, 0x96, 0xb9, 0x80, 0x98, 0xed, 0x80,
+    0xfd, 0x7f, 0x7f, 0xa3, 0x02, 0xaa, 0x82, 0x20, 0x90, 0xce, 0xb7, 0x09, 0x06, 0xa5, 0x57, 0xaf,
+    0x97, 0xa0, 0x84, 0xc9, 0xa6, 0x52, 0xd7, 0xb3, 0x01, 0x2a, 0xef, 0xc4, 0xfa, 0x97, 0x81, 0x68,
+    0xbd, 0x99, 0xe3, 0x0a, 0x95, 0x42, 0x01, 0x97, 0x45, 0x2d, 0xc2, 0x21, 0x95, 0xcd, 0xb0, 0xea,
+    0x5d, 0xee, 0x4b, 0xaf, 0x84, 0x49, 0xec, 0x07, 0x09, 0x8d, 0x53, 0xaf, 0x1d, 0x15, 0xb9, 0xd7,
+    0x84, 0xa0, 0xaa, 0x1e, 0x90, 0x3e, 0x61, 0x0d, 0x10, 0x0d, 0x53, 0x1e, 0xbc, 0x70, 0xf4, 0x9b,
+    0x43, 0x15, 0x61, 0xad, 0x30, 0xb7, 0xd6, 0x3a, 0xce, 0x55, 0xc0, 0xd1, 0xbf, 0x9d, 0x4b, 0xa6,
+    0x88, 0xc0, 0x9c, 0xae, 0x83, 0xb5, 0x45, 0x62, 0xba, 0xe5, 0x0a, 0x6e, 0x1f, 0xa4, 0xc2, 0x26,
+    0x26, 0xa5, 0x2e, 0xdb, 0x1a, 0x90, 0x77, 0x26, 0x11, 0xdd, 0x42, 0x54, 0xfb, 0x34, 0x44, 0xee,
+    0xdf, 0x87, 0xed, 0xa2, 0xed, 0x06, 0xdc, 0xb7, 0xd2, 0xd2, 0xdf, 0x03,
+  };
+
+  const uint8_t brotli_prose_q5_w10[] = {
+    0xa1, 0x48, 0x0e, 0x00, 0x20, 0x50, 0xd8, 0x9a, 0xbe, 0x46, 0x4d, 0x1a, 0x7f, 0x15, 0x06, 0x00,
+    0x85, 0x79, 0xd8, 0x47, 0x2a, 0x4e, 0xde, 0x02, 0xf6, 0xfd, 0x8f, 0xc8, 0x6e, 0x54, 0xfa, 0xdb,
+    0x34, 0xc0, 0x6c, 0xa0, 0xf1, 0x02, 0x8c, 0x25, 0x88, 0x75, 0x2e, 0x0b, 0xa2, 0xea, 0x2f, 0x26,
+    0xf1, 0xed, 0x19, 0x88, 0x45, 0x9e, 0xa6, 0x61, 0xd3, 0x48, 0xa4, 0x6a, 0x08, 0x33, 0xf4, 0x78,
+    0x27, 0xcf, 0x78, 0xb6, 0xaa, 0x5d, 0xeb, 0x63, 0x20, 0x2c, 0xd7, 0xe4, 0xb0, 0x83, 0x18, 0x4e,
+    0x26, 0x51, 0x6e, 0x1f, 0xb2, 0xf3, 0xf4, 0x3a, 0x55, 0xd0, 0x7a, 0xb0, 0xbd, 0x23, 0xb0, 0x5c,
+    0xaa, 0x9c, 0x21, 0x91, 0xfa, 0x92, 0x62, 0xfc, 0xf4, 0xa3, 0xe1, 0xb9, 0x5d, 0x71, 0x5f, 0x5d,
+    0x2f, 0xf7, 0x27, 0x8f, 0xd9, 0x6e, 0x49, 0xd5, 0x5e, 0x30, 0x12, 0xdb, 0xd1, 0xf0, 0xea, 0x53,
+    0xfc, 0xb3, 0xb3, 0x61, 0x9a, 0x57, 0xe2, 0x94, 0x67, 0xfa, 0x18, 0xcc, 0x00, 0x98, 0xe2, 0x3f,
+    0xd1, 0xf5, 0x75, 0x2c, 0x97, 0x98, 0xcd, 0x59, 0xaa, 0xb0, 0xaa, 0x46, 0x89, 0x41, 0xee, 0xb1,
+    0x95, 0x95, 0x34, 0x01, 0xc4, 0x0a, 0x7c, 0x74, 0x23, 0x6c, 0x0c, 0x26, 0x12, 0xcf, 0x41, 0xe9,
+    0x87, 0x93, 0xd4, 0x84, 0x99, 0x0f, 0x14, 0x16, 0x04, 0x4e, 0x57, 0xf6, 0x2f, 0x0c, 0x8b, 0x3c,
+    0x6b, 0x2c, 0x47, 0x10, 0x1f, 0x4b, 0xb4, 0x97, 0xf7, 0x4e, 0xd3, 0x63, 0x75, 0xa9, 0xfb, 0x40,
+    0xac, 0x05, 0x48, 0x9d, 0xeb, 0x5e, 0x34, 0xb0, 0x7d, 0x31, 0x04, 0x0a, 0x2c, 0x51, 0x94, 0x35,
+    0xfd, 0x31, 0x34, 0x99, 0xff, 0x36, 0x6c, 0xfe, 0x4b, 0x4f, 0x87, 0x03, 0x37, 0xec, 0xc6, 0x3d,
+  };
+
+  const uint8_t brotli_text_q1[] = {
+    0x83, 0xc3, 0x09, 0x00, 0x80, 0xaa, 0xaa, 0xaa, 0xea, 0xff, 0x2e, 0x97, 0x13, 0xc3, 0x9d, 0x41,
+    0x8e, 0x77, 0x51, 0x53, 0x51, 0x53, 0x0d, 0x17, 0x55, 0xf5, 0x50, 0x53, 0x73, 0x8b, 0x70, 0x78,
+    0xff, 0x7f, 0xa2, 0x95, 0x6f, 0x3b, 0xa5, 0x78, 0xcf, 0x62, 0x28, 0x5d, 0xe9, 0x3f, 0x18, 0x38,
+    0xb0, 0x00, 0x16, 0x16, 0xba, 0x59, 0x4c, 0x06, 0x0e, 0x1c, 0xb8, 0x4e, 0x2c, 0xcb, 0x3c, 0xbe,
+    0xe7, 0x51, 0x41, 0x80, 0xb5, 0x2d, 0xbf, 0xab, 0x6e, 0xd9, 0x17, 0x76, 0x75, 0x3c, 0x9e, 0x9f,
+    0xdd, 0x7b, 0x8a, 0x3e, 0xfe, 0x64, 0x29, 0x1c, 0xb9, 0x5d, 0xdb, 0xc6, 0xe1, 0xd0, 0xb2, 0xf5,
+    0x37, 0xf3, 0xe3, 0x0b, 0xd7, 0x5e, 0x6e, 0x1d, 0x4f, 0x1b, 0x79, 0x3e, 0x08, 0xaf, 0xef, 0xf5,
+    0x2e, 0xa5, 0xdb, 0x80, 0x86, 0x0e, 0xc7, 0xff, 0x97, 0xad, 0xa3, 0xb6, 0x8f, 0x43, 0xb2, 0x97,
+    0xb0, 0xed, 0xf8, 0xb9, 0xfb, 0xfb, 0xc2, 0xef, 0xdd, 0x8e, 0x17, 0xe0, 0xfa, 0x4a, 0x10, 0x79,
+    0x9e, 0xcf, 0x4b, 0x1c, 0x7e, 0x7d, 0xdb, 0x3b, 0xb6, 0x0a, 0x58, 0x90, 0xef, 0xd1, 0xb6, 0x2f,
+    0x0b, 0x90, 0xd7, 0xbf, 0x6c, 0x82, 0xdf, 0x25, 0x7c, 0x9c, 0xbb, 0x42, 0x1e, 0x9e, 0x66, 0x31,
+    0xc2, 0xf6, 0xcc, 0xf1, 0x33, 0xec, 0xfb, 0x2f, 0xf4, 0x82, 0x4f, 0xa7, 0xa5, 0x48, 0x84, 0x48,
+    0x7e, 0x96, 0xf9, 0x07, 0x2f, 0xce, 0x91, 0xd6, 0x15, 0xc1, 0xa5, 0xd5, 0x73, 0xe5, 0x79, 0x24,
+    0xed, 0x9b, 0x98, 0x70, 0x76, 0xc0, 0x40, 0xb3, 0x6d, 0x5d, 0x23, 0xc9, 0x7f, 0x4a, 0x7c, 0xcc,
+    0x97, 0x07, 0xe0, 0x7c, 0x49, 0x6b, 0x3e, 0x03, 0xc2, 0xce, 0xce, 0xeb, 0x59, 0x10, 0xc3, 0x82,
+    0xeb, 0x17, 0xa1, 0xc9, 0x67, 0x8b, 0x02, 0xd9, 0x90, 0xc7, 0x27, 0x2e, 0x95, 0x15, 0x9e, 0x11,
+    0x75, 0xb8, 0xa9, 0x2f, 0x8a, 0xd2, 0xc2, 0x0f, 0x47, 0xe3, 0xb5, 0xf6, 0xce, 0xf2, 0x33, 0xe6,
+    0xf1, 0xf2, 0xee, 0xda, 0x8c, 0xe2, 0x94, 0x26, 0x95, 0xc1, 0x76, 0x21, 0x96, 0x22, 0x4f, 0x3a,
+    0x78, 0x4a, 0x1b, 0xf6, 0xe4, 0x2e, 0x30, 0xc2, 0xbe, 0x9a, 0x0f, 0xd5, 0xd6, 0xe2, 0x03, 0x0d,
+    0xd1, 0x20, 0xb8, 0x5e, 0x45, 0x39, 0xef, 0xc1, 0x43, 0x89, 0x4f, 0x70, 0x0c, 0x29, 0xdb, 0x45,
+    0x53, 0xdd, 0x75, 0xc0, 0xc9, 0xdd, 0xca, 0x9e, 0x86, 0x51, 0x81, 0x61, 0xa6, 0xc6, 0x24, 0x43,
+    0x62, 0x54, 0xc7, 0x55, 0x26, 0x71, 0x31, 0xb6, 0x1b, 0xdd, 0x07, 0xf3, 0x4f, 0x46, 0x6e, 0xb6,
+    0x07, 0xf0, 0x46, 0x94, 0x1d, 0x3d, 0xad, 0x8c, 0xc2, 0xee, 0x51, 0x27, 0x4e, 0xe8, 0xd5, 0xb9,
+    0xa9, 0x13, 0x1f, 0x84, 0xd5, 0xab, 0xbf, 0xc5, 0xea, 0x25, 0x54, 0x02, 0xc6, 0xbd, 0x14, 0x2b,
+    0xb8, 0x70, 0x84, 0x70, 0x8b, 0xf1, 0xfc, 0xee, 0x68, 0x93, 0xe6, 0xee, 0x56, 0x9e, 0xea, 0x5b,
+    0xa7, 0xdd, 0xb6, 0x30, 0xac, 0x05, 0xd4, 0xd1, 0x61, 0xcb, 0xd0, 0x97, 0xa8, 0xe9, 0xcf, 0x02,
+    0xd9, 0x1d, 0x5c, 0x18, 0x3d, 0x9f, 0xf7, 0x30, 0xf2, 0x62, 0xb6, 0x49, 0x12, 0x05, 0xd2, 0x41,
+    0x1e, 0xff, 0x7b, 0x64, 0x7d, 0xa3, 0x2c, 0x6c, 0x44, 0x90, 0x99, 0x9e, 0x15, 0xda, 0x72, 0x4f,
+    0x8e, 0x1a, 0x76, 0xf8, 0xb8, 0x2c, 0x58, 0xbb, 0xa2, 0x7c, 0x36, 0x18, 0xd7, 0x2a, 0x3e, 0xfd,
+    0xc3, 0xe5, 0xf9, 0x70, 0x1f, 0x34, 0x8d, 0x56, 0x6a, 0xdc, 0x23, 0xa3, 0xd3, 0x29, 0x2e, 0x90,
+    0x0b, 0x7e, 0x72, 0x20, 0xd4, 0xff, 0x91, 0x82, 0x93, 0x4c, 0x64, 0x10, 0x00, 0x40, 0x50, 0x22,
+    0x5a, 0x4f, 0xc9, 0x97, 0xa5, 0x65, 0x66, 0xed, 0x60, 0x00, 0x1b, 0x77, 0xe6, 0xad, 0xd9, 0x75,
+    0x66, 0x3c, 0x9a, 0x5b, 0x92, 0x5c, 0xee, 0x20, 0x86, 0x5d, 0x18, 0xe4, 0xa8, 0xc1, 0x65, 0x3a,
+    0xba, 0x1d, 0x07, 0x53, 0x84, 0xaf, 0xbf, 0x61, 0xdf, 0x3a, 0x41, 0x7b, 0x52, 0x83, 0xfb, 0x15,
+    0x27, 0x34, 0xa8, 0xbd, 0x11, 0x62, 0x72, 0x0d, 0xb7, 0x33, 0x82, 0xd4, 0x57, 0x11, 0x8c, 0x6e,
+    0xa4, 0xc5, 0xa1, 0x30, 0x7c, 0xb8, 0xc4, 0x81, 0x49, 0x81, 0x49, 0xd1, 0x1b, 0x2a, 0x7e, 0xf3,
+    0xe5, 0xb4, 0x77, 0x9d, 0x4e, 0x33, 0xd2, 0xe8, 0xb2, 0x12, 0xe8, 0x50, 0xed, 0xaa, 0x63, 0x1b,
+    0x2e, 0x53, 0x5a, 0x9d, 0x50, 0x16, 0xe8, 0x35, 0x4f, 0x53, 0x2f, 0xc3, 0x96, 0x33, 0x76, 0xa7,
+    0xbc, 0xa8, 0xb4, 0x69, 0x5a, 0xf1, 0xca, 0xbc, 0x17, 0x78, 0x33, 0xfb, 0xfe, 0xfa, 0xe2, 0x13,
+    0xb1, 0x75, 0x5e, 0xcc, 0xa1, 0xb2, 0x33, 0x43, 0x3c, 0xbe, 0x45, 0x4c, 0xca, 0x4d, 0xeb, 0x95,
+    0xe0, 0x0a, 0x36, 0xa2, 0x6c, 0xca, 0x01, 0x43, 0x52, 0x1f, 0xc0, 0xad, 0x5d, 0xfa, 0xf6, 0x5b,
+    0xe2, 0x06, 0x53, 0x26, 0x4d, 0x51, 0x80, 0x5e, 0xe0, 0xb2, 0x52, 0x39, 0x8e, 0x34, 0x3c, 0xca,
+    0x4d, 0xcf, 0x19, 0x53, 0x59, 0xaf, 0x79, 0x4e, 0xfc, 0xa8, 0x7b, 0x7b, 0x2a, 0xcb, 0x80, 0x22,
+    0x0b, 0x9f, 0x74, 0xa5, 0x4b, 0x16, 0x8e, 0xe4, 0x8f, 0x61, 0xee, 0x70, 0x41, 0xf8, 0x8c, 0x02,
+    0x2f, 0x47, 0xbd, 0xa2, 0x72, 0xf5, 0xad, 0x70, 0xc5, 0x6b, 0x42, 0xc8, 0x22, 0x20, 0xd2, 0xca,
+    0x86, 0x99, 0x28, 0x2c, 0x4e, 0x44, 0xa4, 0x35, 0x5a, 0x92, 0x80, 0xd8, 0xd6, 0xa0, 0x51, 0x72,
+    0xae, 0xed, 0x61, 0x59, 0x4b, 0x10, 0x97, 0xb1, 0x4d, 0x04, 0x34, 0x73, 0xf9, 0x42, 0x07, 0xbf,
+    0x49, 0x06, 0xac, 0x52, 0xdf, 0xf7, 0xc4, 0xdc, 0x50, 0x0a, 0x20, 0xe8, 0x32, 0x38, 0x63, 0x53,
+    0xb2, 0x1b, 0x93, 0xca, 0x8c, 0x9d, 0xf2, 0xae, 0xec, 0x57, 0x99, 0x23, 0xe5, 0x6f, 0x53, 0xa1,
+    0xe1, 0x5c, 0x6d, 0x7a, 0x89, 0x30, 0x3c, 0xf6, 0x2b, 0x6c, 0x3f, 0x20, 0xa3, 0x9c, 0xdd, 0x18,
+    0x2a, 0x40, 0x85, 0x47, 0x68, 0xbb, 0x46, 0xa6, 0x75, 0x68, 0x72, 0x39, 0x76, 0x64, 0x42, 0xcc,
+    0x05, 0x6b, 0x04, 0xf9, 0xd4, 0x6a, 0x60, 0x08, 0xd3, 0x23, 0xd0, 0xe0, 0xf7, 0x32, 0xda, 0x13,
+    0xbc, 0xa9, 0xbf, 0xbd, 0xf6, 0xc0, 0x11, 0x22, 0xe5, 0x4a, 0x13, 0xdf, 0x1d, 0x0c, 0xa9, 0x3c,
+    0x5d, 0x73, 0x04, 0x0d, 0x3b, 0x56, 0x93, 0xc2, 0xa1, 0x1b, 0x34, 0x5a, 0x95, 0x79, 0x77, 0xe3,
+    0x1a, 0xa3, 0x94, 0x97, 0x56, 0x57, 0x47, 0xb5, 0x7d, 0xd7, 0x84, 0xb6, 0xa8, 0x76, 0x13, 0xa9,
+    0x2d, 0x4a, 0xd0, 0x33, 0x82, 0xf3, 0xc8, 0x12, 0x4d, 0xda, 0x98, 0x55, 0x43, 0x05, 0x34, 0x72,
+    0x78, 0xb0, 0x1d, 0xb4, 0x6c, 0xb4, 0x72, 0x8e, 0x31, 0xa3, 0x94, 0xcf, 0xe1, 0x57, 0xef, 0xeb,
+    0xc6, 0x0a, 0x2d, 0x1a, 0xc5, 0x53, 0xbb, 0x6f, 0x5f, 0x1b, 0xc4, 0xc8, 0xb6, 0x33, 0xa7, 0x45,
+    0x0e, 0xc7, 0x28, 0x95, 0x01, 0x01, 0x23, 0x2b, 0xf7, 0x41, 0xc3, 0x30, 0x2d, 0x74, 0x50, 0xc2,
+    0x89, 0x2f, 0x52, 0x91, 0xa8, 0x6a, 0xfd, 0xe6, 0x30, 0x76, 0xe3, 0xfd, 0x7d, 0x33, 0x04, 0x3a,
+    0x35, 0x4c, 0x7c, 0xd5, 0x00, 0x0e, 0x27, 0x37, 0x8e, 0x90, 0x3c, 0x64, 0x0c, 0x37, 0xa7, 0xa7,
+    0xfa, 0x0a, 0x45, 0xe8, 0x8c, 0xbe, 0xa8, 0x3f, 0xb2, 0x56, 0xbd, 0x12, 0xf3, 0xa6, 0x7c, 0xcf,
+    0xaf, 0xe8, 0x9b, 0x2b, 0xbd, 0x07, 0x10, 0xfb, 0xf5, 0x5b, 0xfc, 0x8a, 0x45, 0x36, 0xb2, 0xdb,
+    0x52, 0x3a, 0x1b, 0x5d, 0x6a, 0x46, 0x37, 0xfb, 0x6a, 0x85, 0xaf, 0x5d, 0x59, 0xec, 0x2c, 0x03,
+    0x7e, 0xe8, 0x48, 0x95, 0xf7, 0xc8, 0x07, 0x26, 0xf5, 0xb3, 0x43, 0x1c, 0xe2, 0x9d, 0x2d, 0x09,
+    0x03, 0xcb, 0x8a, 0xd4, 0x5c, 0x19, 0x5e, 0x95, 0x5a, 0xa7, 0x18, 0xf6, 0x6e, 0x69, 0x6b, 0xd2,
+    0xbf, 0x99, 0xf3, 0x5b, 0x93, 0xf9, 0xed, 0xaf, 0x76, 0xe3, 0x54, 0xcd, 0x50, 0xca, 0x0a, 0x79,
+    0xff, 0xb8, 0xd2, 0xd5, 0x8d, 0x60, 0x9e, 0x79, 0xed, 0x17, 0xc5, 0xdd, 0x91, 0xd0, 0xb8, 0xa5,
+    0x38, 0xd9, 0x19, 0x3d, 0x3b, 0x11, 0xb0, 0x68, 0x85, 0x7d, 0x50, 0x08, 0x0c, 0xcb, 0xae, 0xb6,
+    0x56, 0x96, 0xed, 0xd2, 0xef, 0xcd, 0x26, 0xe5, 0x39, 0xce, 0xc4, 0xa6, 0x1f, 0xd5, 0x2d, 0xb4,
+    0x9b, 0xdb, 0x0a, 0xe9, 0xc9, 0xf8, 0x36, 0x44, 0x96, 0xb2, 0x0d, 0x63, 0x98, 0x66, 0x06, 0x1c,
+    0x33, 0x52, 0x4d, 0x80, 0x93, 0x3a, 0x6f, 0x6b, 0x86, 0x88, 0x28, 0xb2, 0x17, 0x45, 0x1d, 0x7a,
+    0xfc, 0xe4, 0xb3, 0x31, 0x70, 0x19, 0x11, 0x56, 0x40, 0xb4, 0x4d, 0x0a, 0x87, 0x52, 0x9e, 0x46,
+    0x1c, 0x02, 0x1f, 0xda, 0x29, 0x11, 0xcc, 0xb0, 0x9f, 0x6a, 0x8b, 0xd0, 0x1b, 0x09, 0x7c, 0xeb,
+    0xf6, 0xf2, 0x76, 0x07, 0xf1, 0xb0, 0x9d, 0x5d, 0x84, 0xfd, 0x01, 0xe2, 0xd1, 0x9a, 0x67, 0x2b,
+    0x21, 0x59, 0xbc, 0xe8, 0x00, 0x45, 0x8c, 0x47, 0xff, 0x3d, 0x93, 0xce, 0x7d, 0xb3, 0x79, 0xb2,
+    0x8b, 0xfa, 0x70, 0x0f, 0xbd, 0x3d, 0xaf, 0xb4, 0x55, 0xcc, 0x2b, 0x5a, 0x62, 0x79, 0x2a, 0xb9,
+    0xce, 0x6f, 0x0c, 0xd0, 0xa0, 0xdd, 0xde, 0x34, 0x69, 0x14, 0xf7, 0xcc, 0xe3, 0xc6, 0x48, 0xed,
+    0x85, 0x18, 0x56, 0x2d, 0xb1, 0x7f, 0xbf, 0x5a, 0x4a, 0x04, 0xb9, 0x63, 0x79, 0x59, 0x30, 0xf4,
+    0x5e, 0x52, 0xb9, 0xf9, 0xdf, 0x9a, 0xf7, 0x35, 0x41, 0x7a, 0x53, 0x93, 0xc6, 0xcd, 0xa6, 0x73,
+    0x2a, 0x2d, 0x8d, 0x30, 0x97, 0x13, 0xf5, 0xc7, 0x57, 0x21, 0x93, 0xf4, 0xb7, 0xb8, 0x45, 0xf4,
+    0xfb, 0x31, 0xf7, 0x14, 0xf7, 0x61, 0x54, 0x00, 0x2c, 0x78, 0x29, 0x36, 0xef, 0x24, 0xe4, 0x5b,
+    0xee, 0xec, 0xb4, 0xda, 0x12, 0x8d, 0x16, 0x6c, 0x40, 0xa3, 0x31, 0xfd, 0xee, 0x64, 0x42, 0x18,
+    0xc0, 0x77, 0xab, 0x1a, 0x29, 0x38, 0x02, 0x5a, 0x8d, 0x3f, 0xb5, 0xed, 0x7a, 0xdd, 0x55, 0xff,
+    0x4e, 0xfa, 0xcc, 0x5c, 0x1e, 0xc1, 0xe3, 0x6d, 0x81, 0x82, 0x77, 0xfb, 0xff, 0x87, 0x20, 0x8a,
+    0x68, 0x29, 0x6e, 0xdc, 0x6f, 0xd5, 0x2d, 0xfb, 0x42, 0x0c,
+  };
+
+  const uint8_t brotli_text_q6[] = {
+    0x13, 0x87, 0x13, 0x00, 0xc4, 0x32, 0x8f, 0xfa, 0x69, 0xaa, 0x49, 0x3f, 0x99, 0xb2, 0x87, 0xbd,
+    0x3b, 0x82, 0x95, 0x13, 0xfc, 0x53, 0x61, 0x6f, 0xec, 0x8d, 0x44, 0x38, 0xdf, 0x26, 0x29, 0x63,
+    0x6d, 0x85, 0x43, 0xce, 0x34, 0x8c, 0x7f, 0xef, 0xfe, 0xb6, 0xd8, 0x10, 0x07, 0x36, 0xd5, 0xb4,
+    0x25, 0xc8, 0xa1, 0x99, 0xbc, 0x14, 0xe9, 0x7f, 0xa3, 0xff, 0xbf, 0x2e, 0xf2, 0x25, 0x50, 0xb8,
+    0x42, 0xfa, 0x6b, 0xfc, 0x37, 0xbc, 0xbc, 0x99, 0x82, 0x26, 0xfb, 0x90, 0x4f, 0x74, 0x2a, 0xcc,
+    0xca, 0x86, 0xdb, 0x9f, 0xb7, 0xbb, 0x94, 0x7d, 0x38, 0xe8, 0x5b, 0xbd, 0xa0, 0x5a, 0xaf, 0x89,
+    0x39, 0x42, 0xe5, 0x93, 0xe0, 0x7a, 0xef, 0xe7, 0x45, 0x03, 0x9b, 0xe1, 0xc7, 0xa2, 0x38, 0x67,
+    0xbd, 0xae, 0x9f, 0x9f, 0x7c, 0xcb, 0x79, 0x4f, 0xaf, 0xc5, 0xc4, 0xfe, 0x93, 0x46, 0x7f, 0xbb,
+    0x51, 0x7a, 0xcd, 0xc5, 0x55, 0xd8, 0x7c, 0x81, 0x68, 0x2d, 0xae, 0x41, 0x5b, 0x2e, 0xdf, 0x6f,
+    0xc3, 0xf7, 0x37, 0x14, 0xfa, 0x48, 0x1a, 0x89, 0x4a, 0x01, 0x3c, 0x7c, 0x5e, 0xf2, 0x87, 0xc5,
+    0x15, 0x6c, 0xa5, 0xc1, 0x52, 0x4b, 0x6b, 0x99, 0xd7, 0x22, 0xb1, 0x7d, 0x14, 0x2b, 0x3e, 0x73,
+    0xa3, 0x3f, 0xc3, 0x84, 0x23, 0x1e, 0x3a, 0xf8, 0x85, 0x01, 0xf8, 0xbc, 0x1c, 0x7b, 0xbe, 0x2f,
+    0x69, 0x4f, 0x94, 0x5b, 0x2c, 0xae, 0x8b, 0xe0, 0xf7, 0xa2, 0x89, 0xc8, 0x52, 0xb7, 0x96, 0xe9,
+    0x0b, 0x62, 0x72, 0xd1, 0x27, 0x73, 0x63, 0xff, 0xed, 0x16, 0x2c, 0x74, 0x5f, 0xd0, 0xba, 0x96,
+    0x95, 0x49, 0xc2, 0x6e, 0x34, 0x22, 0x52, 0x25, 0x69, 0x50, 0x92, 0xb1, 0x84, 0x14, 0xe6, 0x95,
+    0x1d, 0xb8, 0xe2, 0x36, 0xc0, 0x43, 0x9e, 0x10, 0xd3, 0xb8, 0xb6, 0x2a, 0x84, 0xa4, 0x6c, 0x71,
+    0x2c, 0x29, 0xb7, 0x5e, 0xcb, 0x15, 0xd2, 0x79, 0x04, 0xdf, 0x90, 0x89, 0xfc, 0x5e, 0x2c, 0x0b,
+    0xf6, 0x52, 0xb3, 0x76, 0x8b, 0xa4, 0x1f, 0xce, 0x56, 0xc4, 0x29, 0x35, 0x12, 0x63, 0x8b, 0x0e,
+    0x3e, 0xa4, 0x12, 0x37, 0x6c, 0x3a, 0x35, 0x21, 0x8a, 0x84, 0xdd, 0x10, 0x5d, 0xce, 0xe8, 0x78,
+    0xdf, 0xb9, 0xa1, 0x3b, 0xf5, 0xf4, 0x8a, 0x57, 0x14, 0x05, 0xb8, 0xaf, 0xd9, 0x0a, 0xa8, 0x27,
+    0xe4, 0x2e, 0x37, 0x89, 0xb8, 0x5d, 0xbb, 0x16, 0xe7, 0x89, 0x08, 0x9a, 0x00, 0xe0, 0xae, 0x3a,
+    0x04, 0xc1, 0x0f, 0xb7, 0x45, 0x0c, 0xcc, 0x1d, 0xd1, 0x1d, 0x44, 0xbd, 0x15, 0x57, 0xc2, 0xcd,
+    0x6c, 0x16, 0x35, 0xb5, 0xae, 0xcf, 0x12, 0x4d, 0x6d, 0x21, 0xf4, 0x01, 0x0c, 0xfa, 0x06, 0x1f,
+    0x28, 0x5c, 0xf3, 0xda, 0x6f, 0xc3, 0x3c, 0x82, 0xdd, 0x4a, 0xe2, 0x2e, 0x58, 0xf6, 0x27, 0x5c,
+    0x7e, 0x5f, 0xa4, 0x70, 0xdb, 0xd1, 0x56, 0x0a, 0xba, 0x2c, 0xaa, 0x5d, 0xe8, 0x4d, 0x91, 0xbb,
+    0xa2, 0xcb, 0x36, 0xb8, 0x62, 0xa5, 0x9e, 0x87, 0xc2, 0x48, 0xe3, 0x27, 0x05, 0x42, 0xaa, 0x43,
+    0xcd, 0x5d, 0x1b, 0xe1, 0x47, 0x88, 0x76, 0xa0, 0xa0, 0x1c, 0xf9, 0xf3, 0x19, 0x38, 0x4c, 0x01,
+    0x25, 0xc1, 0x76, 0xfd, 0xc2, 0xa1, 0x9d, 0xf6, 0x20, 0x2b, 0xa6, 0x78, 0x2e, 0x2d, 0x57, 0x30,
+    0xae, 0xe4, 0x5d, 0xae, 0x6e, 0xba, 0xd6, 0xf8, 0x8a, 0x9f, 0x95, 0xc9, 0xd2, 0x7d, 0x27, 0x03,
+    0x35, 0xf8, 0x5e, 0xa2, 0x5f, 0xb5, 0xf1, 0x96, 0x25, 0x5e, 0x43, 0x45, 0x57, 0xac, 0x77, 0x6f,
+    0xb0, 0x52, 0x7e, 0x2f, 0xab, 0x6a, 0xc1, 0x10, 0x24, 0x0e, 0x6f, 0xa7, 0x02, 0x57, 0xfb, 0x7e,
+    0x20, 0x87, 0x44, 0x4c, 0x15, 0xae, 0xeb, 0xa2, 0x3e, 0x43, 0x52, 0xe8, 0x75, 0x41, 0x15, 0x8f,
+    0x99, 0x89, 0x75, 0xc2, 0xd6, 0x55, 0xc2, 0xd1, 0x2e, 0xa6, 0x47, 0xc5, 0xfb, 0xb0, 0xa3, 0x14,
+    0xbd, 0xe2, 0x2d, 0x06, 0xd0, 0x83, 0xac, 0x61, 0x70, 0xba, 0xa4, 0x20, 0xec, 0x26, 0x79, 0x48,
+    0xdc, 0x92, 0x26, 0x7e, 0xd2, 0x5c, 0x0e, 0x34, 0xb0, 0x3d, 0xbf, 0x90, 0x33, 0xa2, 0x6b, 0xff,
+    0x5c, 0x57, 0xb2, 0x78, 0x65, 0x12, 0xd1, 0x2e, 0xc0, 0x15, 0xfe, 0x4d, 0x71, 0xb4, 0x7d, 0x01,
+    0x10, 0xd2, 0xcb, 0x21, 0x0b, 0xc6, 0x83, 0x0b, 0xd4, 0x00, 0xc7, 0x4d, 0x3b, 0xa2, 0xc1, 0x2e,
+    0x44, 0xd6, 0x01, 0xce, 0xad, 0x6b, 0xc1, 0x49, 0xb3, 0x8a, 0x42, 0x12, 0x2d, 0x02, 0xc9, 0x00,
+    0xc1, 0xc0, 0x0e, 0x51, 0x86, 0xe3, 0x5d, 0x41, 0x78, 0x15, 0xcf, 0x4f, 0xd5, 0x49, 0x06, 0xba,
+    0x76, 0x6c, 0xdd, 0x9d, 0x2a, 0x18, 0x0d, 0x5f, 0xdd, 0x42, 0x55, 0x66, 0x61, 0x21, 0x6d, 0x56,
+    0x99, 0x16, 0x1f, 0x1a, 0xc1, 0xad, 0xb4, 0x65, 0xa7, 0xe5, 0xc1, 0xe5, 0xa9, 0x67, 0x02, 0x6e,
+    0x4f, 0xfe, 0xde, 0xae, 0x1a, 0x07, 0xe3, 0xd5, 0x8e, 0x20, 0xe8, 0xc7, 0xce, 0xa9, 0x82, 0x2d,
+    0xe4, 0x20, 0x97, 0xef, 0xe4, 0xf7, 0x89, 0x4e, 0x8a, 0x25, 0x49, 0x6c, 0xe0, 0xd1, 0xe7, 0xed,
+    0xe2, 0xc9, 0xb2, 0x3d, 0x36, 0xb8, 0x0f, 0x76, 0xa8, 0xdf, 0x05, 0x34, 0x9c, 0x0c, 0x3b, 0x83,
+    0xc4, 0xdf, 0xbd, 0x61, 0x57, 0xf4, 0x50, 0x2a, 0x9b, 0x66, 0xf9, 0x2b, 0xcc, 0x7b, 0xa9, 0x2b,
+    0x2d, 0x54, 0xae, 0x81, 0xb3, 0x0d, 0x34, 0x1b, 0xc0, 0x25, 0xdc, 0xea, 0x46, 0x04, 0xc5, 0x73,
+    0x0f, 0x7c, 0x8c, 0xdc, 0x9a, 0x4c, 0x9a, 0x29, 0x64, 0x5e, 0xb9, 0x79, 0x2a, 0xd4, 0x0a, 0xaf,
+    0x38, 0x62, 0x59, 0x73, 0x4f, 0x1e, 0x57, 0xa9, 0xee, 0xa0, 0x2d, 0xd7, 0x51, 0x48, 0x0f, 0x48,
+    0xff, 0x6f, 0x51, 0x21, 0x72, 0xca, 0xd4, 0x03, 0xec, 0xb9, 0x82, 0xe2, 0x02, 0xb6, 0xa1, 0x95,
+    0x16, 0xa3, 0xcb, 0x58, 0x20, 0x3a, 0xb0, 0xc5, 0x3a, 0x5d, 0x48, 0x87, 0x6b, 0x56, 0xf9, 0xba,
+    0x46, 0x6f, 0xd3, 0x0a, 0x0f, 0x0d, 0x1f, 0xed, 0x3e, 0x5a, 0xa3, 0x86, 0xfd, 0x7b, 0x21, 0xa0,
+    0xd8, 0xaa, 0x6e, 0xd9, 0x2c, 0xa0, 0x91, 0x1d, 0x33, 0x6c, 0x68, 0xdf, 0xd1, 0xa2, 0x09, 0xc0,
+    0x4d, 0x2c, 0xea, 0x3a, 0x73, 0xa0, 0xaf, 0xf0, 0xbe, 0x4d, 0x8a, 0xd6, 0xbd, 0x74, 0x10, 0x59,
+    0xdc, 0x7a, 0xe3, 0x01, 0x87, 0x17, 0x65, 0xeb, 0x24, 0xbf, 0xf7, 0xf8, 0x13, 0x27, 0xb5, 0x72,
+    0x66, 0x9d, 0x14, 0x40, 0x9e, 0xf1, 0x3c, 0xef, 0xa1, 0x0d, 0x1c, 0xff, 0x0c, 0xa3, 0xee, 0x36,
+    0x3b, 0x9e, 0x98, 0x86, 0x3b, 0x86, 0xc9, 0x74, 0x20, 0xb8, 0x8e, 0x51, 0x91, 0x95, 0x72, 0x12,
+    0x51, 0xe1, 0x63, 0x35, 0x52, 0x55, 0xd3, 0x66, 0x0d, 0xa9, 0xe3, 0x59, 0x82, 0x49, 0x67, 0x37,
+    0xd5, 0x50, 0x02, 0xa7, 0x2f, 0xa5, 0x9a, 0x90, 0x4a, 0x64, 0x3a, 0x6b, 0x42, 0x7e, 0x1c, 0x36,
+    0x9b, 0x8f, 0xac, 0xb9, 0xaa, 0xda, 0xee, 0x87, 0x82, 0x72, 0xdd, 0x35, 0xf0, 0xd4, 0x98, 0xbe,
+    0x34, 0x48, 0x87, 0x1e, 0x9b, 0xcb, 0xa7, 0xe7, 0x2c, 0x59, 0xa1, 0x76, 0x1f, 0xc6, 0x53, 0x19,
+    0x6e, 0x9c, 0x95, 0x8b, 0x65, 0xd6, 0x4c, 0xcb, 0x6b, 0xac, 0x07, 0x32, 0xaa, 0xa5, 0x4e, 0xbd,
+    0x03, 0x64, 0x77, 0xd3, 0xe4, 0x64, 0x3f, 0xa8, 0xda, 0x79, 0xad, 0x1b, 0xad, 0xd5, 0xa3, 0xd0,
+    0xcd, 0xfb, 0x86, 0xe1, 0x73, 0xce, 0xbd, 0x6a, 0xb9, 0x54, 0x5c, 0x4f, 0xd5, 0x59, 0xbf, 0xd3,
+    0xbb, 0x37, 0x20, 0xda, 0x86, 0x59, 0x68, 0x4f, 0x94, 0x27, 0x3a, 0x6c, 0x79, 0xec, 0x6c, 0x6b,
+    0x63, 0x8c, 0xe4, 0x73, 0x14, 0x01, 0xfe, 0x73, 0x35, 0xd6, 0x09, 0xe9, 0xed, 0xd0, 0x92, 0xe7,
+    0xe7, 0x82, 0x34, 0xaa, 0x5b, 0x45, 0x3d, 0xeb, 0xc7, 0xbb, 0x25, 0x7b, 0x4d, 0xdd, 0x27, 0xdb,
+    0xb3, 0x38, 0xbe, 0xd8, 0xec, 0x5a, 0xc6, 0xe2, 0x2a, 0xfe, 0xe2, 0x40, 0x98, 0xf0, 0x72, 0xd1,
+    0xb4, 0xae, 0x41, 0x79, 0xf0, 0x58, 0xaa, 0x13, 0x37, 0x54, 0x9d, 0x72, 0x68, 0xd5, 0xcf, 0x09,
+    0xbe, 0x53, 0x1c, 0x44, 0x9c, 0x24, 0x9d, 0x68, 0xf3, 0xe7, 0x14, 0x71, 0x7b, 0xfa, 0xb7, 0xd0,
+    0x4c, 0xa6, 0x71, 0x23, 0xa3, 0xed, 0xa4, 0x15, 0x95, 0x29, 0xd1, 0x2b, 0x64, 0x3d, 0x8a, 0xd3,
+    0x48, 0x1a, 0x1a, 0x80, 0x4e, 0xbd, 0xfa, 0x65, 0x03, 0x9b, 0xc1, 0xd3, 0x49, 0xc0, 0x9a, 0xde,
+    0x54, 0xed, 0x34, 0x3f, 0x79, 0x7b, 0x09, 0xf3, 0x8e, 0xac, 0x3a, 0x62, 0x00, 0x90, 0x8d, 0xdb,
+    0xb6, 0xdd, 0xf8, 0xf5, 0xb3, 0x97, 0x33, 0x5c, 0x5a, 0x00, 0x4d, 0xf4, 0xc6, 0xf8, 0x76, 0x38,
+    0xf2, 0x71, 0x01,
+  };
+
+  const uint8_t brotli_text_q11[] = {
+    0x1b, 0x87, 0x13, 0x00, 0x8c, 0x93, 0x54, 0x63, 0xbb, 0x0f, 0x4a, 0xe7, 0xa6, 0xf5, 0xe6, 0xb5,
+    0x43, 0xfb, 0x90, 0x00, 0x4f, 0x82, 0x1a, 0x15, 0x8c, 0xb5, 0xf5, 0xa5, 0x3c, 0x56, 0xd3, 0xf1,
+    0x18, 0x04, 0xcb, 0x27, 0xe1, 0xbf, 0xff, 0xbd, 0xef, 0x8c, 0x44, 0x38, 0xff, 0xe6, 0xdc, 0x3d,
+    0x3f, 0xe5, 0x25, 0xd4, 0xe2, 0x10, 0x06, 0x47, 0xdf, 0x93, 0xfa, 0x89, 0x63, 0xa1, 0xd0, 0x31,
+    0x94, 0xba, 0x1f, 0xf3, 0xb6, 0xb6, 0x0a, 0x24, 0x02, 0xe2, 0xcf, 0xfc, 0xb9, 0xcd, 0xf5, 0x21,
+    0x55, 0x50, 0x8d, 0xa7, 0xc8, 0x38, 0x6b, 0xd8, 0x96, 0x44, 0x62, 0xf0, 0xca, 0x6c, 0xb9, 0xfc,
+    0xfd, 0x73, 0x57, 0xcd, 0x58, 0xf4, 0xb3, 0x1e, 0x57, 0x59, 0xf2, 0x35, 0xcb, 0x1a, 0x71, 0x25,
+    0xf4, 0x3c, 0x3b, 0xfc, 0x02, 0xe7, 0x97, 0x22, 0xb3, 0xfa, 0xdb, 0xfb, 0x77, 0x7f, 0xdf, 0xd7,
+    0x10, 0x88, 0x90, 0xfe, 0x5f, 0xd8, 0xfe, 0x8a, 0x76, 0x75, 0xe7, 0x1c, 0xcc, 0x8f, 0xa0, 0x9e,
+    0x77, 0xac, 0x5d, 0xcd, 0xcf, 0x6f, 0xfc, 0x1f, 0xd0, 0xd8, 0x83, 0xb6, 0x0c, 0x2a, 0x03, 0x72,
+    0xf3, 0xe3, 0xf1, 0xcb, 0xc5, 0x19, 0x53, 0x17, 0x60, 0xcc, 0xa2, 0x0d, 0xbc, 0x57, 0xdf, 0x23,
+    0x17, 0xc3, 0x4a, 0x4e, 0x5f, 0xa8, 0xc7, 0x40, 0x38, 0xe2, 0xa6, 0xc8, 0xdf, 0x38, 0x88, 0x9c,
+    0xda, 0xa2, 0x82, 0x67, 0xd2, 0x1b, 0xd9, 0x17, 0x0e, 0xf8, 0x9f, 0x34, 0x08, 0x91, 0x5c, 0x12,
+    0x74, 0x51, 0x8c, 0x14, 0x7e, 0xf6, 0x32, 0x6e, 0x95, 0x6c, 0x35, 0xb8, 0x0e, 0xb5, 0x6d, 0x65,
+    0x15, 0x9b, 0xeb, 0x19, 0x8b, 0x60, 0xea, 0xd3, 0xac, 0x9f, 0x80, 0x5d, 0x94, 0x06, 0x5e, 0xe1,
+    0x48, 0x2f, 0xd3, 0x16, 0x3d, 0x91, 0x19, 0x35, 0xc5, 0x6b, 0x99, 0x92, 0xd1, 0x85, 0x45, 0x5c,
+    0x46, 0x6f, 0x89, 0x63, 0x29, 0xb0, 0xb9, 0x5f, 0x2e, 0x85, 0x18, 0x39, 0xdb, 0xaf, 0xd2, 0x6f,
+    0x66, 0x6e, 0xb3, 0xd7, 0x90, 0xdc, 0x64, 0x6a, 0xfc, 0x14, 0x8b, 0x10, 0xdc, 0xde, 0xb1, 0x6e,
+    0x62, 0xc4, 0x1e, 0x0e, 0x2c, 0x81, 0xc5, 0x45, 0x7b, 0x33, 0x5a, 0xf6, 0x6b, 0xbd, 0x1d, 0x1b,
+    0x5c, 0xa9, 0xbb, 0x67, 0xb5, 0xa2, 0x6a, 0xd1, 0xbd, 0x87, 0x22, 0xe6, 0xe5, 0x0f, 0x01, 0x9f,
+    0x77, 0xb9, 0x66, 0x49, 0x32, 0x8b, 0x00, 0x84, 0x10, 0xf7, 0x29, 0xe0, 0x3f, 0x97, 0x19, 0x1c,
+    0xce, 0xc5, 0xa8, 0x9c, 0x28, 0x53, 0xd3, 0x83, 0xb7, 0xc6, 0xcc, 0x68, 0xac, 0xde, 0x1e, 0x51,
+    0x1d, 0x6b, 0x97, 0xd2, 0x57, 0x44, 0xba, 0xc9, 0x0f, 0x0b, 0xe7, 0xb5, 0x75, 0x39, 0xf0, 0x42,
+    0x76, 0x19, 0x99, 0xab, 0x11, 0x99, 0x9f, 0xe9, 0x5e, 0xa9, 0x12, 0xde, 0xec, 0x6d, 0x65, 0x60,
+    0xeb, 0xc2, 0xec, 0x62, 0xaf, 0x93, 0xdc, 0x99, 0xdd, 0x02, 0xfc, 0x6e, 0xd6, 0x7d, 0x27, 0x46,
+    0xc0, 0x77, 0x08, 0x38, 0xd4, 0x63, 0xa6, 0x73, 0x63, 0xd6, 0x31, 0xaa, 0x99, 0xd9, 0x4b, 0xb1,
+    0xe4, 0x73, 0x2f, 0x12, 0x3a, 0x81, 0x66, 0x80, 0x97, 0x5e, 0x3c, 0x64, 0xd1, 0x5e, 0x59, 0x9c,
+    0xe6, 0xfe, 0xb2, 0x52, 0xce, 0xa8, 0xe0, 0xcd, 0x4c, 0x8d, 0x2b, 0x8b, 0xcf, 0xba, 0xb7, 0x41,
+    0xc6, 0x76, 0x05, 0x03, 0x16, 0x5c, 0x15, 0xe8, 0xe7, 0x81, 0xef, 0x28, 0x51, 0x0e, 0x5d, 0xe3,
+    0x4a, 0xb4, 0xf7, 0x06, 0x88, 0x2b, 0x69, 0x31, 0xcd, 0x40, 0xf2, 0xbc, 0x2e, 0x33, 0x53, 0xc9,
+    0xec, 0xea, 0x18, 0x62, 0x30, 0x26, 0xec, 0x76, 0xea, 0x31, 0x9a, 0xbc, 0xd7, 0xd9, 0x14, 0xfb,
+    0x0c, 0xbe, 0x9e, 0x99, 0x65, 0x91, 0xd8, 0x2e, 0xa1, 0xc7, 0xfa, 0x3b, 0xe2, 0xd0, 0xc2, 0xe8,
+    0x5c, 0xc2, 0x81, 0x5e, 0x59, 0x6e, 0x70, 0xaf, 0x87, 0x60, 0x70, 0x33, 0xdc, 0x81, 0x5b, 0xda,
+    0x90, 0x17, 0xcb, 0x41, 0x2c, 0xb2, 0x3b, 0xbe, 0x56, 0xcc, 0x30, 0x2e, 0xeb, 0xb3, 0x8b, 0x4c,
+    0x99, 0x89, 0x41, 0x4e, 0xc0, 0xef, 0x6f, 0xcb, 0x97, 0xe3, 0xf0, 0x99, 0x90, 0x35, 0x1e, 0x81,
+    0xa6, 0x91, 0x94, 0x88, 0x30, 0xa3, 0x96, 0x47, 0x47, 0xdc, 0xe4, 0x59, 0x47, 0x2c, 0xee, 0xd6,
+    0x5f, 0x6a, 0x80, 0xf5, 0xca, 0xd2, 0x08, 0x7b, 0xad, 0x35, 0xce, 0x50, 0x88, 0x02, 0x3c, 0x5f,
+    0x8b, 0xc2, 0x73, 0xee, 0xdf, 0x77, 0x27, 0x81, 0xba, 0x12, 0x5c, 0x57, 0xc9, 0x82, 0x23, 0x70,
+    0xed, 0x16, 0xe8, 0x13, 0x17, 0x58, 0xa3, 0x34, 0x8d, 0x1c, 0x40, 0x64, 0x2a, 0x58, 0x1c, 0x96,
+    0xf7, 0x4b, 0x4f, 0xc5, 0x1c, 0xd3, 0x63, 0xe5, 0xd5, 0x4b, 0xc5, 0x0d, 0x84, 0xda, 0x83, 0x62,
+    0x5f, 0x0c, 0xc2, 0x74, 0x98, 0x8b, 0xde, 0xf5, 0x15, 0x81, 0xed, 0x9d, 0xa8, 0xcd, 0x90, 0x71,
+    0x03, 0x1f, 0xd7, 0x3c, 0x4b, 0x4c, 0x94, 0xb9, 0x6c, 0xd0, 0x1a, 0xd8, 0xd5, 0x9f, 0x83, 0x85,
+    0x1d, 0x61, 0xc7, 0x04, 0xbe, 0xf7, 0x06, 0x67, 0x74, 0x34, 0x29, 0x7e, 0xb4, 0x5e, 0xae, 0xf7,
+    0xa6, 0x5d, 0xc9, 0xac, 0xec, 0x3c, 0x76, 0x41, 0x63, 0x02, 0xad, 0xbc, 0xf3, 0xc6, 0x44, 0x8a,
+    0x63, 0x2f, 0x72, 0x7a, 0xf8, 0xef, 0x9b, 0x4c, 0xbf, 0x1a, 0x5e, 0x2d, 0x33, 0x19, 0xca, 0xee,
+    0x35, 0x95, 0x58, 0x99, 0xaa, 0x8d, 0x5d, 0x75, 0x4f, 0xe7, 0xd4, 0xf7, 0xb3, 0x46, 0x17, 0xef,
+    0xa5, 0x41, 0x19, 0x62, 0x0a, 0x99, 0xdc, 0xc8, 0x9c, 0x53, 0xe4, 0x2c, 0xb1, 0xde, 0x4a, 0x4b,
+    0xd0, 0x7b, 0x6e, 0xf3, 0x3b, 0x30, 0x20, 0x6d, 0x0c, 0x87, 0xbd, 0x6f, 0x17, 0x96, 0xde, 0x6d,
+    0xd5, 0xba, 0xd9, 0xfc, 0xf4, 0xec, 0xa3, 0x2c, 0x0a, 0xed, 0xb3, 0x0b, 0x40, 0x54, 0x7d, 0x8d,
+    0x88, 0x58, 0x54, 0x8a, 0x80, 0x6f, 0x9f, 0x56, 0x0e, 0x4f, 0x21, 0xa5, 0xe4, 0xf1, 0x5e, 0x94,
+    0xcd, 0xf5, 0xae, 0x14, 0x23, 0x08, 0x6a, 0xc7, 0xdd, 0x20, 0x13, 0x8f, 0x38, 0xbc, 0x10, 0xad,
+    0x20, 0xd1, 0x1e, 0x7f, 0x59, 0x50, 0xe3, 0x56, 0x3e, 0x29, 0xe4, 0xa5, 0x3f, 0xcc, 0xac, 0x4c,
+    0x35, 0xe7, 0x03, 0x94, 0xba, 0x86, 0xcd, 0x94, 0x71, 0x6b, 0xa5, 0x98, 0x9c, 0x0e, 0x04, 0x3b,
+    0xa5, 0xe2, 0xa2, 0xb3, 0x03, 0x11, 0xf7, 0xf9, 0x3d, 0x47, 0x92, 0x35, 0xbb, 0xd6, 0x58, 0xdc,
+    0x29, 0x4a, 0x02, 0x2b, 0x7a, 0x9c, 0xe0, 0xc7, 0x34, 0x3a, 0xe6, 0x84, 0x31, 0x45, 0xfa, 0xac,
+    0x09, 0x4a, 0xe6, 0x7b, 0x33, 0x03, 0xcd, 0x99, 0x50, 0x96, 0xf1, 0x9d, 0xc3, 0xce, 0x91, 0x49,
+    0xec, 0xcb, 0x82, 0xf1, 0xd0, 0xd3, 0x75, 0x39, 0x3a, 0xac, 0x0b, 0xe3, 0xec, 0x5c, 0x8e, 0x97,
+    0x3f, 0xba, 0xc4, 0xc0, 0xa2, 0x5a, 0x56, 0x59, 0x1f, 0x66, 0xa0, 0x49, 0xa3, 0xe5, 0x20, 0xde,
+    0x4d, 0xf9, 0x7a, 0xc5, 0x41, 0x95, 0xcb, 0x21, 0x4c, 0xf9, 0xc8, 0xdb, 0x44, 0x2e, 0x34, 0x3f,
+    0xbf, 0xbb, 0x99, 0x11, 0x79, 0x49, 0xee, 0xbb, 0xb3, 0xce, 0x7b, 0xb7, 0x09, 0x61, 0x5a, 0x6a,
+    0x21, 0x57, 0x94, 0xc4, 0x1a, 0x06, 0x46, 0x99, 0xd1, 0x8e, 0x3e, 0x32, 0x9f, 0xa3, 0x20, 0xf8,
+    0x61, 0x37, 0xd6, 0x76, 0x69, 0x44, 0xb0, 0x25, 0xe8, 0x5c, 0x80, 0x3c, 0x17, 0xd7, 0x89, 0x8c,
+    0xe1, 0xb6, 0xb7, 0x64, 0xe5, 0x54, 0x9f, 0x6c, 0x5b, 0x1f, 0xed, 0xae, 0x5d, 0x0b, 0x6c, 0x7a,
+    0xe3, 0x2f, 0x0e, 0xb8, 0xc2, 0x9b, 0x93, 0x66, 0xda, 0xe2, 0x29, 0x2b, 0x36, 0xe5, 0x89, 0x0b,
+    0xb3, 0xd3, 0xec, 0x5a, 0xf5, 0x7e, 0xa2, 0xef, 0x1e, 0x07, 0x11, 0x0d, 0x19, 0x4e, 0xb4, 0xf3,
+    0x23, 0xcd, 0x2b, 0xab, 0x7f, 0xac, 0x99, 0xa1, 0xf9, 0x04, 0x5f, 0x4c, 0xc0, 0x0f, 0x29, 0x5a,
+    0x2e, 0x2b, 0x2f, 0x9e, 0x4a, 0x52, 0x6f, 0x00, 0x9c, 0x7a, 0xd7, 0xab, 0x6a, 0xf0, 0xe9, 0x24,
+    0x40, 0xe6, 0x2a, 0xb1, 0xf6, 0x4c, 0xd7, 0x25, 0xc6, 0xe3, 0x5f, 0x47, 0x22, 0xb5, 0x4f, 0xe1,
+    0x6c, 0x6c, 0xde, 0xf8, 0x79, 0xaf, 0x74, 0x96, 0x6e, 0x3b, 0x50, 0x7b, 0xef, 0xec, 0xdf, 0xff,
+    0x68, 0x1d, 0x17, 0x00,
+  };
+
+  const uint8_t brotli_noise_q5[] = {
+    0x70, 0x25, 0x10, 0x3c, 0x5e, 0x81, 0xb4, 0x0c, 0x5e, 0xc6, 0x8e, 0x04, 0xa3, 0x40, 0x6c, 0x97,
+    0xd6, 0x3c, 0xfb, 0xdc, 0x53, 0xae, 0x88, 0x37, 0x1a, 0x12, 0x51, 0x21, 0xb5, 0x95, 0x61, 0x43,
+    0xc0, 0xee, 0x2d, 0x55, 0xfb, 0x63, 0x8c, 0x77, 0xfe, 0xe0, 0xb6, 0xf5, 0xf9, 0x27, 0x5f, 0xaf,
+    0x29, 0x7e, 0x2c, 0x97, 0xdf, 0x54, 0x04, 0xf3, 0x3b, 0xd4, 0x06, 0x62, 0x0b, 0x58, 0x21, 0xcf,
+    0x68, 0x25, 0x9c, 0xcb, 0xee, 0x02, 0x07, 0xff, 0xcd, 0x74, 0x64, 0xab, 0xf7, 0xbb, 0x7d, 0x6a,
+    0x25, 0xe6, 0xbf, 0xa2, 0x94, 0x89, 0x0d, 0x6b, 0x90, 0xf2, 0x56, 0xc6, 0x46, 0xe9, 0xf0, 0x6e,
+    0x6e, 0x5a, 0x05, 0xa9, 0xbf, 0x71, 0x7f, 0xd7, 0x48, 0x00, 0x59, 0xa9, 0x14, 0x4b, 0x37, 0x3e,
+    0xc5, 0x80, 0x9d, 0x93, 0xfb, 0x7a, 0x4c, 0xfc, 0xb8, 0xa0, 0x73, 0x99, 0x1e, 0xf0, 0xd3, 0x02,
+    0x31, 0x8f, 0x04, 0x8f, 0x79, 0x74, 0x71, 0x04, 0xae, 0xf3, 0xbc, 0x81, 0xce, 0x59, 0xa3, 0xf7,
+    0x4c, 0xc7, 0x95, 0x94, 0x23, 0x06, 0x90, 0xd6, 0x14, 0x0a, 0xf5, 0x39, 0x52, 0x4b, 0x6f, 0xc0,
+    0x54, 0x3d, 0x1a, 0xb1, 0xac, 0x85, 0x7c, 0x62, 0x03, 0xb3, 0x15, 0xdd, 0xa6, 0x9c, 0x7b, 0xb4,
+    0x3d, 0xae, 0x59, 0x62, 0x9d, 0xc1, 0xcc, 0xfc, 0xcc, 0x4e, 0xd8, 0x19, 0xa6, 0x09, 0x12, 0x30,
+    0xbe, 0x4e, 0xaa, 0xd7, 0x6a, 0xd4, 0x66, 0x9f, 0x0f, 0x97, 0x51, 0x7a, 0x1f, 0x00, 0x1c, 0xe7,
+    0x63, 0x99, 0x80, 0x4e, 0x7f, 0xf3, 0x16, 0x46, 0xc9, 0x7d, 0x7a, 0xbf, 0xde, 0x71, 0xab, 0x30,
+    0x9a, 0x22, 0xfe, 0x5c, 0x4d, 0x41, 0x18, 0x3b, 0x60, 0xec, 0xc2, 0x28, 0xc2, 0xa3, 0x89, 0x59,
+    0xc9, 0x63, 0x83, 0x3f, 0x61, 0x99, 0xab, 0x62, 0xb8, 0xa0, 0x9f, 0xc6, 0xc7, 0xfb, 0xce, 0xf2,
+    0x57, 0x8d, 0x40, 0x2f, 0x6f, 0x62, 0x9e, 0x8e, 0x43, 0xf3, 0x1d, 0xcb, 0x1c, 0xd7, 0x68, 0x24,
+    0xc2, 0x58, 0xc2, 0xad, 0x62, 0x61, 0xe7, 0xcf, 0x0d, 0xaf, 0x6e, 0xdc, 0x2f, 0x55, 0xb2, 0xfa,
+    0xa9, 0xd5, 0x83, 0xd4, 0x6f, 0x82, 0x2a, 0xc2, 0xce, 0xdf, 0x7b, 0x5d, 0xbd, 0x25, 0x01, 0xb7,
+    0xe1, 0x3a, 0x7d, 0xa8, 0x23, 0xaf, 0x4f, 0xe2, 0xfc, 0x9a, 0x73, 0xc5, 0xe7, 0x5d, 0x34, 0x21,
+    0x85, 0xb6, 0xb9, 0x64, 0x72, 0x9e, 0x0f, 0xd5, 0xd9, 0xd9, 0x5a, 0xea, 0x3a, 0x46, 0x43, 0xd6,
+    0x01, 0x3f, 0xdc, 0xd0, 0xc9, 0x9d, 0x88, 0xc2, 0x81, 0x43, 0x9d, 0x56, 0xc7, 0x2b, 0xd3, 0x96,
+    0x28, 0x60, 0xbc, 0x89, 0x1e, 0x68, 0xc7, 0x99, 0xff, 0xfe, 0x9b, 0x93, 0x2c, 0x2b, 0xc0, 0x97,
+    0x3e, 0x0f, 0xe9, 0x5a, 0xff, 0xf5, 0x5e, 0x6b, 0x58, 0x80, 0x3e, 0x7b, 0xa9, 0x07, 0xb2, 0xd7,
+    0x0f, 0x76, 0x47, 0x84, 0xa0, 0x46, 0xef, 0xb4, 0xa0, 0x5e, 0x83, 0x8c, 0x2e, 0xf5, 0xad, 0x67,
+    0xfa, 0xc8, 0x92, 0x12, 0xf1, 0x37, 0xc0, 0xae, 0x05, 0x1b, 0x0f, 0x32, 0x6c, 0x6d, 0x9b, 0xbc,
+    0xff, 0x0f, 0xfa, 0x28, 0xa7, 0x52, 0x47, 0xa1, 0xe1, 0xfd, 0xbc, 0x1e, 0xe2, 0xfb, 0xe4, 0x03,
+    0xd8, 0xfc, 0xaa, 0x54, 0x51, 0x98, 0xbf, 0x2f, 0xcd, 0xd4, 0x2a, 0x8f, 0xf1, 0x0e, 0xf8, 0x6d,
+    0xff, 0xb7, 0x5b, 0xdc, 0x66, 0x5a, 0xb4, 0xad, 0xaa, 0xd3, 0x52, 0xa6, 0xeb, 0xc9, 0xe3, 0x80,
+    0xc3, 0xb0, 0xe6, 0x12, 0x55, 0x00, 0x94, 0x67, 0xba, 0x5c, 0x0f, 0xb6, 0x21, 0xd0, 0xda, 0x67,
+    0x58, 0x6d, 0xd1, 0x9d, 0x95, 0xdf, 0x3f, 0xfa, 0xa7, 0xce, 0xb7, 0x94, 0xf3, 0x1d, 0xcc, 0x44,
+    0xe7, 0x5d, 0xe1, 0xd1, 0xb6, 0x09, 0x98, 0xa0, 0x9a, 0x5a, 0xa2, 0xe4, 0xe5, 0xcc, 0xf3, 0x7c,
+    0x9b, 0xa5, 0xa9, 0xfa, 0x70, 0x19, 0x15, 0x80, 0x47, 0xce, 0xc0, 0x6d, 0xa6, 0xeb, 0x64, 0x0a,
+    0xb5, 0xf1, 0x19, 0xac, 0xb2, 0x05, 0x4b, 0xfc, 0xff, 0x68, 0x29, 0x67, 0x2b, 0x4d, 0x9c, 0xd0,
+    0x9a, 0x46, 0x12, 0x16, 0xb6, 0xf0, 0x86, 0x07, 0xbf, 0xa6, 0xa7, 0xca, 0xb5, 0x58, 0x15, 0xe3,
+    0xe3, 0xce, 0xf1, 0x4f, 0x0b, 0xf7, 0x50, 0x6f, 0x40, 0x15, 0x4f, 0xa1, 0xe7, 0xd6, 0xd1, 0xdd,
+    0x6d, 0xab, 0x22, 0xa9, 0xaa, 0x02, 0x07, 0x2f, 0x07, 0x20, 0x09, 0x57, 0xd4, 0xc1, 0xee, 0x30,
+    0x69, 0xc8, 0xaf, 0xfe, 0x05, 0x96, 0x6c, 0xc0, 0x76, 0xe3, 0x24, 0x03,
+  };
+}
+
+#endif
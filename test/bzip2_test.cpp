@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// bzip2_decoder and parallel_bzip2_decoder on streams made by another encoder:
+// the parallel decoder must match the serial one for any number of threads and
+// both must fail on corrupt or truncated input.
+//
+
+#include <andyzip/bzip2_decoder.hpp>
+#include <andyzip/parallel_bzip2_decoder.hpp>
+
+#include "bzip2_test_data.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+
+namespace {
+  std::vector<uint8_t> periodic() {
+    std::vector<uint8_t> period = andyzip_test::noise(997, 1);
+    std::fill(period.begin() + 100, period.begin() + 400, 'a');
+    std::vector<uint8_t> result;
+    for (int i = 0; i != 251; ++i) result.insert(result.end(), period.begin(), period.end());
+    return result;
+  }
+
+  std::vector<uint8_t> letters() {
+    std::vector<uint8_t> result = andyzip_test::noise(5000, 7);
+    for (auto &b : result) b = (uint8_t)('a' + (b & 3));
+    return result;
+  }
+
+  // Decode with the serial decoder and the parallel one on 1, 2, 4 and 8 threads.
+  // Returns false if they do not all give expected, or all fail if expected is empty.
+  bool decodes_to(const std::vector<uint8_t> &src, const std::vector<uint8_t> &expected) {
+    const uint8_t *src_max = src.data() + src.size();
+    bool ok = true;
+    {
+      std::vector<uint8_t> out = andyzip_test::bytes("prefix");
+      const uint8_t *end = andyzip::bzip2_decoder().decode_append(out, src.data(), src_max);
+      ok &= expected.empty() ? !end && out.size() == 6 : end == src_max && std::equal(expected.begin(), expected.end(), out.begin() + 6);
+    }
+    for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+      std::vector<uint8_t> out = andyzip_test::bytes("prefix");
+      const uint8_t *end = andyzip::parallel_bzip2_decoder(threads).decode_append(out, src.data(), src_max);
+      ok &= expected.empty() ? !end && out.size() == 6 : end == src_max && out.size() == expected.size() + 6 && std::equal(expected.begin(), expected.end(), out.begin() + 6);
+    }
+    return ok;
+  }
+}
+
+int main() {
+  using andyzip_test::bzip2_periodic;
+  using andyzip_test::bzip2_letters;
+
+  std::vector<uint8_t> a(bzip2_periodic, bzip2_periodic + sizeof(bzip2_periodic));
+  std::vector<uint8_t> b(bzip2_letters, bzip2_letters + sizeof(bzip2_letters));
+  std::vector<uint8_t> expected_a = periodic(), expected_b = letters();
+
+  CHECK(andyzip::bzip2_decoder::block_size(a.data(), a.data() + a.size()) == 100000);
+  CHECK(andyzip::bzip2_decoder::block_size(b.data(), b.data() + b.size()) == 900000);
+  CHECK(decodes_to(a, expected_a));
+  CHECK(decodes_to(b, expected_b));
+
+  // concatenated streams with different block sizes decode as one.
+  {
+    std::vector<uint8_t> ab = a, expected_ab = expected_a;
+    ab.insert(ab.end(), b.begin(), b.end());
+    expected_ab.insert(expected_ab.end(), expected_b.begin(), expected_b.end());
+    CHECK(decodes_to(ab, expected_ab));
+    ab.insert(ab.end(), a.begin(), a.end());
+    expected_ab.insert(expected_ab.end(), expected_a.begin(), expected_a.end());
+    CHECK(decodes_to(ab, expected_ab));
+  }
+
+  // a flipped bit in the middle of the data fails the block CRC or the decode.
+  for (size_t pos : { a.size() / 3, a.size() / 2, a.size() * 3 / 4 }) {
+    std::vector<uint8_t> bad = a;
+    bad[pos] ^= 0x10;
+    CHECK(decodes_to(bad, std::vector<uint8_t>()));
+  }
+
+  // a wrong stream CRC.
+  {
+    std::vector<uint8_t> bad = b;
+    bad[bad.size() - 2] ^= 0x01;
+    CHECK(decodes_to(bad, std::vector<uint8_t>()));
+  }
+
+  // truncated streams.
+  for (size_t size : { (size_t)3, (size_t)20, a.size() / 2, a.size() - 1 }) {
+    CHECK(decodes_to(std::vector<uint8_t>(a.begin(), a.begin() + size), std::vector<uint8_t>()));
+  }
+
+  return andyzip_test::result();
+}
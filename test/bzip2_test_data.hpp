@@ -0,0 +1,370 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// bzip2 streams made by Python's bz2 module for bzip2_test.cpp:
+//
+//   def noise(size, seed):
+//       out = bytearray()
+//       for i in range(size):
+//           seed = (seed * 1664525 + 1013904223) & 0xffffffff
+//           out.append(seed >> 24)
+//       return bytes(out)
+//   period = bytearray(noise(997, 1))
+//   period[100:400] = b'a' * 300
+//   periodic = bz2.compress(bytes(period) * 251, 1)    # two blocks
+//   letters = bz2.compress(bytes(ord('a') + (b & 3) for b in noise(5000, 7)), 9)
+//
+
+#ifndef ANDYZIP_BZIP2_TEST_DATA_HPP_
+#define ANDYZIP_BZIP2_TEST_DATA_HPP_
+
+#include <cstdint>
+
+namespace andyzip_test {
+  const uint8_t bzip2_periodic[] = {
+    0x42, 0x5a, 0x68, 0x31, 0x31, 0x41, 0x59, 0x26, 0x53, 0x59, 0xe0, 0x24, 0xb5, 0xcf, 0x00, 0x2c,
+    0x75, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xbf, 0x77, 0xff, 0xf9, 0x9f, 0xdf, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xef, 0xf7, 0xfd, 0xff, 0xdf, 0xff, 0xff, 0xf7, 0xff, 0xef, 0xff, 0xff, 0x7f, 0xff,
+    0xbd, 0x7f, 0xff, 0xe0, 0x0e, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x0d, 0x0d, 0x00, 0x1a, 0x00, 0x00, 0x00, 0xd0, 0x68, 0x00,
+    0x03, 0x40, 0x00, 0x00, 0x00, 0x1a, 0x00, 0xd0, 0x00, 0x0d, 0x00, 0x00, 0x1a, 0x00, 0x00, 0x00,
+    0x00, 0xc9, 0x91, 0xa0, 0x00, 0x00, 0x00, 0x06, 0x80, 0x01, 0x00, 0x00, 0x68, 0x68, 0x00, 0xd0,
+    0x00, 0x00, 0x06, 0x83, 0x40, 0x00, 0x1a, 0x00, 0x00, 0x00, 0x00, 0xd0, 0x06, 0x80, 0x00, 0x68,
+    0x00, 0x00, 0xd0, 0x00, 0x00, 0x00, 0x06, 0x4c, 0x8d, 0x00, 0x00, 0x00, 0x00, 0x34, 0x00, 0x08,
+    0x00, 0x03, 0x43, 0x40, 0x06, 0x80, 0x00, 0x00, 0x34, 0x1a, 0x00, 0x00, 0xd0, 0x00, 0x00, 0x00,
+    0x06, 0x80, 0x34, 0x00, 0x03, 0x40, 0x00, 0x06, 0x80, 0x00, 0x00, 0x00, 0x32, 0x64, 0x68, 0x00,
+    0x00, 0x00, 0x01, 0xa0, 0x00, 0x40, 0x00, 0x1a, 0x1a, 0x00, 0x34, 0x00, 0x00, 0x01, 0xa0, 0xd0,
+    0x00, 0x06, 0x80, 0x00, 0x00, 0x00, 0x34, 0x01, 0xa0, 0x00, 0x1a, 0x00, 0x00, 0x34, 0x00, 0x00,
+    0x00, 0x01, 0x93, 0x23, 0x40, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x02, 0x00, 0x00, 0xd0, 0xd0, 0x01,
+    0xa0, 0x00, 0x00, 0x0d, 0x06, 0x80, 0x00, 0x34, 0x00, 0x00, 0x00, 0x01, 0xa0, 0x0d, 0x00, 0x00,
+    0xd0, 0x00, 0x01, 0xa0, 0x00, 0x00, 0x00, 0x0c, 0x99, 0x1a, 0x00, 0x00, 0x00, 0x00, 0x68, 0x00,
+    0x02, 0x95, 0x55, 0x46, 0x8d, 0x1a, 0x4f, 0x48, 0xd9, 0x27, 0xa3, 0x50, 0x7a, 0x27, 0xa8, 0xc9,
+    0x8d, 0x02, 0x61, 0xa0, 0x27, 0xa4, 0x69, 0xea, 0x3f, 0x48, 0xd4, 0xc1, 0xa0, 0xca, 0x6d, 0x0d,
+    0x13, 0x4f, 0x44, 0x69, 0x89, 0x82, 0x69, 0x89, 0x84, 0xd3, 0xd4, 0xda, 0x9a, 0x36, 0xa6, 0x13,
+    0x4f, 0x46, 0x93, 0xd0, 0xd0, 0x02, 0x64, 0xda, 0x98, 0xd1, 0xa0, 0x99, 0x1e, 0x81, 0x34, 0x60,
+    0x04, 0xc1, 0x34, 0xd9, 0x1a, 0x06, 0xa7, 0x82, 0x9e, 0x4c, 0xa1, 0xd7, 0x4a, 0x1c, 0x0a, 0xa1,
+    0xb4, 0xca, 0x1d, 0x3c, 0xa1, 0xa9, 0x94, 0x3b, 0x15, 0x43, 0x48, 0xa8, 0x62, 0x25, 0x0d, 0x7e,
+    0x50, 0xf6, 0x95, 0x0e, 0xae, 0x50, 0xcd, 0x2a, 0x19, 0x35, 0x43, 0xb7, 0x54, 0x3b, 0xaa, 0x50,
+    0xd5, 0x4a, 0x19, 0x65, 0x43, 0xce, 0x54, 0x32, 0x52, 0x86, 0x39, 0x50, 0xd8, 0xd5, 0x0f, 0x06,
+    0x50, 0xd8, 0x65, 0x0e, 0x91, 0x50, 0xf6, 0xa5, 0x0d, 0x69, 0x50, 0xdf, 0xa5, 0x0d, 0x1c, 0xa1,
+    0xc7, 0x4a, 0x1b, 0xc4, 0xa1, 0xbb, 0x2a, 0x19, 0x99, 0x43, 0x40, 0xa8, 0x69, 0xa5, 0x0f, 0x06,
+    0x50, 0xe5, 0x95, 0x0c, 0x7c, 0xa1, 0xca, 0xaa, 0x1b, 0x8c, 0xa1, 0xc6, 0xaa, 0x1d, 0xfa, 0xa1,
+    0x95, 0x94, 0x36, 0x09, 0x43, 0xf8, 0x2a, 0x1a, 0x09, 0x43, 0x55, 0x28, 0x7c, 0x2a, 0x86, 0xe7,
+    0x28, 0x63, 0xd5, 0x0d, 0x1c, 0xa1, 0x88, 0x54, 0x38, 0x19, 0x43, 0x56, 0xa8, 0x66, 0xa5, 0x0d,
+    0xae, 0x50, 0xf4, 0xe5, 0x0e, 0xf6, 0x50, 0xc3, 0xca, 0x1c, 0x72, 0xa1, 0x91, 0x54, 0x3d, 0xe5,
+    0x43, 0x8b, 0x94, 0x31, 0x2a, 0x87, 0xaf, 0x28, 0x6f, 0x12, 0x86, 0x5d, 0x50, 0xe0, 0x15, 0x0d,
+    0x8a, 0x50, 0xe6, 0x55, 0x0d, 0x4c, 0xa1, 0x92, 0x94, 0x36, 0x89, 0x43, 0x82, 0x94, 0x37, 0xf5,
+    0x43, 0x21, 0x28, 0x74, 0x8a, 0x87, 0x81, 0x28, 0x6c, 0x8a, 0x86, 0x5d, 0x50, 0xe0, 0x65, 0x0e,
+    0x1e, 0x50, 0xdf, 0xa5, 0x0c, 0xcc, 0xa1, 0xbf, 0x2a, 0x1c, 0x9c, 0xa1, 0xf7, 0x25, 0x0d, 0xe6,
+    0x50, 0xc0, 0x94, 0x3b, 0xe9, 0x43, 0x95, 0x94, 0x34, 0xca, 0x87, 0x92, 0xa8, 0x6b, 0xca, 0x87,
+    0x36, 0xa8, 0x62, 0x55, 0x0d, 0xd9, 0x50, 0xf1, 0x15, 0x0d, 0x2c, 0xa1, 0xc2, 0x4a, 0x1c, 0x44,
+    0xa1, 0xc9, 0x4a, 0x1d, 0x22, 0xa1, 0x9a, 0x54, 0x35, 0x99, 0x43, 0xb9, 0x94, 0x31, 0x6a, 0x87,
+    0xa7, 0x28, 0x6c, 0xd2, 0x86, 0xcd, 0x28, 0x75, 0xb2, 0x86, 0xa9, 0x50, 0xdc, 0xa5, 0x0c, 0xd2,
+    0xa1, 0x90, 0x94, 0x30, 0xaa, 0x87, 0x6b, 0x28, 0x68, 0x95, 0x0d, 0xaa, 0x50, 0xfc, 0xb2, 0x86,
+    0x49, 0x50, 0xd5, 0x4a, 0x1b, 0x74, 0xa1, 0xbb, 0xca, 0x1d, 0x14, 0xa1, 0xd4, 0xaa, 0x18, 0xd9,
+    0x43, 0xfa, 0x4a, 0x1d, 0x9a, 0xa1, 0xb4, 0xaa, 0x1c, 0xe4, 0xa1, 0xae, 0x4a, 0x1a, 0x79, 0x43,
+    0xf9, 0x4a, 0x1b, 0x3a, 0xa1, 0xc1, 0xca, 0x1f, 0xba, 0x50, 0xf3, 0x55, 0x0d, 0x66, 0x50, 0xd7,
+    0x65, 0x0d, 0xd2, 0x50, 0xda, 0xa5, 0x0e, 0x02, 0x50, 0xd8, 0xe5, 0x0f, 0x1a, 0x50, 0xeb, 0xa5,
+    0x0d, 0xd5, 0x50, 0xc7, 0xca, 0x18, 0x59, 0x43, 0xb5, 0x94, 0x3a, 0x09, 0x43, 0xc5, 0x94, 0x33,
+    0xea, 0x86, 0xf4, 0xa8, 0x6b, 0x52, 0x86, 0xb7, 0x28, 0x65, 0xe5, 0x0f, 0xd5, 0x28, 0x6e, 0xaa,
+    0x86, 0xcd, 0x28, 0x70, 0x9b, 0x5c, 0xa1, 0xbe, 0x2a, 0x1f, 0x5d, 0x28, 0x74, 0x52, 0x87, 0x77,
+    0x28, 0x7c, 0x0a, 0x87, 0x66, 0xa8, 0x7f, 0x75, 0x43, 0x1b, 0x28, 0x69, 0x25, 0x0c, 0xac, 0xa1,
+    0x81, 0x28, 0x7c, 0xd9, 0x43, 0x72, 0x54, 0x32, 0x72, 0x86, 0x3e, 0x50, 0xed, 0x25, 0x0d, 0xca,
+    0x50, 0xf6, 0x55, 0x0c, 0x54, 0xa1, 0xcf, 0x4a, 0x1e, 0x32, 0xa1, 0x8c, 0x94, 0x3d, 0x65, 0x43,
+    0x35, 0x28, 0x67, 0x55, 0x0e, 0xf9, 0x50, 0xed, 0x25, 0x0e, 0x26, 0x50, 0xe1, 0x25, 0x0e, 0xfa,
+    0x50, 0xfe, 0xb2, 0x87, 0x6b, 0x28, 0x6b, 0x92, 0x87, 0xbd, 0x28, 0x6c, 0x4a, 0x86, 0x9e, 0x50,
+    0xf2, 0x65, 0x0f, 0xf7, 0x28, 0x67, 0xa5, 0x0d, 0xbd, 0x50, 0xd0, 0xca, 0x1e, 0x94, 0xa1, 0x81,
+    0x28, 0x6e, 0x0a, 0x87, 0x63, 0x28, 0x75, 0x2a, 0x87, 0x0b, 0x28, 0x73, 0x4a, 0x86, 0xb1, 0x28,
+    0x7a, 0x52, 0x87, 0x9b, 0x28, 0x71, 0xea, 0x87, 0x8d, 0x28, 0x66, 0x55, 0x0e, 0xe2, 0x50, 0xe9,
+    0x95, 0x0e, 0xc6, 0x50, 0xd1, 0xaa, 0x1d, 0x1c, 0xa1, 0xe0, 0x4a, 0x1a, 0x55, 0x43, 0x6c, 0x94,
+    0x31, 0xaa, 0x86, 0xec, 0xa8, 0x61, 0x55, 0x0e, 0xca, 0x50, 0xec, 0xd5, 0x0c, 0x34, 0xa1, 0xbf,
+    0xca, 0x1d, 0x4c, 0xa1, 0x92, 0x54, 0x3b, 0x89, 0x43, 0x7b, 0x94, 0x3d, 0x35, 0x43, 0x71, 0x54,
+    0x38, 0x75, 0x43, 0xeb, 0x4a, 0x1e, 0x04, 0xa1, 0xb6, 0xca, 0x1d, 0x5c, 0xa1, 0xc0, 0x2a, 0x1e,
+    0x14, 0xa1, 0xba, 0xaa, 0x1e, 0x0a, 0xa1, 0xde, 0x4a, 0x1e, 0xdc, 0xa1, 0xea, 0xaa, 0x18, 0xa9,
+    0x43, 0x18, 0xa8, 0x65, 0xa5, 0x0e, 0x2a, 0x50, 0xf9, 0x15, 0x0e, 0x5e, 0x50, 0xcf, 0xaa, 0x1d,
+    0xa2, 0xa1, 0x8a, 0x54, 0x30, 0x92, 0x87, 0xaf, 0x28, 0x6f, 0x8a, 0x87, 0x9a, 0xa8, 0x6b, 0x05,
+    0x43, 0x56, 0xa8, 0x62, 0x15, 0x0d, 0x65, 0x24, 0xbb, 0x65, 0x43, 0x04, 0xa8, 0x78, 0x92, 0x86,
+    0x9d, 0x50, 0xf2, 0x15, 0x0c, 0xd4, 0xa1, 0xd4, 0xca, 0x1c, 0x44, 0xa1, 0x85, 0x94, 0x36, 0xd5,
+    0x43, 0x11, 0x28, 0x72, 0xb2, 0x87, 0x73, 0x28, 0x72, 0x8a, 0x86, 0x51, 0x50, 0xc8, 0xaa, 0x1e,
+    0xfa, 0xa1, 0x93, 0x54, 0x30, 0x52, 0x87, 0x69, 0x28, 0x7b, 0x32, 0x86, 0x6e, 0x50, 0xdb, 0xa5,
+    0x0e, 0x5e, 0x50, 0xe1, 0xe5, 0x0f, 0x22, 0x50, 0xf0, 0xe5, 0x0c, 0x6a, 0xa1, 0xb9, 0xca, 0x1e,
+    0x74, 0xa1, 0xb2, 0xca, 0x1d, 0xec, 0xa1, 0x9c, 0x54, 0x33, 0xf2, 0x87, 0x22, 0xa8, 0x66, 0xd5,
+    0x0f, 0x4a, 0x50, 0xf7, 0x65, 0x0c, 0xba, 0xa1, 0xff, 0x15, 0x0f, 0x8d, 0x50, 0xe9, 0xd5, 0x0e,
+    0x19, 0x50, 0xeb, 0x25, 0x0d, 0xe5, 0x50, 0xe2, 0x55, 0x0c, 0xe4, 0xa1, 0x98, 0x54, 0x3d, 0x59,
+    0x43, 0xf6, 0xaa, 0x1f, 0x32, 0x50, 0xde, 0xa5, 0x0c, 0xc2, 0xa1, 0xc9, 0x4a, 0x1a, 0x89, 0x43,
+    0x4a, 0xa8, 0x78, 0xf2, 0x87, 0x9f, 0x28, 0x61, 0xe5, 0x0d, 0x44, 0xa1, 0x8a, 0x94, 0x34, 0xd2,
+    0x86, 0x0e, 0x50, 0xd9, 0x15, 0x0c, 0x44, 0xa1, 0xdc, 0xca, 0x18, 0xc9, 0x43, 0xb7, 0x94, 0x38,
+    0xa9, 0x43, 0xca, 0x94, 0x38, 0x39, 0x43, 0x6a, 0x94, 0x37, 0x09, 0x43, 0xa1, 0x54, 0x32, 0xd2,
+    0x87, 0x11, 0x28, 0x73, 0xb2, 0x86, 0x96, 0x50, 0xf7, 0x95, 0x0c, 0x1a, 0xa1, 0xdb, 0x4a, 0x1e,
+    0x64, 0xa1, 0x86, 0x94, 0x35, 0x32, 0x86, 0x4d, 0x50, 0xfb, 0x32, 0x87, 0x22, 0xa8, 0x76, 0x0a,
+    0x87, 0x34, 0xa8, 0x65, 0x65, 0x0f, 0xe7, 0x28, 0x71, 0x92, 0x86, 0x92, 0x50, 0xcb, 0x4a, 0x1b,
+    0x6a, 0xa1, 0x97, 0x94, 0x33, 0xb2, 0x86, 0x3d, 0x50, 0xd6, 0xa5, 0x0c, 0x05, 0x43, 0x11, 0x28,
+    0x67, 0xa5, 0x0d, 0xc2, 0x50, 0xf8, 0x65, 0x0f, 0x62, 0x50, 0xf5, 0x95, 0x0f, 0x6e, 0x50, 0xe8,
+    0x95, 0x0c, 0x54, 0xa1, 0xf8, 0x55, 0x0c, 0x82, 0xa1, 0xff, 0xa5, 0x0d, 0x04, 0xa1, 0x9b, 0x94,
+    0x36, 0x19, 0x43, 0x5b, 0x94, 0x33, 0xd2, 0x86, 0x2d, 0x50, 0xce, 0x2a, 0x1b, 0x5c, 0xa1, 0xb2,
+    0xaa, 0x18, 0xc5, 0x43, 0xe7, 0xca, 0x1a, 0x45, 0x43, 0x45, 0x28, 0x66, 0x65, 0x0c, 0x24, 0xa1,
+    0xea, 0x4a, 0x19, 0x05, 0x43, 0x16, 0xa8, 0x6f, 0x72, 0x87, 0x4b, 0x28, 0x64, 0xe5, 0x0c, 0xec,
+    0xa1, 0xb3, 0xaa, 0x1d, 0x7a, 0xa1, 0xe6, 0x2a, 0x1e, 0xf2, 0xa1, 0xb2, 0xaa, 0x1c, 0xfa, 0xa1,
+    0x89, 0x94, 0x31, 0x32, 0x87, 0x4c, 0xa8, 0x6c, 0x6a, 0x86, 0xaa, 0x50, 0xe6, 0x15, 0x0e, 0x82,
+    0x50, 0xf9, 0x25, 0x0f, 0x26, 0x50, 0xde, 0xa5, 0x0c, 0x8c, 0xa1, 0xd6, 0xca, 0x1e, 0x34, 0xa1,
+    0xa3, 0x94, 0x31, 0xaa, 0x86, 0x04, 0xa1, 0xe0, 0xaa, 0x19, 0x05, 0x43, 0xd1, 0x94, 0x32, 0x4a,
+    0x87, 0x46, 0xa8, 0x79, 0xea, 0x87, 0x35, 0x28, 0x7d, 0xf9, 0x43, 0xe8, 0x4a, 0x18, 0xc9, 0x43,
+    0xa8, 0x94, 0x38, 0x89, 0x43, 0x1f, 0x28, 0x69, 0x55, 0x0d, 0x44, 0xa1, 0xa3, 0x94, 0x30, 0xaa,
+    0x86, 0x04, 0xa1, 0xe2, 0xca, 0x1f, 0x4d, 0x50, 0xeb, 0x55, 0x0e, 0x72, 0x50, 0xf3, 0x55, 0x0c,
+    0xfa, 0xa1, 0xb7, 0x2a, 0x1a, 0xf4, 0xa1, 0xbc, 0x4a, 0x18, 0x39, 0x43, 0xa5, 0x94, 0x3d, 0x85,
+    0x43, 0x74, 0x54, 0x3c, 0xa5, 0x43, 0xab, 0x54, 0x33, 0x32, 0x87, 0x97, 0x28, 0x66, 0x25, 0x0e,
+    0xdd, 0x50, 0xf9, 0x25, 0x0f, 0x91, 0x50, 0xc3, 0xaa, 0x19, 0xe9, 0x43, 0xfd, 0x2a, 0x1e, 0x2a,
+    0xa1, 0x8c, 0x54, 0x39, 0x05, 0x43, 0x02, 0x50, 0xf7, 0x15, 0x0d, 0x22, 0xa1, 0xd5, 0x4a, 0x1e,
+    0xa4, 0xa1, 0x9c, 0x94, 0x3e, 0x09, 0x43, 0x86, 0x94, 0x34, 0xca, 0x86, 0xb9, 0x28, 0x66, 0x65,
+    0x0e, 0x32, 0x50, 0xd3, 0x2a, 0x19, 0x69, 0x43, 0x0d, 0x28, 0x7c, 0x4a, 0x87, 0x21, 0x28, 0x6e,
+    0x6a, 0x87, 0x94, 0xa8, 0x77, 0x52, 0x86, 0x8d, 0x50, 0xcc, 0x4a, 0x1d, 0x2a, 0xa1, 0x80, 0xa8,
+    0x70, 0x4a, 0x87, 0x90, 0xa8, 0x6a, 0x55, 0x0f, 0xcc, 0xa8, 0x65, 0x65, 0x0d, 0x44, 0xa1, 0xcb,
+    0x4a, 0x1a, 0x85, 0x43, 0xe2, 0x94, 0x3e, 0x29, 0x43, 0x87, 0x94, 0x3d, 0x49, 0x43, 0xa5, 0x94,
+    0x3b, 0x85, 0x43, 0x94, 0x94, 0x3b, 0x69, 0x43, 0x3d, 0x28, 0x77, 0xaa, 0x86, 0xa6, 0x50, 0xdd,
+    0xd5, 0x0d, 0x04, 0xa1, 0xa4, 0x94, 0x39, 0x39, 0x43, 0x7c, 0x54, 0x3d, 0x79, 0x43, 0x97, 0x94,
+    0x32, 0x8a, 0x86, 0x39, 0x50, 0xf6, 0x55, 0x0f, 0xf0, 0xa8, 0x71, 0x32, 0x86, 0xc6, 0xa8, 0x72,
+    0x52, 0x87, 0xb0, 0xa8, 0x68, 0xa5, 0x0f, 0x96, 0xa8, 0x73, 0xd2, 0x86, 0xbf, 0x28, 0x76, 0x52,
+    0x86, 0x1e, 0x50, 0xd1, 0x2a, 0x1e, 0x64, 0xa1, 0xf7, 0x65, 0x0d, 0xfa, 0x50, 0xc3, 0xca, 0x1c,
+    0xb2, 0xa1, 0x98, 0x54, 0x38, 0xa9, 0x43, 0xa0, 0x94, 0x31, 0x72, 0x87, 0x61, 0x28, 0x62, 0x25,
+    0x0e, 0x86, 0x50, 0xca, 0x2a, 0x1b, 0xb4, 0xa1, 0xe1, 0x2a, 0x1d, 0xe4, 0xa1, 0xa4, 0x54, 0x3e,
+    0x05, 0x43, 0x2d, 0x28, 0x75, 0x0a, 0x86, 0xe2, 0xa8, 0x7c, 0x72, 0x86, 0xe4, 0xa8, 0x6b, 0xaa,
+    0x87, 0x22, 0xa8, 0x79, 0x12, 0x87, 0x1a, 0xa8, 0x63, 0x95, 0x0d, 0x4c, 0xa1, 0x85, 0x54, 0x37,
+    0x49, 0x43, 0x04, 0xa8, 0x67, 0xe5, 0x0e, 0x02, 0x50, 0xc1, 0xca, 0x1a, 0xb9, 0x43, 0x28, 0xa8,
+    0x6a, 0xd5, 0x0f, 0x3d, 0x50, 0xc9, 0xca, 0x1b, 0x54, 0xa1, 0xcd, 0xaa, 0x1a, 0x29, 0x43, 0xdd,
+    0x54, 0x33, 0xaa, 0x86, 0x76, 0x50, 0xfb, 0x52, 0x87, 0x8b, 0x28, 0x77, 0x52, 0x87, 0xe8, 0x94,
+    0x35, 0x6a, 0x86, 0x09, 0x50, 0xcb, 0xca, 0x1f, 0x1a, 0xa1, 0xe3, 0xca, 0x1a, 0x19, 0x43, 0x9c,
+    0x54, 0x3d, 0x19, 0x43, 0x98, 0x94, 0x38, 0x39, 0x43, 0x2b, 0x28, 0x6d, 0xf2, 0x86, 0x45, 0x50,
+    0xe4, 0x95, 0x0e, 0x19, 0x50, 0xc1, 0xca, 0x18, 0x49, 0x43, 0x4d, 0x28, 0x68, 0x15, 0x0d, 0x81,
+    0x50, 0xd7, 0x65, 0x0f, 0xa4, 0xa8, 0x6a, 0x15, 0x0d, 0x9e, 0x50, 0xf7, 0xd5, 0x0c, 0x1c, 0xa1,
+    0xa7, 0x54, 0x35, 0x52, 0x86, 0xee, 0xa8, 0x6f, 0xb2, 0x86, 0xd0, 0xa8, 0x61, 0xa5, 0x0e, 0x7d,
+    0x50, 0xd6, 0x15, 0x0d, 0xf6, 0x50, 0xeb, 0x15, 0x0c, 0x14, 0xa1, 0x9c, 0x94, 0x38, 0x45, 0x43,
+    0xd7, 0x54, 0x3a, 0x75, 0x43, 0xda, 0x54, 0x34, 0x32, 0x86, 0xc0, 0xa8, 0x65, 0x25, 0x0f, 0x55,
+    0x50, 0xe5, 0xe5, 0x0c, 0x4c, 0xa1, 0xa9, 0x94, 0x3e, 0x8a, 0xa1, 0xdf, 0xca, 0x1a, 0xc2, 0xa1,
+    0xcc, 0xca, 0x1e, 0x84, 0xa1, 0xf8, 0xe5, 0x0c, 0xda, 0xa1, 0x91, 0x94, 0x37, 0x45, 0x43, 0x6c,
+    0x94, 0x34, 0x52, 0x86, 0x81, 0x50, 0xf8, 0x15, 0x0e, 0xe2, 0x50, 0xf8, 0x65, 0x0e, 0x79, 0x50,
+    0xea, 0x15, 0x0c, 0x2a, 0xa1, 0x8b, 0x54, 0x3a, 0xd9, 0x43, 0xa1, 0x94, 0x35, 0x6a, 0x87, 0xb9,
+    0x28, 0x6d, 0xb2, 0x87, 0x3a, 0xa8, 0x75, 0x4a, 0x87, 0x1e, 0xa8, 0x74, 0x92, 0x87, 0x17, 0x28,
+    0x6f, 0x92, 0x86, 0x19, 0x50, 0xec, 0xa5, 0x0d, 0xa6, 0x50, 0xc7, 0x2a, 0x1e, 0x8a, 0xa1, 0xdd,
+    0xca, 0x1e, 0xcc, 0xa1, 0xaa, 0x54, 0x38, 0x59, 0x43, 0x37, 0x28, 0x60, 0x2a, 0x1e, 0xe4, 0xa1,
+    0xe8, 0x4a, 0x1f, 0x6d, 0x50, 0xe6, 0x15, 0x0c, 0xac, 0xa1, 0xa7, 0x54, 0x3c, 0xb9, 0x43, 0xd3,
+    0x54, 0x3f, 0xca, 0xa1, 0xb4, 0x4a, 0x1c, 0x72, 0xa1, 0xab, 0x94, 0x35, 0x2a, 0x87, 0x45, 0x28,
+    0x78, 0x72, 0x86, 0x85, 0x50, 0xe3, 0xd5, 0x0d, 0xee, 0x50, 0xe8, 0x25, 0x0e, 0xfe, 0x50, 0xd9,
+    0x55, 0x0f, 0x86, 0x50, 0xe3, 0x25, 0x0d, 0x1c, 0xa1, 0x84, 0x54, 0x38, 0xc5, 0x43, 0xcc, 0x94,
+    0x3a, 0xf5, 0x43, 0x7a, 0x94, 0x38, 0xe5, 0x43, 0x98, 0x54, 0x3f, 0xf9, 0x8a, 0x0a, 0xc9, 0x32,
+    0x9a, 0xce, 0xa1, 0x5c, 0xe6, 0x78, 0x01, 0x92, 0x8f, 0xff, 0xff, 0xff, 0xff, 0xfd, 0xfb, 0xbf,
+    0xff, 0xcc, 0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f, 0xbf, 0xef, 0xfe, 0xff, 0xff,
+    0xff, 0xbf, 0xff, 0x7f, 0xff, 0xfb, 0xff, 0xfd, 0xeb, 0xff, 0xff, 0x00, 0x63, 0xf0, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x34, 0x34, 0x00, 0x68,
+    0x00, 0x00, 0x03, 0x41, 0xa0, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x68, 0x03, 0x40, 0x00, 0x34,
+    0x00, 0x00, 0x68, 0x00, 0x00, 0x00, 0x03, 0x26, 0x46, 0x80, 0x00, 0x00, 0x00, 0x1a, 0x00, 0x04,
+    0x00, 0x01, 0xa1, 0xa0, 0x03, 0x40, 0x00, 0x00, 0x1a, 0x0d, 0x00, 0x00, 0x68, 0x00, 0x00, 0x00,
+    0x03, 0x40, 0x1a, 0x00, 0x01, 0xa0, 0x00, 0x03, 0x40, 0x00, 0x00, 0x00, 0x19, 0x32, 0x34, 0x00,
+    0x00, 0x00, 0x00, 0xd0, 0x00, 0x20, 0x00, 0x0d, 0x0d, 0x00, 0x1a, 0x00, 0x00, 0x00, 0xd0, 0x68,
+    0x00, 0x03, 0x40, 0x00, 0x00, 0x00, 0x1a, 0x00, 0xd0, 0x00, 0x0d, 0x00, 0x00, 0x1a, 0x00, 0x00,
+    0x00, 0x00, 0xc9, 0x91, 0xa0, 0x00, 0x00, 0x00, 0x06, 0x80, 0x01, 0x00, 0x00, 0x68, 0x68, 0x00,
+    0xd0, 0x00, 0x00, 0x06, 0x83, 0x40, 0x00, 0x1a, 0x00, 0x00, 0x00, 0x00, 0xd0, 0x06, 0x80, 0x00,
+    0x68, 0x00, 0x00, 0xd0, 0x00, 0x00, 0x00, 0x06, 0x4c, 0x8d, 0x00, 0x00, 0x00, 0x00, 0x34, 0x00,
+    0x02, 0x6a, 0xaa, 0xa8, 0xd1, 0xa0, 0x9e, 0x91, 0xb2, 0x4f, 0x46, 0xa1, 0x84, 0xf4, 0x99, 0x33,
+    0x21, 0xa8, 0xc0, 0x68, 0x4c, 0x8c, 0xd4, 0xd9, 0x1a, 0x9e, 0xa6, 0x04, 0xd9, 0x4d, 0xa1, 0xa2,
+    0x69, 0xe4, 0x8d, 0x31, 0x30, 0x4d, 0x31, 0x30, 0x27, 0xa9, 0xb5, 0x34, 0x6d, 0x4c, 0x26, 0x9e,
+    0x8d, 0x27, 0xa1, 0xa0, 0x04, 0xc9, 0xb5, 0x31, 0xa0, 0x13, 0x23, 0xd0, 0x26, 0x8f, 0x40, 0x09,
+    0x82, 0x69, 0xb1, 0x34, 0x0d, 0x4f, 0x05, 0x10, 0x00, 0x06, 0x86, 0x80, 0x0d, 0x00, 0x00, 0x00,
+    0x68, 0x34, 0x00, 0x01, 0xa0, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x68, 0x00, 0x06, 0x80, 0x00, 0x0d,
+    0x00, 0x00, 0x00, 0x00, 0x64, 0xc8, 0xd0, 0x00, 0x00, 0x00, 0x03, 0x40, 0x01, 0xe6, 0x42, 0x76,
+    0x10, 0x9c, 0x1a, 0x26, 0xdb, 0x09, 0xd4, 0xc2, 0x6a, 0x61, 0x3b, 0x34, 0x4d, 0x1a, 0x26, 0x16,
+    0x13, 0x60, 0x84, 0xf7, 0x11, 0x3a, 0xd8, 0x4c, 0xca, 0x26, 0x45, 0x13, 0xb9, 0x44, 0xef, 0x08,
+    0x9a, 0xa8, 0x4c, 0xa2, 0x27, 0xa0, 0x89, 0xc2, 0xc2, 0x6f, 0x68, 0x9b, 0x22, 0x27, 0x89, 0x09,
+    0xb1, 0x42, 0x74, 0xc8, 0x9e, 0xe4, 0x26, 0xb4, 0x89, 0x90, 0x84, 0xd1, 0x42, 0x65, 0xa1, 0x37,
+    0x98, 0x4c, 0x5a, 0x26, 0x62, 0x13, 0x3e, 0x89, 0xa6, 0x84, 0xf1, 0x21, 0x39, 0x74, 0x4c, 0x64,
+    0x27, 0x2c, 0x89, 0xb9, 0x42, 0x71, 0xe8, 0x9e, 0x0a, 0x26, 0x4e, 0x13, 0x61, 0x84, 0xfe, 0x08,
+    0x99, 0xf8, 0x4d, 0x54, 0x27, 0xc4, 0x89, 0xba, 0x42, 0x63, 0x11, 0x34, 0x50, 0x98, 0x54, 0x4e,
+    0x0e, 0x13, 0x56, 0x89, 0x99, 0x84, 0xdb, 0xa1, 0x3d, 0x58, 0x4e, 0xfe, 0x13, 0x09, 0x09, 0x96,
+    0x44, 0xc7, 0xa2, 0x69, 0x11, 0x38, 0xd8, 0x4c, 0x32, 0x27, 0xb3, 0x09, 0xbc, 0xc2, 0x65, 0x51,
+    0x38, 0x24, 0x4d, 0x8e, 0x13, 0x9a, 0x44, 0xd4, 0xc2, 0x70, 0xb0, 0x9b, 0x64, 0x27, 0x09, 0x09,
+    0xf7, 0x51, 0x31, 0xd0, 0x9d, 0x32, 0x27, 0x85, 0x09, 0xb3, 0xa2, 0x65, 0x51, 0x38, 0x38, 0x4e,
+    0x26, 0x13, 0x21, 0x09, 0x98, 0x84, 0xc8, 0x22, 0x72, 0x90, 0x9b, 0xfc, 0x26, 0xf5, 0x09, 0x8d,
+    0x84, 0xf0, 0x21, 0x39, 0x68, 0x4d, 0x32, 0x27, 0x98, 0x89, 0xaf, 0xa2, 0x73, 0x88, 0x98, 0x64,
+    0x4c, 0x5a, 0x27, 0x8e, 0x89, 0xa5, 0x84, 0xe1, 0xe1, 0x38, 0xa8, 0x4e, 0x4e, 0x13, 0xa6, 0x44,
+    0xcc, 0xa2, 0x6b, 0x30, 0x9d, 0xdc, 0x26, 0x1d, 0x13, 0xd5, 0x84, 0xda, 0xa1, 0x36, 0xa8, 0x4e,
+    0xbe, 0x13, 0x54, 0x89, 0xb9, 0xc2, 0x66, 0x51, 0x31, 0xd0, 0x98, 0x24, 0x4e, 0xde, 0x13, 0x40,
+    0x89, 0x88, 0x84, 0xfc, 0xd0, 0x9c, 0x2a, 0x26, 0xaa, 0x13, 0x15, 0x09, 0xbc, 0x42, 0x74, 0x90,
+    0x9d, 0x5a, 0x26, 0xeb, 0x09, 0xfd, 0x21, 0x3b, 0x54, 0x4d, 0xb5, 0x13, 0x9d, 0x84, 0xd7, 0x21,
+    0x34, 0xf0, 0x9f, 0xca, 0x13, 0x6b, 0x44, 0xe1, 0xa1, 0x3f, 0x74, 0x26, 0x85, 0x13, 0x59, 0x84,
+    0xd7, 0x61, 0x37, 0x68, 0x4c, 0x44, 0x27, 0x05, 0x09, 0xb2, 0x42, 0x79, 0x30, 0x9d, 0x84, 0x26,
+    0xee, 0x89, 0x8c, 0x84, 0xc1, 0x42, 0x76, 0xf0, 0x9d, 0x0c, 0x27, 0x91, 0x09, 0x9e, 0x44, 0xdf,
+    0x11, 0x35, 0xa8, 0x4d, 0x6e, 0x13, 0x2b, 0x09, 0xfa, 0xa1, 0x37, 0x74, 0x4d, 0xa9, 0x13, 0x13,
+    0x09, 0x8e, 0x44, 0xde, 0xa8, 0x4e, 0x92, 0x13, 0xbd, 0x84, 0xf8, 0x51, 0x3b, 0x54, 0x4f, 0xee,
+    0x89, 0xba, 0x42, 0x68, 0xe1, 0x32, 0x70, 0x9b, 0xfc, 0x26, 0xc5, 0x09, 0xb9, 0x22, 0x71, 0x10,
+    0x9b, 0xf4, 0x27, 0x6d, 0x09, 0xb9, 0x42, 0x7b, 0x68, 0x9b, 0x2c, 0x27, 0x3f, 0x09, 0xe4, 0xa2,
+    0x62, 0x21, 0x3d, 0x84, 0x4c, 0xcc, 0x26, 0x71, 0x13, 0xc0, 0x44, 0xed, 0xa1, 0x38, 0xa8, 0x4e,
+    0x1a, 0x13, 0xc0, 0x84, 0xfe, 0xb0, 0x9d, 0xbc, 0x26, 0xb9, 0x09, 0xa4, 0x84, 0xd8, 0xd1, 0x34,
+    0xf0, 0x9e, 0x64, 0x27, 0xfb, 0x84, 0xce, 0xc2, 0x62, 0x91, 0x3c, 0x38, 0x4f, 0x52, 0x13, 0x7f,
+    0x84, 0xfa, 0xe8, 0x9d, 0x9c, 0x27, 0x56, 0x89, 0xc3, 0xc2, 0x73, 0x68, 0x9a, 0xc4, 0x27, 0xa9,
+    0x09, 0xa1, 0x84, 0xcb, 0x22, 0x79, 0x30, 0x99, 0x84, 0x4e, 0xea, 0x13, 0xa8, 0x44, 0xec, 0xe1,
+    0x34, 0x48, 0x9d, 0x2c, 0x27, 0x85, 0x09, 0xa5, 0x44, 0xdb, 0xe1, 0x37, 0x54, 0x4c, 0x5a, 0x26,
+    0x09, 0x13, 0xb4, 0x84, 0xed, 0x51, 0x30, 0x70, 0x99, 0x08, 0x4e, 0xae, 0x13, 0x84, 0x44, 0xee,
+    0xa1, 0x37, 0xde, 0x89, 0x13, 0xd5, 0x44, 0xdc, 0xd1, 0x38, 0x94, 0x4d, 0xc6, 0x13, 0xc2, 0x84,
+    0xc5, 0x42, 0x75, 0xb0, 0x9c, 0x12, 0x27, 0x8b, 0x09, 0x8b, 0x44, 0xf1, 0x11, 0x3b, 0xe8, 0x4f,
+    0x76, 0x13, 0xd7, 0x44, 0xd9, 0xe1, 0x36, 0xe4, 0x4c, 0xa4, 0x27, 0x19, 0x09, 0xf2, 0xa2, 0x73,
+    0x10, 0x99, 0xe4, 0x4e, 0xd9, 0x13, 0x67, 0x44, 0xd7, 0xa1, 0x3d, 0x98, 0x4e, 0x05, 0x13, 0x42,
+    0x89, 0xac, 0x48, 0x9a, 0xb4, 0x4c, 0x2a, 0x26, 0xb2, 0x2a, 0x5d, 0xc2, 0x26, 0x01, 0x13, 0xc7,
+    0x84, 0xd3, 0xa2, 0x79, 0x68, 0x99, 0x98, 0x4e, 0xae, 0x13, 0x69, 0x84, 0xc1, 0x42, 0x6e, 0x08,
+    0x98, 0x58, 0x4e, 0x5a, 0x13, 0xbb, 0x84, 0xe5, 0x51, 0x32, 0x48, 0x98, 0xf4, 0x4f, 0x81, 0x13,
+    0x22, 0x89, 0x80, 0x84, 0xed, 0xa1, 0x3d, 0xb8, 0x4c, 0xd4, 0x26, 0x2a, 0x13, 0x98, 0x84, 0xe2,
+    0x61, 0x3c, 0xb8, 0x4f, 0x1a, 0x13, 0x75, 0x44, 0xdd, 0x21, 0x3d, 0x08, 0x4d, 0xa2, 0x13, 0xbf,
+    0x84, 0xcd, 0xa2, 0x67, 0xa1, 0x39, 0x24, 0x4c, 0xd2, 0x27, 0xa9, 0x09, 0xef, 0xc2, 0x65, 0x51,
+    0x3f, 0xe2, 0x27, 0xc8, 0x89, 0xd4, 0xa2, 0x71, 0x08, 0x9d, 0x74, 0x26, 0xf4, 0x89, 0xc5, 0xa2,
+    0x66, 0xe1, 0x32, 0xe8, 0x9e, 0xbc, 0x27, 0xed, 0x44, 0xf9, 0xd0, 0x9b, 0xe4, 0x26, 0x5d, 0x13,
+    0x93, 0x84, 0xd4, 0x42, 0x69, 0x51, 0x3c, 0xa8, 0x4f, 0x46, 0x13, 0x09, 0x09, 0xa8, 0x84, 0xd9,
+    0xa1, 0x34, 0xd0, 0x98, 0x18, 0x4d, 0x9d, 0x13, 0x0b, 0x09, 0xdd, 0xc2, 0x62, 0x61, 0x3b, 0x98,
+    0x4e, 0x32, 0x13, 0xcd, 0x84, 0xe1, 0xa1, 0x31, 0x10, 0x9b, 0x8c, 0x27, 0x46, 0x89, 0x94, 0x84,
+    0xe2, 0xa1, 0x39, 0xe8, 0x4d, 0x2c, 0x26, 0x91, 0x13, 0x02, 0x89, 0xdc, 0x42, 0x79, 0xf0, 0x98,
+    0x38, 0x4d, 0x4c, 0x26, 0x45, 0x13, 0xed, 0x42, 0x72, 0x48, 0x9d, 0x92, 0x27, 0x36, 0x89, 0x93,
+    0x84, 0xfe, 0x70, 0x9c, 0x74, 0x26, 0x8e, 0x13, 0x29, 0x09, 0xb8, 0x22, 0x65, 0x61, 0x33, 0x90,
+    0x98, 0xc4, 0x4d, 0x6a, 0x13, 0x1a, 0x89, 0x85, 0x84, 0xce, 0xc2, 0x6e, 0x30, 0x9f, 0x14, 0x27,
+    0xb5, 0x09, 0xec, 0x22, 0x7b, 0xb0, 0x9d, 0x22, 0x26, 0xcd, 0x09, 0xf8, 0x91, 0x31, 0xc8, 0x9f,
+    0xfa, 0x13, 0x3f, 0x09, 0x9a, 0x84, 0xd8, 0xa1, 0x35, 0xb8, 0x4c, 0xec, 0x26, 0x1d, 0x13, 0x36,
+    0x89, 0xb7, 0x42, 0x6d, 0x08, 0x98, 0x94, 0x4f, 0xa3, 0x09, 0xa3, 0x44, 0xd0, 0x42, 0x66, 0x21,
+    0x35, 0xe8, 0x4f, 0x5a, 0x13, 0x1c, 0x89, 0x87, 0x44, 0xdf, 0x61, 0x3a, 0x78, 0x4c, 0x8c, 0x26,
+    0x72, 0x13, 0x6b, 0x44, 0xec, 0x51, 0x3c, 0xf4, 0x4d, 0x22, 0x26, 0xd0, 0x89, 0xd0, 0x22, 0x61,
+    0xa1, 0x30, 0xd0, 0x9d, 0x42, 0x26, 0xc8, 0x89, 0xaa, 0x84, 0xe6, 0x51, 0x3a, 0x18, 0x4f, 0x96,
+    0x13, 0xcc, 0x84, 0xdf, 0x21, 0x31, 0xf0, 0x9d, 0x7c, 0x27, 0x93, 0x09, 0xa2, 0x84, 0xdd, 0x51,
+    0x31, 0xb0, 0x9e, 0x22, 0x26, 0x39, 0x13, 0xd3, 0x84, 0xe1, 0x51, 0x3a, 0x54, 0x4f, 0x45, 0x13,
+    0x9b, 0x84, 0xfc, 0x10, 0x9f, 0x4a, 0x13, 0x13, 0x09, 0xd5, 0x42, 0x71, 0x50, 0x98, 0xc8, 0x4d,
+    0x2a, 0x26, 0xa2, 0x13, 0x45, 0x09, 0x82, 0x44, 0xc6, 0xc2, 0x79, 0x10, 0x9b, 0x4a, 0x27, 0x5e,
+    0x89, 0xce, 0xc2, 0x68, 0x51, 0x33, 0xc8, 0x98, 0xa4, 0x4d, 0x7e, 0x13, 0x79, 0x84, 0xc0, 0xc2,
+    0x74, 0xf0, 0x9e, 0xd2, 0x26, 0xec, 0x89, 0xe6, 0xa2, 0x75, 0xa8, 0x99, 0x88, 0x4f, 0x3a, 0x13,
+    0x2f, 0x09, 0xdc, 0xa2, 0x7c, 0xb0, 0x9f, 0x2a, 0x26, 0x11, 0x13, 0x3b, 0x09, 0xfe, 0x91, 0x3c,
+    0x84, 0x4c, 0x4a, 0x27, 0x22, 0x89, 0x8d, 0x84, 0xf7, 0x91, 0x34, 0x68, 0x9d, 0x64, 0x27, 0xad,
+    0x09, 0x9b, 0x84, 0xf8, 0x61, 0x38, 0x88, 0x4d, 0x32, 0x26, 0xb9, 0x09, 0x98, 0x84, 0xe3, 0xa1,
+    0x34, 0xc8, 0x99, 0x48, 0x4c, 0x1c, 0x27, 0xc6, 0x89, 0xc8, 0xc2, 0x6e, 0x88, 0x9e, 0x6a, 0x27,
+    0x79, 0x09, 0xa2, 0x44, 0xcb, 0xc2, 0x74, 0xe8, 0x98, 0xd4, 0x4e, 0x11, 0x13, 0xcb, 0x44, 0xd4,
+    0xa2, 0x7e, 0x74, 0x4c, 0x9c, 0x26, 0xa2, 0x13, 0x97, 0x84, 0xd4, 0x22, 0x7c, 0x70, 0x9f, 0x1c,
+    0x27, 0x13, 0x09, 0xeb, 0x42, 0x74, 0xf0, 0x9d, 0xd2, 0x27, 0x2b, 0x09, 0xdc, 0x42, 0x67, 0x61,
+    0x3b, 0xf4, 0x4d, 0x4c, 0x26, 0xf0, 0x89, 0x9f, 0x84, 0xd1, 0xc2, 0x72, 0x90, 0x9c, 0x02, 0x27,
+    0xb3, 0x09, 0xcc, 0x42, 0x64, 0x91, 0x37, 0xb4, 0x4f, 0x6d, 0x13, 0xfc, 0x22, 0x71, 0x70, 0x9b,
+    0x22, 0x27, 0x27, 0x09, 0xed, 0x22, 0x68, 0x21, 0x3e, 0x6a, 0x27, 0x3f, 0x09, 0xb0, 0x42, 0x76,
+    0x90, 0x98, 0x48, 0x4d, 0x02, 0x27, 0x9f, 0x09, 0xf7, 0x21, 0x32, 0x10, 0x98, 0x48, 0x4e, 0x5d,
+    0x13, 0x2e, 0x89, 0xc6, 0x42, 0x74, 0x30, 0x98, 0x78, 0x4e, 0xca, 0x13, 0x0b, 0x09, 0xd1, 0xc2,
+    0x64, 0x91, 0x31, 0x70, 0x9e, 0x2a, 0x27, 0x7d, 0x09, 0xa3, 0x44, 0xf8, 0x51, 0x32, 0x90, 0x9d,
+    0x52, 0x26, 0xe4, 0x89, 0xf2, 0x42, 0x6e, 0x68, 0x9a, 0xea, 0x27, 0x24, 0x89, 0xe5, 0xc2, 0x71,
+    0xe8, 0x9b, 0xda, 0x26, 0xa6, 0x13, 0x04, 0x89, 0xbb, 0x42, 0x60, 0x11, 0x33, 0xd0, 0x9c, 0x14,
+    0x26, 0x06, 0x13, 0x57, 0x09, 0x92, 0x44, 0xd5, 0xa2, 0x7a, 0x28, 0x99, 0x18, 0x4c, 0x44, 0x27,
+    0x38, 0x89, 0xa0, 0x84, 0xf7, 0xd1, 0x33, 0x88, 0x99, 0xc8, 0x4d, 0xfa, 0x13, 0xc8, 0x84, 0xef,
+    0x21, 0x3a, 0x28, 0x4d, 0x5a, 0x26, 0x01, 0x13, 0x2b, 0x09, 0xf2, 0x22, 0x79, 0x50, 0x9e, 0x1c,
+    0x27, 0x3a, 0x89, 0xe9, 0xc2, 0x73, 0x30, 0x9c, 0x34, 0x26, 0x4e, 0x13, 0xeb, 0x42, 0x63, 0xd1,
+    0x39, 0x34, 0x4e, 0x21, 0x13, 0x03, 0x09, 0xaf, 0x42, 0x69, 0xa1, 0x33, 0xe8, 0x9b, 0x0a, 0x26,
+    0xbb, 0x09, 0xf4, 0xd1, 0x35, 0x08, 0x9b, 0x5c, 0x27, 0xc0, 0x89, 0x81, 0x84, 0xd3, 0xa2, 0x6a,
+    0xa1, 0x37, 0x84, 0x4e, 0x06, 0x13, 0x6c, 0x44, 0xc1, 0xc2, 0x74, 0x08, 0x9a, 0xc2, 0x27, 0x03,
+    0x09, 0xd7, 0x22, 0x60, 0x21, 0x33, 0x70, 0x9c, 0x3a, 0x27, 0xb2, 0x89, 0xd4, 0xa2, 0x7b, 0x88,
+    0x9e, 0x1c, 0x26, 0xc2, 0x89, 0x92, 0x84, 0xf5, 0xd1, 0x39, 0x88, 0x4c, 0x34, 0x26, 0xa6, 0x13,
+    0x65, 0x44, 0xf0, 0x61, 0x35, 0x84, 0x4e, 0x6a, 0x13, 0xd2, 0x84, 0xfc, 0x90, 0x99, 0xa4, 0x4c,
+    0x7c, 0x26, 0xec, 0x89, 0xb7, 0xc2, 0x68, 0x21, 0x33, 0xe8, 0x9f, 0x0a, 0x27, 0x75, 0x09, 0xf1,
+    0x42, 0x73, 0xe8, 0x9d, 0x52, 0x26, 0x09, 0x13, 0x0e, 0x89, 0xd7, 0xc2, 0x74, 0x70, 0x9a, 0xb4,
+    0x4f, 0x7a, 0x13, 0x70, 0x84, 0xe7, 0x91, 0x3a, 0xc4, 0x4e, 0x41, 0x13, 0xa6, 0x84, 0xe3, 0x61,
+    0x38, 0x08, 0x4c, 0x1a, 0x27, 0x69, 0x09, 0xb6, 0xc2, 0x6f, 0x68, 0x9e, 0x9a, 0x27, 0x7b, 0x09,
+    0xed, 0xc2, 0x6a, 0x91, 0x3e, 0xf4, 0x26, 0x6a, 0x13, 0x1a, 0x89, 0xef, 0x42, 0x7a, 0x50, 0x9f,
+    0x6d, 0x13, 0x99, 0x44, 0xc9, 0xc2, 0x69, 0xd1, 0x3c, 0xe8, 0x4f, 0x55, 0x13, 0xfc, 0xa2, 0x6d,
+    0x90, 0x99, 0x64, 0x4d, 0x5c, 0x26, 0xa5, 0x13, 0xa4, 0x84, 0xf1, 0xa1, 0x3c, 0x34, 0x4e, 0x41,
+    0x13, 0x7d, 0x84, 0xe8, 0x61, 0x3c, 0x18, 0x4d, 0xa1, 0x13, 0xe2, 0x84, 0xe3, 0xa1, 0x34, 0x50,
+    0x9a, 0xf2, 0x27, 0x1c, 0x89, 0xe7, 0xc2, 0x76, 0x28, 0x9b, 0xe4, 0x26, 0x59, 0x13, 0x99, 0x44,
+    0xff, 0xe2, 0xee, 0x48, 0xa7, 0x0a, 0x12, 0x02, 0x8c, 0x5e, 0xea, 0x00,
+  };
+
+  const uint8_t bzip2_letters[] = {
+    0x42, 0x5a, 0x68, 0x39, 0x31, 0x41, 0x59, 0x26, 0x53, 0x59, 0x50, 0x36, 0x8e, 0x01, 0x00, 0x03,
+    0x41, 0xc1, 0x00, 0x74, 0x00, 0x3c, 0x00, 0x60, 0x0b, 0xdc, 0xd3, 0xb6, 0x82, 0xa9, 0xad, 0xf6,
+    0xed, 0xbb, 0x8e, 0xce, 0x19, 0xb9, 0x9b, 0xb9, 0x42, 0x83, 0x6d, 0x90, 0xdb, 0x16, 0x35, 0x03,
+    0x9b, 0xb6, 0x77, 0x10, 0xc0, 0x81, 0xa9, 0xf8, 0xa5, 0x24, 0x0d, 0x3c, 0x54, 0xa0, 0x12, 0x9e,
+    0x4a, 0x52, 0x7a, 0x84, 0x30, 0x20, 0x4a, 0x9e, 0xca, 0x54, 0x1f, 0x77, 0xf2, 0x7c, 0x5c, 0x89,
+    0xf5, 0xae, 0x66, 0x59, 0x21, 0xc2, 0x69, 0xa1, 0x4c, 0x15, 0x91, 0xe8, 0xe3, 0x8c, 0x61, 0x72,
+    0x50, 0x54, 0x8a, 0xb2, 0x2b, 0x51, 0x4c, 0x8b, 0x39, 0xf0, 0xa0, 0x7c, 0x44, 0x67, 0x20, 0x71,
+    0x58, 0x72, 0x99, 0x4d, 0x49, 0x44, 0xa8, 0x96, 0x9d, 0x6a, 0xfd, 0x46, 0x5a, 0xf4, 0x92, 0x43,
+    0x93, 0x10, 0x39, 0x5c, 0x40, 0xc2, 0x56, 0x25, 0x7d, 0x7b, 0x22, 0x57, 0x88, 0x55, 0x9c, 0x58,
+    0xa6, 0xea, 0xc6, 0xa1, 0xc4, 0xbd, 0x0b, 0x62, 0x54, 0x67, 0x23, 0x96, 0xc6, 0x19, 0x07, 0x4c,
+    0x54, 0x4c, 0x00, 0x02, 0x31, 0x62, 0x9b, 0x0b, 0x38, 0xd3, 0x41, 0x35, 0x05, 0x8d, 0x64, 0x1a,
+    0xad, 0x39, 0x74, 0x4a, 0xa4, 0x10, 0x85, 0x87, 0xb3, 0x75, 0x99, 0xb6, 0x62, 0xf4, 0xc6, 0xcc,
+    0x5a, 0x2f, 0x38, 0xb2, 0x70, 0xdd, 0x79, 0xaf, 0x43, 0xe4, 0xb7, 0x1d, 0xdb, 0xb3, 0x42, 0x3a,
+    0x6f, 0xdf, 0x50, 0x7d, 0xf5, 0x82, 0x99, 0x72, 0x36, 0x85, 0x31, 0x9a, 0x07, 0x56, 0xc4, 0xdc,
+    0x7e, 0xb6, 0xeb, 0xe5, 0x30, 0x30, 0xad, 0x4b, 0x68, 0x26, 0xd3, 0x21, 0x5b, 0xe5, 0x2f, 0x39,
+    0xe8, 0xfa, 0xee, 0xe0, 0xcb, 0x8d, 0x62, 0xb3, 0x94, 0xcc, 0x15, 0xa5, 0x40, 0xac, 0xfd, 0x67,
+    0x78, 0xdc, 0x60, 0x79, 0xac, 0xb8, 0x71, 0x8e, 0xb2, 0x18, 0x3b, 0x1c, 0xc2, 0x31, 0x8a, 0xd2,
+    0x26, 0x76, 0xc8, 0x56, 0xa5, 0x08, 0xce, 0x59, 0x68, 0x58, 0xe3, 0x88, 0x33, 0xc2, 0xe2, 0x6c,
+    0xa6, 0x21, 0xa8, 0x9c, 0xda, 0x8c, 0x82, 0xa6, 0xda, 0xcc, 0x35, 0x17, 0x39, 0x4b, 0x92, 0x4b,
+    0x0d, 0xa3, 0xde, 0xc9, 0x8f, 0x2d, 0x45, 0x0e, 0x11, 0xab, 0x54, 0xcc, 0x2c, 0x59, 0x7b, 0xbb,
+    0xd2, 0x03, 0x9e, 0x2b, 0x20, 0x0c, 0xbd, 0x71, 0xc8, 0x9b, 0x9d, 0x32, 0xba, 0x2d, 0x38, 0x30,
+    0x58, 0x24, 0xc5, 0x39, 0x1c, 0x4a, 0x9b, 0x47, 0x08, 0x62, 0xce, 0x01, 0x84, 0xb5, 0x14, 0x68,
+    0x0b, 0xac, 0x34, 0xac, 0x0b, 0x4d, 0x95, 0x5f, 0x14, 0x03, 0x8c, 0x11, 0x0d, 0x01, 0x17, 0x2c,
+    0xac, 0x21, 0x5d, 0x4f, 0x49, 0xe8, 0x51, 0xed, 0xba, 0xda, 0x95, 0x5b, 0x98, 0xb2, 0xc2, 0x8e,
+    0xa4, 0x51, 0xf6, 0xd2, 0xd5, 0x55, 0x13, 0x84, 0x6d, 0x45, 0x88, 0x4d, 0x86, 0xc4, 0x3c, 0xf7,
+    0x08, 0x87, 0x97, 0x72, 0x4d, 0xe1, 0xce, 0x3c, 0xa6, 0xcd, 0xe4, 0x80, 0x52, 0xd6, 0x48, 0xb9,
+    0xca, 0xac, 0xa9, 0x95, 0xd5, 0x85, 0xa3, 0x2b, 0x24, 0xb3, 0x2e, 0xc5, 0x55, 0xe3, 0x19, 0x00,
+    0x8c, 0x4a, 0x28, 0xc3, 0x47, 0xed, 0x6f, 0x58, 0x5e, 0x75, 0x66, 0x8d, 0x8c, 0x57, 0xb0, 0xda,
+    0x9f, 0xad, 0x6e, 0xe3, 0xc3, 0xa0, 0x41, 0x84, 0xf5, 0x1a, 0x79, 0x22, 0x25, 0x64, 0xc2, 0xd4,
+    0x42, 0xed, 0xca, 0x3a, 0xca, 0x66, 0x66, 0x52, 0xd3, 0x08, 0x6b, 0x62, 0x60, 0x87, 0xc5, 0x8b,
+    0x90, 0x79, 0xf5, 0x60, 0xc1, 0xf9, 0xae, 0x38, 0x70, 0x6f, 0x0e, 0x31, 0x9a, 0xb3, 0x33, 0x68,
+    0xc2, 0x8f, 0x0e, 0x20, 0x8a, 0xcb, 0xca, 0xb3, 0x48, 0x2d, 0xa0, 0x66, 0xd6, 0xb6, 0x83, 0x40,
+    0x83, 0x27, 0x2a, 0x63, 0xc0, 0xce, 0xde, 0xa7, 0x49, 0x16, 0x8c, 0x84, 0xbe, 0x75, 0xf3, 0xbc,
+    0x9d, 0x93, 0xbb, 0xba, 0xe9, 0xf1, 0x58, 0x96, 0x96, 0x94, 0xc8, 0x93, 0x8d, 0xd8, 0xbe, 0xd6,
+    0x00, 0x7c, 0x9a, 0xe5, 0xa4, 0x58, 0xa2, 0x58, 0x56, 0x8a, 0x6b, 0x9a, 0x69, 0x82, 0x6a, 0x66,
+    0x81, 0xc1, 0x8c, 0xab, 0x62, 0xa5, 0x85, 0x1c, 0xc5, 0xbe, 0x7b, 0x17, 0x35, 0x90, 0x05, 0x60,
+    0x6c, 0xcc, 0x88, 0x0f, 0x87, 0x3c, 0x77, 0x78, 0xc7, 0x3a, 0x97, 0x75, 0xb3, 0xdc, 0x87, 0x09,
+    0x22, 0xe1, 0xe2, 0x11, 0xc3, 0x61, 0x98, 0xab, 0x59, 0x44, 0x11, 0x02, 0x3b, 0xa9, 0x7a, 0x00,
+    0x0c, 0xe4, 0xb0, 0xdb, 0x55, 0x62, 0x5a, 0x4d, 0x53, 0xa7, 0x41, 0x38, 0x87, 0x5e, 0x63, 0x44,
+    0xc5, 0x5e, 0x59, 0xaa, 0x68, 0x5a, 0x5b, 0x0f, 0xa6, 0xf4, 0x87, 0x5d, 0x6e, 0xce, 0xb3, 0x1b,
+    0x27, 0x77, 0x07, 0x2f, 0x6c, 0xc5, 0x32, 0x45, 0x22, 0x8c, 0x89, 0x0a, 0x99, 0xa5, 0x5c, 0x99,
+    0xae, 0x8d, 0x0e, 0xc6, 0x88, 0xad, 0xb4, 0xf0, 0x81, 0x4f, 0x5a, 0x36, 0x19, 0xc3, 0xa9, 0x10,
+    0xd6, 0x3a, 0x42, 0x81, 0x66, 0x09, 0xa6, 0xc6, 0x18, 0xc8, 0x51, 0x82, 0x12, 0x96, 0x72, 0x8a,
+    0x8a, 0x75, 0x11, 0x8c, 0xe2, 0xcb, 0x3a, 0x71, 0x2c, 0xc8, 0xe4, 0x22, 0xb4, 0xd1, 0x30, 0x90,
+    0x92, 0x8f, 0xa1, 0x36, 0xe8, 0x76, 0x34, 0x9d, 0x15, 0x6c, 0xc3, 0x55, 0x6a, 0x99, 0xac, 0x27,
+    0xac, 0xa8, 0xbb, 0x84, 0x45, 0x1f, 0x18, 0xcc, 0x36, 0x98, 0x6d, 0x86, 0xd1, 0xa0, 0x87, 0xd4,
+    0x85, 0xa1, 0x6d, 0xf5, 0x76, 0xe0, 0xa6, 0xa6, 0x33, 0xa8, 0x63, 0xce, 0x36, 0x39, 0x47, 0x4e,
+    0x59, 0x57, 0x0d, 0x10, 0xb4, 0x18, 0xad, 0x74, 0xf5, 0x72, 0x9a, 0x98, 0x0a, 0xee, 0xeb, 0x8c,
+    0xe6, 0x24, 0x41, 0x28, 0xda, 0x40, 0x72, 0xdd, 0x72, 0xa2, 0xdf, 0x19, 0x38, 0x3a, 0xa1, 0xad,
+    0x46, 0xb5, 0x38, 0x10, 0xa0, 0x57, 0x00, 0xb9, 0x9e, 0x61, 0x81, 0x06, 0x15, 0x01, 0xd3, 0x33,
+    0xd6, 0xb3, 0x19, 0x63, 0x58, 0x06, 0x5b, 0x4f, 0x5a, 0x25, 0x94, 0x97, 0xaa, 0x9a, 0x98, 0x4c,
+    0xe2, 0xc1, 0x3e, 0x33, 0xd3, 0xe0, 0x22, 0x87, 0x0e, 0x2d, 0x4b, 0x84, 0xc9, 0x65, 0x15, 0xe8,
+    0x35, 0x44, 0x5c, 0x5a, 0x76, 0x24, 0x47, 0x39, 0xc7, 0x4e, 0xb1, 0x15, 0x40, 0x91, 0x32, 0x08,
+    0x96, 0x74, 0x80, 0x60, 0x73, 0xad, 0x4a, 0xe8, 0x5c, 0x66, 0x11, 0xb5, 0x4d, 0x3a, 0xeb, 0x08,
+    0xb1, 0x6a, 0x24, 0xae, 0x26, 0x35, 0x9b, 0x41, 0x8a, 0x21, 0xc6, 0x9a, 0x5a, 0x21, 0x6c, 0xec,
+    0x8d, 0xa4, 0xb5, 0xa5, 0x52, 0x70, 0x72, 0x92, 0x11, 0x61, 0x51, 0x45, 0xb4, 0xe4, 0x24, 0xd0,
+    0x02, 0xf6, 0x28, 0xcd, 0x2c, 0x07, 0x2f, 0x17, 0x3d, 0x59, 0x8b, 0x88, 0x9a, 0xe5, 0x56, 0x87,
+    0x59, 0x72, 0x59, 0xea, 0x53, 0x2c, 0x9a, 0xb9, 0xb2, 0xe3, 0x0b, 0x6a, 0xd7, 0x44, 0x32, 0x61,
+    0x8c, 0x70, 0x18, 0x52, 0x2c, 0xe2, 0xb8, 0xef, 0x31, 0xe7, 0xc6, 0x53, 0x77, 0xed, 0xe1, 0x51,
+    0xe7, 0xde, 0x07, 0x9b, 0x19, 0x6d, 0xf1, 0xd3, 0x8c, 0xf6, 0x41, 0xd4, 0x91, 0x18, 0xce, 0x1a,
+    0x82, 0x1c, 0x69, 0x24, 0x58, 0x9c, 0xb5, 0x8c, 0xa4, 0x85, 0x67, 0x42, 0xd4, 0x19, 0x2e, 0xa3,
+    0x5d, 0x0a, 0x65, 0xb6, 0x29, 0x24, 0xae, 0x39, 0xed, 0x94, 0xa6, 0x42, 0xa2, 0xaa, 0x1e, 0x22,
+    0x60, 0x4a, 0xef, 0x44, 0xba, 0x14, 0x88, 0xa4, 0x9a, 0x7c, 0x46, 0xd6, 0xbb, 0x26, 0x78, 0x72,
+    0x19, 0x03, 0x92, 0x00, 0x75, 0x38, 0x6a, 0x98, 0xec, 0x28, 0x39, 0x9d, 0x99, 0xa9, 0x35, 0x72,
+    0x06, 0xb3, 0x43, 0x68, 0xb0, 0xb1, 0xd1, 0x8c, 0x05, 0xa2, 0xba, 0x95, 0x9d, 0x25, 0x96, 0xa5,
+    0xe7, 0x2a, 0xf1, 0x82, 0x2c, 0x41, 0x7a, 0xaf, 0x0b, 0xd3, 0xc9, 0x19, 0x71, 0xc8, 0x39, 0x79,
+    0x0a, 0xbb, 0x08, 0x6b, 0x3a, 0x75, 0x06, 0x01, 0xaa, 0xc8, 0x9a, 0x85, 0x03, 0x14, 0xad, 0xe6,
+    0x74, 0x98, 0x7b, 0xa9, 0x57, 0x3c, 0x45, 0x0e, 0x2c, 0xe2, 0x63, 0x22, 0x59, 0x1d, 0x68, 0xb0,
+    0xc4, 0x59, 0x76, 0x85, 0x24, 0xa9, 0x1c, 0xce, 0x39, 0xad, 0x08, 0x71, 0x6f, 0x7a, 0xbd, 0x62,
+    0x30, 0x77, 0x73, 0x02, 0xa1, 0x86, 0xd3, 0x0e, 0xae, 0x00, 0xd5, 0x44, 0xf4, 0xf4, 0x84, 0xa0,
+    0x95, 0xd3, 0x8c, 0xd5, 0xb3, 0x08, 0x24, 0x0d, 0x46, 0x20, 0xa2, 0x9d, 0x12, 0x66, 0xa5, 0xe9,
+    0xa9, 0xc6, 0xc3, 0xc6, 0x72, 0x7e, 0x6f, 0x78, 0x85, 0xc2, 0xd7, 0x4e, 0x52, 0x96, 0x14, 0x5d,
+    0x47, 0x8f, 0x25, 0x8c, 0x14, 0x33, 0x06, 0xbe, 0x60, 0xdd, 0xe5, 0x14, 0x32, 0xee, 0x6c, 0x62,
+    0x5d, 0x10, 0x5a, 0xd0, 0x99, 0xcd, 0xef, 0xbb, 0x24, 0x70, 0x3a, 0x08, 0x19, 0xb0, 0x90, 0xb8,
+    0x21, 0xac, 0x18, 0x90, 0x19, 0x9b, 0x36, 0x12, 0x7e, 0x22, 0x4d, 0xce, 0x4c, 0x01, 0xc8, 0x73,
+    0x0a, 0x94, 0x59, 0x7a, 0x1c, 0x11, 0x85, 0xa5, 0x44, 0x1c, 0x82, 0x14, 0x1d, 0x77, 0xb8, 0x27,
+    0xdd, 0x80, 0xee, 0xa0, 0xb6, 0x49, 0x18, 0x2a, 0xc7, 0x80, 0x32, 0x50, 0xa1, 0x93, 0x86, 0x0d,
+    0x58, 0xa4, 0x1e, 0x41, 0x32, 0xd1, 0x19, 0xb9, 0x61, 0xc2, 0x11, 0x2c, 0xa3, 0xc0, 0x18, 0xcc,
+    0x6e, 0x4c, 0x31, 0x9c, 0x86, 0xb8, 0x71, 0xa4, 0xab, 0x26, 0x46, 0xca, 0xc9, 0x65, 0x32, 0xd2,
+    0x6c, 0xd1, 0x70, 0x58, 0x96, 0xc7, 0x30, 0x11, 0x99, 0xb2, 0xf6, 0x27, 0x36, 0x2d, 0x86, 0xc4,
+    0x3c, 0x1a, 0x73, 0x02, 0xf1, 0x84, 0x97, 0x16, 0x59, 0x13, 0xa8, 0x85, 0x8a, 0xe1, 0x4c, 0xcd,
+    0x0d, 0x24, 0x2a, 0xbd, 0x5c, 0xa6, 0xac, 0x5c, 0xdb, 0xd5, 0xe7, 0xcc, 0x95, 0xc5, 0x73, 0x96,
+    0x33, 0x19, 0x68, 0x44, 0xc6, 0x36, 0x4c, 0xac, 0xac, 0xd2, 0x92, 0x42, 0x3e, 0x52, 0xab, 0x26,
+    0x28, 0xd8, 0x54, 0x68, 0x62, 0xf6, 0x36, 0x13, 0x4c, 0x58, 0xda, 0x07, 0x26, 0x61, 0xcb, 0x53,
+    0x58, 0xd4, 0x19, 0x6b, 0x1d, 0xdd, 0xdd, 0x41, 0x99, 0x80, 0x12, 0x96, 0x40, 0x15, 0xf3, 0xde,
+    0xf3, 0xd4, 0xb5, 0xd4, 0xbe, 0xdd, 0xbb, 0x61, 0x1c, 0x8e, 0x22, 0xc5, 0x8d, 0x95, 0xd8, 0x63,
+    0xbb, 0x8e, 0xe6, 0x2a, 0x85, 0x29, 0xd0, 0xfb, 0x50, 0x20, 0x98, 0x3c, 0xfd, 0xd6, 0xc5, 0xc9,
+    0x59, 0xb7, 0x57, 0x38, 0x33, 0xc2, 0xe8, 0x2c, 0xb8, 0x9a, 0x17, 0x5f, 0x73, 0x60, 0xe1, 0x57,
+    0x38, 0xd5, 0xa7, 0x11, 0x25, 0x41, 0x06, 0x70, 0xd8, 0x44, 0xe9, 0x42, 0x95, 0x01, 0x00, 0xd7,
+    0x77, 0x2e, 0x97, 0x0a, 0x06, 0x45, 0x62, 0x21, 0x66, 0x45, 0x86, 0x15, 0xa6, 0x16, 0xef, 0xf1,
+    0x77, 0x24, 0x53, 0x85, 0x09, 0x05, 0x03, 0x68, 0xe0, 0x10,
+  };
+}
+
+#endif
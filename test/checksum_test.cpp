@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// CRC-32 and Adler-32 against published values and bit-at-a-time references,
+// over sizes and alignments that reach every path (tail bytes, slicing-by-8, pclmul, avx2).
+// Each kernel the CPU can run is also called directly and checked against the others.
+//
+
+#include <andyzip/checksum.hpp>
+
+#include "test.hpp"
+
+#include <cstring>
+
+namespace {
+  uint32_t reference_crc32(uint32_t crc, const uint8_t *p, size_t size) {
+    crc = ~crc;
+    for (size_t i = 0; i != size; ++i) {
+      crc ^= p[i];
+      for (int j = 0; j != 8; ++j) crc = crc >> 1 ^ (0xedb88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+  }
+
+  uint32_t reference_adler32(uint32_t adler, const uint8_t *p, size_t size) {
+    uint32_t a = adler & 0xffff, b = adler >> 16;
+    for (size_t i = 0; i != size; ++i) {
+      a = (a + p[i]) % 65521;
+      b = (b + a) % 65521;
+    }
+    return b << 16 | a;
+  }
+
+  // The Adler-32 sums without the modulo, as the detail kernels leave them.
+  void scalar_adler32_sums(uint32_t &a, uint32_t &b, const uint8_t *p, size_t size) {
+    for (size_t i = 0; i != size; ++i) {
+      a += p[i];
+      b += a;
+    }
+  }
+
+  // Call the detail:: kernels directly on data + offset for sizes up to size.
+  void check_kernels(const std::vector<uint8_t> &data, size_t offset) {
+    const uint8_t *p = data.data() + offset;
+    const andyzip::cpu_feature_set &cpu = andyzip::cpu_features();
+    (void)cpu;
+
+    for (size_t size : { (size_t)0, (size_t)1, (size_t)8, (size_t)9, (size_t)64, (size_t)1000, (size_t)65536 }) {
+      uint32_t slice8 = ~andyzip::detail::crc32_slice8(~0u, p, size);
+      CHECK(slice8 == reference_crc32(0, p, size));
+
+      #ifdef ANDYZIP_CRC32_PCLMUL
+        // whole 16 byte blocks, at least 64 bytes.
+        if (size >= 64 && cpu.pclmul && cpu.sse41) {
+          size_t n = size & ~(size_t)15;
+          CHECK(~andyzip::detail::crc32_pclmul(~0u, p, n) == ~andyzip::detail::crc32_slice8(~0u, p, n));
+          CHECK(~andyzip::detail::crc32_pclmul(~0u, p, n) == reference_crc32(0, p, n));
+          // a running crc goes in the first block.
+          uint32_t start = andyzip::detail::crc32_slice8(~0u, p + n, size - n);
+          CHECK(andyzip::detail::crc32_pclmul(start, p, n) == andyzip::detail::crc32_slice8(start, p, n));
+        }
+      #endif
+    }
+
+    // Adler-32 kernels take up to 5552 bytes between reductions.
+    for (size_t blocks : { (size_t)0, (size_t)1, (size_t)2, (size_t)3, (size_t)100, (size_t)5552 / 32 }) {
+      uint32_t a0 = 12345, b0 = 54321;
+      uint32_t a = a0, b = b0;
+      scalar_adler32_sums(a, b, p, blocks * 32);
+
+      #ifdef ANDYZIP_ADLER32_SSE2
+        {
+          uint32_t sa = a0, sb = b0;
+          andyzip::detail::adler32_sse2(sa, sb, p, blocks * 2);
+          CHECK(sa == a && sb == b);
+        }
+      #endif
+
+      #ifdef ANDYZIP_ADLER32_AVX2
+        if (cpu.avx2) {
+          uint32_t va = a0, vb = b0;
+          andyzip::detail::adler32_avx2(va, vb, p, blocks);
+          CHECK(va == a && vb == b);
+        }
+      #endif
+
+      CHECK((b % 65521) << 16 | (a % 65521) == reference_adler32(b0 << 16 | a0, p, blocks * 32));
+    }
+  }
+}
+
+int main() {
+  const char *check = "123456789";
+  CHECK(andyzip::crc32(0, check, 9) == 0xcbf43926);
+  CHECK(andyzip::crc32(0, "", 0) == 0);
+  CHECK(andyzip::crc32(0, "The quick brown fox jumps over the lazy dog", 43) == 0x414fa339);
+  CHECK(andyzip::adler32(1, "Wikipedia", 9) == 0x11e60398);
+  CHECK(andyzip::adler32(1, "", 0) == 1);
+
+  // all 0xff exercises the largest sums before the Adler-32 reductions.
+  std::vector<uint8_t> ones(1 << 20, 0xff);
+  CHECK(andyzip::adler32(1, ones.data(), ones.size()) == reference_adler32(1, ones.data(), ones.size()));
+
+  std::vector<uint8_t> data = andyzip_test::noise((1 << 20) + 123);
+  static const size_t sizes[] = { 1, 7, 15, 16, 17, 63, 64, 65, 127, 128, 129, 1000, 5551, 5552, 5553, 65536, 100003 };
+  for (size_t offset = 0; offset != 5; ++offset) {
+    for (size_t size : sizes) {
+      const uint8_t *p = data.data() + offset;
+      CHECK(andyzip::crc32(0, p, size) == reference_crc32(0, p, size));
+      CHECK(andyzip::adler32(1, p, size) == reference_adler32(1, p, size));
+    }
+  }
+
+  // the kernels agree with each other, with all bytes at their largest too.
+  for (size_t offset = 0; offset != 3; ++offset) {
+    check_kernels(data, offset);
+    check_kernels(ones, offset);
+  }
+
+  // checksums can be continued across buffers.
+  size_t size = data.size();
+  uint32_t crc = andyzip::crc32(0, data.data(), size);
+  uint32_t adler = andyzip::adler32(1, data.data(), size);
+  CHECK(crc == reference_crc32(0, data.data(), size));
+  CHECK(adler == reference_adler32(1, data.data(), size));
+  for (size_t split : { (size_t)1, (size_t)64, (size_t)5552, size / 3 }) {
+    CHECK(andyzip::crc32(andyzip::crc32(0, data.data(), split), data.data() + split, size - split) == crc);
+    CHECK(andyzip::adler32(andyzip::adler32(1, data.data(), split), data.data() + split, size - split) == adler);
+  }
+
+  return andyzip_test::result();
+}
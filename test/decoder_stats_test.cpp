@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// decoder_stats: a with_stats decoder counts every output byte as a literal
+// or part of a match, and counts the kinds of block it sees. Decoders without
+// stats carry nothing for them.
+//
+
+#include <andyzip/deflate_decoder.hpp>
+#include <andyzip/deflate_encoder.hpp>
+
+#include "test.hpp"
+
+#include <type_traits>
+
+namespace {
+  typedef andyzip::basic_deflate_decoder<andyzip::with_stats<andyzip::checked_input> > stats_decoder;
+
+  // zlib.compressobj(level, zlib.DEFLATED, -15, 9, strategy) from Python, of
+  // "it was the best of times, it was the worst of times, it was the age of wisdom, it was the age of foolishness".
+
+  // level 0: one stored block.
+  const uint8_t stored[] = {
+    0x01, 0x6c, 0x00, 0x93, 0xff, 0x69, 0x74, 0x20, 0x77, 0x61, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20,
+    0x62, 0x65, 0x73, 0x74, 0x20, 0x6f, 0x66, 0x20, 0x74, 0x69, 0x6d, 0x65, 0x73, 0x2c, 0x20, 0x69,
+    0x74, 0x20, 0x77, 0x61, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 0x77, 0x6f, 0x72, 0x73, 0x74, 0x20,
+    0x6f, 0x66, 0x20, 0x74, 0x69, 0x6d, 0x65, 0x73, 0x2c, 0x20, 0x69, 0x74, 0x20, 0x77, 0x61, 0x73,
+    0x20, 0x74, 0x68, 0x65, 0x20, 0x61, 0x67, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x77, 0x69, 0x73, 0x64,
+    0x6f, 0x6d, 0x2c, 0x20, 0x69, 0x74, 0x20, 0x77, 0x61, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 0x61,
+    0x67, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x66, 0x6f, 0x6f, 0x6c, 0x69, 0x73, 0x68, 0x6e, 0x65, 0x73,
+    0x73,
+  };
+
+  // level 6, Z_FIXED: one fixed block.
+  const uint8_t fixed[] = {
+    0xcb, 0x2c, 0x51, 0x28, 0x4f, 0x2c, 0x56, 0x28, 0xc9, 0x48, 0x55, 0x48, 0x4a, 0x2d, 0x2e, 0x51,
+    0xc8, 0x4f, 0x53, 0x28, 0xc9, 0xcc, 0x4d, 0x2d, 0xd6, 0x51, 0xc8, 0x44, 0xc8, 0x94, 0xe7, 0x17,
+    0xe1, 0x92, 0x4a, 0x4c, 0x4f, 0x05, 0x49, 0x94, 0x67, 0x16, 0xa7, 0xe4, 0xe7, 0x62, 0x93, 0x49,
+    0xcb, 0xcf, 0xcf, 0xc9, 0x2c, 0xce, 0xc8, 0x4b, 0x2d, 0x2e, 0x06, 0x00,
+  };
+
+  // level 6: one dynamic block.
+  const uint8_t dynamic[] = {
+    0x75, 0xc9, 0xc1, 0x09, 0x80, 0x30, 0x10, 0x04, 0xc0, 0x56, 0xb6, 0x00, 0x9b, 0x8a, 0xb8, 0x31,
+    0x07, 0xc6, 0x05, 0xf7, 0xe0, 0xda, 0x17, 0x5f, 0x7e, 0x74, 0xbe, 0x13, 0x89, 0x6a, 0x46, 0x0e,
+    0x62, 0xa5, 0x13, 0xea, 0xc8, 0x98, 0xf4, 0x82, 0x78, 0xa7, 0x74, 0xfd, 0x55, 0xdb, 0xf9, 0x44,
+    0x85, 0x37, 0xcd, 0xaf, 0xe9, 0xd2, 0x11, 0x1e, 0x27, 0xed, 0x1b,
+  };
+
+  const char text[] = "it was the best of times, it was the worst of times, it was the age of wisdom, it was the age of foolishness";
+
+  std::vector<uint8_t> decode(const stats_decoder &dec, const uint8_t *src, size_t size) {
+    std::vector<uint8_t> out;
+    if (!dec.decode_append(out, src, src + size)) return andyzip_test::bytes("decode failed");
+    return out;
+  }
+
+  uint64_t total_blocks(const andyzip::decoder_stats &stats) {
+    uint64_t total = 0;
+    for (uint64_t n : stats.blocks) total += n;
+    return total;
+  }
+}
+
+int main() {
+  using andyzip::decoder_stats;
+  std::vector<uint8_t> expected = andyzip_test::bytes(text);
+  stats_decoder dec;
+
+  // stored bytes are neither literals nor matches.
+  CHECK(decode(dec, stored, sizeof(stored)) == expected);
+  CHECK(dec.stats().blocks[decoder_stats::stored_block] == 1);
+  CHECK(total_blocks(dec.stats()) == 1);
+  CHECK(dec.stats().literals == 0);
+  CHECK(dec.stats().matches == 0);
+  CHECK(dec.stats().huffman_builds == 0);
+
+  CHECK(decode(dec, fixed, sizeof(fixed)) == expected);
+  CHECK(dec.stats().blocks[decoder_stats::fixed_block] == 1);
+  CHECK(total_blocks(dec.stats()) == 1);
+  CHECK(dec.stats().literals + dec.stats().match_bytes == expected.size());
+  CHECK(dec.stats().matches > 0);
+  CHECK(dec.stats().codes >= dec.stats().literals + dec.stats().matches);
+
+  // the stats are for the last stream only.
+  CHECK(decode(dec, dynamic, sizeof(dynamic)) == expected);
+  CHECK(dec.stats().blocks[decoder_stats::dynamic_block] == 1);
+  CHECK(total_blocks(dec.stats()) == 1);
+  CHECK(dec.stats().literals + dec.stats().match_bytes == expected.size());
+  CHECK(dec.stats().matches > 0);
+  CHECK(dec.stats().huffman_builds == 3);
+
+  // every match is in both histograms.
+  {
+    uint64_t lengths = 0, distances = 0;
+    for (unsigned i = 0; i != decoder_stats::histogram_size; ++i) {
+      lengths += dec.stats().length_histogram[i];
+      distances += dec.stats().distance_histogram[i];
+    }
+    CHECK(lengths == dec.stats().matches);
+    CHECK(distances == dec.stats().matches);
+  }
+
+  // a larger stream of many blocks from our encoder.
+  {
+    std::vector<uint8_t> in = andyzip_test::text(500000, 1);
+    andyzip::deflate_encoder enc(6);
+    std::vector<uint8_t> z(andyzip::deflate_encoder::max_encoded_size(in.size()));
+    uint8_t *end = enc.encode(z.data(), z.data() + z.size(), in.data(), in.data() + in.size());
+    CHECK(end != nullptr);
+    CHECK(decode(dec, z.data(), end - z.data()) == in);
+    const decoder_stats &stats = dec.stats();
+    CHECK(total_blocks(stats) > 1);
+    CHECK(stats.blocks[decoder_stats::dynamic_block] > 0);
+    CHECK(stats.huffman_builds == 3 * stats.blocks[decoder_stats::dynamic_block]);
+    CHECK(stats.blocks[decoder_stats::stored_block] == 0);
+    CHECK(stats.literals + stats.match_bytes == in.size());
+  }
+
+  // failed streams count what was decoded before the error, and clear first.
+  CHECK(decode(dec, dynamic, sizeof(dynamic) / 2) == andyzip_test::bytes("decode failed"));
+  CHECK(dec.stats().blocks[decoder_stats::dynamic_block] <= 1);
+
+  // decoders without stats hold no state for them: the decoder is still an
+  // empty class, its no_decoder_stats member taking the one byte any object has.
+  static_assert(std::is_empty<andyzip::no_decoder_stats>::value, "no_decoder_stats has no state");
+  static_assert(sizeof(andyzip::deflate_decoder) == 1, "deflate_decoder has no state");
+  static_assert(sizeof(andyzip::trusted_deflate_decoder) == 1, "trusted_deflate_decoder has no state");
+  CHECK(sizeof(stats_decoder) >= sizeof(andyzip::decoder_stats));
+
+  return andyzip_test::result();
+}
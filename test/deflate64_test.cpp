@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Deflate64 (zip method 9) on a hand made stream that uses what differs from
+// deflate: length code 285 with 16 extra bits, distance codes 30 and 31 and the
+// 64k window. Checked with deflate64_decoder and through zipfile_reader.
+//
+
+#include <andyzip/checksum.hpp>
+#include <andyzip/deflate_decoder.hpp>
+#include <andyzip/zipfile_reader.hpp>
+
+#include "test.hpp"
+
+namespace {
+  // Fixed Huffman literal/length code.
+  void symbol(andyzip_test::bit_writer &w, unsigned sym) {
+    if (sym < 144) w.code(0x30 + sym, 8);
+    else if (sym < 256) w.code(0x190 + sym - 144, 9);
+    else if (sym < 280) w.code(sym - 256, 7);
+    else w.code(0xc0 + sym - 280, 8);
+  }
+
+  // Length code 285 (3 + 16 bits) and distance code 30 (32769 + 14 bits) or 31 (49153 + 14 bits).
+  void match(andyzip_test::bit_writer &w, std::vector<uint8_t> &expected, unsigned length, unsigned distance) {
+    symbol(w, 285);
+    w.put(16, length - 3);
+    if (distance >= 49153) {
+      w.code(31, 5);
+      w.put(14, distance - 49153);
+    } else {
+      w.code(30, 5);
+      w.put(14, distance - 32769);
+    }
+    for (unsigned i = 0; i != length; ++i) expected.push_back(expected[expected.size() - distance]);
+  }
+
+  void put2(std::vector<uint8_t> &d, unsigned value) {
+    d.push_back((uint8_t)value);
+    d.push_back((uint8_t)(value >> 8));
+  }
+
+  void put4(std::vector<uint8_t> &d, uint32_t value) {
+    put2(d, value & 0xffff);
+    put2(d, value >> 16);
+  }
+
+  // A zip with one member of the given method.
+  std::vector<uint8_t> make_zip(const std::string &name, unsigned method, const std::vector<uint8_t> &data, const std::vector<uint8_t> &expected) {
+    uint32_t crc = andyzip::crc32(0, expected.data(), expected.size());
+    std::vector<uint8_t> zip;
+    put4(zip, 0x04034b50);
+    put2(zip, 21); put2(zip, 0); put2(zip, method); put4(zip, 0x00210000);
+    put4(zip, crc); put4(zip, (uint32_t)data.size()); put4(zip, (uint32_t)expected.size());
+    put2(zip, (unsigned)name.size()); put2(zip, 0);
+    zip.insert(zip.end(), name.begin(), name.end());
+    zip.insert(zip.end(), data.begin(), data.end());
+
+    size_t dir = zip.size();
+    put4(zip, 0x02014b50);
+    put2(zip, 21); put2(zip, 21); put2(zip, 0); put2(zip, method); put4(zip, 0x00210000);
+    put4(zip, crc); put4(zip, (uint32_t)data.size()); put4(zip, (uint32_t)expected.size());
+    put2(zip, (unsigned)name.size()); put2(zip, 0); put2(zip, 0); put2(zip, 0); put2(zip, 0);
+    put4(zip, 0); put4(zip, 0);
+    zip.insert(zip.end(), name.begin(), name.end());
+
+    size_t dir_size = zip.size() - dir;
+    put4(zip, 0x06054b50);
+    put2(zip, 0); put2(zip, 0); put2(zip, 1); put2(zip, 1);
+    put4(zip, (uint32_t)dir_size); put4(zip, (uint32_t)dir); put2(zip, 0);
+    return zip;
+  }
+}
+
+int main() {
+  andyzip_test::bit_writer w;
+  std::vector<uint8_t> expected = andyzip_test::noise(65535);
+
+  // a stored block fills the 64k window.
+  w.put(1, 0);
+  w.put(2, 0);
+  w.flush();
+  put2(w.bytes, 65535);
+  put2(w.bytes, 0);
+  w.bytes.insert(w.bytes.end(), expected.begin(), expected.end());
+
+  // then a fixed block of literals and long, distant matches.
+  w.put(1, 1);
+  w.put(2, 1);
+  for (uint8_t c : andyzip_test::bytes("deflate64")) {
+    symbol(w, c);
+    expected.push_back(c);
+  }
+  match(w, expected, 300, 40000);
+  match(w, expected, 3, 32769);
+  match(w, expected, 65538, 65536);
+  match(w, expected, 1000, 49153);
+  match(w, expected, 4, 65536);
+  symbol(w, '!');
+  expected.push_back('!');
+  symbol(w, 256);
+  w.flush();
+
+  const uint8_t *src = w.bytes.data(), *src_max = w.bytes.data() + w.bytes.size();
+  andyzip::deflate64_decoder dec64;
+  {
+    std::vector<uint8_t> out(expected.size());
+    CHECK(dec64.decode(out.data(), out.data() + out.size(), src, src_max));
+    CHECK(out == expected);
+  }
+  {
+    std::vector<uint8_t> out;
+    CHECK(dec64.decode_append(out, src, src_max) == src_max);
+    CHECK(out == expected);
+
+    // one byte short of the output fails.
+    std::vector<uint8_t> small(expected.size() - 1);
+    CHECK(!dec64.decode(small.data(), small.data() + small.size(), src, src_max));
+  }
+
+  // plain deflate has no distance codes 30 and 31.
+  {
+    std::vector<uint8_t> out(expected.size());
+    CHECK(!andyzip::deflate_decoder().decode(out.data(), out.data() + out.size(), src, src_max));
+  }
+
+  // through a zip member of method 9.
+  {
+    std::vector<uint8_t> zip = make_zip("d64.bin", 9, w.bytes, expected);
+    zipfile_reader reader(zip.data(), zip.data() + zip.size());
+    CHECK(reader.read("d64.bin") == expected);
+
+    // method 8 with the same data must not decode.
+    std::vector<uint8_t> zip8 = make_zip("d64.bin", 8, w.bytes, expected);
+    zipfile_reader reader8(zip8.data(), zip8.data() + zip8.size());
+    CHECK_THROWS(std::runtime_error, reader8.read("d64.bin"));
+  }
+
+  return andyzip_test::result();
+}
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// deflate_index: random reads from checkpoints must match a full decode,
+// before and after a serialize/deserialize round trip.
+//
+
+#include <andyzip/deflate_index.hpp>
+#include <andyzip/gzip.hpp>
+
+#include "test.hpp"
+
+#include <cstring>
+
+namespace {
+  bool read_matches(const andyzip::deflate_index &index, const uint8_t *begin, const uint8_t *end, const std::vector<uint8_t> &expected, uint64_t offset, size_t size) {
+    std::vector<uint8_t> buffer(size + 1, 0xcc);
+    size_t n = index.read(begin, end, offset, buffer.data(), size);
+    size_t expected_n = offset >= expected.size() ? 0 : std::min(size, (size_t)(expected.size() - offset));
+    return n == expected_n && !memcmp(buffer.data(), expected.data() + (size_t)offset, n) && buffer[size] == 0xcc;
+  }
+
+  void test_stream(const std::vector<uint8_t> &in, int level, uint64_t span) {
+    andyzip::gzip_writer writer(level);
+    std::vector<uint8_t> gz = writer.write(in.data(), in.data() + in.size());
+    andyzip::gzip_reader reader(gz.data(), gz.data() + gz.size());
+    const uint8_t *begin = reader.data(), *end = gz.data() + gz.size();
+
+    andyzip::deflate_index index(begin, end, span);
+    CHECK(index.size() == in.size());
+    CHECK(index.span() == span);
+    CHECK(index.checkpoints().size() > 1);
+
+    std::vector<uint8_t> side_file = index.serialize();
+    andyzip::deflate_index loaded = andyzip::deflate_index::deserialize(side_file.data(), side_file.data() + side_file.size());
+    CHECK(loaded.size() == index.size());
+    CHECK(loaded.checkpoints().size() == index.checkpoints().size());
+
+    // reads at checkpoints, either side of them, across several of them and past the end.
+    std::vector<std::pair<uint64_t, size_t> > reads = {
+      { 0, 1 }, { 0, 100 }, { 1, 70000 }, { in.size() - 1, 1 }, { in.size() - 10, 100 }, { in.size(), 10 }, { 0, in.size() },
+    };
+    for (auto &c : index.checkpoints()) {
+      reads.emplace_back(c.out_offset, 1000);
+      if (c.out_offset) reads.emplace_back(c.out_offset - 1, 2);
+      reads.emplace_back(c.out_offset + 12345, span * 2 + 7);
+    }
+    uint32_t seed = 7;
+    for (int i = 0; i != 50; ++i) {
+      seed = seed * 1664525 + 1013904223;
+      uint64_t offset = seed % in.size();
+      seed = seed * 1664525 + 1013904223;
+      reads.emplace_back(offset, seed % 100000);
+    }
+
+    for (auto &r : reads) {
+      CHECK(read_matches(index, begin, end, in, r.first, r.second));
+      CHECK(read_matches(loaded, begin, end, in, r.first, r.second));
+    }
+  }
+}
+
+int main() {
+  test_stream(andyzip_test::text(3000000), 6, 1 << 18);
+  test_stream(andyzip_test::text(1000000, 5), 1, 100000);
+
+  // stored blocks have no Huffman tables to carry over.
+  test_stream(andyzip_test::noise(500000), 0, 65536);
+
+  // a corrupt side file is rejected.
+  {
+    std::vector<uint8_t> in = andyzip_test::text(500000);
+    andyzip::gzip_writer writer;
+    std::vector<uint8_t> gz = writer.write(in.data(), in.data() + in.size());
+    andyzip::gzip_reader reader(gz.data(), gz.data() + gz.size());
+    andyzip::deflate_index index(reader.data(), gz.data() + gz.size(), 65536);
+    std::vector<uint8_t> side_file = index.serialize();
+    side_file[0] ^= 1;
+    CHECK_THROWS(std::runtime_error, andyzip::deflate_index::deserialize(side_file.data(), side_file.data() + side_file.size()));
+    side_file[0] ^= 1;
+    side_file.resize(side_file.size() / 2);
+    CHECK_THROWS(std::runtime_error, andyzip::deflate_index::deserialize(side_file.data(), side_file.data() + side_file.size()));
+  }
+
+  return andyzip_test::result();
+}
@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Stride delta filter: the SSE2 and scalar paths against a plain reference,
+// round trips for every stride and awkward sizes, and encode_filtered/unfilter.
+//
+
+#include <andyzip/deflate_decoder.hpp>
+#include <andyzip/deflate_encoder.hpp>
+#include <andyzip/filters.hpp>
+
+#include "test.hpp"
+
+namespace {
+  // Byte planes one after another, each delta coded.
+  std::vector<uint8_t> reference_forward(const std::vector<uint8_t> &src, unsigned stride) {
+    if (stride == 0) stride = 1;
+    std::vector<uint8_t> result;
+    for (size_t k = 0; k < stride; ++k) {
+      for (size_t i = k; i < src.size(); i += stride) {
+        result.push_back((uint8_t)(src[i] - (i >= stride ? src[i - stride] : 0)));
+      }
+    }
+    return result;
+  }
+
+  // Records of 32 bit integers that grow slowly, as in a table of offsets.
+  std::vector<uint8_t> records(size_t count, unsigned fields) {
+    std::vector<uint8_t> result;
+    for (uint32_t i = 0; i != count; ++i) {
+      for (unsigned f = 0; f != fields; ++f) {
+        uint32_t value = i * (f + 3) + f * 100000;
+        for (int b = 0; b != 4; ++b) result.push_back((uint8_t)(value >> (b * 8)));
+      }
+    }
+    return result;
+  }
+
+  std::vector<uint8_t> round_trip(const std::vector<uint8_t> &in, unsigned stride) {
+    andyzip::deflate_encoder enc;
+    std::vector<uint8_t> z(in.size() + in.size() / 8 + 1024);
+    uint8_t *end = andyzip::encode_filtered(enc, z.data(), z.data() + z.size(), in.data(), in.data() + in.size(), stride);
+    if (!end) return std::vector<uint8_t>(1);
+    z.resize(end - z.data());
+    std::vector<uint8_t> out;
+    if (!andyzip::deflate_decoder().decode_append(out, z.data(), z.data() + z.size())) return std::vector<uint8_t>(2);
+    if (!andyzip::unfilter(out)) return std::vector<uint8_t>(3);
+    return out;
+  }
+}
+
+int main() {
+  static const size_t sizes[] = { 0, 1, 2, 15, 16, 17, 31, 255, 256, 257, 1000, 4099, 65536 + 13 };
+  for (size_t size : sizes) {
+    std::vector<uint8_t> src = andyzip_test::noise(size, (uint32_t)size);
+    for (unsigned stride = 0; stride <= 20; ++stride) {
+      std::vector<uint8_t> filtered(size), restored(size);
+      andyzip::stride_delta_forward(filtered.data(), src.data(), size, stride);
+      CHECK(filtered == reference_forward(src, stride));
+      andyzip::stride_delta_inverse(restored.data(), filtered.data(), size, stride);
+      CHECK(restored == src);
+    }
+    for (unsigned stride : { 32u, 255u }) {
+      std::vector<uint8_t> filtered(size), restored(size);
+      andyzip::stride_delta_forward(filtered.data(), src.data(), size, stride);
+      andyzip::stride_delta_inverse(restored.data(), filtered.data(), size, stride);
+      CHECK(restored == src);
+    }
+  }
+
+  // choose_stride finds record structure and leaves noise alone.
+  std::vector<uint8_t> table = records(50000, 1);
+  CHECK(andyzip::choose_stride(table.data(), table.data() + table.size()) == 4);
+  std::vector<uint8_t> noise = andyzip_test::noise(100000);
+  CHECK(andyzip::choose_stride(noise.data(), noise.data() + noise.size()) == 0);
+
+  // encode_filtered and unfilter, with a chosen stride and with explicit ones.
+  for (auto &in : { table, records(20001, 3), noise, andyzip_test::text(30000), std::vector<uint8_t>() }) {
+    CHECK(round_trip(in, 0) == in);
+    CHECK(round_trip(in, 3) == in);
+    CHECK(round_trip(in, 12) == in);
+  }
+
+  std::vector<uint8_t> empty;
+  CHECK(!andyzip::unfilter(empty));
+
+  return andyzip_test::result();
+}
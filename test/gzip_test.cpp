@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// gzip and zlib: decode streams made by other tools, round trip our own
+// and check that corrupt trailers are reported.
+//
+
+#include <andyzip/gzip.hpp>
+#include <andyzip/zlib.hpp>
+
+#include "test.hpp"
+
+namespace {
+  // gzip.compress(b"hello world\n", mtime=0) from Python.
+  const uint8_t hello_gz[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0x57,
+    0x28, 0xcf, 0x2f, 0xca, 0x49, 0xe1, 0x02, 0x00, 0x2d, 0x3b, 0x08, 0xaf, 0x0c, 0x00, 0x00, 0x00,
+  };
+
+  // zlib.compress(b"hello hello hello world\n") from Python.
+  const uint8_t hello_z[] = {
+    0x78, 0x9c, 0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0x57, 0xc8, 0x40, 0x22, 0xcb, 0xf3, 0x8b, 0x72, 0x52,
+    0xb8, 0x00, 0x71, 0x4c, 0x08, 0xcf,
+  };
+
+  std::vector<uint8_t> gunzip(const std::vector<uint8_t> &gz) {
+    return andyzip::gzip_reader(gz.data(), gz.data() + gz.size()).read();
+  }
+
+  std::vector<uint8_t> unzlib(const std::vector<uint8_t> &z, const std::vector<uint8_t> &dict = std::vector<uint8_t>()) {
+    andyzip::zlib_reader reader(z.data(), z.data() + z.size());
+    return dict.empty() ? reader.read() : reader.read(dict.data(), dict.size());
+  }
+}
+
+int main() {
+  using andyzip_test::bytes;
+
+  {
+    andyzip::gzip_reader reader(hello_gz, hello_gz + sizeof(hello_gz));
+    CHECK(reader.read() == bytes("hello world\n"));
+    CHECK(reader.mtime() == 0);
+  }
+  {
+    andyzip::zlib_reader reader(hello_z, hello_z + sizeof(hello_z));
+    CHECK(!reader.has_dictionary());
+    CHECK(reader.read() == bytes("hello hello hello world\n"));
+  }
+
+  std::vector<std::vector<uint8_t> > inputs = {
+    std::vector<uint8_t>(),
+    bytes("a"),
+    andyzip_test::text(100000),
+    andyzip_test::noise(70000),
+    std::vector<uint8_t>(300000, 'x'),
+  };
+
+  for (int level : { 0, 1, 6, 9 }) {
+    for (auto &in : inputs) {
+      andyzip::gzip_writer gw(level);
+      std::vector<uint8_t> gz = gw.write(in.data(), in.data() + in.size(), "name.txt", 1234567);
+      andyzip::gzip_reader reader(gz.data(), gz.data() + gz.size());
+      CHECK(reader.read() == in);
+      CHECK(reader.filename() == "name.txt");
+      CHECK(reader.mtime() == 1234567);
+
+      andyzip::zlib_writer zw(level);
+      std::vector<uint8_t> z = zw.write(in.data(), in.data() + in.size());
+      CHECK(unzlib(z) == in);
+    }
+  }
+
+  // concatenated gzip members decode as one file.
+  {
+    std::vector<uint8_t> a = bytes("first member\n"), b = andyzip_test::text(5000, 2);
+    andyzip::gzip_writer gw;
+    std::vector<uint8_t> gz = gw.write(a.data(), a.data() + a.size());
+    std::vector<uint8_t> gz2 = gw.write(b.data(), b.data() + b.size());
+    gz.insert(gz.end(), gz2.begin(), gz2.end());
+    a.insert(a.end(), b.begin(), b.end());
+    CHECK(gunzip(gz) == a);
+  }
+
+  // preset dictionary.
+  {
+    std::vector<uint8_t> dict = andyzip_test::text(2000, 3);
+    std::vector<uint8_t> in = andyzip_test::text(10000, 4);
+    andyzip::zlib_writer zw;
+    std::vector<uint8_t> z = zw.write(in.data(), in.data() + in.size(), dict.data(), dict.size());
+    andyzip::zlib_reader reader(z.data(), z.data() + z.size());
+    CHECK(reader.has_dictionary());
+    CHECK(reader.dictionary_id() == andyzip::adler32(1, dict.data(), dict.size()));
+    CHECK(unzlib(z, dict) == in);
+    CHECK_THROWS(std::runtime_error, unzlib(z));
+    CHECK_THROWS(std::runtime_error, unzlib(z, bytes("wrong dictionary")));
+  }
+
+  // corrupt trailers.
+  {
+    std::vector<uint8_t> in = andyzip_test::text(1000);
+    andyzip::gzip_writer gw;
+    std::vector<uint8_t> gz = gw.write(in.data(), in.data() + in.size());
+    std::vector<uint8_t> bad = gz;
+    bad[bad.size() - 8] ^= 1;
+    CHECK_THROWS(std::runtime_error, gunzip(bad));
+    bad = gz;
+    bad[bad.size() - 1] ^= 1;
+    CHECK_THROWS(std::runtime_error, gunzip(bad));
+    bad.assign(gz.begin(), gz.end() - 6);
+    CHECK_THROWS(std::runtime_error, gunzip(bad));
+
+    andyzip::zlib_writer zw;
+    std::vector<uint8_t> z = zw.write(in.data(), in.data() + in.size());
+    z.back() ^= 1;
+    CHECK_THROWS(std::runtime_error, unzlib(z));
+  }
+
+  return andyzip_test::result();
+}
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// parallel_deflate_decoder must give the same output as the serial decoder,
+// whatever the chunk size and number of threads.
+//
+
+#include <andyzip/deflate_encoder.hpp>
+#include <andyzip/parallel_deflate_decoder.hpp>
+
+#include "test.hpp"
+
+namespace {
+  std::vector<uint8_t> deflate(const std::vector<uint8_t> &in, int level) {
+    andyzip::deflate_encoder enc(level);
+    std::vector<uint8_t> out(in.size() + in.size() / 8 + 1024);
+    uint8_t *end = enc.encode(out.data(), out.data() + out.size(), in.data(), in.data() + in.size());
+    out.resize(end ? end - out.data() : 0);
+    return out;
+  }
+}
+
+int main() {
+  // text with runs of noise, so that chunks start in the middle of long matches
+  // and back references reach into the unknown window before a chunk.
+  std::vector<uint8_t> in;
+  for (uint32_t i = 0; in.size() < 6000000; ++i) {
+    std::vector<uint8_t> t = andyzip_test::text(200000 + i * 1000, i);
+    std::vector<uint8_t> n = andyzip_test::noise(3000 + i * 100, i);
+    in.insert(in.end(), t.begin(), t.end());
+    in.insert(in.end(), n.begin(), n.end());
+  }
+
+  for (int level : { 1, 6 }) {
+    std::vector<uint8_t> z = deflate(in, level);
+    CHECK(!z.empty());
+    const uint8_t *src = z.data(), *src_max = z.data() + z.size();
+
+    std::vector<uint8_t> serial;
+    const uint8_t *serial_end = andyzip::deflate_decoder().decode_append(serial, src, src_max);
+    CHECK(serial_end != nullptr);
+    CHECK(serial == in);
+
+    for (unsigned threads : { 1u, 2u, 4u }) {
+      for (size_t chunk_size : { (size_t)65536, (size_t)100000, (size_t)300001 }) {
+        andyzip::parallel_deflate_decoder dec(threads, chunk_size);
+
+        // output is appended to what is already there.
+        std::vector<uint8_t> out = andyzip_test::bytes("prefix");
+        const uint8_t *end = dec.decode_append(out, src, src_max);
+        CHECK(end == serial_end);
+        CHECK(out.size() == in.size() + 6);
+        CHECK(std::equal(in.begin(), in.end(), out.begin() + 6));
+
+        // with more than one thread the work really was split up.
+        CHECK(threads == 1 ? dec.chunks_joined() == 1 : dec.chunks_joined() > 1);
+      }
+    }
+
+    // a truncated stream fails rather than returning partial output as success.
+    std::vector<uint8_t> out;
+    CHECK(andyzip::parallel_deflate_decoder(4, 65536).decode_append(out, src, src + z.size() / 2) == nullptr);
+  }
+
+  return andyzip_test::result();
+}
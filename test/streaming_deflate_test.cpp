@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// streaming_deflate_decoder::decode_to() on streams many times the size of its
+// ring, with and without a preset dictionary, must give the same bytes in the
+// same order as decoding to one buffer.
+//
+
+#include <andyzip/deflate_decoder.hpp>
+#include <andyzip/deflate_encoder.hpp>
+
+#include "test.hpp"
+
+namespace {
+  typedef andyzip::streaming_deflate_decoder decoder_t;
+
+  std::vector<uint8_t> deflate(const std::vector<uint8_t> &in, const std::vector<uint8_t> &dictionary) {
+    andyzip::deflate_encoder enc(6);
+    std::vector<uint8_t> out(andyzip::deflate_encoder::max_encoded_size(in.size()));
+    const uint8_t *dict = dictionary.empty() ? nullptr : dictionary.data();
+    uint8_t *end = enc.encode(out.data(), out.data() + out.size(), in.data(), in.data() + in.size(), dict, dictionary.size());
+    out.resize(end ? end - out.data() : 0);
+    return out;
+  }
+
+  // Decode with decode_to(), collecting the output and the number of pieces handed to the sink.
+  std::vector<uint8_t> decode_to(const std::vector<uint8_t> &z, const std::vector<uint8_t> &dictionary, size_t &pieces, bool &ok) {
+    std::vector<uint8_t> out;
+    pieces = 0;
+    decoder_t::sink_type sink = [&](const uint8_t *data, size_t size) {
+      out.insert(out.end(), data, data + size);
+      CHECK(size <= decoder_t::window_size + decoder_t::ring_chunk_size);
+      pieces++;
+    };
+    const uint8_t *dict = dictionary.empty() ? nullptr : dictionary.data();
+    const uint8_t *end = decoder_t().decode_to(sink, z.data(), z.data() + z.size(), dict, dictionary.size());
+    ok = end == z.data() + z.size();
+    return out;
+  }
+}
+
+int main() {
+  const size_t ring_size = decoder_t::window_size + decoder_t::ring_chunk_size;
+
+  // text, with noise between so that some blocks are stored.
+  std::vector<uint8_t> in;
+  for (uint32_t i = 0; in.size() < ring_size * 5; ++i) {
+    std::vector<uint8_t> t = andyzip_test::text(150000 + i * 777, i);
+    std::vector<uint8_t> n = andyzip_test::noise(20000, i);
+    in.insert(in.end(), t.begin(), t.end());
+    in.insert(in.end(), n.begin(), n.end());
+  }
+
+  // the dictionary starts the stream off with matches reaching before it.
+  std::vector<uint8_t> dictionary = andyzip_test::text(40000, 7);
+  std::vector<uint8_t> with_dict(dictionary.end() - 20000, dictionary.end());
+  with_dict.insert(with_dict.end(), in.begin(), in.end());
+
+  for (bool use_dictionary : { false, true }) {
+    const std::vector<uint8_t> d = use_dictionary ? dictionary : std::vector<uint8_t>();
+    const std::vector<uint8_t> &data = use_dictionary ? with_dict : in;
+    std::vector<uint8_t> z = deflate(data, d);
+    CHECK(!z.empty());
+    CHECK(data.size() > ring_size * 5);
+
+    size_t pieces;
+    bool ok;
+    CHECK(decode_to(z, d, pieces, ok) == data);
+    CHECK(ok);
+    CHECK(pieces > 5);
+
+    // the same as decoding to one buffer.
+    std::vector<uint8_t> flat;
+    CHECK(andyzip::deflate_decoder().decode_append(flat, z.data(), z.data() + z.size(), 0, d.empty() ? nullptr : d.data(), d.size()) != nullptr);
+    CHECK(flat == data);
+
+    // matches do reach into the dictionary.
+    if (use_dictionary) {
+      andyzip::basic_deflate_decoder<andyzip::with_stats<andyzip::with_ring_output<andyzip::checked_input> > > dec;
+      CHECK(dec.decode_to([](const uint8_t *, size_t) {}, z.data(), z.data() + z.size(), d.data(), d.size()) != nullptr);
+      CHECK(dec.stats().dictionary_refs > 0);
+    }
+
+    // a truncated stream fails after handing on what came before the cut.
+    std::vector<uint8_t> cut(z.begin(), z.begin() + z.size() / 2);
+    std::vector<uint8_t> partial = decode_to(cut, d, pieces, ok);
+    CHECK(!ok);
+    CHECK(partial.size() < data.size());
+    CHECK(std::equal(partial.begin(), partial.end(), data.begin()));
+  }
+
+  // without its dictionary, a stream that uses one fails.
+  {
+    std::vector<uint8_t> z = deflate(with_dict, dictionary);
+    size_t pieces;
+    bool ok;
+    std::vector<uint8_t> out = decode_to(z, std::vector<uint8_t>(), pieces, ok);
+    CHECK(!ok || out != with_dict);
+  }
+
+  return andyzip_test::result();
+}
@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// Helpers for the round trip and known answer tests in this directory.
+//
+// Each test is a small program: CHECK prints failures and main returns
+// andyzip_test::result() so that ctest sees a nonzero exit code.
+//
+
+#ifndef ANDYZIP_TEST_HPP_
+#define ANDYZIP_TEST_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <vector>
+
+#define CHECK(cond) andyzip_test::check((cond), #cond, __FILE__, __LINE__)
+
+// Check that expr throws an exception of type E.
+#define CHECK_THROWS(E, expr) do { \
+    bool thrown_ = false; \
+    try { expr; } catch (const E &) { thrown_ = true; } catch (...) {} \
+    andyzip_test::check(thrown_, "throws " #E ": " #expr, __FILE__, __LINE__); \
+  } while (0)
+
+namespace andyzip_test {
+  inline int &failures() { static int n = 0; return n; }
+
+  inline bool check(bool ok, const char *what, const char *file, int line) {
+    if (!ok) {
+      fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+      ++failures();
+    }
+    return ok;
+  }
+
+  inline int result() {
+    if (failures()) fprintf(stderr, "%d checks failed\n", failures());
+    return failures() ? 1 : 0;
+  }
+
+  // Reproducible pseudo-random bytes.
+  inline std::vector<uint8_t> noise(size_t size, uint32_t seed = 1) {
+    std::vector<uint8_t> result(size);
+    for (auto &b : result) {
+      seed = seed * 1664525 + 1013904223;
+      b = (uint8_t)(seed >> 24);
+    }
+    return result;
+  }
+
+  // Reproducible compressible text: words from a small vocabulary.
+  inline std::vector<uint8_t> text(size_t size, uint32_t seed = 1) {
+    static const char *words[] = {
+      "the ", "quick ", "brown ", "fox ", "jumps ", "over ", "lazy ", "dog ", "zip ", "file ",
+      "deflate ", "huffman ", "table ", "window ", "block ", "length ", "distance ", "literal ",
+      "stream ", "archive ", "member ", "header ", "\n", ", ", ". ",
+    };
+    std::vector<uint8_t> result;
+    result.reserve(size + 16);
+    while (result.size() < size) {
+      seed = seed * 1664525 + 1013904223;
+      const char *w = words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+      while (*w) result.push_back((uint8_t)*w++);
+    }
+    result.resize(size);
+    return result;
+  }
+
+  inline std::vector<uint8_t> bytes(const std::string &str) {
+    return std::vector<uint8_t>(str.begin(), str.end());
+  }
+
+  // Bits for hand made deflate and brotli streams: values LSB first, Huffman codes MSB first.
+  struct bit_writer {
+    std::vector<uint8_t> bytes;
+    uint32_t acc = 0;
+    unsigned n = 0;
+
+    void put(unsigned bits, uint32_t value) {
+      for (unsigned i = 0; i != bits; ++i) {
+        acc |= (value >> i & 1) << n;
+        if (++n == 8) flush();
+      }
+    }
+
+    void code(uint32_t value, unsigned bits) {
+      for (unsigned i = bits; i-- != 0; ) put(1, value >> i & 1);
+    }
+
+    // Pad to a byte boundary with zeros.
+    void flush() {
+      if (n) bytes.push_back((uint8_t)acc);
+      acc = 0;
+      n = 0;
+    }
+  };
+}
+
+#endif
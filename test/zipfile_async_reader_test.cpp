@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// zipfile_async_reader: extract every member of an archive on disk through
+// io_uring (where the kernel has it) and through the pread threads, with large
+// and small in flight budgets, and check errors reach the callback and wait().
+//
+
+#include <andyzip/zipfile_async_reader.hpp>
+#include <andyzip/zipfile_writer.hpp>
+
+#include "test.hpp"
+
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <unistd.h>
+
+namespace {
+  // An unlinked temporary file holding data. The caller closes it.
+  int temp_file(const std::vector<uint8_t> &data) {
+    char name[] = "andyzip_async_test_XXXXXX";
+    int fd = mkstemp(name);
+    if (fd < 0) return fd;
+    unlink(name);
+    if (write(fd, data.data(), data.size()) != (ssize_t)data.size()) {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  // Extract every member, returning the data by name and counting the errors.
+  std::map<std::string, std::vector<uint8_t> > extract_all(int fd, bool use_io_uring, size_t max_in_flight, int &errors, int &calls) {
+    std::map<std::string, std::vector<uint8_t> > result;
+    std::mutex mutex;
+    errors = calls = 0;
+    andyzip::zipfile_async_reader reader(fd, 3, max_in_flight, use_io_uring);
+    CHECK(use_io_uring || !reader.uses_io_uring());
+    for (auto e : reader.entries()) {
+      reader.extract(e, [&](const zipfile_reader::entry &e, std::vector<uint8_t> &data, std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        calls++;
+        if (error) errors++;
+        result[std::string(e.name(), e.name_size())].swap(data);
+      });
+    }
+    reader.wait();
+    return result;
+  }
+}
+
+int main() {
+  std::map<std::string, std::vector<uint8_t> > members;
+  std::vector<uint8_t> zip;
+  {
+    andyzip::zipfile_writer writer([&zip](const uint8_t *data, size_t size) { zip.insert(zip.end(), data, data + size); });
+    for (int i = 0; i != 300; ++i) {
+      std::string name = "m" + std::to_string(i);
+      members[name] = i % 3 == 0 ? andyzip_test::noise(i * 31, i) : andyzip_test::text(i * 101, i);
+      writer.add(name, members[name]);
+    }
+    members["big.txt"] = andyzip_test::text(1000000);
+    writer.add("big.txt", members["big.txt"]);
+
+    // a member with a data descriptor.
+    members["streamed.txt"] = andyzip_test::text(200000, 5);
+    writer.begin_member("streamed.txt");
+    writer.write(members["streamed.txt"].data(), members["streamed.txt"].size());
+    writer.end_member();
+    writer.finish();
+  }
+
+  int fd = temp_file(zip);
+  if (!CHECK(fd >= 0)) return andyzip_test::result();
+
+  for (bool use_io_uring : { true, false }) {
+    // a budget smaller than one member still lets that member through on its own.
+    for (size_t max_in_flight : { (size_t)64 << 20, (size_t)100000 }) {
+      int errors = 0, calls = 0;
+      auto got = extract_all(fd, use_io_uring, max_in_flight, errors, calls);
+      CHECK(errors == 0);
+      CHECK(calls == (int)members.size());
+      CHECK(got == members);
+    }
+  }
+
+  // an exception from a callback is passed on by wait(), once.
+  for (bool use_io_uring : { true, false }) {
+    andyzip::zipfile_async_reader reader(fd, 2, 64 << 20, use_io_uring);
+    std::atomic<int> calls(0);
+    for (auto e : reader.entries()) {
+      reader.extract(e, [&](const zipfile_reader::entry &e, std::vector<uint8_t> &, std::exception_ptr) {
+        calls++;
+        if (e.name_is("m7")) throw std::logic_error("callback failed");
+      });
+    }
+    CHECK_THROWS(std::logic_error, reader.wait());
+    CHECK(calls == (int)members.size());
+    reader.wait();
+  }
+  close(fd);
+
+  // a corrupt member gets an error and empty data; the rest are unaffected.
+  {
+    zipfile_reader index(zip.data(), zip.data() + zip.size());
+    zipfile_reader::entry e = *index.find("m10");
+    std::vector<uint8_t> bad = zip;
+    bad[e.offset() + 30 + e.name_size() + e.compressed_size() / 2] ^= 0x55;
+    fd = temp_file(bad);
+    if (!CHECK(fd >= 0)) return andyzip_test::result();
+    for (bool use_io_uring : { true, false }) {
+      int errors = 0, calls = 0;
+      auto got = extract_all(fd, use_io_uring, 64 << 20, errors, calls);
+      CHECK(errors == 1);
+      CHECK(calls == (int)members.size());
+      CHECK(got["m10"].empty());
+      got["m10"] = members["m10"];
+      CHECK(got == members);
+    }
+    close(fd);
+  }
+
+  return andyzip_test::result();
+}
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// zipfile_cache: least recently used eviction within the byte budget, hit and
+// miss counts, lookups by name and reads from several threads.
+//
+
+#include <andyzip/zipfile_cache.hpp>
+#include <andyzip/zipfile_writer.hpp>
+
+#include "test.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+  std::string name(int i) { return "m" + std::to_string(i); }
+
+  std::vector<uint8_t> content(int i) { return andyzip_test::text(1000, (uint32_t)i); }
+}
+
+int main() {
+  std::vector<uint8_t> zip;
+  {
+    andyzip::zipfile_writer writer([&zip](const uint8_t *data, size_t size) { zip.insert(zip.end(), data, data + size); });
+    for (int i = 0; i != 10; ++i) writer.add(name(i), content(i));
+    writer.add("big", andyzip_test::text(10000));
+    writer.add("dup", andyzip_test::bytes("first"));
+    writer.add("dup", andyzip_test::bytes("second"));
+    writer.finish();
+  }
+  zipfile_reader reader(zip.data(), zip.data() + zip.size());
+
+  // room for three members.
+  andyzip::zipfile_cache cache(reader, 3500);
+  CHECK(*cache.read(name(0)) == content(0));
+  CHECK(*cache.read(name(1)) == content(1));
+  andyzip::zipfile_cache::buffer held = cache.read(name(2));
+  CHECK(cache.misses() == 3 && cache.hits() == 0 && cache.evictions() == 0 && cache.bytes() == 3000);
+
+  // m0 becomes the most recent, so m1 is evicted for m3.
+  CHECK(*cache.read(name(0)) == content(0));
+  CHECK(cache.hits() == 1);
+  CHECK(*cache.read(name(3)) == content(3));
+  CHECK(cache.evictions() == 1 && cache.bytes() == 3000);
+  CHECK(*cache.read(name(1)) == content(1));
+  CHECK(cache.misses() == 5 && cache.evictions() == 2);
+  CHECK(*cache.read(name(0)) == content(0));
+  CHECK(cache.hits() == 2);
+
+  // m2 has gone from the cache but the buffer is still good.
+  CHECK(*held == content(2));
+  CHECK(*cache.read(name(2)) == content(2));
+  CHECK(cache.misses() == 6);
+
+  // reads by entry and by name share the cache.
+  CHECK(*cache.read(*reader.find(name(2))) == content(2));
+  CHECK(cache.hits() == 3);
+
+  // a member over the budget is returned but not kept.
+  size_t bytes = cache.bytes();
+  uint64_t evictions = cache.evictions();
+  CHECK(cache.read("big")->size() == 10000);
+  CHECK(cache.read("big")->size() == 10000);
+  CHECK(cache.bytes() == bytes && cache.evictions() == evictions && cache.misses() == 8);
+
+  // the first of two members with the same name, as zipfile_reader::find.
+  CHECK(*cache.read("dup") == andyzip_test::bytes("first"));
+  CHECK_THROWS(std::runtime_error, cache.read("missing"));
+
+  cache.clear();
+  CHECK(cache.bytes() == 0);
+  uint64_t misses = cache.misses();
+  cache.read(name(0));
+  CHECK(cache.misses() == misses + 1);
+
+  // many threads on a cache that holds about half the members.
+  {
+    andyzip::zipfile_cache shared(reader, 5500);
+    std::atomic<int> errors(0);
+    std::vector<std::thread> threads;
+    const int reads = 2000;
+    for (int t = 0; t != 4; ++t) {
+      threads.emplace_back([&, t]() {
+        uint32_t seed = t + 1;
+        for (int j = 0; j != reads; ++j) {
+          seed = seed * 1664525 + 1013904223;
+          int i = (seed >> 16) % 10;
+          if (*shared.read(name(i)) != content(i)) errors++;
+        }
+      });
+    }
+    for (auto &t : threads) t.join();
+    CHECK(errors == 0);
+    CHECK(shared.hits() + shared.misses() == 4 * reads);
+    CHECK(shared.bytes() <= 5500);
+  }
+
+  return andyzip_test::result();
+}
@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// zipfile_stream_reader on archives from zipfile_writer, including members with
+// data descriptors, fed in pieces of various sizes.
+//
+
+#include <andyzip/zipfile_stream_reader.hpp>
+#include <andyzip/zipfile_writer.hpp>
+
+#include "test.hpp"
+
+namespace {
+  typedef andyzip::zipfile_writer writer_t;
+  typedef andyzip::zipfile_stream_reader::member member_t;
+
+  struct expected_t {
+    std::string name;
+    std::vector<uint8_t> data;
+  };
+
+  std::vector<uint8_t> write_zip(const std::vector<expected_t> &members, bool streamed) {
+    std::vector<uint8_t> zip;
+    writer_t writer([&zip](const uint8_t *data, size_t size) { zip.insert(zip.end(), data, data + size); }, 6, 2);
+    for (auto &m : members) {
+      if (streamed) {
+        writer.begin_member(m.name);
+        for (size_t pos = 0; pos < m.data.size(); pos += 100000) {
+          writer.write(m.data.data() + pos, std::min((size_t)100000, m.data.size() - pos));
+        }
+        writer.end_member();
+      } else {
+        writer.add(m.name, m.data);
+      }
+    }
+    writer.finish();
+    return zip;
+  }
+
+  // Feed the archive piece bytes at a time, taking members as they complete.
+  std::vector<member_t> stream(const std::vector<uint8_t> &zip, size_t piece) {
+    andyzip::zipfile_stream_reader reader;
+    std::vector<member_t> result;
+    member_t m;
+    for (size_t pos = 0; pos < zip.size(); pos += piece) {
+      reader.feed(zip.data() + pos, std::min(piece, zip.size() - pos));
+      while (reader.next(m)) result.push_back(m);
+    }
+    reader.finish();
+    while (reader.next(m)) result.push_back(m);
+    CHECK(reader.done());
+    return result;
+  }
+
+  // A member holding "a", its local header claiming usize bytes, and the end record.
+  std::vector<uint8_t> local_header(const std::string &name, unsigned method, const std::vector<uint8_t> &data, uint64_t usize, bool zip64 = false) {
+    std::vector<uint8_t> d;
+    auto put = [&d](uint64_t value, int bytes) {
+      for (int i = 0; i != bytes; ++i) d.push_back((uint8_t)(value >> (i * 8)));
+    };
+    std::vector<uint8_t> a = andyzip_test::bytes("a");
+    put(0x04034b50, 4);
+    put(zip64 ? 45 : 20, 2);
+    put(0, 2);
+    put(method, 2);
+    put(0, 4);
+    put(andyzip::crc32(0, a.data(), a.size()), 4);
+    put(zip64 ? 0xffffffff : data.size(), 4);
+    put(zip64 ? 0xffffffff : usize, 4);
+    put(name.size(), 2);
+    put(zip64 ? 20 : 0, 2);
+    d.insert(d.end(), name.begin(), name.end());
+    if (zip64) {
+      put(0x0001, 2);
+      put(16, 2);
+      put(usize, 8);
+      put(data.size(), 8);
+    }
+    d.insert(d.end(), data.begin(), data.end());
+    put(0x06054b50, 4);
+    put(0, 18);
+    return d;
+  }
+
+  bool same(const std::vector<member_t> &got, const std::vector<expected_t> &expected) {
+    if (got.size() != expected.size()) return false;
+    for (size_t i = 0; i != got.size(); ++i) {
+      if (got[i].name != expected[i].name || got[i].data != expected[i].data) return false;
+      if (got[i].crc != andyzip::crc32(0, expected[i].data.data(), expected[i].data.size())) return false;
+    }
+    return true;
+  }
+}
+
+int main() {
+  std::vector<expected_t> members = {
+    { "text.txt", andyzip_test::text(3000000) },
+    { "noise.bin", andyzip_test::noise(300000) },
+    { "empty", std::vector<uint8_t>() },
+    { "small.txt", andyzip_test::bytes("small\n") },
+    { "dir/more.txt", andyzip_test::text(50000, 3) },
+  };
+
+  for (bool streamed : { true, false }) {
+    std::vector<uint8_t> zip = write_zip(members, streamed);
+    for (size_t piece : { (size_t)997, (size_t)65536, zip.size() }) {
+      CHECK(same(stream(zip, piece), members));
+    }
+  }
+
+  // byte at a time, on something smaller.
+  std::vector<expected_t> small = {
+    { "a.txt", andyzip_test::text(20000) },
+    { "b.bin", andyzip_test::noise(3000) },
+    { "c.txt", andyzip_test::text(100, 2) },
+  };
+  for (bool streamed : { true, false }) {
+    CHECK(same(stream(write_zip(small, streamed), 1), small));
+  }
+
+  // an archive that stops before its central directory.
+  {
+    std::vector<uint8_t> zip = write_zip(small, true);
+    zip.resize(zip.size() / 2);
+    CHECK_THROWS(std::runtime_error, stream(zip, 4096));
+  }
+
+  // a corrupt member fails its CRC check.
+  {
+    std::vector<expected_t> one = { { "n.bin", andyzip_test::noise(1000) } };
+    std::vector<uint8_t> zip = write_zip(one, false);
+    zip[30 + 5 + 500] ^= 1;
+    CHECK_THROWS(std::runtime_error, stream(zip, zip.size()));
+  }
+
+  // local headers claiming far more data than their compressed size can hold
+  // fail before anything is allocated for them.
+  {
+    // a fixed deflate block of "a" and 0xfffffff0 bytes claimed.
+    std::vector<uint8_t> data = { 0x4b, 0x04, 0x00 };
+    CHECK_THROWS(std::runtime_error, stream(local_header("a", 8, data, 0xfffffff0), 5));
+
+    // 2^64 - 1 bytes claimed in a zip64 extra field.
+    CHECK_THROWS(std::runtime_error, stream(local_header("a", 8, data, ~(uint64_t)0, true), 5));
+
+    // stored members have the same size compressed and not.
+    CHECK_THROWS(std::runtime_error, stream(local_header("a", 0, andyzip_test::bytes("a"), 2), 5));
+
+    // a plausible claim for what is in the header still has to match.
+    CHECK_THROWS(std::runtime_error, stream(local_header("a", 8, data, 1000), 5));
+    CHECK(stream(local_header("a", 8, data, 1), 5).size() == 1);
+  }
+
+  return andyzip_test::result();
+}
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// (C) Andy Thomason 2017
+//
+// zipfile_writer to zipfile_reader: every way of adding a member must read back
+// with the right data, method, CRC and time, and bad arguments must throw.
+//
+
+#include <andyzip/zipfile_reader.hpp>
+#include <andyzip/zipfile_writer.hpp>
+
+#include "test.hpp"
+
+#include <stdexcept>
+
+namespace {
+  const uint32_t some_time = 0x4b2a6c21;
+
+  std::vector<uint8_t> write_zip(const std::function<void (andyzip::zipfile_writer &)> &fn, unsigned num_threads = 2) {
+    std::vector<uint8_t> zip;
+    andyzip::zipfile_writer writer([&zip](const uint8_t *data, size_t size) { zip.insert(zip.end(), data, data + size); }, 6, num_threads);
+    fn(writer);
+    writer.finish();
+    return zip;
+  }
+}
+
+int main() {
+  typedef andyzip::zipfile_writer writer_t;
+
+  std::vector<uint8_t> text = andyzip_test::text(200000);
+  std::vector<uint8_t> noise = andyzip_test::noise(100000);
+  std::vector<uint8_t> big = andyzip_test::text((size_t)writer_t::stream_chunk_size * 5 / 2 + 17, 9);
+  std::vector<uint8_t> big_noise = andyzip_test::noise((size_t)writer_t::stream_chunk_size + 5, 9);
+
+  // random bytes, but 64 copies of the same 8k, which only looks random byte by byte.
+  std::vector<uint8_t> repeats;
+  std::vector<uint8_t> block = andyzip_test::noise(8192, 11);
+  for (int j = 0; j != 64; ++j) repeats.insert(repeats.end(), block.begin(), block.end());
+
+  struct expected_t {
+    const char *name;
+    const std::vector<uint8_t> *data;
+    unsigned method;
+    bool streamed;
+  };
+  std::vector<uint8_t> empty;
+  expected_t expected[] = {
+    { "stored.txt", &text, writer_t::stored, false },
+    { "deflated.txt", &text, writer_t::deflated, false },
+    { "auto/text.txt", &text, writer_t::deflated, false },
+    { "auto/noise.bin", &noise, writer_t::stored, false },
+    { "auto/repeats.bin", &repeats, writer_t::deflated, false },
+    { "empty", &empty, writer_t::deflated, false },
+    { "streamed.txt", &big, writer_t::deflated, true },
+    { "streamed_noise.bin", &big_noise, writer_t::deflated, true },
+    { "streamed_empty", &empty, writer_t::deflated, true },
+    { "after_streams.txt", &text, writer_t::deflated, false },
+  };
+
+  std::vector<uint8_t> zip = write_zip([&](writer_t &w) {
+    w.add("stored.txt", text.data(), text.data() + text.size(), writer_t::stored, some_time);
+    w.add("deflated.txt", text, writer_t::deflated, some_time);
+    w.add("auto/text.txt", text, writer_t::automatic, some_time);
+    w.add("auto/noise.bin", noise, writer_t::automatic, some_time);
+    w.add("auto/repeats.bin", repeats, writer_t::automatic, some_time);
+    w.add("empty", std::vector<uint8_t>(), writer_t::deflated, some_time);
+
+    // odd sized writes that straddle the chunk boundaries.
+    w.begin_member("streamed.txt", writer_t::automatic, some_time);
+    for (size_t pos = 0; pos < big.size(); pos += 77777) {
+      w.write(big.data() + pos, std::min((size_t)77777, big.size() - pos));
+    }
+    w.end_member();
+
+    w.begin_member("streamed_noise.bin", writer_t::automatic, some_time);
+    w.write(big_noise.data(), big_noise.size());
+    w.end_member();
+
+    w.begin_member("streamed_empty", writer_t::stored, some_time);
+    w.end_member();
+
+    w.add("after_streams.txt", text, writer_t::automatic, some_time);
+
+    // out of order calls and unsupported methods.
+    CHECK_THROWS(std::runtime_error, w.write(text.data(), 1));
+    CHECK_THROWS(std::runtime_error, w.end_member());
+    CHECK_THROWS(std::invalid_argument, w.add("bzip2", text, 12));
+    CHECK_THROWS(std::invalid_argument, w.begin_member("lzma", 14));
+  });
+
+  zipfile_reader reader(zip.data(), zip.data() + zip.size());
+  size_t n = sizeof(expected) / sizeof(expected[0]);
+  CHECK(reader.filenames().size() == n);
+  size_t i = 0;
+  for (auto e : reader.entries()) {
+    if (!CHECK(i < n)) break;
+    const expected_t &x = expected[i++];
+    const std::vector<uint8_t> &data = *x.data;
+    CHECK(e.name_is(x.name));
+    CHECK(e.method() == x.method);
+    CHECK(e.dos_date_time() == some_time);
+    CHECK(e.size() == data.size());
+    CHECK(e.crc() == andyzip::crc32(0, data.data(), data.size()));
+    CHECK(((e.flags() & 8) != 0) == x.streamed);
+    CHECK(reader.read(e) == data);
+    CHECK(reader.read(x.name) == data);
+  }
+  CHECK(i == n);
+  CHECK(reader.find("auto/noise.bin") != reader.entries().end());
+  CHECK(reader.find("missing") == reader.entries().end());
+
+  // compressed members are smaller and the stored ones are not.
+  for (auto e : reader.entries()) {
+    if (e.name_is("deflated.txt")) CHECK(e.compressed_size() < text.size() / 2);
+    if (e.name_is("stored.txt")) CHECK(e.compressed_size() == text.size());
+    if (e.name_is("auto/repeats.bin")) CHECK(e.compressed_size() < repeats.size() / 16);
+  }
+
+  // one thread gives the same archive as several.
+  std::vector<uint8_t> serial = write_zip([&](writer_t &w) {
+    w.add("a", text, writer_t::automatic, some_time);
+    w.add("b", noise, writer_t::automatic, some_time);
+  }, 1);
+  std::vector<uint8_t> parallel = write_zip([&](writer_t &w) {
+    w.add("a", text, writer_t::automatic, some_time);
+    w.add("b", noise, writer_t::automatic, some_time);
+  }, 4);
+  CHECK(serial == parallel);
+
+  // more than 65535 members needs a zip64 end of central directory.
+  const size_t many = 70000;
+  std::vector<uint8_t> many_zip = write_zip([&](writer_t &w) {
+    for (size_t j = 0; j != many; ++j) {
+      std::string name = "f" + std::to_string(j);
+      w.add(name, andyzip_test::bytes(name), writer_t::stored);
+    }
+  });
+  zipfile_reader many_reader(many_zip.data(), many_zip.data() + many_zip.size());
+  size_t count = 0;
+  for (auto e : many_reader.entries()) {
+    if (count % 9999 == 0) CHECK(many_reader.read(e) == andyzip_test::bytes("f" + std::to_string(count)));
+    ++count;
+  }
+  CHECK(count == many);
+
+  return andyzip_test::result();
+}